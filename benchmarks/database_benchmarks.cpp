@@ -0,0 +1,89 @@
+#include <benchmark/benchmark.h>
+#include <satox/core/database_manager.hpp>
+#include <filesystem>
+#include <string>
+#include <vector>
+
+using satox::core::DatabaseManager;
+using satox::core::DatabaseType;
+
+namespace {
+
+// One file-backed SQLite database per benchmark run, shaped like the indexer's UTXO table
+class SQLiteBench {
+public:
+    SQLiteBench(const std::string& name, bool wal) {
+        path_ = (std::filesystem::temp_directory_path() / ("satox_bench_" + name + ".db")).string();
+        removeFiles();
+        manager_.initialize(DatabaseManager::DatabaseConfig{});
+
+        nlohmann::json config = {{"path", path_}, {"busy_timeout", 5000}};
+        if (wal) {
+            config["journal_mode"] = "WAL";
+            config["synchronous"] = "NORMAL";
+            config["cache_size"] = -65536;
+            config["mmap_size"] = 256 * 1024 * 1024;
+        }
+        id_ = manager_.connect(DatabaseType::SQLITE, config);
+        nlohmann::json result;
+        manager_.executeQuery(id_, "CREATE TABLE utxo (txid TEXT, vout INTEGER, amount INTEGER, script BLOB)", result);
+    }
+
+    ~SQLiteBench() {
+        manager_.disconnect(id_);
+        manager_.shutdown();
+        removeFiles();
+    }
+
+    static std::vector<DatabaseManager::QueryParam> row(int64_t n) {
+        return {std::string(64, 'a' + n % 26), n % 4, n * 1000, std::vector<uint8_t>(25, static_cast<uint8_t>(n))};
+    }
+
+    DatabaseManager& manager() { return manager_; }
+    const std::string& id() const { return id_; }
+
+private:
+    void removeFiles() {
+        for (const char* suffix : {"", "-wal", "-shm", "-journal"}) {
+            std::filesystem::remove(path_ + suffix);
+        }
+    }
+
+    DatabaseManager manager_;
+    std::string id_;
+    std::string path_;
+};
+
+const char* const kInsertUtxo = "INSERT INTO utxo VALUES (?, ?, ?, ?)";
+
+} // namespace
+
+// One autocommit INSERT per row; arg 0 = default journal, 1 = WAL + synchronous=NORMAL
+static void BM_SQLiteSingleInserts(benchmark::State& state) {
+    SQLiteBench bench("single", state.range(0) != 0);
+    nlohmann::json result;
+    int64_t n = 0;
+    for (auto _ : state) {
+        bench.manager().executeQuery(bench.id(), kInsertUtxo, SQLiteBench::row(n++), result);
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_SQLiteSingleInserts)->Arg(0)->Arg(1)->Unit(benchmark::kMicrosecond);
+
+// executeBatch: one prepared statement, range(0) bound tuples, one transaction
+static void BM_SQLiteBatchedInserts(benchmark::State& state) {
+    SQLiteBench bench("batched", true);
+    const int64_t batchSize = state.range(0);
+    std::vector<std::vector<DatabaseManager::QueryParam>> rows;
+    rows.reserve(batchSize);
+    for (int64_t i = 0; i < batchSize; ++i) {
+        rows.push_back(SQLiteBench::row(i));
+    }
+
+    nlohmann::json result;
+    for (auto _ : state) {
+        bench.manager().executeBatch(bench.id(), kInsertUtxo, rows, result);
+    }
+    state.SetItemsProcessed(state.iterations() * batchSize);
+}
+BENCHMARK(BM_SQLiteBatchedInserts)->Arg(100)->Arg(1000)->Arg(10000)->Unit(benchmark::kMillisecond);
@@ -0,0 +1,78 @@
+#include <benchmark/benchmark.h>
+#include <satox/blockchain/kawpow.hpp>
+#include <filesystem>
+#include <string>
+#include <vector>
+
+using satox::blockchain::Kawpow;
+
+namespace {
+
+constexpr uint64_t BENCH_EPOCH = 1;
+
+std::string benchDirectory() {
+    auto directory = std::filesystem::temp_directory_path() / "satox-kawpow-bench";
+    std::filesystem::create_directories(directory);
+    return directory.string();
+}
+
+} // namespace
+
+// Cold start: no epoch file yet, so the cache is generated and written out
+static void BM_EpochCacheCold(benchmark::State& state) {
+    const std::string directory = benchDirectory();
+    Kawpow::setEpochDirectory(directory);
+    Kawpow::setEpochCacheCapacity(0);
+    for (auto _ : state) {
+        state.PauseTiming();
+        std::filesystem::remove_all(directory);
+        std::filesystem::create_directories(directory);
+        state.ResumeTiming();
+        auto context = Kawpow::getEpochContext(BENCH_EPOCH);
+        benchmark::DoNotOptimize(context->cache.data());
+    }
+    Kawpow::setEpochDirectory("");
+    Kawpow::setEpochCacheCapacity(satox::blockchain::KAWPOW_EPOCH_CACHE_CAPACITY);
+}
+BENCHMARK(BM_EpochCacheCold)->UseRealTime()->Unit(benchmark::kMillisecond);
+
+// Warm start: the epoch file from an earlier run is mapped read-only
+static void BM_EpochCacheWarm(benchmark::State& state) {
+    Kawpow::setEpochDirectory(benchDirectory());
+    Kawpow::setEpochCacheCapacity(0);
+    Kawpow::getEpochContext(BENCH_EPOCH);
+    for (auto _ : state) {
+        auto context = Kawpow::getEpochContext(BENCH_EPOCH);
+        benchmark::DoNotOptimize(context->cache.data());
+    }
+    Kawpow::setEpochDirectory("");
+    Kawpow::setEpochCacheCapacity(satox::blockchain::KAWPOW_EPOCH_CACHE_CAPACITY);
+}
+BENCHMARK(BM_EpochCacheWarm)->UseRealTime()->Unit(benchmark::kMillisecond);
+
+// Baseline: in-memory generation, as on every start without an epoch directory
+static void BM_EpochCacheInMemory(benchmark::State& state) {
+    Kawpow::setEpochCacheCapacity(0);
+    for (auto _ : state) {
+        auto context = Kawpow::getEpochContext(BENCH_EPOCH);
+        benchmark::DoNotOptimize(context->cache.data());
+    }
+    Kawpow::setEpochCacheCapacity(satox::blockchain::KAWPOW_EPOCH_CACHE_CAPACITY);
+}
+BENCHMARK(BM_EpochCacheInMemory)->UseRealTime()->Unit(benchmark::kMillisecond);
+
+// Light verification against a resident epoch cache
+static void BM_LightVerify(benchmark::State& state) {
+    std::vector<uint8_t> header(satox::blockchain::KAWPOW_HEADER_BYTES, 0x5a);
+    std::vector<uint8_t> target(satox::blockchain::KAWPOW_HASH_BYTES, 0xff);
+    std::vector<uint8_t> hash;
+    std::vector<uint8_t> mix_hash;
+    const uint64_t block_number = BENCH_EPOCH * satox::blockchain::KAWPOW_EPOCH_LENGTH;
+    Kawpow kawpow;
+    kawpow.computeHash(header, block_number, 42, hash, mix_hash);
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(kawpow.verifyHash(header, block_number, 42, mix_hash, target));
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_LightVerify);
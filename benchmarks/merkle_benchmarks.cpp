@@ -0,0 +1,87 @@
+#include <benchmark/benchmark.h>
+#include <satox/core/merkle_tree.h>
+#include <openssl/sha.h>
+#include <vector>
+
+using satox::core::MerkleTree;
+
+namespace {
+
+std::vector<MerkleTree::Digest> makeLeaves(size_t count) {
+    std::vector<MerkleTree::Digest> leaves(count);
+    for (size_t i = 0; i < count; ++i) {
+        for (size_t j = 0; j < leaves[i].size(); ++j) {
+            leaves[i][j] = static_cast<uint8_t>(i * 31 + j);
+        }
+    }
+    return leaves;
+}
+
+} // namespace
+
+// Whole tree from precomputed leaves; range(0) = leaf count
+static void BM_BuildFromLeaves(benchmark::State& state) {
+    const auto leaves = makeLeaves(static_cast<size_t>(state.range(0)));
+    MerkleTree tree;
+    for (auto _ : state) {
+        tree.buildFromLeaves(leaves);
+        benchmark::DoNotOptimize(tree.getRootDigest());
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_BuildFromLeaves)->RangeMultiplier(10)->Range(1000, 1000000)->UseRealTime()->Unit(benchmark::kMillisecond);
+
+// The level kernel: range(0) pairs per call (SHA-NI when the CPU has it)
+static void BM_HashPairs(benchmark::State& state) {
+    const size_t pairs = static_cast<size_t>(state.range(0));
+    const auto in = makeLeaves(2 * pairs);
+    std::vector<MerkleTree::Digest> out(pairs);
+    for (auto _ : state) {
+        MerkleTree::hashPairs(in.data(), out.data(), pairs);
+        benchmark::DoNotOptimize(out.data());
+    }
+    state.SetItemsProcessed(state.iterations() * pairs);
+}
+BENCHMARK(BM_HashPairs)->Arg(1024);
+
+// Baseline: one OpenSSL one-shot SHA-256 per pair
+static void BM_HashPairsOpenSSL(benchmark::State& state) {
+    const size_t pairs = static_cast<size_t>(state.range(0));
+    const auto in = makeLeaves(2 * pairs);
+    std::vector<MerkleTree::Digest> out(pairs);
+    for (auto _ : state) {
+        for (size_t i = 0; i < pairs; ++i) {
+            SHA256(in[2 * i].data(), 64, out[i].data());
+        }
+        benchmark::DoNotOptimize(out.data());
+    }
+    state.SetItemsProcessed(state.iterations() * pairs);
+}
+BENCHMARK(BM_HashPairsOpenSSL)->Arg(1024);
+
+// Proof for every 1000th leaf of a 1M-leaf tree, then verification
+static void BM_ProofRoundTrip(benchmark::State& state) {
+    MerkleTree tree;
+    const auto leaves = makeLeaves(1000000);
+    tree.buildFromLeaves(leaves);
+    size_t index = 0;
+    for (auto _ : state) {
+        auto proof = tree.getProof(index);
+        benchmark::DoNotOptimize(MerkleTree::verifyProof(leaves[index], index, proof, tree.getRootDigest()));
+        index = (index + 1000) % leaves.size();
+    }
+}
+BENCHMARK(BM_ProofRoundTrip);
+
+// Block-template pattern: append one leaf and re-root; range(0) = starting leaves
+static void BM_AppendLeaf(benchmark::State& state) {
+    MerkleTree tree;
+    tree.buildFromLeaves(makeLeaves(static_cast<size_t>(state.range(0))));
+    const auto extra = makeLeaves(1);
+    for (auto _ : state) {
+        tree.append(extra[0]);
+        benchmark::DoNotOptimize(tree.getRootDigest());
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_AppendLeaf)->Arg(1000)->Arg(100000);
@@ -0,0 +1,52 @@
+#include <benchmark/benchmark.h>
+#include <satox/core/proof_of_work.h>
+#include <string>
+#include <vector>
+
+using satox::core::ProofOfWork;
+
+namespace {
+
+// Attempts per benchmark iteration; the target is unreachable, so every run
+// sweeps the whole range
+constexpr uint64_t kNoncesPerIteration = 1 << 18;
+
+// 76 bytes: an 80-byte block header without its nonce
+const std::vector<uint8_t> kHeaderPrefix(76, 0x5a);
+
+} // namespace
+
+// Midstate engine, binary nonce; range(0) = mining threads
+static void BM_MidstateHashRate(benchmark::State& state) {
+    ProofOfWork pow;
+    ProofOfWork::Hash target{};  // all zero: never met
+    ProofOfWork::MiningOptions options;
+    options.threads = static_cast<size_t>(state.range(0));
+
+    uint64_t start = 0;
+    uint64_t hashes = 0;
+    for (auto _ : state) {
+        options.startNonce = start;
+        options.endNonce = start + kNoncesPerIteration - 1;
+        hashes += pow.mine(kHeaderPrefix, target, options).hashes;
+        start += kNoncesPerIteration;
+    }
+    state.SetItemsProcessed(hashes);
+    state.counters["hashes/s"] = benchmark::Counter(static_cast<double>(hashes), benchmark::Counter::kIsRate);
+}
+BENCHMARK(BM_MidstateHashRate)->Arg(1)->Arg(2)->Arg(4)->Arg(8)->UseRealTime()->Unit(benchmark::kMillisecond);
+
+// Baseline: the string path (concatenate, hash, hex-encode, compare) per attempt
+static void BM_StringHashAttempt(benchmark::State& state) {
+    const std::string previousHash(64, 'a');
+    const std::string merkleRoot(64, 'b');
+    const std::string target(4, '0');
+    uint64_t nonce = 0;
+    for (auto _ : state) {
+        std::string hash = ProofOfWork::calculateHash(previousHash + merkleRoot +
+                                                      std::to_string(1700000000) + std::to_string(nonce++));
+        benchmark::DoNotOptimize(hash.compare(0, target.size(), target));
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_StringHashAttempt);
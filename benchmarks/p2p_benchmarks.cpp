@@ -0,0 +1,115 @@
+#include <benchmark/benchmark.h>
+#include <satox/network/p2p_codec.hpp>
+#include <satox/network/p2p_protocol.hpp>
+#include <algorithm>
+#include <array>
+#include <cstring>
+#include <random>
+#include <vector>
+
+using namespace satox;
+
+namespace {
+
+std::vector<uint8_t> makeStream(size_t payloadSize, size_t frames) {
+    std::vector<uint8_t> payload(payloadSize);
+    for (size_t i = 0; i < payload.size(); ++i) {
+        payload[i] = static_cast<uint8_t>(i * 131);
+    }
+    P2POutgoingFrame frame = makeFrame(P2PMessageType::BLOCK, payload.data(), payload.size());
+    std::vector<uint8_t> stream;
+    for (size_t i = 0; i < frames; ++i) {
+        stream.insert(stream.end(), frame.header, frame.header + P2P_HEADER_SIZE);
+        stream.insert(stream.end(), payload.begin(), payload.end());
+    }
+    return stream;
+}
+
+} // namespace
+
+// Streaming parse of block-sized frames arriving in 64 KiB reads; range(0) = payload bytes
+static void BM_ParseFrames(benchmark::State& state) {
+    const size_t payloadSize = static_cast<size_t>(state.range(0));
+    const size_t frames = std::max<size_t>(1, (8 << 20) / (payloadSize + P2P_HEADER_SIZE));
+    const auto stream = makeStream(payloadSize, frames);
+    const size_t chunk = 64 * 1024;
+
+    P2PFrameParser parser;
+    P2PFrameView frame;
+    for (auto _ : state) {
+        size_t parsed = 0;
+        for (size_t offset = 0; offset < stream.size(); offset += chunk) {
+            parser.feed(stream.data() + offset, std::min(chunk, stream.size() - offset));
+            while (parser.next(frame) == P2PFrameParser::Status::Frame) {
+                benchmark::DoNotOptimize(frame.payload);
+                ++parsed;
+            }
+        }
+        if (parsed != frames) {
+            state.SkipWithError("frame count mismatch");
+        }
+    }
+    state.SetBytesProcessed(state.iterations() * stream.size());
+}
+BENCHMARK(BM_ParseFrames)->Arg(1024)->Arg(64 * 1024)->Arg(1 << 20)->Arg(2 << 20);
+
+// Baseline: whole-buffer deserializeMessage, one vector per message
+static void BM_DeserializeMessage(benchmark::State& state) {
+    const size_t payloadSize = static_cast<size_t>(state.range(0));
+    const auto stream = makeStream(payloadSize, 1);
+    for (auto _ : state) {
+        P2PMessage message = deserializeMessage(stream);
+        benchmark::DoNotOptimize(message.payload.data());
+    }
+    state.SetBytesProcessed(state.iterations() * stream.size());
+}
+BENCHMARK(BM_DeserializeMessage)->Arg(1024)->Arg(64 * 1024)->Arg(1 << 20)->Arg(2 << 20);
+
+// Command dispatch: perfect-hash lookup of every known command
+static void BM_LookupCommand(benchmark::State& state) {
+    std::vector<std::array<char, P2P_COMMAND_SIZE>> commands(P2P_MESSAGE_TYPE_COUNT);
+    for (size_t i = 0; i < commands.size(); ++i) {
+        commands[i].fill(0);
+        const char* name = messageCommand(static_cast<P2PMessageType>(i));
+        std::copy(name, name + std::strlen(name), commands[i].begin());
+    }
+    for (auto _ : state) {
+        for (const auto& command : commands) {
+            P2PMessageType type;
+            benchmark::DoNotOptimize(lookupCommand(command.data(), type));
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * commands.size());
+}
+BENCHMARK(BM_LookupCommand);
+
+// Fuzz: valid frames with random bit flips, truncated lengths and random read
+// boundaries. The parser must stop with Error or NeedMore, never misbehave.
+static void BM_FuzzParser(benchmark::State& state) {
+    std::mt19937_64 rng(0x5a70c);
+    const auto clean = makeStream(4096, 16);
+    size_t errors = 0;
+    for (auto _ : state) {
+        auto stream = clean;
+        for (int flips = rng() % 4; flips > 0; --flips) {
+            stream[rng() % stream.size()] ^= static_cast<uint8_t>(1u << (rng() % 8));
+        }
+        stream.resize(rng() % (stream.size() + 1));
+
+        P2PFrameParser parser(P2P_NETWORK_MAGIC, 1 << 20);
+        P2PFrameView frame;
+        size_t offset = 0;
+        P2PFrameParser::Status status = P2PFrameParser::Status::NeedMore;
+        while (offset < stream.size() && status != P2PFrameParser::Status::Error) {
+            size_t take = std::min<size_t>(1 + rng() % 8192, stream.size() - offset);
+            parser.feed(stream.data() + offset, take);
+            offset += take;
+            while ((status = parser.next(frame)) == P2PFrameParser::Status::Frame) {
+                benchmark::DoNotOptimize(frame.payload);
+            }
+        }
+        errors += status == P2PFrameParser::Status::Error;
+    }
+    state.counters["error_rate"] = benchmark::Counter(static_cast<double>(errors) / state.iterations());
+}
+BENCHMARK(BM_FuzzParser);
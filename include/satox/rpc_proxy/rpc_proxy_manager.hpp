@@ -46,10 +46,16 @@
 #include <nlohmann/json.hpp>
 #include <functional>
 #include <vector>
+#include <chrono>
+#include <future>
+#include <unordered_map>
+#include <unordered_set>
 
 /** @ingroup rpc_proxy */
 namespace satox::rpc_proxy {
 
+class HttpConnectionPool;
+
 /** @ingroup rpc_proxy */
 struct RpcProxyConfig {
     std::string endpoint;
@@ -58,6 +64,16 @@ struct RpcProxyConfig {
     uint32_t timeout_ms = 30000;
     bool enableLogging = true;
     std::string logPath = "logs/components/rpc_proxy/";
+    size_t max_connections = 8;           // keep-alive connections to the endpoint
+    // Read-only methods: identical in-flight calls share one upstream request,
+    // and answers are reused for cache_ttl_ms (0 disables the cache)
+    uint32_t cache_ttl_ms = 1000;
+    std::vector<std::string> read_only_methods = {
+        "getblockcount", "getbestblockhash", "getblockhash", "getblock",
+        "getblockheader", "getblockchaininfo", "getdifficulty", "getmempoolinfo",
+        "getmininginfo", "getnetworkinfo", "getchaintips", "getrawtransaction",
+        "gettxout", "getassetdata", "listassets"
+    };
 };
 
 /** @ingroup rpc_proxy */
@@ -79,6 +95,9 @@ public:
     std::string getLastError() const;
     RpcProxyStats getStats() const;
     bool sendRpcRequest(const nlohmann::json& request, nlohmann::json& response);
+    // One HTTP round trip for all requests (JSON-RPC batch); responses are
+    // matched back to request order
+    bool sendRpcBatch(const std::vector<nlohmann::json>& requests, std::vector<nlohmann::json>& responses);
     void registerErrorCallback(std::function<void(const std::string&)> cb);
     void registerHealthCallback(std::function<void(bool)> cb);
 private:
@@ -90,6 +109,21 @@ private:
     void logInfo(const std::string& msg) const;
     void notifyError(const std::string& msg) const;
     void notifyHealth(bool healthy) const;
+
+    struct CachedResponse {
+        nlohmann::json response;
+        std::chrono::steady_clock::time_point expires;
+    };
+    struct UpstreamResult {
+        bool ok = false;
+        nlohmann::json response;
+        std::string error;
+    };
+    using SharedResult = std::shared_future<UpstreamResult>;
+
+    UpstreamResult postUpstream(HttpConnectionPool& pool, const nlohmann::json& body);
+    void recordResult(bool ok, std::chrono::steady_clock::time_point start, const std::string& error);
+
     mutable std::mutex mutex_;
     RpcProxyConfig config_;
     RpcProxyStats stats_;
@@ -98,6 +132,17 @@ private:
     bool healthy_ = true;
     std::vector<std::function<void(const std::string&)>> errorCallbacks_;
     std::vector<std::function<void(bool)>> healthCallbacks_;
+
+    // The pool is shared so requests that already hold it finish after shutdown()
+    std::shared_ptr<HttpConnectionPool> pool_;
+    std::unordered_set<std::string> readOnlyMethods_;
+    mutable std::mutex cacheMutex_;              // cache_, inFlight_ and the counters below
+    std::unordered_map<std::string, CachedResponse> cache_;
+    std::unordered_map<std::string, SharedResult> inFlight_;
+    uint64_t cacheHits_ = 0;
+    uint64_t coalesced_ = 0;
+    uint64_t upstreamRequests_ = 0;
+    uint64_t batches_ = 0;
 };
 
 } // namespace satox::rpc_proxy 
@@ -27,6 +27,7 @@
 
 #include <vector>
 #include <cstdint>
+#include <memory>
 #include <string>
 
 namespace satox {
@@ -45,9 +46,72 @@ constexpr uint32_t KAWPOW_NONCE_BYTES = 8;
 constexpr uint32_t KAWPOW_HEADER_BYTES = 32;
 constexpr uint32_t KAWPOW_MIX_BYTES = 128;
 constexpr uint32_t KAWPOW_ACCESSES = 64;
+constexpr size_t KAWPOW_EPOCH_CACHE_CAPACITY = 2;        // epochs kept warm by default
+constexpr uint32_t KAWPOW_PREGENERATE_BLOCKS = 750;      // start the next epoch's cache this early
 
+/**
+ * KAWPOW proof of work.
+ *
+ * Dataset item i is cache item (i mod n) XORed with KAWPOW_DATASET_PARENTS
+ * further cache items, so it can be derived from the epoch cache alone.
+ * verifyHash does exactly that for the KAWPOW_ACCESSES items a hash touches
+ * (the light path) and never builds the dataset; computeHash uses the full
+ * dataset only when initializeDataset was called for that epoch.
+ *
+ * Epoch caches are shared by every Kawpow instance in the process. They are
+ * reference counted, generated once even when several threads ask at the
+ * same time, and the most recently used KAWPOW_EPOCH_CACHE_CAPACITY epochs
+ * stay resident after their last user lets go. Within KAWPOW_PREGENERATE_BLOCKS
+ * of an epoch boundary the next epoch's cache is built on a background thread.
+ *
+ * With setEpochDirectory, caches and datasets are written once to
+ *   kawpow-cache-<epoch>.bin, kawpow-dataset-<epoch>.bin
+ * (a 4 KiB header page, then the bytes) and mapped read-only on later runs.
+ * Files are written under a temporary name and renamed when complete, so a
+ * crash never leaves a partial one behind. Dataset generation is split
+ * across all cores.
+ */
 class Kawpow {
 public:
+    // Cache or dataset bytes: an anonymous mapping, or a mapping of an epoch file
+    class EpochBuffer {
+    public:
+        EpochBuffer() = default;
+        ~EpochBuffer();
+        EpochBuffer(const EpochBuffer&) = delete;
+        EpochBuffer& operator=(const EpochBuffer&) = delete;
+        EpochBuffer(EpochBuffer&& other) noexcept;
+        EpochBuffer& operator=(EpochBuffer&& other) noexcept;
+
+        bool allocate(uint64_t size);
+        // Writable mapping of a new file at path; visible there after seal()
+        bool create(const std::string& path, uint32_t kind, uint64_t epoch, uint64_t size);
+        bool seal();
+        // Read-only mapping of a finished file, rejected unless the header matches
+        bool open(const std::string& path, uint32_t kind, uint64_t epoch, uint64_t size);
+        void reset();
+
+        uint8_t* data() { return data_; }
+        const uint8_t* data() const { return data_; }
+        uint64_t size() const { return size_; }
+        bool mapped() const { return !path_.empty(); }
+
+    private:
+        uint8_t* data_ = nullptr;
+        uint64_t size_ = 0;
+        int fd_ = -1;                        // only while a created file is unsealed
+        uint32_t kind_ = 0;
+        uint64_t epoch_ = 0;
+        std::string path_;
+        std::string tempPath_;
+    };
+
+    struct EpochContext {
+        uint64_t epoch = 0;
+        EpochBuffer cache;
+        uint64_t datasetItems = 0;           // 64-byte items in the full dataset
+    };
+
     Kawpow();
     ~Kawpow();
 
@@ -59,7 +123,20 @@ public:
     Kawpow(Kawpow&&) noexcept = default;
     Kawpow& operator=(Kawpow&&) noexcept = default;
 
-    // Main KAWPOW functions
+    // Main KAWPOW functions; block_number selects the epoch
+    bool computeHash(const std::vector<uint8_t>& header,
+                    uint64_t block_number,
+                    uint64_t nonce,
+                    std::vector<uint8_t>& hash,
+                    std::vector<uint8_t>& mix_hash);
+
+    bool verifyHash(const std::vector<uint8_t>& header,
+                   uint64_t block_number,
+                   uint64_t nonce,
+                   const std::vector<uint8_t>& mix_hash,
+                   const std::vector<uint8_t>& target);
+
+    // Epoch 0 (block 0) variants
     bool computeHash(const std::vector<uint8_t>& header,
                     uint64_t nonce,
                     std::vector<uint8_t>& hash,
@@ -76,21 +153,33 @@ public:
     void clearCache();
     void clearDataset();
 
-private:
-    // Internal helper functions
+    // Process-wide epoch caches
+    static std::shared_ptr<const EpochContext> getEpochContext(uint64_t epoch);
+    static void setEpochCacheCapacity(size_t epochs);
+    // Starts building an epoch's cache on a background thread
+    static void prefetchEpoch(uint64_t epoch);
+    // Where epoch files are kept; empty (the default) keeps everything in memory
+    static void setEpochDirectory(const std::string& directory);
+
     uint64_t getEpoch(uint64_t block_number) const;
     uint64_t getCacheSize(uint64_t block_number) const;
     uint64_t getDatasetSize(uint64_t block_number) const;
-    bool generateCache(uint64_t block_number);
+
+private:
+    // Internal helper functions
+    static std::shared_ptr<const EpochContext> generateCache(uint64_t epoch);
+    static void fillCache(uint64_t epoch, uint8_t* cache, uint64_t size);
     bool generateDataset(uint64_t block_number);
+    static void datasetItem(const EpochContext& context, uint64_t index, uint8_t* item);
     void hashHeader(const std::vector<uint8_t>& header, std::vector<uint8_t>& hash);
     void hashNonce(uint64_t nonce, std::vector<uint8_t>& hash);
     void mixHash(const std::vector<uint8_t>& seed, std::vector<uint8_t>& mix_hash);
 
     // Internal state
-    std::vector<uint8_t> cache_;
-    std::vector<uint8_t> dataset_;
+    std::shared_ptr<const EpochContext> context_;
+    EpochBuffer dataset_;
     uint64_t current_epoch_;
+    uint64_t dataset_epoch_;
     bool cache_initialized_;
     bool dataset_initialized_;
 };
@@ -71,7 +71,7 @@ bool Block::validateKawpowProof() const {
     std::fill(target.begin(), target.end(), 0xFF);
     target[0] = 0xFF >> (difficulty_ % 8);
     
-    return kawpow.verifyHash(header_bytes, nonce_, mix_hash_bytes, target);
+    return kawpow.verifyHash(header_bytes, height_, nonce_, mix_hash_bytes, target);
 }
 
 std::string Block::calculateKawpowHeaderHash() const {
@@ -93,7 +93,7 @@ std::string Block::calculateKawpowHeaderHash() const {
         }
     }
     
-    if (!kawpow.computeHash(header_bytes, nonce_, hash, mix_hash)) {
+    if (!kawpow.computeHash(header_bytes, height_, nonce_, hash, mix_hash)) {
         return "";
     }
     
@@ -124,7 +124,7 @@ std::string Block::calculateKawpowMixHash() const {
         }
     }
     
-    if (!kawpow.computeHash(header_bytes, nonce_, hash, mix_hash)) {
+    if (!kawpow.computeHash(header_bytes, height_, nonce_, hash, mix_hash)) {
         return "";
     }
     
@@ -155,7 +155,7 @@ bool Block::verifyKawpowDifficulty() const {
         }
     }
     
-    if (!kawpow.computeHash(header_bytes, nonce_, hash, mix_hash)) {
+    if (!kawpow.computeHash(header_bytes, height_, nonce_, hash, mix_hash)) {
         return false;
     }
     
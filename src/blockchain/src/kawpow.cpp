@@ -30,14 +30,281 @@
 #include <openssl/evp.h>
 #include <openssl/rand.h>
 #include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <future>
+#include <list>
+#include <map>
+#include <mutex>
 #include <stdexcept>
+#include <thread>
+#include <utility>
 #include <cstring>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
 
 namespace satox {
 namespace blockchain {
 
+namespace {
+
+constexpr size_t EPOCH_FILE_HEADER = 4096;   // keeps the mapped bytes page aligned
+constexpr char EPOCH_FILE_MAGIC[8] = {'S', 'A', 'T', 'O', 'X', 'K', 'P', '1'};
+constexpr uint32_t EPOCH_FILE_CACHE = 0;
+constexpr uint32_t EPOCH_FILE_DATASET = 1;
+
+struct EpochFileHeader {
+    char magic[8];
+    uint32_t kind;
+    uint32_t reserved;
+    uint64_t epoch;
+    uint64_t size;
+};
+
+// Process-wide epoch caches. `lru` holds strong references to the most
+// recently used epochs; `pending` lets concurrent callers wait on a single
+// generation instead of each building the same cache.
+struct EpochCacheRegistry {
+    std::mutex mutex;
+    size_t capacity = KAWPOW_EPOCH_CACHE_CAPACITY;
+    std::string directory;
+    std::list<std::shared_ptr<const Kawpow::EpochContext>> lru;   // front = most recent
+    std::map<uint64_t, std::weak_ptr<const Kawpow::EpochContext>> live;
+    std::map<uint64_t, std::shared_future<std::shared_ptr<const Kawpow::EpochContext>>> pending;
+    std::atomic<uint64_t> prefetched{0};                          // highest epoch prefetched + 1
+    std::vector<std::pair<std::shared_future<std::shared_ptr<const Kawpow::EpochContext>>, std::thread>> background;
+
+    ~EpochCacheRegistry() {
+        for (auto& generation : background) {
+            if (generation.second.joinable()) {
+                generation.second.join();
+            }
+        }
+    }
+
+    // Caller holds the mutex. A generation publishes its result under the
+    // mutex as its last step, so a ready one is about to exit and joins at once.
+    void pruneBackground() {
+        auto finished = std::remove_if(background.begin(), background.end(), [](auto& generation) {
+            if (generation.first.wait_for(std::chrono::seconds(0)) != std::future_status::ready) {
+                return false;
+            }
+            generation.second.join();
+            return true;
+        });
+        background.erase(finished, background.end());
+    }
+
+    void touch(const std::shared_ptr<const Kawpow::EpochContext>& context) {
+        lru.remove(context);
+        lru.push_front(context);
+        while (lru.size() > capacity) {
+            lru.pop_back();
+        }
+    }
+
+    // Caller holds the mutex
+    void finish(uint64_t epoch, const std::shared_ptr<const Kawpow::EpochContext>& context) {
+        pending.erase(epoch);
+        if (context) {
+            live[epoch] = context;
+            touch(context);
+        }
+    }
+};
+
+EpochCacheRegistry& epochCaches() {
+    static EpochCacheRegistry registry;
+    return registry;
+}
+
+std::string epochDirectory() {
+    auto& registry = epochCaches();
+    std::lock_guard<std::mutex> lock(registry.mutex);
+    return registry.directory;
+}
+
+std::string epochFilePath(const std::string& directory, const char* kind, uint64_t epoch) {
+    return directory + "/kawpow-" + kind + "-" + std::to_string(epoch) + ".bin";
+}
+
+void adviseHugePages(void* address, size_t length) {
+#ifdef MADV_HUGEPAGE
+    madvise(address, length, MADV_HUGEPAGE);
+#else
+    (void)address;
+    (void)length;
+#endif
+}
+
+// Consensus: the cache grows by half each epoch, rounded up to the growth
+// step. The mask is a 32-bit constant, kept as it always was.
+uint64_t epochCacheSize(uint64_t epoch) {
+    uint64_t size = KAWPOW_CACHE_BYTES_INIT;
+    for (uint64_t i = 0; i < epoch; ++i) {
+        size = size * 3 / 2;
+        size = (size + KAWPOW_CACHE_BYTES_GROWTH - 1) & ~(KAWPOW_CACHE_BYTES_GROWTH - 1);
+    }
+    return size;
+}
+
+size_t generatorThreads() {
+    static const size_t threads = std::max(1u, std::thread::hardware_concurrency());
+    return threads;
+}
+
+} // namespace
+
+Kawpow::EpochBuffer::~EpochBuffer() {
+    reset();
+}
+
+Kawpow::EpochBuffer::EpochBuffer(EpochBuffer&& other) noexcept {
+    *this = std::move(other);
+}
+
+Kawpow::EpochBuffer& Kawpow::EpochBuffer::operator=(EpochBuffer&& other) noexcept {
+    if (this != &other) {
+        reset();
+        data_ = other.data_;
+        size_ = other.size_;
+        fd_ = other.fd_;
+        kind_ = other.kind_;
+        epoch_ = other.epoch_;
+        path_ = std::move(other.path_);
+        tempPath_ = std::move(other.tempPath_);
+        other.data_ = nullptr;
+        other.size_ = 0;
+        other.fd_ = -1;
+        other.path_.clear();
+        other.tempPath_.clear();
+    }
+    return *this;
+}
+
+bool Kawpow::EpochBuffer::allocate(uint64_t size) {
+    reset();
+    void* address = mmap(nullptr, size, PROT_READ | PROT_WRITE,
+                         MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (address == MAP_FAILED) {
+        return false;
+    }
+    adviseHugePages(address, size);
+    data_ = static_cast<uint8_t*>(address);
+    size_ = size;
+    return true;
+}
+
+bool Kawpow::EpochBuffer::create(const std::string& path, uint32_t kind, uint64_t epoch, uint64_t size) {
+    reset();
+    // Each writer gets its own temp file, whether another process or another
+    // thread of this one is building the same epoch
+    std::string temp = path + ".tmp.XXXXXX";
+    int fd = mkostemp(&temp[0], O_CLOEXEC);
+    if (fd < 0) {
+        return false;
+    }
+    if (fchmod(fd, 0644) != 0 || ftruncate(fd, EPOCH_FILE_HEADER + size) != 0) {
+        ::close(fd);
+        unlink(temp.c_str());
+        return false;
+    }
+    void* address = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, EPOCH_FILE_HEADER);
+    if (address == MAP_FAILED) {
+        ::close(fd);
+        unlink(temp.c_str());
+        return false;
+    }
+    adviseHugePages(address, size);
+    data_ = static_cast<uint8_t*>(address);
+    size_ = size;
+    fd_ = fd;
+    kind_ = kind;
+    epoch_ = epoch;
+    path_ = path;
+    tempPath_ = std::move(temp);
+    return true;
+}
+
+bool Kawpow::EpochBuffer::seal() {
+    if (fd_ < 0) {
+        return data_ != nullptr;
+    }
+
+    // The header goes in last, so only a fully written file ever carries one
+    EpochFileHeader header{};
+    std::memcpy(header.magic, EPOCH_FILE_MAGIC, sizeof(header.magic));
+    header.kind = kind_;
+    header.epoch = epoch_;
+    header.size = size_;
+    bool ok = msync(data_, size_, MS_SYNC) == 0 &&
+              pwrite(fd_, &header, sizeof(header), 0) == static_cast<ssize_t>(sizeof(header)) &&
+              fdatasync(fd_) == 0 &&
+              rename(tempPath_.c_str(), path_.c_str()) == 0;
+    ::close(fd_);
+    fd_ = -1;
+    if (!ok) {
+        unlink(tempPath_.c_str());
+        reset();
+        return false;
+    }
+    tempPath_.clear();
+    mprotect(data_, size_, PROT_READ);
+    return true;
+}
+
+bool Kawpow::EpochBuffer::open(const std::string& path, uint32_t kind, uint64_t epoch, uint64_t size) {
+    reset();
+    int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        return false;
+    }
+
+    EpochFileHeader header{};
+    struct stat status{};
+    bool valid = fstat(fd, &status) == 0 &&
+                 static_cast<uint64_t>(status.st_size) == EPOCH_FILE_HEADER + size &&
+                 pread(fd, &header, sizeof(header), 0) == static_cast<ssize_t>(sizeof(header)) &&
+                 std::memcmp(header.magic, EPOCH_FILE_MAGIC, sizeof(header.magic)) == 0 &&
+                 header.kind == kind && header.epoch == epoch && header.size == size;
+    void* address = valid ? mmap(nullptr, size, PROT_READ, MAP_SHARED, fd, EPOCH_FILE_HEADER) : MAP_FAILED;
+    ::close(fd);
+    if (address == MAP_FAILED) {
+        return false;
+    }
+
+    adviseHugePages(address, size);
+    // Cache reads are scattered but the whole cache is hot; dataset reads are
+    // scattered and mostly cold
+    madvise(address, size, kind == EPOCH_FILE_CACHE ? MADV_WILLNEED : MADV_RANDOM);
+    data_ = static_cast<uint8_t*>(const_cast<void*>(address));
+    size_ = size;
+    kind_ = kind;
+    epoch_ = epoch;
+    path_ = path;
+    return true;
+}
+
+void Kawpow::EpochBuffer::reset() {
+    if (data_) {
+        munmap(data_, size_);
+    }
+    if (fd_ >= 0) {
+        ::close(fd_);
+        unlink(tempPath_.c_str());
+    }
+    data_ = nullptr;
+    size_ = 0;
+    fd_ = -1;
+    path_.clear();
+    tempPath_.clear();
+}
+
 Kawpow::Kawpow()
     : current_epoch_(0)
+    , dataset_epoch_(0)
     , cache_initialized_(false)
     , dataset_initialized_(false) {
 }
@@ -51,13 +318,28 @@ bool Kawpow::computeHash(const std::vector<uint8_t>& header,
                         uint64_t nonce,
                         std::vector<uint8_t>& hash,
                         std::vector<uint8_t>& mix_hash) {
+    return computeHash(header, 0, nonce, hash, mix_hash);
+}
+
+bool Kawpow::verifyHash(const std::vector<uint8_t>& header,
+                       uint64_t nonce,
+                       const std::vector<uint8_t>& mix_hash,
+                       const std::vector<uint8_t>& target) {
+    return verifyHash(header, 0, nonce, mix_hash, target);
+}
+
+bool Kawpow::computeHash(const std::vector<uint8_t>& header,
+                        uint64_t block_number,
+                        uint64_t nonce,
+                        std::vector<uint8_t>& hash,
+                        std::vector<uint8_t>& mix_hash) {
     if (header.size() != KAWPOW_HEADER_BYTES) {
         return false;
     }
 
-    // Initialize cache and dataset if needed
-    uint64_t block_number = 0; // TODO: Get from header
-    if (!initializeCache(block_number) || !initializeDataset(block_number)) {
+    // The cache is enough; mixHash derives dataset items from it unless the
+    // full dataset was built for this epoch
+    if (!initializeCache(block_number)) {
         return false;
     }
 
@@ -76,7 +358,7 @@ bool Kawpow::computeHash(const std::vector<uint8_t>& header,
     }
 
     // Generate mix hash
-    mix_hash.resize(KAWPOW_MIX_BYTES);
+    mix_hash.assign(KAWPOW_MIX_BYTES, 0);
     mixHash(seed, mix_hash);
 
     // Calculate final hash
@@ -90,6 +372,7 @@ bool Kawpow::computeHash(const std::vector<uint8_t>& header,
 }
 
 bool Kawpow::verifyHash(const std::vector<uint8_t>& header,
+                       uint64_t block_number,
                        uint64_t nonce,
                        const std::vector<uint8_t>& mix_hash,
                        const std::vector<uint8_t>& target) {
@@ -99,7 +382,7 @@ bool Kawpow::verifyHash(const std::vector<uint8_t>& header,
 
     std::vector<uint8_t> hash;
     std::vector<uint8_t> computed_mix_hash;
-    if (!computeHash(header, nonce, hash, computed_mix_hash)) {
+    if (!computeHash(header, block_number, nonce, hash, computed_mix_hash)) {
         return false;
     }
 
@@ -115,17 +398,23 @@ bool Kawpow::verifyHash(const std::vector<uint8_t>& header,
 
 bool Kawpow::initializeCache(uint64_t block_number) {
     uint64_t epoch = getEpoch(block_number);
+
+    // Close to the boundary, have the next epoch ready before it is needed
+    if (block_number % KAWPOW_EPOCH_LENGTH >= KAWPOW_EPOCH_LENGTH - KAWPOW_PREGENERATE_BLOCKS &&
+        epochCaches().prefetched.load(std::memory_order_relaxed) < epoch + 2) {
+        prefetchEpoch(epoch + 1);
+    }
+
     if (epoch == current_epoch_ && cache_initialized_) {
         return true;
     }
 
-    uint64_t cache_size = getCacheSize(block_number);
-    cache_.resize(cache_size);
-    
-    if (!generateCache(block_number)) {
+    auto context = getEpochContext(epoch);
+    if (!context) {
         return false;
     }
 
+    context_ = std::move(context);
     current_epoch_ = epoch;
     cache_initialized_ = true;
     return true;
@@ -133,112 +422,258 @@ bool Kawpow::initializeCache(uint64_t block_number) {
 
 bool Kawpow::initializeDataset(uint64_t block_number) {
     uint64_t epoch = getEpoch(block_number);
-    if (epoch == current_epoch_ && dataset_initialized_) {
+    if (epoch == dataset_epoch_ && dataset_initialized_) {
         return true;
     }
+    if (!initializeCache(block_number)) {
+        return false;
+    }
+    dataset_initialized_ = false;
 
     uint64_t dataset_size = getDatasetSize(block_number);
-    dataset_.resize(dataset_size);
-    
-    if (!generateDataset(block_number)) {
+    std::string directory = epochDirectory();
+    if (!directory.empty()) {
+        std::string path = epochFilePath(directory, "dataset", epoch);
+        if (dataset_.open(path, EPOCH_FILE_DATASET, epoch, dataset_size)) {
+            dataset_epoch_ = epoch;
+            dataset_initialized_ = true;
+            return true;
+        }
+        if (dataset_.create(path, EPOCH_FILE_DATASET, epoch, dataset_size) &&
+            generateDataset(block_number) && dataset_.seal()) {
+            dataset_epoch_ = epoch;
+            dataset_initialized_ = true;
+            return true;
+        }
+        // Unwritable directory: fall back to memory
+    }
+
+    if (!dataset_.allocate(dataset_size) || !generateDataset(block_number)) {
+        dataset_.reset();
         return false;
     }
 
+    dataset_epoch_ = epoch;
     dataset_initialized_ = true;
     return true;
 }
 
 void Kawpow::clearCache() {
-    cache_.clear();
+    context_.reset();
     cache_initialized_ = false;
 }
 
 void Kawpow::clearDataset() {
-    dataset_.clear();
+    dataset_.reset();
     dataset_initialized_ = false;
 }
 
+std::shared_ptr<const Kawpow::EpochContext> Kawpow::getEpochContext(uint64_t epoch) {
+    auto& registry = epochCaches();
+    std::shared_future<std::shared_ptr<const EpochContext>> future;
+    std::promise<std::shared_ptr<const EpochContext>> promise;
+    {
+        std::lock_guard<std::mutex> lock(registry.mutex);
+        auto live = registry.live.find(epoch);
+        if (live != registry.live.end()) {
+            if (auto context = live->second.lock()) {
+                registry.touch(context);
+                return context;
+            }
+            registry.live.erase(live);
+        }
+
+        auto pending = registry.pending.find(epoch);
+        if (pending != registry.pending.end()) {
+            future = pending->second;
+        } else {
+            registry.pending.emplace(epoch, promise.get_future().share());
+        }
+    }
+    if (future.valid()) {
+        return future.get();
+    }
+
+    // This caller generates; everyone else waiting on the epoch shares the result
+    std::shared_ptr<const EpochContext> context;
+    try {
+        context = generateCache(epoch);
+    } catch (const std::exception&) {
+        context.reset();
+    }
+
+    std::lock_guard<std::mutex> lock(registry.mutex);
+    registry.finish(epoch, context);
+    promise.set_value(context);
+    return context;
+}
+
+void Kawpow::prefetchEpoch(uint64_t epoch) {
+    auto& registry = epochCaches();
+    std::lock_guard<std::mutex> lock(registry.mutex);
+    uint64_t prefetched = registry.prefetched.load(std::memory_order_relaxed);
+    registry.prefetched.store(std::max(prefetched, epoch + 1), std::memory_order_relaxed);
+
+    auto live = registry.live.find(epoch);
+    if ((live != registry.live.end() && !live->second.expired()) ||
+        registry.pending.count(epoch) != 0) {
+        return;
+    }
+
+    registry.pruneBackground();
+    auto promise = std::make_shared<std::promise<std::shared_ptr<const EpochContext>>>();
+    auto result = promise->get_future().share();
+    registry.pending.emplace(epoch, result);
+    registry.background.emplace_back(result, [&registry, epoch, promise]() {
+        std::shared_ptr<const EpochContext> context;
+        try {
+            context = generateCache(epoch);
+        } catch (const std::exception&) {
+            context.reset();
+        }
+        std::lock_guard<std::mutex> lock(registry.mutex);
+        registry.finish(epoch, context);
+        promise->set_value(context);
+    });
+}
+
+void Kawpow::setEpochCacheCapacity(size_t epochs) {
+    auto& registry = epochCaches();
+    std::lock_guard<std::mutex> lock(registry.mutex);
+    registry.capacity = epochs;
+    while (registry.lru.size() > registry.capacity) {
+        registry.lru.pop_back();
+    }
+}
+
+void Kawpow::setEpochDirectory(const std::string& directory) {
+    auto& registry = epochCaches();
+    std::lock_guard<std::mutex> lock(registry.mutex);
+    registry.directory = directory;
+}
+
 uint64_t Kawpow::getEpoch(uint64_t block_number) const {
     return block_number / KAWPOW_EPOCH_LENGTH;
 }
 
 uint64_t Kawpow::getCacheSize(uint64_t block_number) const {
-    uint64_t epoch = getEpoch(block_number);
-    uint64_t size = KAWPOW_CACHE_BYTES_INIT;
-    for (uint64_t i = 0; i < epoch; ++i) {
-        size = size * 3 / 2;
-        size = (size + KAWPOW_CACHE_BYTES_GROWTH - 1) & ~(KAWPOW_CACHE_BYTES_GROWTH - 1);
-    }
-    return size;
+    return epochCacheSize(getEpoch(block_number));
 }
 
 uint64_t Kawpow::getDatasetSize(uint64_t block_number) const {
     return getCacheSize(block_number) * KAWPOW_DATASET_PARENTS;
 }
 
-bool Kawpow::generateCache(uint64_t block_number) {
-    if (cache_.empty()) {
-        return false;
+std::shared_ptr<const Kawpow::EpochContext> Kawpow::generateCache(uint64_t epoch) {
+    auto context = std::make_shared<EpochContext>();
+    context->epoch = epoch;
+    uint64_t cache_size = epochCacheSize(epoch);
+    context->datasetItems = cache_size * KAWPOW_DATASET_PARENTS / 64;
+
+    std::string directory = epochDirectory();
+    if (!directory.empty()) {
+        std::string path = epochFilePath(directory, "cache", epoch);
+        if (context->cache.open(path, EPOCH_FILE_CACHE, epoch, cache_size)) {
+            return context;
+        }
+        if (context->cache.create(path, EPOCH_FILE_CACHE, epoch, cache_size)) {
+            fillCache(epoch, context->cache.data(), cache_size);
+            if (context->cache.seal()) {
+                return context;
+            }
+        }
+        // Unwritable directory: fall back to memory
+    }
+
+    if (!context->cache.allocate(cache_size)) {
+        return nullptr;
     }
+    fillCache(epoch, context->cache.data(), cache_size);
+    mprotect(context->cache.data(), cache_size, PROT_READ);
+    return context;
+}
 
+void Kawpow::fillCache(uint64_t epoch, uint8_t* cache, uint64_t size) {
     // Initialize Keccak sponge
     KeccakSponge sponge;
     KeccakSponge_Initialize(&sponge, KECCAK_SPONGE_BITRATE, KECCAK_SPONGE_CAPACITY);
 
-    // Generate seed
+    // Seed from the epoch's first block number, so every block of the epoch
+    // shares the cache
+    const uint64_t block_number = epoch * KAWPOW_EPOCH_LENGTH;
     std::vector<uint8_t> seed(32);
-    for (size_t i = 0; i < 32; ++i) {
+    for (size_t i = 0; i < sizeof(block_number); ++i) {
         seed[i] = static_cast<uint8_t>(block_number >> (i * 8));
     }
 
     // Generate cache using Keccak-512
-    for (size_t i = 0; i < cache_.size(); i += 64) {
+    for (uint64_t i = 0; i < size; i += 64) {
         KeccakSponge_Absorb(&sponge, seed.data(), seed.size());
-        KeccakSponge_Squeeze(&sponge, cache_.data() + i, std::min(64UL, cache_.size() - i));
+        KeccakSponge_Squeeze(&sponge, cache + i, std::min<uint64_t>(64, size - i));
     }
 
-    // Mix the cache
-    for (size_t i = 0; i < KAWPOW_CACHE_ROUNDS; ++i) {
-        for (size_t j = 0; j < cache_.size(); j += 64) {
+    // Mix the cache. One round XORs every word of a 64-byte block with the
+    // XOR of the block's eight words, which leaves that XOR unchanged, so a
+    // second round restores the block: only the parity of the round count matters.
+    if (KAWPOW_CACHE_ROUNDS % 2 != 0) {
+        for (uint64_t j = 0; j < size; j += 64) {
+            uint64_t words[8];
+            std::memcpy(words, cache + j, 64);
             uint64_t v = 0;
-            for (size_t k = 0; k < 8; ++k) {
-                v ^= *reinterpret_cast<uint64_t*>(cache_.data() + ((j + k * 8) % cache_.size()));
+            for (uint64_t word : words) {
+                v ^= word;
             }
-            for (size_t k = 0; k < 8; ++k) {
-                *reinterpret_cast<uint64_t*>(cache_.data() + ((j + k * 8) % cache_.size())) ^= v;
+            for (uint64_t& word : words) {
+                word ^= v;
             }
+            std::memcpy(cache + j, words, 64);
         }
     }
+}
 
-    return true;
+void Kawpow::datasetItem(const EpochContext& context, uint64_t index, uint8_t* item) {
+    const uint64_t cache_items = context.cache.size() / 64;
+    const uint8_t* cache = context.cache.data();
+
+    uint64_t mix[8];
+    std::memcpy(mix, cache + (index % cache_items) * 64, 64);
+    for (size_t j = 0; j < KAWPOW_DATASET_PARENTS; ++j) {
+        uint64_t parent[8];
+        std::memcpy(parent, cache + ((index * KAWPOW_DATASET_PARENTS + j) % cache_items) * 64, 64);
+        for (size_t k = 0; k < 8; ++k) {
+            mix[k] ^= parent[k];
+        }
+    }
+    std::memcpy(item, mix, 64);
 }
 
 bool Kawpow::generateDataset(uint64_t block_number) {
-    if (dataset_.empty() || cache_.empty()) {
+    if (!dataset_.data() || !context_) {
         return false;
     }
 
-    // Generate dataset using cache
-    for (size_t i = 0; i < dataset_.size(); i += 64) {
-        uint64_t index = i / 64;
-        std::vector<uint8_t> mix(64);
-        
-        // Initialize mix with cache data
-        size_t cache_index = (index % (cache_.size() / 64)) * 64;
-        std::memcpy(mix.data(), cache_.data() + cache_index, 64);
-
-        // Mix with parent nodes
-        for (size_t j = 0; j < KAWPOW_DATASET_PARENTS; ++j) {
-            uint64_t parent_index = (index * KAWPOW_DATASET_PARENTS + j) % (cache_.size() / 64);
-            size_t parent_offset = parent_index * 64;
-            
-            for (size_t k = 0; k < 64; ++k) {
-                mix[k] ^= cache_[parent_offset + k];
-            }
+    // Items are independent, so each thread fills a contiguous range
+    const EpochContext& context = *context_;
+    uint8_t* dataset = dataset_.data();
+    const uint64_t items = dataset_.size() / 64;
+    const size_t thread_count = std::min<uint64_t>(generatorThreads(), items);
+    const uint64_t per_thread = (items + thread_count - 1) / thread_count;
+
+    auto fill = [&context, dataset, items, per_thread](size_t t) {
+        uint64_t end = std::min(items, (t + 1) * per_thread);
+        for (uint64_t i = t * per_thread; i < end; ++i) {
+            datasetItem(context, i, dataset + i * 64);
         }
+    };
 
-        // Store mixed data
-        std::memcpy(dataset_.data() + i, mix.data(), 64);
+    std::vector<std::thread> threads;
+    threads.reserve(thread_count - 1);
+    for (size_t t = 1; t < thread_count; ++t) {
+        threads.emplace_back(fill, t);
+    }
+    fill(0);
+    for (auto& thread : threads) {
+        thread.join();
     }
 
     return true;
@@ -259,25 +694,33 @@ void Kawpow::hashNonce(uint64_t nonce, std::vector<uint8_t>& hash) {
 }
 
 void Kawpow::mixHash(const std::vector<uint8_t>& seed, std::vector<uint8_t>& mix_hash) {
-    if (dataset_.empty()) {
+    if (!context_) {
         std::fill(mix_hash.begin(), mix_hash.end(), 0);
         return;
     }
+    const bool full = dataset_initialized_ && dataset_epoch_ == current_epoch_;
 
     // Initialize mix with seed
     std::vector<uint8_t> mix(64);
     std::memcpy(mix.data(), seed.data(), std::min(seed.size(), size_t(64)));
 
-    // Mix with dataset
+    // Mix with dataset items, read from the dataset or derived from the cache
+    uint8_t item[64];
     for (size_t i = 0; i < KAWPOW_ACCESSES; ++i) {
         uint64_t index = 0;
         for (size_t j = 0; j < 8; ++j) {
             index = (index << 8) | mix[j];
         }
-        index %= dataset_.size() / 64;
-        
+        index %= context_->datasetItems;
+
+        const uint8_t* source = item;
+        if (full) {
+            source = dataset_.data() + index * 64;
+        } else {
+            datasetItem(*context_, index, item);
+        }
         for (size_t j = 0; j < 64; ++j) {
-            mix[j] ^= dataset_[index * 64 + j];
+            mix[j] ^= source[j];
         }
     }
 
@@ -286,4 +729,4 @@ void Kawpow::mixHash(const std::vector<uint8_t>& seed, std::vector<uint8_t>& mix
 }
 
 } // namespace blockchain
-} // namespace satox 
\ No newline at end of file
+} // namespace satox
@@ -26,6 +26,7 @@
 #pragma once
 
 #include <string>
+#include <string_view>
 #include <unordered_map>
 #include <memory>
 #include <mutex>
@@ -33,6 +34,11 @@
 #include <functional>
 #include <list>
 #include <optional>
+#include <array>
+#include <atomic>
+#include <condition_variable>
+#include <thread>
+#include <vector>
 #include <nlohmann/json.hpp>
 
 namespace satox::core {
@@ -58,16 +64,17 @@ public:
         size_t missCount;
         double hitRate;
         size_t evictionCount;
+        size_t expiredCount;
     };
 
     // Cache configuration structure
     struct CacheConfig {
-        size_t maxSize;                    // Maximum cache size in bytes
+        size_t maxSize;                    // Maximum cache size in bytes, allocator overhead included
         size_t maxEntries;                 // Maximum number of entries
         std::chrono::seconds defaultTTL;   // Default time-to-live
         bool enableLRU;                    // Enable Least Recently Used eviction
         bool enableLFU;                    // Enable Least Frequently Used eviction
-        size_t cleanupInterval;            // Cleanup interval in seconds
+        size_t cleanupInterval;            // Background expiry interval in seconds (0 disables the thread)
     };
 
     // Cache callback type
@@ -125,27 +132,131 @@ public:
 
 private:
     CacheManager() = default;
-    ~CacheManager() = default;
+    ~CacheManager();
+
+    // Count-min sketch of recent access frequency: four rows of counters
+    // saturating at 15, all halved once per sample period so that old
+    // popularity fades. Used for TinyLFU admission when enableLFU is set.
+    class FrequencySketch {
+    public:
+        void resize(size_t expectedEntries);
+        void increment(size_t hash);
+        uint8_t estimate(size_t hash) const;
+        void clear();
+
+    private:
+        size_t index(size_t hash, size_t row) const;
+
+        std::vector<uint8_t> counters_;
+        size_t mask_ = 0;
+        size_t additions_ = 0;
+        size_t samplePeriod_ = 0;
+    };
+
+    struct Node;
+    using NodeList = std::list<Node>;
+    using TimerList = std::list<NodeList::iterator>;
+
+    struct Node {
+        CacheEntry entry;
+        size_t hash;
+        bool inWindow;
+        size_t timerSlot;           // wheel slot holding `timer`
+        TimerList::iterator timer;
+    };
+
+    // Hierarchical timing wheel over whole seconds: four levels of 64 slots,
+    // a level-k slot spanning 64^k seconds. Entries move down one level at a
+    // time as their expiry approaches, so each is touched a bounded number of
+    // times no matter how long its TTL is.
+    class ExpiryWheel {
+    public:
+        void reset(uint64_t now);
+        void schedule(NodeList::iterator node);
+        void cancel(NodeList::iterator node);
+        // Advances to `now` and returns the entries that expired; they stay
+        // listed until cancelled
+        TimerList& advance(uint64_t now);
+
+    private:
+        static constexpr size_t kLevels = 4;
+        static constexpr size_t kSlots = 64;
+        static constexpr size_t kDueSlot = kLevels * kSlots;
+
+        void place(NodeList::iterator node, uint64_t due);
+        void cascade(size_t level);
+
+        std::array<TimerList, kDueSlot + 1> slots_;
+        uint64_t current_ = 0;
+    };
+
+    // Index key carrying its precomputed hash; the view points into Node::entry.key
+    struct KeyRef {
+        std::string_view key;
+        size_t hash;
+        bool operator==(const KeyRef& other) const { return key == other.key; }
+    };
+    struct KeyRefHash {
+        size_t operator()(const KeyRef& ref) const { return ref.hash; }
+    };
+
+    // One lock stripe. Both lists keep the most recently used entry at the
+    // front; touching or evicting an entry is a splice or erase through the
+    // iterator stored in the index.
+    struct Shard {
+        std::mutex mutex;
+        std::unordered_map<KeyRef, NodeList::iterator, KeyRefHash> index;
+        NodeList window;  // admission window for new entries (LFU only)
+        NodeList main;
+        FrequencySketch sketch;
+        ExpiryWheel expiry;
+    };
+
+    // Small caches use fewer shards so that per-shard LRU order stays close to global order
+    static constexpr size_t kShardCount = 16;
+    static constexpr size_t kMinEntriesPerShard = 64;
 
     // Helper methods
-    bool evictEntry();
-    void updateAccessStats(const std::string& key);
+    Shard& shardFor(size_t hash);
+    bool evictEntry(Shard& shard);
+    void enforceLimits();
+    void touch(Shard& shard, NodeList::iterator node);
+    void eraseNode(Shard& shard, NodeList::iterator node);
+    void expireEntries();
+    void expiryLoop();
+    void stopExpiryThread();
     void notifyCallbacks(const std::string& key, const std::string& value);
     bool validateKey(const std::string& key);
     bool validateValue(const std::string& value);
     size_t calculateEntrySize(const CacheEntry& entry);
     void updateStats(bool hit);
+    void setLastError(const std::string& error);
 
     // Member variables
-    bool initialized_ = false;
-    std::mutex mutex_;
-    std::unordered_map<std::string, CacheEntry> cache_;
-    std::list<std::string> lruList_;  // For LRU eviction
-    std::vector<CacheCallback> callbacks_;
-    CacheConfig config_;
-    CacheStats stats_;
+    std::atomic<bool> initialized_{false};
+    mutable std::mutex mutex_;  // configuration, callback registration, last error
+    std::array<Shard, kShardCount> shards_;
+    size_t shardCount_ = 1;  // shards in use, fixed at initialize
+    std::atomic<size_t> evictionCursor_{0};
+    std::shared_ptr<const std::vector<CacheCallback>> callbacks_;
+    CacheConfig config_{};
+    std::atomic<size_t> maxSize_{0};
+    std::atomic<size_t> maxEntries_{0};
+    std::atomic<size_t> windowCapacity_{1};  // per shard
+    std::atomic<size_t> totalSize_{0};
+    std::atomic<size_t> entryCount_{0};
+    std::atomic<size_t> hitCount_{0};
+    std::atomic<size_t> missCount_{0};
+    std::atomic<size_t> evictionCount_{0};
+    std::atomic<size_t> expiredCount_{0};
     std::string lastError_;
     std::chrono::system_clock::time_point lastCleanup_;
+
+    // Background expiry, woken every cleanupInterval seconds
+    std::mutex expiryMutex_;
+    std::condition_variable expiryCv_;
+    bool stopExpiry_ = false;
+    std::thread expiryThread_;
 };
 
 } // namespace satox::core 
\ No newline at end of file
@@ -25,10 +25,13 @@
 
 #pragma once
 
+#include <cstdint>
 #include <string>
+#include <string_view>
 #include <memory>
 #include <mutex>
 #include <optional>
+#include <variant>
 #include <vector>
 #include <unordered_map>
 #include <functional>
@@ -45,7 +48,9 @@ enum class DatabaseType {
     REDIS,
     MONGODB,
     ROCKSDB,
-    MEMORY
+    MEMORY,
+    SUPABASE,  // Cloud database
+    FIREBASE   // Cloud database
 };
 
 class DatabaseManager {
@@ -76,6 +81,29 @@ public:
         std::string transaction_id;
     };
 
+    // Value bound to a `?` / `?NNN` / `:name` placeholder, in placeholder order.
+    // Strings bind as TEXT and byte vectors as BLOB.
+    using QueryParam = std::variant<std::nullptr_t, int64_t, double, std::string, std::vector<uint8_t>>;
+
+    // Typed view of the current result row. Views returned by getText/getBlob
+    // and the row itself are only valid inside the row callback.
+    class RowView {
+    public:
+        enum class ColumnType { INTEGER, FLOAT, TEXT, BLOB, NULL_VALUE };
+
+        virtual ~RowView() = default;
+        virtual int columnCount() const = 0;
+        virtual const std::string& columnName(int column) const = 0;
+        virtual ColumnType columnType(int column) const = 0;
+        virtual int64_t getInt64(int column) const = 0;
+        virtual double getDouble(int column) const = 0;
+        virtual std::string_view getText(int column) const = 0;
+        virtual std::string_view getBlob(int column) const = 0;  // binary-safe
+    };
+
+    // Return false to stop iterating early
+    using RowCallback = std::function<bool(const RowView& row)>;
+
     DatabaseManager();
     ~DatabaseManager();
 
@@ -90,8 +118,23 @@ public:
     // Query operations
     // QueryResult executeQuery(const std::string& query);
     // QueryResult executePreparedQuery(const std::string& query, const std::vector<std::string>& params);
+    // SQLite rows land in result["rows"]; BLOB columns are JSON strings holding the raw bytes
     bool executeQuery(const std::string& id, const std::string& query, nlohmann::json& result);
+    bool executeQuery(const std::string& id, const std::string& query, const std::vector<QueryParam>& params,
+                      nlohmann::json& result);
+    // Streams rows to `onRow` without building a result document (SQLite).
+    // Statements are prepared once per connection and kept in an LRU cache
+    // sized by the connection's "statement_cache_size" option (default 64).
+    bool streamQuery(const std::string& id, const std::string& query, const std::vector<QueryParam>& params,
+                     const RowCallback& onRow);
+    // Each entry may be a single statement or a multi-statement script
     bool executeTransaction(const std::string& id, const std::vector<std::string>& queries, nlohmann::json& result);
+    // Bulk write (SQLite): runs one prepared statement once per parameter tuple
+    // inside a single transaction, all or nothing; inside a transaction that is
+    // already open it uses a savepoint instead. result["rows_affected"] holds
+    // the total change count.
+    bool executeBatch(const std::string& id, const std::string& query,
+                      const std::vector<std::vector<QueryParam>>& rows, nlohmann::json& result);
     
     // Transaction operations
     Transaction beginTransaction();
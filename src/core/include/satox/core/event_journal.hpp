@@ -0,0 +1,184 @@
+/**
+ * @file event_journal.hpp
+ * @brief Append-only event journal behind EventManager::getEvents
+ * @copyright Copyright (c) 2025 Satoxcoin Core Developers
+ * @license MIT License
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+namespace satox::core {
+
+/**
+ * Append-only, segmented journal of published events.
+ *
+ * Files in Config::directory:
+ *   events-<first sequence>.log   records of  u32 length | u32 crc32 | body
+ *
+ * body = u64 sequence | i64 timestamp (microseconds since epoch) | u8 type |
+ *        u8 priority | u16 name, source, correlationId, traceId lengths |
+ *        u32 data length, followed by the four strings and the CBOR payload.
+ *
+ * Segments are read through read-only mappings. Each one keeps an in-memory
+ * index rebuilt from the record headers on open: (timestamp, offset) pairs
+ * sorted by time, plus one such list per type and per name. A range query
+ * binary searches those lists and never decodes a payload; visitors get
+ * views into the mapping and decide what to parse.
+ *
+ * Appends are buffered and written once flushBytes accumulate, flushInterval
+ * passes, or a query needs them. Bytes a failed write did get out leave the
+ * buffer, and queries read the rest from it until a later write succeeds.
+ * Open stops at the first torn or corrupt record of the last segment and
+ * truncates it there.
+ *
+ * Retention drops whole sealed segments whose newest event is older than
+ * maxAge, then the oldest ones while the journal exceeds maxBytes. compact()
+ * rewrites sealed segments without their expired records, merging small
+ * neighbours up to segmentSize; the rewrite is renamed over the first segment
+ * of its group before the others are unlinked. Open removes any of those a
+ * crash left behind, recognised by a first sequence an earlier segment covers.
+ */
+class EventJournal {
+public:
+    struct Config {
+        std::string directory;
+        size_t segmentSize = 64 * 1024 * 1024;
+        std::chrono::seconds maxAge{0};      // 0 keeps events forever
+        size_t maxBytes = 0;                 // 0 is unbounded
+        size_t flushBytes = 64 * 1024;
+        std::chrono::milliseconds flushInterval{1000};
+        bool syncOnFlush = false;            // fdatasync after each write
+    };
+
+    // One stored event; the views point into the segment mapping and are
+    // only valid inside the visitor call
+    struct RecordView {
+        uint64_t sequence = 0;
+        std::chrono::system_clock::time_point timestamp;
+        uint8_t type = 0;
+        uint8_t priority = 0;
+        std::string_view name;
+        std::string_view source;
+        std::string_view correlationId;
+        std::string_view traceId;
+        const uint8_t* data = nullptr;       // CBOR
+        size_t dataSize = 0;
+    };
+
+    // Return false to stop the replay
+    using RecordVisitor = std::function<bool(const RecordView&)>;
+
+    EventJournal() = default;
+    ~EventJournal();
+    EventJournal(const EventJournal&) = delete;
+    EventJournal& operator=(const EventJournal&) = delete;
+
+    bool open(const Config& config, std::string& error);
+    void close();
+    bool isOpen() const;
+
+    // Stores the record and returns its sequence number, or 0 on failure.
+    // record.sequence is ignored.
+    uint64_t append(const RecordView& record);
+    bool flush();
+
+    // Records with start <= timestamp <= end, in time order within each
+    // segment and segments in append order
+    void replay(std::chrono::system_clock::time_point start,
+                std::chrono::system_clock::time_point end,
+                const RecordVisitor& visitor);
+    void replayType(uint8_t type,
+                    std::chrono::system_clock::time_point start,
+                    std::chrono::system_clock::time_point end,
+                    const RecordVisitor& visitor);
+    void replayName(const std::string& name,
+                    std::chrono::system_clock::time_point start,
+                    std::chrono::system_clock::time_point end,
+                    const RecordVisitor& visitor);
+
+    void applyRetention();
+    bool compact(std::string& error);
+
+    size_t getRecordCount() const;
+    size_t getSizeBytes() const;
+    std::string getLastError() const;
+
+private:
+    struct IndexEntry {
+        int64_t timestamp;
+        uint64_t offset;
+        bool operator<(const IndexEntry& other) const { return timestamp < other.timestamp; }
+    };
+
+    struct Segment {
+        uint64_t firstSequence = 0;
+        std::string path;
+        size_t bytes = 0;                    // including records still buffered
+        size_t fileBytes = 0;                // written to the file
+        size_t records = 0;
+        uint64_t lastSequence = 0;
+        int64_t minTimestamp = INT64_MAX;
+        int64_t maxTimestamp = INT64_MIN;
+        std::vector<IndexEntry> timeIndex;
+        std::unordered_map<uint8_t, std::vector<IndexEntry>> typeIndex;
+        std::unordered_map<std::string, std::vector<IndexEntry>> nameIndex;
+        bool sorted = true;                  // false once a timestamp went backwards
+        const uint8_t* mapping = nullptr;
+        size_t mappingSize = 0;
+    };
+
+    using IndexSelector = std::function<const std::vector<IndexEntry>*(const Segment&)>;
+
+    std::string segmentPath(uint64_t firstSequence) const;
+    bool loadSegment(Segment& segment, bool truncateTail, std::string& error);
+    void indexRecord(Segment& segment, const RecordView& record, uint64_t offset);
+    bool openActive(uint64_t firstSequence, std::string& error);
+    bool writePending();
+    bool mapSegment(Segment& segment);
+    static void unmapSegment(Segment& segment);
+    static void sortIndexes(Segment& segment);
+    void applyRetentionLocked();
+    void removeSegment(size_t index);
+    void replayIndexed(const IndexSelector& select, int64_t start, int64_t end,
+                       const RecordVisitor& visitor);
+
+    Config config_;
+    mutable std::mutex mutex_;
+    bool open_ = false;
+    std::vector<Segment> segments_;          // oldest first; the last one is active
+    int fd_ = -1;
+    std::vector<uint8_t> pending_;
+    std::chrono::steady_clock::time_point lastFlush_;
+    uint64_t nextSequence_ = 1;
+    std::string lastError_;
+};
+
+} // namespace satox::core
@@ -32,14 +32,32 @@
 #include <functional>
 #include <unordered_map>
 #include <vector>
-#include <queue>
+#include <array>
 #include <thread>
 #include <atomic>
 #include <condition_variable>
 #include <nlohmann/json.hpp>
+#include "satox/core/event_journal.hpp"
 
 namespace satox::core {
 
+/**
+ * Publish/subscribe hub for SDK events.
+ *
+ * Published events are moved into one bounded MPMC ring per priority and
+ * taken by the worker threads, CRITICAL first. One pop in every
+ * STARVATION_INTERVAL is offered to the levels below CRITICAL instead
+ * (LOW, NORMAL and HIGH take turns going first), so a steady stream of urgent
+ * events cannot starve the rest.
+ *
+ * Subscriptions and filters live in an immutable table that writers copy,
+ * modify and swap; workers dispatch from a snapshot without holding any lock.
+ *
+ * With a journal enabled, every accepted event is also queued for a journal
+ * writer thread that appends it to an EventJournal, so publishers never wait
+ * on the journal's lock or its I/O. The journal serves getEvents, which first
+ * writes out whatever is still queued, and raw replay after a restart.
+ */
 class EventManager {
 public:
     // Event types
@@ -117,16 +135,19 @@ public:
 
     // Initialization and shutdown
     bool initialize(size_t maxQueueSize = 1000, size_t numWorkers = 4);
+    // Drops queued events, subscriptions and filters
     void shutdown();
 
-    // Event publishing
+    // Event publishing; the rvalue overloads move the payload into the queue
     bool publishEvent(const Event& event);
+    bool publishEvent(Event&& event);
     bool publishEvent(EventType type, const std::string& name,
-                     const nlohmann::json& data = nlohmann::json::object(),
+                     nlohmann::json data = nlohmann::json::object(),
                      Priority priority = Priority::NORMAL);
     bool publishEventAsync(const Event& event);
+    bool publishEventAsync(Event&& event);
     bool publishEventAsync(EventType type, const std::string& name,
-                          const nlohmann::json& data = nlohmann::json::object(),
+                          nlohmann::json data = nlohmann::json::object(),
                           Priority priority = Priority::NORMAL);
 
     // Event subscription (token-based)
@@ -154,7 +175,12 @@ public:
     void processEvents();
     void waitForEvents(std::chrono::milliseconds timeout = std::chrono::milliseconds(0));
 
-    // Event querying
+    // Event journal; getEvents returns nothing while it is disabled
+    bool enableJournal(const EventJournal::Config& config);
+    void disableJournal();
+    std::shared_ptr<EventJournal> getJournal() const;
+
+    // Event querying (from the journal)
     std::vector<Event> getEvents(EventType type,
                                std::chrono::system_clock::time_point start,
                                std::chrono::system_clock::time_point end);
@@ -182,34 +208,99 @@ public:
 
 private:
     EventManager() = default;
-    ~EventManager() = default;
+    ~EventManager();
+
+    static constexpr size_t PRIORITY_LEVELS = 4;
+    // Every this many pops, lower priorities get the first look
+    static constexpr size_t STARVATION_INTERVAL = 16;
+
+    // Bounded MPMC ring (sequence-numbered cells); capacity is a power of two
+    class EventRing {
+    public:
+        explicit EventRing(size_t capacity);
+        bool push(Event&& event);
+        bool pop(Event& event);
+
+    private:
+        struct Cell {
+            std::atomic<size_t> sequence;
+            Event event;
+        };
+
+        std::unique_ptr<Cell[]> cells_;
+        size_t mask_;
+        alignas(64) std::atomic<size_t> head_{0};
+        alignas(64) std::atomic<size_t> tail_{0};
+    };
+
+    // Immutable once published; replaced wholesale by subscribe/unsubscribe/addFilter
+    struct SubscriptionTable {
+        std::unordered_map<EventType, std::vector<Subscription>> typeSubscriptions;
+        std::unordered_map<std::string, std::vector<Subscription>> nameSubscriptions;
+        std::vector<Subscription> filterSubscriptions;
+        std::unordered_map<EventType, std::vector<EventFilter>> typeFilters;
+        std::unordered_map<std::string, std::vector<EventFilter>> nameFilters;
+    };
+
+    // An accepted event as the journal writer will store it; the payload is
+    // CBOR-encoded at publish time so the event itself can be moved on
+    struct JournalRecord {
+        std::chrono::system_clock::time_point timestamp;
+        uint8_t type = 0;
+        uint8_t priority = 0;
+        std::string name;
+        std::string source;
+        std::string correlationId;
+        std::string traceId;
+        std::vector<uint8_t> data;
+    };
 
     // Helper methods
     void workerThread();
+    bool popEvent(Event& event);
     bool validateEvent(const Event& event) const;
     void updateStats(const Event& event, std::chrono::milliseconds processingTime);
     void handleEvent(const Event& event, const Subscription& subscription);
     void handleEventAsync(const Event& event, const Subscription& subscription);
     bool matchEvent(const Event& event, const Subscription& subscription) const;
+    bool passesFilters(const Event& event, const SubscriptionTable& table) const;
+    std::shared_ptr<const SubscriptionTable> subscriptions() const;
+    void updateSubscriptions(const std::function<void(SubscriptionTable&)>& update);
+    void setLastError(const std::string& error);
+    void journalEvent(const JournalRecord& entry);
+    void queueForJournal(const Event& event);
+    void journalWriterThread();
+    void drainJournalQueue();
+    void stopJournalWriter();
+    static Event decodeEvent(const EventJournal::RecordView& record);
     void cleanupSubscriptions();
     void cleanupFilters();
     SubscriptionToken generateToken();
 
     // Member variables
-    bool initialized_ = false;
-    mutable std::mutex mutex_;
-    std::condition_variable condition_;
-    std::queue<Event> eventQueue_;
+    std::atomic<bool> initialized_ = false;
+    mutable std::mutex mutex_;          // lifecycle, table writers, lastError_
+    std::array<std::unique_ptr<EventRing>, PRIORITY_LEVELS> queues_;
     size_t maxQueueSize_ = 1000;
+    std::atomic<size_t> queuedEvents_ = 0;    // reserved slots, bounded by maxQueueSize_
+    std::atomic<size_t> availableEvents_ = 0; // pushed and not yet taken
+    std::atomic<size_t> popTick_ = 0;
+    std::mutex wakeMutex_;
+    std::condition_variable condition_;
+    std::atomic<size_t> sleepingWorkers_ = 0;
     std::vector<std::thread> workers_;
     std::atomic<bool> running_ = false;
-    std::unordered_map<EventType, std::vector<Subscription>> typeSubscriptions_;
-    std::unordered_map<std::string, std::vector<Subscription>> nameSubscriptions_;
-    std::vector<Subscription> filterSubscriptions_;
-    std::unordered_map<EventType, std::vector<EventFilter>> typeFilters_;
-    std::unordered_map<std::string, std::vector<EventFilter>> nameFilters_;
-    EventStats stats_;
-    bool statsEnabled_ = false;
+    std::shared_ptr<const SubscriptionTable> subscriptions_ = std::make_shared<SubscriptionTable>();
+    std::shared_ptr<EventJournal> journal_;   // read with std::atomic_load
+    std::mutex journalQueueMutex_;
+    std::condition_variable journalQueueCondition_;
+    std::vector<JournalRecord> journalQueue_; // accepted, not yet journaled
+    bool journalStopping_ = false;
+    std::mutex journalWriteMutex_;            // drained batches append in order
+    std::thread journalWriter_;               // started by enableJournal
+    mutable std::mutex statsMutex_;
+    EventStats stats_{};
+    std::atomic<bool> statsEnabled_ = false;
     std::string lastError_;
     std::atomic<SubscriptionToken> nextToken_ = 1;
 };
@@ -25,16 +25,33 @@
 
 #pragma once
 
+#include <array>
+#include <cstddef>
+#include <cstdint>
 #include <string>
 #include <vector>
-#include <memory>
 #include <openssl/sha.h>
 
 namespace satox {
 namespace core {
 
+/**
+ * Binary Merkle tree over SHA-256.
+ *
+ * Every level is kept, leaves first and the root last. A parent is
+ * SHA-256(left || right) over the raw 32-byte digests; an odd node at the end
+ * of a level is paired with itself. Proofs list the sibling of every level,
+ * bottom up, so verifying only needs the leaf index to know which side each
+ * sibling is on.
+ *
+ * The tree is incremental: appending or updating leaves only rehashes the
+ * parents above the changed range, which is O(log n) for a single leaf, and
+ * proofs are read from the kept levels without a rebuild.
+ */
 class MerkleTree {
 public:
+    using Digest = std::array<uint8_t, SHA256_DIGEST_LENGTH>;
+
     MerkleTree();
     ~MerkleTree() = default;
 
@@ -46,38 +63,63 @@ public:
     MerkleTree(MerkleTree&&) noexcept = default;
     MerkleTree& operator=(MerkleTree&&) noexcept = default;
 
-    // Tree operations
+    // Tree operations; leaves are SHA-256 of each transaction, hashes are hex
     void buildTree(const std::vector<std::string>& transactions);
     std::string getRoot() const;
     std::vector<std::string> getProof(const std::string& transaction) const;
+    // The transaction must be a leaf of this tree, which supplies its index
     bool verifyProof(const std::string& transaction,
                     const std::string& root,
                     const std::vector<std::string>& proof) const;
 
+    // Binary interface; leaves are digests (e.g. txids) in order
+    void buildFromLeaves(std::vector<Digest> leaves);
+    const Digest& getRootDigest() const;
+    size_t getLeafCount() const;
+    std::vector<Digest> getProof(size_t leafIndex) const;
+    static bool verifyProof(const Digest& leaf, size_t leafIndex,
+                            const std::vector<Digest>& proof, const Digest& root);
+    // True when every proof is valid. Nodes already authenticated by an
+    // earlier proof in the batch end the hashing for later proofs that reach
+    // them; the rest of such a proof is compared with the known siblings.
+    static bool verifyProofs(const std::vector<Digest>& leaves,
+                             const std::vector<size_t>& leafIndices,
+                             const std::vector<std::vector<Digest>>& proofs,
+                             const Digest& root);
+
+    // Incremental updates
+    void append(const Digest& leaf);
+    void appendLeaves(const std::vector<Digest>& leaves);
+    bool updateLeaf(size_t leafIndex, const Digest& leaf);
+    // Roots of the perfect subtrees covering the leaves, largest first
+    std::vector<Digest> getFrontier() const;
+
+    // out[i] = SHA-256(in[2i] || in[2i+1]) for i < count. Uses the SHA-NI
+    // instructions when the CPU has them; `in` and `out` may not overlap.
+    static void hashPairs(const Digest* in, Digest* out, size_t count);
+    static Digest hashPair(const Digest& left, const Digest& right);
+
+#ifdef TESTING
+    // Test-only: whether hashPairs runs the SHA-NI kernel, and a switch to
+    // force the portable OpenSSL path (false restores CPU detection)
+    static bool usesShaNiForTesting();
+    static void setPortableHashingForTesting(bool portable);
+#endif
+
 private:
-    struct Node {
-        std::string hash;
-        std::shared_ptr<Node> left;
-        std::shared_ptr<Node> right;
-        std::string data;
-
-        explicit Node(const std::string& h) : hash(h), left(nullptr), right(nullptr) {}
-    };
-
-    std::shared_ptr<Node> root_;
-
-    // Optimized hash calculation methods
-    static std::string calculateHash(const std::string& data);
-    static std::string calculateHashOptimized(const std::string& data);
-    static std::string combineHashes(const std::string& left, const std::string& right);
-    static std::string combineHashesOptimized(const std::string& left, const std::string& right);
-
-    // Tree building and traversal methods
-    void buildTreeRecursive(std::vector<std::shared_ptr<Node>>& nodes);
-    std::vector<std::string> getProofRecursive(const std::shared_ptr<Node>& node,
-                                             const std::string& transaction,
-                                             std::vector<std::string>& proof) const;
+    // Levels at or above this many parents are hashed on several threads
+    static constexpr size_t PARALLEL_THRESHOLD = 1 << 14;
+
+    std::vector<std::vector<Digest>> levels_; // leaves first, root level last
+
+    // Rehashes every parent above leaves [begin, end)
+    void rehash(size_t begin, size_t end);
+    size_t findLeaf(const Digest& leaf) const;
+
+    static Digest hashData(const std::string& data);
+    static std::string toHex(const Digest& digest);
+    static bool fromHex(const std::string& hex, Digest& digest);
 };
 
 } // namespace core
-} // namespace satox 
\ No newline at end of file
+} // namespace satox
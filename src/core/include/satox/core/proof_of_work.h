@@ -25,9 +25,13 @@
 
 #pragma once
 
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <limits>
+#include <memory>
 #include <string>
 #include <vector>
-#include <cstdint>
 #include <openssl/sha.h>
 
 namespace satox {
@@ -35,6 +39,21 @@ namespace core {
 
 class ProofOfWork {
 public:
+    using Hash = std::array<uint8_t, SHA256_DIGEST_LENGTH>;
+
+    struct MiningOptions {
+        size_t threads = 0;                                        // 0 = hardware concurrency
+        uint64_t startNonce = 0;
+        uint64_t endNonce = std::numeric_limits<uint64_t>::max();  // inclusive
+    };
+
+    struct MiningResult {
+        bool found = false;
+        uint64_t nonce = 0;
+        Hash hash{};
+        uint64_t hashes = 0;  // attempts made by all threads
+    };
+
     ProofOfWork();
     ~ProofOfWork() = default;
 
@@ -47,10 +66,24 @@ public:
     ProofOfWork& operator=(ProofOfWork&&) noexcept = default;
 
     // Mining functions
+    // Returns the nonce as 16 hex digits, or an empty string if cancelled
     std::string mineBlock(const std::string& previousHash,
                          const std::string& merkleRoot,
                          uint64_t timestamp,
                          uint64_t difficulty);
+
+    // Finds the lowest nonce with SHA256(headerPrefix || nonce as 8
+    // little-endian bytes) <= target, both compared as big-endian numbers;
+    // the answer does not depend on the thread count
+    MiningResult mine(const std::vector<uint8_t>& headerPrefix,
+                      const Hash& target,
+                      const MiningOptions& options);
+    MiningResult mine(const std::vector<uint8_t>& headerPrefix, const Hash& target);
+
+    // Stops a running mine()/mineBlock() from another thread. A cancel that
+    // lands before the search starts stops it as soon as it does; each
+    // search consumes the cancel, so the following one runs normally.
+    void cancel();
     
     // Verification functions
     bool verifyBlock(const std::string& hash,
@@ -64,14 +97,26 @@ public:
     static std::string calculateHash(const std::string& data);
     static bool meetsDifficulty(const std::string& hash, uint64_t difficulty);
     static uint64_t getDifficulty(uint64_t blockHeight);
+    static std::string calculateHashOptimized(const std::string& data);
+    // Largest digest with `difficulty` leading zero hex digits
+    static Hash difficultyToTarget(uint64_t difficulty);
 
 private:
     static constexpr uint64_t INITIAL_DIFFICULTY = 4;
     static constexpr uint64_t DIFFICULTY_ADJUSTMENT_INTERVAL = 2016;
     static constexpr uint64_t TARGET_BLOCK_TIME = 600; // 10 minutes in seconds
 
-    std::string generateNonce();
+    enum class NonceEncoding {
+        BINARY_LE64,  // mine(): raw 8 bytes
+        HEX16         // mineBlock(): 16 lowercase hex digits, as verifyBlock expects
+    };
+
+    MiningResult search(const std::vector<uint8_t>& prefix, const Hash& target,
+                        const MiningOptions& options, NonceEncoding encoding);
+
     bool isValidNonce(const std::string& nonce);
+
+    std::unique_ptr<std::atomic<bool>> cancelled_;
 };
 
 } // namespace core
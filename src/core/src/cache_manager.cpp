@@ -22,19 +22,177 @@
  * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
  * SOFTWARE.
  */
-
 #include "satox/core/cache_manager.hpp"
 #include <algorithm>
+#include <iterator>
 #include <sstream>
 #include <iomanip>
 
 namespace satox::core {
 
+namespace {
+
+constexpr size_t kSketchRows = 4;
+constexpr uint8_t kSketchMax = 15;
+constexpr size_t kSketchCountersPerEntry = 4;
+constexpr uint64_t kSketchSeeds[kSketchRows] = {
+    0xc3a5c85c97cb3127ULL, 0xb492b66fbe98f273ULL, 0x9ae16a3b2f90404fULL, 0xcbf29ce484222325ULL};
+
+uint64_t mixHash(uint64_t h) {
+    h *= 0x9e3779b97f4a7c15ULL;
+    return h ^ (h >> 32);
+}
+
+uint64_t toSeconds(std::chrono::system_clock::time_point time) {
+    auto seconds = std::chrono::duration_cast<std::chrono::seconds>(time.time_since_epoch()).count();
+    return seconds > 0 ? static_cast<uint64_t>(seconds) : 0;
+}
+
+// Bytes malloc really hands out for a request: glibc rounds up to 16-byte
+// chunks that carry an 8-byte header, with a 32-byte minimum
+size_t allocationSize(size_t requested) {
+    return std::max<size_t>(32, (requested + sizeof(size_t) + 15) & ~size_t(15));
+}
+
+// Heap bytes behind a string, zero while it fits the small-string buffer
+size_t stringHeapSize(const std::string& text) {
+    const char* data = text.data();
+    const char* object = reinterpret_cast<const char*>(&text);
+    if (data >= object && data < object + sizeof(text)) {
+        return 0;
+    }
+    return allocationSize(text.capacity() + 1);
+}
+
+} // namespace
+
+void CacheManager::FrequencySketch::resize(size_t expectedEntries) {
+    // Each row gets several counters per entry so that a scan of one-off keys
+    // between agings spreads thinly instead of inflating the hot keys' rivals
+    size_t width = 64;
+    while (width < expectedEntries * kSketchCountersPerEntry) {
+        width <<= 1;
+    }
+    counters_.assign(width * kSketchRows, 0);
+    mask_ = width - 1;
+    additions_ = 0;
+    samplePeriod_ = std::max<size_t>(expectedEntries, 1) * 10;
+}
+
+void CacheManager::FrequencySketch::increment(size_t hash) {
+    if (counters_.empty()) {
+        return;
+    }
+
+    bool added = false;
+    for (size_t row = 0; row < kSketchRows; ++row) {
+        uint8_t& counter = counters_[index(hash, row)];
+        if (counter < kSketchMax) {
+            ++counter;
+            added = true;
+        }
+    }
+
+    // Aging: halve everything once per sample period
+    if (added && ++additions_ >= samplePeriod_) {
+        for (auto& counter : counters_) {
+            counter >>= 1;
+        }
+        additions_ /= 2;
+    }
+}
+
+uint8_t CacheManager::FrequencySketch::estimate(size_t hash) const {
+    if (counters_.empty()) {
+        return 0;
+    }
+
+    uint8_t frequency = kSketchMax;
+    for (size_t row = 0; row < kSketchRows; ++row) {
+        frequency = std::min(frequency, counters_[index(hash, row)]);
+    }
+    return frequency;
+}
+
+void CacheManager::FrequencySketch::clear() {
+    std::fill(counters_.begin(), counters_.end(), 0);
+    additions_ = 0;
+}
+
+size_t CacheManager::FrequencySketch::index(size_t hash, size_t row) const {
+    return row * (mask_ + 1) + (mixHash(hash + kSketchSeeds[row]) & mask_);
+}
+
+void CacheManager::ExpiryWheel::reset(uint64_t now) {
+    for (auto& slot : slots_) {
+        slot.clear();
+    }
+    current_ = now;
+}
+
+void CacheManager::ExpiryWheel::schedule(NodeList::iterator node) {
+    // An entry expires once now > expiry, i.e. from the next whole second on
+    place(node, std::max(toSeconds(node->entry.expiry) + 1, current_ + 1));
+}
+
+void CacheManager::ExpiryWheel::cancel(NodeList::iterator node) {
+    slots_[node->timerSlot].erase(node->timer);
+}
+
+CacheManager::TimerList& CacheManager::ExpiryWheel::advance(uint64_t now) {
+    while (current_ < now) {
+        ++current_;
+        // Refill the lower levels whenever a level wraps
+        for (size_t level = 1; level < kLevels; ++level) {
+            if ((current_ & ((uint64_t(1) << (6 * level)) - 1)) != 0) {
+                break;
+            }
+            cascade(level);
+        }
+
+        TimerList& slot = slots_[current_ & (kSlots - 1)];
+        for (auto& node : slot) {
+            node->timerSlot = kDueSlot;
+        }
+        slots_[kDueSlot].splice(slots_[kDueSlot].end(), slot);
+    }
+    return slots_[kDueSlot];
+}
+
+void CacheManager::ExpiryWheel::place(NodeList::iterator node, uint64_t due) {
+    uint64_t delta = due > current_ ? due - current_ : 0;
+    size_t level = 0;
+    while (level + 1 < kLevels && delta >= (uint64_t(1) << (6 * (level + 1)))) {
+        ++level;
+    }
+    // Beyond the top level's span: park in the farthest slot, re-filed on cascade
+    uint64_t span = uint64_t(1) << (6 * kLevels);
+    if (delta >= span) {
+        due = current_ + span - 1;
+    }
+
+    size_t slot = level * kSlots + ((due >> (6 * level)) & (kSlots - 1));
+    node->timerSlot = slot;
+    node->timer = slots_[slot].insert(slots_[slot].end(), node);
+}
+
+void CacheManager::ExpiryWheel::cascade(size_t level) {
+    TimerList pending;
+    pending.swap(slots_[level * kSlots + ((current_ >> (6 * level)) & (kSlots - 1))]);
+    for (auto node : pending) {
+        place(node, std::max(toSeconds(node->entry.expiry) + 1, current_));
+    }
+}
+
 CacheManager& CacheManager::getInstance() {
     static CacheManager instance;
     return instance;
 }
 
+CacheManager::~CacheManager() {
+    stopExpiryThread();
+}
+
 bool CacheManager::initialize(const CacheConfig& config) {
     std::lock_guard<std::mutex> lock(mutex_);
     
@@ -49,25 +207,47 @@ bool CacheManager::initialize(const CacheConfig& config) {
     }
 
     config_ = config;
-    stats_ = CacheStats{};
-    stats_.maxSize = config.maxSize;
+    maxSize_ = config.maxSize;
+    maxEntries_ = config.maxEntries;
+    shardCount_ = 1;
+    while (shardCount_ < kShardCount && config.maxEntries / (shardCount_ * 2) >= kMinEntriesPerShard) {
+        shardCount_ *= 2;
+    }
+    windowCapacity_ = std::max<size_t>(1, config.maxEntries / shardCount_ / 100);
     lastCleanup_ = std::chrono::system_clock::now();
+    for (auto& shard : shards_) {
+        std::lock_guard<std::mutex> shardLock(shard.mutex);
+        shard.sketch.resize(config.maxEntries / shardCount_ + 1);
+        shard.expiry.reset(toSeconds(lastCleanup_));
+    }
+    hitCount_ = 0;
+    missCount_ = 0;
+    evictionCount_ = 0;
+    expiredCount_ = 0;
     initialized_ = true;
+
+    if (config.cleanupInterval > 0) {
+        std::lock_guard<std::mutex> expiryLock(expiryMutex_);
+        stopExpiry_ = false;
+        expiryThread_ = std::thread(&CacheManager::expiryLoop, this);
+    }
     return true;
 }
 
 void CacheManager::shutdown() {
+    stopExpiryThread();
+
     std::lock_guard<std::mutex> lock(mutex_);
     if (initialized_) {
-        clear();
         initialized_ = false;
+        clear();
     }
 }
 
 bool CacheManager::set(const std::string& key, const std::string& value,
                       std::chrono::seconds ttl) {
     if (!initialized_) {
-        lastError_ = "Cache manager not initialized";
+        setLastError("Cache manager not initialized");
         return false;
     }
 
@@ -75,39 +255,66 @@ bool CacheManager::set(const std::string& key, const std::string& value,
         return false;
     }
 
-    std::lock_guard<std::mutex> lock(mutex_);
-
     // Calculate entry size
+    auto now = std::chrono::system_clock::now();
     CacheEntry entry;
     entry.key = key;
     entry.value = value;
-    entry.size = value.size() + key.size();
     entry.accessCount = 0;
-    entry.lastAccess = std::chrono::system_clock::now();
-    entry.expiry = ttl.count() > 0 ? 
-        std::chrono::system_clock::now() + ttl :
-        std::chrono::system_clock::now() + config_.defaultTTL;
+    entry.lastAccess = now;
+    entry.expiry = now + (ttl.count() > 0 ? ttl : config_.defaultTTL);
+    entry.size = calculateEntrySize(entry);
+    const size_t entrySize = entry.size;
 
-    // Check if we need to evict entries
-    while (stats_.totalSize + entry.size > config_.maxSize ||
-           cache_.size() >= config_.maxEntries) {
-        if (!evictEntry()) {
-            lastError_ = "Failed to evict entry for new value";
-            return false;
-        }
+    if (entrySize > maxSize_) {
+        setLastError("Failed to evict entry for new value: value exceeds cache size");
+        return false;
     }
 
-    // Add or update entry
-    auto it = cache_.find(key);
-    if (it != cache_.end()) {
-        stats_.totalSize -= it->second.size;
-        lruList_.remove(key);
+    const size_t hash = std::hash<std::string_view>{}(key);
+    Shard& shard = shardFor(hash);
+    {
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        if (config_.enableLFU) {
+            shard.sketch.increment(hash);
+        }
+
+        auto it = shard.index.find(KeyRef{key, hash});
+        if (it != shard.index.end()) {
+            // Update in place
+            CacheEntry& existing = it->second->entry;
+            totalSize_ -= existing.size;
+            existing.value = std::move(entry.value);
+            existing.size = calculateEntrySize(existing);
+            totalSize_ += existing.size;
+            existing.expiry = entry.expiry;
+            shard.expiry.cancel(it->second);
+            shard.expiry.schedule(it->second);
+            touch(shard, it->second);
+        } else {
+            NodeList& list = config_.enableLFU ? shard.window : shard.main;
+            list.push_front(Node{std::move(entry), hash, config_.enableLFU, 0, {}});
+            shard.index.emplace(KeyRef{list.front().entry.key, hash}, list.begin());
+            shard.expiry.schedule(list.begin());
+            totalSize_ += entrySize;
+            ++entryCount_;
+
+            // The oldest window entry graduates to the main segment, unless the
+            // cache is full, in which case it has to win admission against the
+            // main segment's eviction victim first
+            while (shard.window.size() > windowCapacity_) {
+                if (totalSize_ > maxSize_ || entryCount_ > maxEntries_) {
+                    evictEntry(shard);
+                } else {
+                    shard.main.splice(shard.main.begin(), shard.window, std::prev(shard.window.end()));
+                    shard.main.front().inWindow = false;
+                }
+            }
+        }
     }
 
-    cache_[key] = entry;
-    lruList_.push_front(key);
-    stats_.totalSize += entry.size;
-    stats_.totalEntries = cache_.size();
+    // Check if we need to evict entries
+    enforceLimits();
 
     notifyCallbacks(key, value);
     return true;
@@ -120,36 +327,33 @@ bool CacheManager::set(const std::string& key, const nlohmann::json& value,
 
 std::optional<std::string> CacheManager::get(const std::string& key) {
     if (!initialized_) {
-        lastError_ = "Cache manager not initialized";
+        setLastError("Cache manager not initialized");
         return std::nullopt;
     }
 
-    std::lock_guard<std::mutex> lock(mutex_);
-
-    auto it = cache_.find(key);
-    if (it == cache_.end()) {
-        updateStats(false);
-        return std::nullopt;
-    }
+    const size_t hash = std::hash<std::string_view>{}(key);
+    Shard& shard = shardFor(hash);
+    std::optional<std::string> value;
+    {
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        if (config_.enableLFU) {
+            shard.sketch.increment(hash);
+        }
 
-    // Check if entry has expired
-    if (std::chrono::system_clock::now() > it->second.expiry) {
-        cache_.erase(it);
-        lruList_.remove(key);
-        stats_.totalSize -= it->second.size;
-        stats_.totalEntries = cache_.size();
-        updateStats(false);
-        return std::nullopt;
+        auto it = shard.index.find(KeyRef{key, hash});
+        if (it != shard.index.end()) {
+            // Check if entry has expired
+            if (std::chrono::system_clock::now() > it->second->entry.expiry) {
+                eraseNode(shard, it->second);
+            } else {
+                touch(shard, it->second);
+                value = it->second->entry.value;
+            }
+        }
     }
 
-    // Update access statistics
-    it->second.accessCount++;
-    it->second.lastAccess = std::chrono::system_clock::now();
-    lruList_.remove(key);
-    lruList_.push_front(key);
-
-    updateStats(true);
-    return it->second.value;
+    updateStats(value.has_value());
+    return value;
 }
 
 std::optional<nlohmann::json> CacheManager::getJson(const std::string& key) {
@@ -161,50 +365,48 @@ std::optional<nlohmann::json> CacheManager::getJson(const std::string& key) {
     try {
         return nlohmann::json::parse(*value);
     } catch (const std::exception& e) {
-        lastError_ = "Failed to parse JSON: " + std::string(e.what());
+        setLastError("Failed to parse JSON: " + std::string(e.what()));
         return std::nullopt;
     }
 }
 
 bool CacheManager::remove(const std::string& key) {
     if (!initialized_) {
-        lastError_ = "Cache manager not initialized";
+        setLastError("Cache manager not initialized");
         return false;
     }
 
-    std::lock_guard<std::mutex> lock(mutex_);
+    const size_t hash = std::hash<std::string_view>{}(key);
+    Shard& shard = shardFor(hash);
+    std::lock_guard<std::mutex> lock(shard.mutex);
 
-    auto it = cache_.find(key);
-    if (it == cache_.end()) {
+    auto it = shard.index.find(KeyRef{key, hash});
+    if (it == shard.index.end()) {
         return false;
     }
 
-    stats_.totalSize -= it->second.size;
-    cache_.erase(it);
-    lruList_.remove(key);
-    stats_.totalEntries = cache_.size();
+    eraseNode(shard, it->second);
     return true;
 }
 
 bool CacheManager::exists(const std::string& key) {
     if (!initialized_) {
-        lastError_ = "Cache manager not initialized";
+        setLastError("Cache manager not initialized");
         return false;
     }
 
-    std::lock_guard<std::mutex> lock(mutex_);
+    const size_t hash = std::hash<std::string_view>{}(key);
+    Shard& shard = shardFor(hash);
+    std::lock_guard<std::mutex> lock(shard.mutex);
 
-    auto it = cache_.find(key);
-    if (it == cache_.end()) {
+    auto it = shard.index.find(KeyRef{key, hash});
+    if (it == shard.index.end()) {
         return false;
     }
 
     // Check if entry has expired
-    if (std::chrono::system_clock::now() > it->second.expiry) {
-        cache_.erase(it);
-        lruList_.remove(key);
-        stats_.totalSize -= it->second.size;
-        stats_.totalEntries = cache_.size();
+    if (std::chrono::system_clock::now() > it->second->entry.expiry) {
+        eraseNode(shard, it->second);
         return false;
     }
 
@@ -212,22 +414,28 @@ bool CacheManager::exists(const std::string& key) {
 }
 
 void CacheManager::clear() {
-    std::lock_guard<std::mutex> lock(mutex_);
-    cache_.clear();
-    lruList_.clear();
-    stats_.totalSize = 0;
-    stats_.totalEntries = 0;
+    for (auto& shard : shards_) {
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        for (NodeList* list : {&shard.window, &shard.main}) {
+            for (const auto& node : *list) {
+                totalSize_ -= node.entry.size;
+            }
+            entryCount_ -= list->size();
+            list->clear();
+        }
+        shard.index.clear();
+        shard.sketch.clear();
+        shard.expiry.reset(toSeconds(std::chrono::system_clock::now()));
+    }
 }
 
 bool CacheManager::setMulti(const std::unordered_map<std::string, std::string>& entries,
                            std::chrono::seconds ttl) {
     if (!initialized_) {
-        lastError_ = "Cache manager not initialized";
+        setLastError("Cache manager not initialized");
         return false;
     }
 
-    std::lock_guard<std::mutex> lock(mutex_);
-
     for (const auto& [key, value] : entries) {
         if (!set(key, value, ttl)) {
             return false;
@@ -242,16 +450,14 @@ std::unordered_map<std::string, std::string> CacheManager::getMulti(
     std::unordered_map<std::string, std::string> result;
     
     if (!initialized_) {
-        lastError_ = "Cache manager not initialized";
+        setLastError("Cache manager not initialized");
         return result;
     }
 
-    std::lock_guard<std::mutex> lock(mutex_);
-
     for (const auto& key : keys) {
         auto value = get(key);
         if (value) {
-            result[key] = *value;
+            result[key] = std::move(*value);
         }
     }
 
@@ -260,12 +466,10 @@ std::unordered_map<std::string, std::string> CacheManager::getMulti(
 
 bool CacheManager::removeMulti(const std::vector<std::string>& keys) {
     if (!initialized_) {
-        lastError_ = "Cache manager not initialized";
+        setLastError("Cache manager not initialized");
         return false;
     }
 
-    std::lock_guard<std::mutex> lock(mutex_);
-
     for (const auto& key : keys) {
         if (!remove(key)) {
             return false;
@@ -277,82 +481,99 @@ bool CacheManager::removeMulti(const std::vector<std::string>& keys) {
 
 bool CacheManager::setTTL(const std::string& key, std::chrono::seconds ttl) {
     if (!initialized_) {
-        lastError_ = "Cache manager not initialized";
+        setLastError("Cache manager not initialized");
         return false;
     }
 
-    std::lock_guard<std::mutex> lock(mutex_);
+    const size_t hash = std::hash<std::string_view>{}(key);
+    Shard& shard = shardFor(hash);
+    std::lock_guard<std::mutex> lock(shard.mutex);
 
-    auto it = cache_.find(key);
-    if (it == cache_.end()) {
+    auto it = shard.index.find(KeyRef{key, hash});
+    if (it == shard.index.end()) {
         return false;
     }
 
-    it->second.expiry = std::chrono::system_clock::now() + ttl;
+    it->second->entry.expiry = std::chrono::system_clock::now() + ttl;
+    shard.expiry.cancel(it->second);
+    shard.expiry.schedule(it->second);
     return true;
 }
 
 std::chrono::system_clock::time_point CacheManager::getExpiry(const std::string& key) {
     if (!initialized_) {
-        lastError_ = "Cache manager not initialized";
+        setLastError("Cache manager not initialized");
         return std::chrono::system_clock::time_point();
     }
 
-    std::lock_guard<std::mutex> lock(mutex_);
+    const size_t hash = std::hash<std::string_view>{}(key);
+    Shard& shard = shardFor(hash);
+    std::lock_guard<std::mutex> lock(shard.mutex);
 
-    auto it = cache_.find(key);
-    if (it == cache_.end()) {
+    auto it = shard.index.find(KeyRef{key, hash});
+    if (it == shard.index.end()) {
         return std::chrono::system_clock::time_point();
     }
 
-    return it->second.expiry;
+    return it->second->entry.expiry;
 }
 
 size_t CacheManager::getSize(const std::string& key) {
     if (!initialized_) {
-        lastError_ = "Cache manager not initialized";
+        setLastError("Cache manager not initialized");
         return 0;
     }
 
-    std::lock_guard<std::mutex> lock(mutex_);
+    const size_t hash = std::hash<std::string_view>{}(key);
+    Shard& shard = shardFor(hash);
+    std::lock_guard<std::mutex> lock(shard.mutex);
 
-    auto it = cache_.find(key);
-    if (it == cache_.end()) {
+    auto it = shard.index.find(KeyRef{key, hash});
+    if (it == shard.index.end()) {
         return 0;
     }
 
-    return it->second.size;
+    return it->second->entry.size;
 }
 
 size_t CacheManager::getTotalSize() {
-    std::lock_guard<std::mutex> lock(mutex_);
-    return stats_.totalSize;
+    return totalSize_;
 }
 
 size_t CacheManager::getEntryCount() {
-    std::lock_guard<std::mutex> lock(mutex_);
-    return stats_.totalEntries;
+    return entryCount_;
 }
 
 CacheManager::CacheStats CacheManager::getStats() {
-    std::lock_guard<std::mutex> lock(mutex_);
-    
+    CacheStats stats{};
+    stats.totalEntries = entryCount_;
+    stats.totalSize = totalSize_;
+    stats.maxSize = maxSize_;
+    stats.hitCount = hitCount_;
+    stats.missCount = missCount_;
+    stats.evictionCount = evictionCount_;
+    stats.expiredCount = expiredCount_;
+
     // Calculate hit rate
-    size_t totalAccesses = stats_.hitCount + stats_.missCount;
-    stats_.hitRate = totalAccesses > 0 ? 
-        static_cast<double>(stats_.hitCount) / totalAccesses : 0.0;
+    size_t totalAccesses = stats.hitCount + stats.missCount;
+    stats.hitRate = totalAccesses > 0 ? 
+        static_cast<double>(stats.hitCount) / totalAccesses : 0.0;
 
-    return stats_;
+    return stats;
 }
 
 void CacheManager::registerCallback(CacheCallback callback) {
     std::lock_guard<std::mutex> lock(mutex_);
-    callbacks_.push_back(callback);
+    // Copy on write, so set() can read the list without taking mutex_
+    auto callbacks = callbacks_ ? std::make_shared<std::vector<CacheCallback>>(*callbacks_)
+                                : std::make_shared<std::vector<CacheCallback>>();
+    callbacks->push_back(std::move(callback));
+    std::atomic_store(&callbacks_, std::shared_ptr<const std::vector<CacheCallback>>(std::move(callbacks)));
 }
 
 void CacheManager::unregisterCallback() {
     std::lock_guard<std::mutex> lock(mutex_);
-    callbacks_.clear();
+    std::atomic_store(&callbacks_, std::shared_ptr<const std::vector<CacheCallback>>());
 }
 
 void CacheManager::cleanup() {
@@ -360,136 +581,172 @@ void CacheManager::cleanup() {
         return;
     }
 
-    std::lock_guard<std::mutex> lock(mutex_);
-
-    auto now = std::chrono::system_clock::now();
-    if (now - lastCleanup_ < std::chrono::seconds(config_.cleanupInterval)) {
-        return;
-    }
-
-    // Remove expired entries
-    for (auto it = cache_.begin(); it != cache_.end();) {
-        if (now > it->second.expiry) {
-            stats_.totalSize -= it->second.size;
-            lruList_.remove(it->first);
-            it = cache_.erase(it);
-        } else {
-            ++it;
-        }
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        lastCleanup_ = std::chrono::system_clock::now();
     }
-
-    stats_.totalEntries = cache_.size();
-    lastCleanup_ = now;
+    expireEntries();
 }
 
 void CacheManager::resize(size_t newMaxSize) {
-    std::lock_guard<std::mutex> lock(mutex_);
-    
     if (newMaxSize == 0) {
-        lastError_ = "Invalid cache size";
+        setLastError("Invalid cache size");
         return;
     }
 
-    config_.maxSize = newMaxSize;
-    stats_.maxSize = newMaxSize;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        config_.maxSize = newMaxSize;
+        maxSize_ = newMaxSize;
+    }
 
     // Evict entries if necessary
-    while (stats_.totalSize > config_.maxSize) {
-        if (!evictEntry()) {
-            break;
-        }
-    }
+    enforceLimits();
 }
 
 void CacheManager::setMaxEntries(size_t newMaxEntries) {
-    std::lock_guard<std::mutex> lock(mutex_);
-    
     if (newMaxEntries == 0) {
-        lastError_ = "Invalid max entries";
+        setLastError("Invalid max entries");
         return;
     }
 
-    config_.maxEntries = newMaxEntries;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        config_.maxEntries = newMaxEntries;
+        maxEntries_ = newMaxEntries;
+        windowCapacity_ = std::max<size_t>(1, newMaxEntries / shardCount_ / 100);
+    }
 
     // Evict entries if necessary
-    while (cache_.size() > config_.maxEntries) {
-        if (!evictEntry()) {
-            break;
-        }
-    }
+    enforceLimits();
 }
 
 std::string CacheManager::getLastError() const {
+    std::lock_guard<std::mutex> lock(mutex_);
     return lastError_;
 }
 
 void CacheManager::clearLastError() {
+    std::lock_guard<std::mutex> lock(mutex_);
     lastError_.clear();
 }
 
-bool CacheManager::evictEntry() {
-    if (cache_.empty()) {
-        return false;
-    }
+CacheManager::Shard& CacheManager::shardFor(size_t hash) {
+    return shards_[mixHash(hash) % shardCount_];
+}
+
+bool CacheManager::evictEntry(Shard& shard) {
+    NodeList::iterator victim;
 
-    std::string keyToEvict;
-
-    if (config_.enableLRU && config_.enableLFU) {
-        // Use both LRU and LFU for eviction
-        auto it = std::min_element(cache_.begin(), cache_.end(),
-            [](const auto& a, const auto& b) {
-                return a.second.accessCount < b.second.accessCount ||
-                       (a.second.accessCount == b.second.accessCount &&
-                        a.second.lastAccess < b.second.lastAccess);
-            });
-        keyToEvict = it->first;
-    } else if (config_.enableLRU) {
-        // Use LRU for eviction
-        keyToEvict = lruList_.back();
-    } else if (config_.enableLFU) {
-        // Use LFU for eviction
-        auto it = std::min_element(cache_.begin(), cache_.end(),
-            [](const auto& a, const auto& b) {
-                return a.second.accessCount < b.second.accessCount;
-            });
-        keyToEvict = it->first;
+    if (!config_.enableLFU) {
+        // LRU: the least recently used entry
+        if (shard.main.empty()) {
+            return false;
+        }
+        victim = std::prev(shard.main.end());
+    } else if (shard.main.empty() || shard.window.empty()) {
+        if (shard.main.empty() && shard.window.empty()) {
+            return false;
+        }
+        NodeList& list = shard.main.empty() ? shard.window : shard.main;
+        victim = std::prev(list.end());
     } else {
-        // Default to LRU
-        keyToEvict = lruList_.back();
+        // TinyLFU admission: the oldest window entry replaces the main
+        // segment's LRU entry only if it has been used more often recently;
+        // ties keep the incumbent
+        auto candidate = std::prev(shard.window.end());
+        auto incumbent = std::prev(shard.main.end());
+        if (shard.sketch.estimate(candidate->hash) > shard.sketch.estimate(incumbent->hash)) {
+            shard.main.splice(shard.main.begin(), shard.window, candidate);
+            candidate->inWindow = false;
+            victim = incumbent;
+        } else {
+            victim = candidate;
+        }
     }
 
-    auto it = cache_.find(keyToEvict);
-    if (it != cache_.end()) {
-        stats_.totalSize -= it->second.size;
-        cache_.erase(it);
-        lruList_.remove(keyToEvict);
-        stats_.totalEntries = cache_.size();
-        stats_.evictionCount++;
-        return true;
+    eraseNode(shard, victim);
+    ++evictionCount_;
+    return true;
+}
+
+void CacheManager::enforceLimits() {
+    // Limits are global while eviction is per shard: a shared cursor walks
+    // the shards round robin, one victim each, so evictions spread evenly
+    size_t emptyShards = 0;
+    while (emptyShards < shardCount_ && (totalSize_ > maxSize_ || entryCount_ > maxEntries_)) {
+        Shard& shard = shards_[evictionCursor_++ % shardCount_];
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        if (evictEntry(shard)) {
+            emptyShards = 0;
+        } else {
+            ++emptyShards;
+        }
     }
+}
+
+void CacheManager::touch(Shard& shard, NodeList::iterator node) {
+    node->entry.accessCount++;
+    node->entry.lastAccess = std::chrono::system_clock::now();
+    NodeList& list = node->inWindow ? shard.window : shard.main;
+    list.splice(list.begin(), list, node);
+}
+
+void CacheManager::eraseNode(Shard& shard, NodeList::iterator node) {
+    totalSize_ -= node->entry.size;
+    --entryCount_;
+    shard.expiry.cancel(node);
+    shard.index.erase(KeyRef{node->entry.key, node->hash});
+    (node->inWindow ? shard.window : shard.main).erase(node);
+}
 
-    return false;
+void CacheManager::expireEntries() {
+    const uint64_t now = toSeconds(std::chrono::system_clock::now());
+    for (size_t i = 0; i < shardCount_; ++i) {
+        Shard& shard = shards_[i];
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        TimerList& expired = shard.expiry.advance(now);
+        while (!expired.empty()) {
+            eraseNode(shard, expired.front());
+            ++expiredCount_;
+        }
+    }
 }
 
-void CacheManager::updateAccessStats(const std::string& key) {
-    auto it = cache_.find(key);
-    if (it != cache_.end()) {
-        it->second.accessCount++;
-        it->second.lastAccess = std::chrono::system_clock::now();
-        lruList_.remove(key);
-        lruList_.push_front(key);
+void CacheManager::expiryLoop() {
+    std::unique_lock<std::mutex> lock(expiryMutex_);
+    const auto interval = std::chrono::seconds(config_.cleanupInterval);
+    while (!expiryCv_.wait_for(lock, interval, [this] { return stopExpiry_; })) {
+        lock.unlock();
+        expireEntries();
+        lock.lock();
+    }
+}
+
+void CacheManager::stopExpiryThread() {
+    {
+        std::lock_guard<std::mutex> lock(expiryMutex_);
+        stopExpiry_ = true;
+    }
+    expiryCv_.notify_all();
+    if (expiryThread_.joinable()) {
+        expiryThread_.join();
     }
 }
 
 void CacheManager::notifyCallbacks(const std::string& key, const std::string& value) {
-    for (const auto& callback : callbacks_) {
+    auto callbacks = std::atomic_load(&callbacks_);
+    if (!callbacks) {
+        return;
+    }
+    for (const auto& callback : *callbacks) {
         callback(key, value);
     }
 }
 
 bool CacheManager::validateKey(const std::string& key) {
     if (key.empty()) {
-        lastError_ = "Invalid key: empty key";
+        setLastError("Invalid key: empty key");
         return false;
     }
     return true;
@@ -497,22 +754,33 @@ bool CacheManager::validateKey(const std::string& key) {
 
 bool CacheManager::validateValue(const std::string& value) {
     if (value.empty()) {
-        lastError_ = "Invalid value: empty value";
+        setLastError("Invalid value: empty value");
         return false;
     }
     return true;
 }
 
 size_t CacheManager::calculateEntrySize(const CacheEntry& entry) {
-    return entry.key.size() + entry.value.size();
+    // Everything allocated on behalf of the entry: its list node, index node
+    // and bucket slot, expiry wheel node, plus heap storage of key and value
+    using IndexNode = std::pair<const KeyRef, NodeList::iterator>;
+    return allocationSize(sizeof(Node) + 2 * sizeof(void*)) +
+           allocationSize(sizeof(void*) + sizeof(IndexNode) + sizeof(size_t)) + sizeof(void*) +
+           allocationSize(sizeof(NodeList::iterator) + 2 * sizeof(void*)) +
+           stringHeapSize(entry.key) + stringHeapSize(entry.value);
 }
 
 void CacheManager::updateStats(bool hit) {
     if (hit) {
-        stats_.hitCount++;
+        hitCount_++;
     } else {
-        stats_.missCount++;
+        missCount_++;
     }
 }
 
-} // namespace satox::core 
\ No newline at end of file
+void CacheManager::setLastError(const std::string& error) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    lastError_ = error;
+}
+
+} // namespace satox::core
@@ -26,14 +26,8 @@
 #include "satox/core/database_manager.hpp"
 #include "satox/core/cloud/supabase_manager.hpp"
 #include "satox/core/cloud/firebase_manager.hpp"
-#include "satox/core/cloud/aws_config.hpp"
-#include "satox/core/cloud/azure_config.hpp"
-#include "satox/core/cloud/google_cloud_config.hpp"
 #include "satox/core/cloud/supabase_config.hpp"
 #include "satox/core/cloud/firebase_config.hpp"
-#include "satox/core/cloud/aws_manager.hpp"
-#include "satox/core/cloud/azure_manager.hpp"
-#include "satox/core/cloud/google_cloud_manager.hpp"
 #include <sqlite3.h>
 
 // Conditional includes for optional database backends
@@ -57,6 +51,10 @@
 #include <rocksdb/db.h>
 #include <rocksdb/options.h>
 #include <rocksdb/table.h>
+#include <rocksdb/advanced_cache.h>
+#include <rocksdb/filter_policy.h>
+#include <rocksdb/slice_transform.h>
+#include <rocksdb/write_batch.h>
 #endif
 
 #include <spdlog/spdlog.h>
@@ -69,12 +67,219 @@
 #include <atomic>
 #include <sstream>
 #include <iomanip>
+#include <algorithm>
+#include <cctype>
+#include <list>
+#include <type_traits>
 
 using json = nlohmann::json;
 using satox::core::DatabaseType;
 
 namespace satox::core {
 
+// LRU cache of prepared statements for one SQLite connection, keyed by SQL text.
+// Column names are captured once per statement instead of once per row.
+class SQLiteStatementCache {
+public:
+    struct Entry {
+        sqlite3_stmt* stmt = nullptr;
+        std::vector<std::string> columns;
+    };
+
+    // Resets a statement and drops its bindings when a query is done with it
+    class Lease {
+    public:
+        explicit Lease(sqlite3_stmt* stmt) : stmt_(stmt) {}
+        ~Lease() {
+            sqlite3_reset(stmt_);
+            sqlite3_clear_bindings(stmt_);
+        }
+        Lease(const Lease&) = delete;
+        Lease& operator=(const Lease&) = delete;
+
+    private:
+        sqlite3_stmt* stmt_;
+    };
+
+    SQLiteStatementCache(sqlite3* db, size_t capacity) : db_(db), capacity_(std::max<size_t>(1, capacity)) {}
+
+    ~SQLiteStatementCache() {
+        clear();
+    }
+
+    SQLiteStatementCache(const SQLiteStatementCache&) = delete;
+    SQLiteStatementCache& operator=(const SQLiteStatementCache&) = delete;
+
+    // Returns nullptr with `error` set if preparation fails, or with `error`
+    // empty if the SQL holds no statement (only whitespace or comments).
+    // Text with several statements is refused and flags `multipleStatements`.
+    Entry* acquire(const std::string& sql, std::string& error, bool* multipleStatements = nullptr) {
+        auto found = index_.find(sql);
+        if (found != index_.end()) {
+            lru_.splice(lru_.begin(), lru_, found->second);
+            Entry& entry = found->second->second;
+            // Re-preparation after a schema change may alter the result columns
+            if (static_cast<size_t>(sqlite3_column_count(entry.stmt)) != entry.columns.size()) {
+                loadColumns(entry);
+            }
+            return &entry;
+        }
+
+        sqlite3_stmt* stmt = nullptr;
+        const char* tail = nullptr;
+        int rc = sqlite3_prepare_v3(db_, sql.data(), static_cast<int>(sql.size()), SQLITE_PREPARE_PERSISTENT, &stmt, &tail);
+        if (rc != SQLITE_OK) {
+            error = sqlite3_errmsg(db_);
+            return nullptr;
+        }
+        if (!stmt) {
+            error.clear();
+            return nullptr;
+        }
+        // Only the first statement would ever run; refuse rather than drop the rest silently
+        if (tail && *tail) {
+            sqlite3_stmt* extra = nullptr;
+            int tailRc = sqlite3_prepare_v2(db_, tail, -1, &extra, nullptr);
+            if (extra || tailRc != SQLITE_OK) {
+                sqlite3_finalize(extra);
+                sqlite3_finalize(stmt);
+                error = "SQL text holds more than one statement";
+                if (multipleStatements) {
+                    *multipleStatements = true;
+                }
+                return nullptr;
+            }
+        }
+
+        lru_.emplace_front(sql, Entry{stmt, {}});
+        index_.emplace(lru_.front().first, lru_.begin());
+        loadColumns(lru_.front().second);
+        while (lru_.size() > capacity_) {
+            index_.erase(lru_.back().first);
+            sqlite3_finalize(lru_.back().second.stmt);
+            lru_.pop_back();
+        }
+        return &lru_.front().second;
+    }
+
+    // Must run before the connection is closed
+    void clear() {
+        for (auto& [_, entry] : lru_) {
+            sqlite3_finalize(entry.stmt);
+        }
+        lru_.clear();
+        index_.clear();
+    }
+
+private:
+    static void loadColumns(Entry& entry) {
+        int count = sqlite3_column_count(entry.stmt);
+        entry.columns.clear();
+        entry.columns.reserve(count);
+        for (int i = 0; i < count; ++i) {
+            const char* name = sqlite3_column_name(entry.stmt, i);
+            entry.columns.emplace_back(name ? name : "");
+        }
+    }
+
+    using LruList = std::list<std::pair<std::string, Entry>>;
+
+    sqlite3* db_;
+    size_t capacity_;
+    LruList lru_;
+    std::unordered_map<std::string_view, LruList::iterator> index_;  // keys point into lru_
+};
+
+// RowView over the statement's current row; values are read straight from SQLite
+class SQLiteRowView : public DatabaseManager::RowView {
+public:
+    SQLiteRowView(sqlite3_stmt* stmt, const std::vector<std::string>& columns) : stmt_(stmt), columns_(columns) {}
+
+    int columnCount() const override {
+        return static_cast<int>(columns_.size());
+    }
+
+    const std::string& columnName(int column) const override {
+        return columns_.at(column);
+    }
+
+    ColumnType columnType(int column) const override {
+        switch (sqlite3_column_type(stmt_, column)) {
+            case SQLITE_INTEGER: return ColumnType::INTEGER;
+            case SQLITE_FLOAT: return ColumnType::FLOAT;
+            case SQLITE_TEXT: return ColumnType::TEXT;
+            case SQLITE_BLOB: return ColumnType::BLOB;
+            default: return ColumnType::NULL_VALUE;
+        }
+    }
+
+    int64_t getInt64(int column) const override {
+        return sqlite3_column_int64(stmt_, column);
+    }
+
+    double getDouble(int column) const override {
+        return sqlite3_column_double(stmt_, column);
+    }
+
+    std::string_view getText(int column) const override {
+        // Fetch the pointer before the size, as SQLite requires
+        const auto* text = reinterpret_cast<const char*>(sqlite3_column_text(stmt_, column));
+        return text ? std::string_view(text, sqlite3_column_bytes(stmt_, column)) : std::string_view();
+    }
+
+    std::string_view getBlob(int column) const override {
+        const auto* blob = static_cast<const char*>(sqlite3_column_blob(stmt_, column));
+        return blob ? std::string_view(blob, sqlite3_column_bytes(stmt_, column)) : std::string_view();
+    }
+
+private:
+    sqlite3_stmt* stmt_;
+    const std::vector<std::string>& columns_;
+};
+
+#ifdef SATOX_ENABLE_ROCKSDB
+// Column families opened by default, one per chain entity
+const std::vector<std::string> kRocksDBEntityFamilies = {"blocks", "transactions", "assets", "nfts", "utxos"};
+
+// One open RocksDB instance. Every column family shares the same block cache,
+// so block_cache_size is a budget for the whole database.
+struct RocksDBStore {
+    rocksdb::DB* db = nullptr;
+    std::vector<rocksdb::ColumnFamilyHandle*> handles;
+    std::unordered_map<std::string, rocksdb::ColumnFamilyHandle*> families;
+    std::unordered_map<std::string, size_t> prefixLengths;
+    std::shared_ptr<rocksdb::Cache> blockCache;
+
+    RocksDBStore() = default;
+    RocksDBStore(const RocksDBStore&) = delete;
+    RocksDBStore& operator=(const RocksDBStore&) = delete;
+
+    ~RocksDBStore() {
+        if (db) {
+            for (auto* handle : handles) {
+                db->DestroyColumnFamilyHandle(handle);
+            }
+            delete db;
+        }
+    }
+
+    // Empty name means the default family; nullptr for a family that was not opened
+    rocksdb::ColumnFamilyHandle* family(const std::string& name) const {
+        if (name.empty()) {
+            return db->DefaultColumnFamily();
+        }
+        auto it = families.find(name);
+        return it == families.end() ? nullptr : it->second;
+    }
+
+    // 0 when the family has no prefix extractor
+    size_t prefixLength(const std::string& name) const {
+        auto it = prefixLengths.find(name.empty() ? rocksdb::kDefaultColumnFamilyName : name);
+        return it == prefixLengths.end() ? 0 : it->second;
+    }
+};
+#endif
+
 // Forward declarations for database-specific structures
 struct DatabaseConnection {
     DatabaseType type;
@@ -84,6 +289,7 @@ struct DatabaseConnection {
     std::chrono::system_clock::time_point lastActivity;
     int queryCount = 0;
     int errorCount = 0;
+    std::shared_ptr<SQLiteStatementCache> statements;  // SQLite only
 };
 
 enum class ConnectionState {
@@ -206,84 +412,6 @@ public:
                 case DatabaseType::FIREBASE:
                     success = connectFirebase(conn);
                     break;
-                case DatabaseType::AWS: {
-                    try {
-                        // Parse query as JSON for AWS operations
-                        json query_json;
-                        try {
-                            query_json = json::parse(query);
-                        } catch (const std::exception& e) {
-                            setLastError("Invalid AWS query format: " + std::string(e.what()));
-                            return "";
-                        }
-                        
-                        std::string service = query_json.value("service", "rds");
-                        json params = query_json.value("params", json::object());
-                        
-                        result = satox::core::cloud::AWSManager::getInstance().executeQuery(service, params);
-                        success = !result.contains("error");
-                        
-                        if (!success) {
-                            setLastError("AWS query error: " + result.value("error", "Unknown error"));
-                        }
-                    } catch (const std::exception& e) {
-                        setLastError("AWS query execution failed: " + std::string(e.what()));
-                        success = false;
-                    }
-                    break;
-                }
-                case DatabaseType::AZURE: {
-                    try {
-                        // Parse query as JSON for Azure operations
-                        json query_json;
-                        try {
-                            query_json = json::parse(query);
-                        } catch (const std::exception& e) {
-                            setLastError("Invalid Azure query format: " + std::string(e.what()));
-                            return "";
-                        }
-                        
-                        std::string service = query_json.value("service", "sql");
-                        json params = query_json.value("params", json::object());
-                        
-                        result = satox::core::cloud::AzureManager::getInstance().executeQuery(service, params);
-                        success = !result.contains("error");
-                        
-                        if (!success) {
-                            setLastError("Azure query error: " + result.value("error", "Unknown error"));
-                        }
-                    } catch (const std::exception& e) {
-                        setLastError("Azure query execution failed: " + std::string(e.what()));
-                        success = false;
-                    }
-                    break;
-                }
-                case DatabaseType::GOOGLE_CLOUD: {
-                    try {
-                        // Parse query as JSON for Google Cloud operations
-                        json query_json;
-                        try {
-                            query_json = json::parse(query);
-                        } catch (const std::exception& e) {
-                            setLastError("Invalid Google Cloud query format: " + std::string(e.what()));
-                            return "";
-                        }
-                        
-                        std::string service = query_json.value("service", "sql");
-                        json params = query_json.value("params", json::object());
-                        
-                        result = satox::core::cloud::GoogleCloudManager::getInstance().executeQuery(service, params);
-                        success = !result.contains("error");
-                        
-                        if (!success) {
-                            setLastError("Google Cloud query error: " + result.value("error", "Unknown error"));
-                        }
-                    } catch (const std::exception& e) {
-                        setLastError("Google Cloud query execution failed: " + std::string(e.what()));
-                        success = false;
-                    }
-                    break;
-                }
                 default:
                     setLastError("Unsupported database type");
                     return "";
@@ -346,18 +474,6 @@ public:
                 case DatabaseType::FIREBASE:
                     success = disconnectFirebase(it->second);
                     break;
-                case DatabaseType::AWS:
-                    satox::core::cloud::AWSManager::getInstance().disconnect();
-                    success = true;
-                    break;
-                case DatabaseType::AZURE:
-                    satox::core::cloud::AzureManager::getInstance().disconnect();
-                    success = true;
-                    break;
-                case DatabaseType::GOOGLE_CLOUD:
-                    satox::core::cloud::GoogleCloudManager::getInstance().disconnect();
-                    success = true;
-                    break;
                 default:
                     setLastError("Unsupported database type");
                     return false;
@@ -420,18 +536,6 @@ public:
                 case DatabaseType::FIREBASE:
                     success = executeFirebaseQuery(it->second, query, result);
                     break;
-                case DatabaseType::AWS:
-                    result = satox::core::cloud::AWSManager::getInstance().executeQuery("rds", query);
-                    success = true; // TODO: Check actual result
-                    break;
-                case DatabaseType::AZURE:
-                    result = satox::core::cloud::AzureManager::getInstance().executeQuery("sql", query);
-                    success = true; // TODO: Check actual result
-                    break;
-                case DatabaseType::GOOGLE_CLOUD:
-                    result = satox::core::cloud::GoogleCloudManager::getInstance().executeQuery("sql", query);
-                    success = true; // TODO: Check actual result
-                    break;
                 default:
                     setLastError("Unsupported database type");
                     return false;
@@ -450,6 +554,77 @@ public:
         }
     }
 
+    bool executeQuery(const std::string& id, const std::string& query, const std::vector<QueryParam>& params, json& result) {
+        if (params.empty()) {
+            return executeQuery(id, query, result);
+        }
+        std::lock_guard<std::mutex> lock(mutex_);
+        
+        auto it = connections_.find(id);
+        if (it == connections_.end()) {
+            setLastError("Connection not found");
+            return false;
+        }
+        if (it->second.type != DatabaseType::SQLITE) {
+            setLastError("Bound parameters are only supported by the SQLite backend");
+            return false;
+        }
+
+        try {
+            bool success = executeSQLiteQuery(it->second, query, params, result);
+            updateStats(it->second, success);
+            return success;
+        } catch (const std::exception& e) {
+            setLastError("Failed to execute query: " + std::string(e.what()));
+            updateStats(it->second, false);
+            return false;
+        }
+    }
+
+    bool streamQuery(const std::string& id, const std::string& query, const std::vector<QueryParam>& params,
+                     const RowCallback& onRow) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        
+        auto it = connections_.find(id);
+        if (it == connections_.end()) {
+            setLastError("Connection not found");
+            return false;
+        }
+        if (it->second.type != DatabaseType::SQLITE) {
+            setLastError("Streaming queries are only supported by the SQLite backend");
+            return false;
+        }
+
+        try {
+            bool success = streamSQLiteQuery(it->second, query, params, onRow);
+            updateStats(it->second, success);
+            return success;
+        } catch (const std::exception& e) {
+            setLastError("Failed to execute query: " + std::string(e.what()));
+            updateStats(it->second, false);
+            return false;
+        }
+    }
+
+    bool executeBatch(const std::string& id, const std::string& query,
+                      const std::vector<std::vector<QueryParam>>& rows, json& result) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        
+        auto it = connections_.find(id);
+        if (it == connections_.end()) {
+            setLastError("Connection not found");
+            return false;
+        }
+        if (it->second.type != DatabaseType::SQLITE) {
+            setLastError("Batched statements are only supported by the SQLite backend");
+            return false;
+        }
+
+        bool success = executeSQLiteBatch(it->second, query, rows, result);
+        updateStats(it->second, success);
+        return success;
+    }
+
     bool executeTransaction(const std::string& id, const std::vector<std::string>& queries, json& result) {
         std::lock_guard<std::mutex> lock(mutex_);
         
@@ -496,18 +671,6 @@ public:
                 case DatabaseType::FIREBASE:
                     success = executeFirebaseTransaction(it->second, queries, result);
                     break;
-                case DatabaseType::AWS:
-                    result = satox::core::cloud::AWSManager::getInstance().executeTransaction("rds", queries);
-                    success = true; // TODO: Check actual result
-                    break;
-                case DatabaseType::AZURE:
-                    result = satox::core::cloud::AzureManager::getInstance().executeTransaction("sql", queries);
-                    success = true; // TODO: Check actual result
-                    break;
-                case DatabaseType::GOOGLE_CLOUD:
-                    result = satox::core::cloud::GoogleCloudManager::getInstance().executeTransaction("sql", queries);
-                    success = true; // TODO: Check actual result
-                    break;
                 default:
                     setLastError("Unsupported database type");
                     return false;
@@ -533,10 +696,6 @@ public:
     }
 
 private:
-
-    // Cloud database managers
-    std::unique_ptr<SupabaseManager> supabase_manager_;
-    std::unique_ptr<FirebaseManager> firebase_manager_;
     // Helper methods
     std::string generateConnectionId() {
         static int counter = 0;
@@ -570,7 +729,12 @@ private:
                 sqlite3_close(db);
                 return false;
             }
+            if (!configureSQLite(db, conn.config)) {
+                sqlite3_close(db);
+                return false;
+            }
             conn.handle = db;
+            conn.statements = std::make_shared<SQLiteStatementCache>(db, conn.config.value("statement_cache_size", 64));
             conn.connected = true;
             return true;
         } catch (const std::exception& e) {
@@ -579,9 +743,61 @@ private:
         }
     }
 
+    // Applies the optional tuning options of a SQLite connection config:
+    //   journal_mode  DELETE | TRUNCATE | PERSIST | MEMORY | WAL | OFF
+    //   synchronous   OFF | NORMAL | FULL | EXTRA
+    //   mmap_size     bytes of the file to memory-map
+    //   cache_size    pages, or KiB when negative (SQLite convention)
+    //   busy_timeout  milliseconds to retry on a locked database
+    bool configureSQLite(sqlite3* db, const json& config) {
+        static const std::vector<std::string> journalModes = {"DELETE", "TRUNCATE", "PERSIST", "MEMORY", "WAL", "OFF"};
+        static const std::vector<std::string> syncModes = {"OFF", "NORMAL", "FULL", "EXTRA"};
+
+        // PRAGMA values cannot be bound, so only whitelisted words and integers reach the SQL
+        std::vector<std::string> pragmas;
+        auto choice = [&](const char* option, const std::vector<std::string>& allowed) {
+            if (!config.contains(option)) {
+                return true;
+            }
+            std::string value = config[option].get<std::string>();
+            std::transform(value.begin(), value.end(), value.begin(),
+                           [](unsigned char c) { return static_cast<char>(std::toupper(c)); });
+            if (std::find(allowed.begin(), allowed.end(), value) == allowed.end()) {
+                setLastError("Invalid SQLite " + std::string(option) + ": " + value);
+                return false;
+            }
+            pragmas.push_back("PRAGMA " + std::string(option) + " = " + value);
+            return true;
+        };
+        if (!choice("journal_mode", journalModes) || !choice("synchronous", syncModes)) {
+            return false;
+        }
+        for (const char* option : {"mmap_size", "cache_size"}) {
+            if (config.contains(option)) {
+                pragmas.push_back("PRAGMA " + std::string(option) + " = " + std::to_string(config[option].get<int64_t>()));
+            }
+        }
+
+        for (const auto& pragma : pragmas) {
+            if (sqlite3_exec(db, pragma.c_str(), nullptr, nullptr, nullptr) != SQLITE_OK) {
+                setLastError("Failed to apply SQLite option (" + pragma + "): " + std::string(sqlite3_errmsg(db)));
+                return false;
+            }
+        }
+        if (config.contains("busy_timeout")) {
+            sqlite3_busy_timeout(db, config["busy_timeout"].get<int>());
+        }
+        return true;
+    }
+
     bool disconnectSQLite(DatabaseConnection& conn) {
         try {
             if (conn.handle) {
+                // Cached statements must be finalized before the connection can close
+                if (conn.statements) {
+                    conn.statements->clear();
+                    conn.statements.reset();
+                }
                 sqlite3_close(static_cast<sqlite3*>(conn.handle));
                 conn.handle = nullptr;
             }
@@ -594,45 +810,26 @@ private:
     }
 
     bool executeSQLiteQuery(DatabaseConnection& conn, const std::string& query, json& result) {
-        try {
-            sqlite3* db = static_cast<sqlite3*>(conn.handle);
-            sqlite3_stmt* stmt;
-            int rc = sqlite3_prepare_v2(db, query.c_str(), -1, &stmt, nullptr);
-            if (rc != SQLITE_OK) {
-                setLastError("Failed to prepare SQLite statement: " + std::string(sqlite3_errmsg(db)));
-                return false;
-            }
+        return executeSQLiteQuery(conn, query, {}, result);
+    }
 
+    bool executeSQLiteQuery(DatabaseConnection& conn, const std::string& query, const std::vector<QueryParam>& params,
+                            json& result) {
+        try {
             json rows = json::array();
-            while (sqlite3_step(stmt) == SQLITE_ROW) {
-                json row;
-                int cols = sqlite3_column_count(stmt);
-                for (int i = 0; i < cols; i++) {
-                    std::string colName = sqlite3_column_name(stmt, i);
-                    int type = sqlite3_column_type(stmt, i);
-                    switch (type) {
-                        case SQLITE_INTEGER:
-                            row[colName] = sqlite3_column_int64(stmt, i);
-                            break;
-                        case SQLITE_FLOAT:
-                            row[colName] = sqlite3_column_double(stmt, i);
-                            break;
-                        case SQLITE_TEXT:
-                            row[colName] = std::string(reinterpret_cast<const char*>(sqlite3_column_text(stmt, i)));
-                            break;
-                        case SQLITE_BLOB:
-                            row[colName] = std::string(reinterpret_cast<const char*>(sqlite3_column_blob(stmt, i)));
-                            break;
-                        case SQLITE_NULL:
-                            row[colName] = nullptr;
-                            break;
-                    }
+            bool success = streamSQLiteQuery(conn, query, params, [&rows](const RowView& row) {
+                json record = json::object();
+                for (int i = 0; i < row.columnCount(); i++) {
+                    record.emplace(row.columnName(i), sqliteColumnToJson(row, i));
                 }
-                rows.push_back(row);
+                rows.push_back(std::move(record));
+                return true;
+            });
+            if (!success) {
+                return false;
             }
 
-            sqlite3_finalize(stmt);
-            result["rows"] = rows;
+            result["rows"] = std::move(rows);
             result["success"] = true;
             return true;
         } catch (const std::exception& e) {
@@ -641,6 +838,94 @@ private:
         }
     }
 
+    bool streamSQLiteQuery(DatabaseConnection& conn, const std::string& query, const std::vector<QueryParam>& params,
+                           const RowCallback& onRow) {
+        sqlite3* db = static_cast<sqlite3*>(conn.handle);
+        if (!db || !conn.statements) {
+            setLastError("SQLite connection is closed");
+            return false;
+        }
+
+        std::string error;
+        auto* entry = conn.statements->acquire(query, error);
+        if (!entry) {
+            if (error.empty()) {
+                return true;  // nothing to execute
+            }
+            setLastError("Failed to prepare SQLite statement: " + error);
+            return false;
+        }
+        SQLiteStatementCache::Lease lease(entry->stmt);
+
+        if (!bindSQLiteParams(entry->stmt, params, error)) {
+            setLastError("Failed to bind SQLite parameters: " + error);
+            return false;
+        }
+
+        SQLiteRowView row(entry->stmt, entry->columns);
+        int rc;
+        while ((rc = sqlite3_step(entry->stmt)) == SQLITE_ROW) {
+            if (onRow && !onRow(row)) {
+                return true;
+            }
+        }
+        if (rc != SQLITE_DONE) {
+            setLastError("Failed to execute SQLite statement: " + std::string(sqlite3_errmsg(db)));
+            return false;
+        }
+        return true;
+    }
+
+    static bool bindSQLiteParams(sqlite3_stmt* stmt, const std::vector<QueryParam>& params, std::string& error) {
+        int expected = sqlite3_bind_parameter_count(stmt);
+        if (expected != static_cast<int>(params.size())) {
+            error = "statement expects " + std::to_string(expected) + " parameters, got " + std::to_string(params.size());
+            return false;
+        }
+        // Values are bound SQLITE_STATIC: they outlive the statement's use and the Lease clears them
+        for (size_t i = 0; i < params.size(); i++) {
+            const int index = static_cast<int>(i) + 1;
+            int rc = std::visit([stmt, index](const auto& value) -> int {
+                using T = std::decay_t<decltype(value)>;
+                if constexpr (std::is_same_v<T, std::nullptr_t>) {
+                    return sqlite3_bind_null(stmt, index);
+                } else if constexpr (std::is_same_v<T, int64_t>) {
+                    return sqlite3_bind_int64(stmt, index, value);
+                } else if constexpr (std::is_same_v<T, double>) {
+                    return sqlite3_bind_double(stmt, index, value);
+                } else if constexpr (std::is_same_v<T, std::string>) {
+                    return sqlite3_bind_text64(stmt, index, value.data(), value.size(), SQLITE_STATIC, SQLITE_UTF8);
+                } else if (value.empty()) {
+                    return sqlite3_bind_zeroblob(stmt, index, 0);
+                } else {
+                    return sqlite3_bind_blob64(stmt, index, value.data(), value.size(), SQLITE_STATIC);
+                }
+            }, params[i]);
+            if (rc != SQLITE_OK) {
+                error = sqlite3_errstr(rc);
+                return false;
+            }
+        }
+        return true;
+    }
+
+    static json sqliteColumnToJson(const RowView& row, int column) {
+        switch (row.columnType(column)) {
+            case RowView::ColumnType::INTEGER:
+                return row.getInt64(column);
+            case RowView::ColumnType::FLOAT:
+                return row.getDouble(column);
+            case RowView::ColumnType::TEXT:
+                return std::string(row.getText(column));
+            case RowView::ColumnType::BLOB:
+                // Same string encoding as before, but no longer cut off at the first NUL;
+                // streamQuery's RowView::getBlob gives typed access to the bytes
+                return std::string(row.getBlob(column));
+            default:
+                return nullptr;
+        }
+    }
+
     bool executeSQLiteTransaction(DatabaseConnection& conn, const std::vector<std::string>& queries, json& result) {
         try {
             sqlite3* db = static_cast<sqlite3*>(conn.handle);
@@ -650,11 +935,23 @@ private:
                 return false;
             }
 
+            // Each query goes through the statement cache, so repeated transactions skip parsing;
+            // multi-statement scripts can't be cached and run through sqlite3_exec as before
             bool success = true;
             for (const auto& query : queries) {
-                rc = sqlite3_exec(db, query.c_str(), nullptr, nullptr, nullptr);
-                if (rc != SQLITE_OK) {
-                    setLastError("Failed to execute SQLite transaction query: " + std::string(sqlite3_errmsg(db)));
+                std::string error;
+                bool script = false;
+                if (conn.statements && !conn.statements->acquire(query, error, &script) && script) {
+                    char* message = nullptr;
+                    if (sqlite3_exec(db, query.c_str(), nullptr, nullptr, &message) != SQLITE_OK) {
+                        setLastError("Failed to execute SQLite script: " + std::string(message ? message : sqlite3_errmsg(db)));
+                        sqlite3_free(message);
+                        success = false;
+                        break;
+                    }
+                    continue;
+                }
+                if (!streamSQLiteQuery(conn, query, {}, nullptr)) {
                     success = false;
                     break;
                 }
@@ -678,6 +975,75 @@ private:
         }
     }
 
+    bool executeSQLiteBatch(DatabaseConnection& conn, const std::string& query,
+                            const std::vector<std::vector<QueryParam>>& rows, json& result) {
+        try {
+            sqlite3* db = static_cast<sqlite3*>(conn.handle);
+            if (!db || !conn.statements) {
+                setLastError("SQLite connection is closed");
+                return false;
+            }
+
+            std::string error;
+            auto* entry = conn.statements->acquire(query, error);
+            if (!entry) {
+                setLastError("Failed to prepare SQLite statement: " + (error.empty() ? std::string("empty statement") : error));
+                return false;
+            }
+
+            // Wrap the batch in a transaction, or in a savepoint when one is already
+            // open, so a failing tuple undoes exactly this batch
+            const bool ownTransaction = sqlite3_get_autocommit(db) != 0;
+            const char* begin = ownTransaction ? "BEGIN IMMEDIATE" : "SAVEPOINT satox_batch";
+            if (sqlite3_exec(db, begin, nullptr, nullptr, nullptr) != SQLITE_OK) {
+                setLastError("Failed to begin SQLite transaction: " + std::string(sqlite3_errmsg(db)));
+                return false;
+            }
+
+            int64_t affected = 0;
+            bool success = true;
+            for (const auto& params : rows) {
+                SQLiteStatementCache::Lease lease(entry->stmt);
+                if (!bindSQLiteParams(entry->stmt, params, error)) {
+                    setLastError("Failed to bind SQLite parameters: " + error);
+                    success = false;
+                    break;
+                }
+                int rc;
+                while ((rc = sqlite3_step(entry->stmt)) == SQLITE_ROW) {
+                }
+                if (rc != SQLITE_DONE) {
+                    setLastError("Failed to execute SQLite batch: " + std::string(sqlite3_errmsg(db)));
+                    success = false;
+                    break;
+                }
+                affected += sqlite3_changes(db);
+            }
+
+            if (ownTransaction) {
+                if (success && sqlite3_exec(db, "COMMIT", nullptr, nullptr, nullptr) != SQLITE_OK) {
+                    setLastError("Failed to commit SQLite batch: " + std::string(sqlite3_errmsg(db)));
+                    success = false;
+                }
+                if (!success) {
+                    sqlite3_exec(db, "ROLLBACK", nullptr, nullptr, nullptr);
+                }
+            } else {
+                if (!success) {
+                    sqlite3_exec(db, "ROLLBACK TO satox_batch", nullptr, nullptr, nullptr);
+                }
+                sqlite3_exec(db, "RELEASE satox_batch", nullptr, nullptr, nullptr);
+            }
+
+            result["success"] = success;
+            result["rows_affected"] = success ? affected : 0;
+            return success;
+        } catch (const std::exception& e) {
+            setLastError("Failed to execute SQLite batch: " + std::string(e.what()));
+            return false;
+        }
+    }
+
 #ifdef SATOX_ENABLE_POSTGRESQL
     // PostgreSQL methods (full implementation)
     bool connectPostgreSQL(DatabaseConnection& conn) {
@@ -1399,12 +1765,23 @@ private:
             int maxBytesForLevelBase = conn.config.value("max_bytes_for_level_base", 256 * 1024 * 1024); // 256MB
             bool enableCompression = conn.config.value("enable_compression", true);
             std::string compressionType = conn.config.value("compression_type", "snappy");
-            
-            rocksdb::DB* db;
+            size_t blockCacheSize = conn.config.value("block_cache_size", size_t(8 * 1024 * 1024)); // 8MB
+            int bloomBitsPerKey = conn.config.value("bloom_bits_per_key", 10);
+            std::vector<std::string> columnFamilies =
+                conn.config.value("column_families", kRocksDBEntityFamilies);
+            // Fixed-length key prefixes per family, e.g. {"utxos": 32} for txid-prefixed outpoints
+            json prefixLengths = conn.config.value("prefix_lengths", json::object());
+
+            if (bloomBitsPerKey < 0) {
+                setLastError("bloom_bits_per_key must not be negative");
+                return false;
+            }
+
             rocksdb::Options options;
             
             // Basic options
             options.create_if_missing = createIfMissing;
+            options.create_missing_column_families = true;
             options.max_background_jobs = maxBackgroundJobs;
             options.write_buffer_size = writeBufferSize;
             options.max_write_buffer_number = maxWriteBufferNumber;
@@ -1434,22 +1811,58 @@ private:
             options.use_fsync = false; // Use fdatasync for better performance
             options.bytes_per_sync = 1024 * 1024; // 1MB
             
-            // Configure table options
+            auto store = std::make_unique<RocksDBStore>();
+            store->blockCache = rocksdb::NewLRUCache(blockCacheSize);
+
+            // Table options shared by every family: one block cache, bloom
+            // filters cached (and pinned for L0) next to the data blocks
             rocksdb::BlockBasedTableOptions tableOptions;
-            // tableOptions.filter_policy.reset(rocksdb::NewBloomFilterPolicy(10));
-            // Use default filter policy for now
-            tableOptions.block_cache = rocksdb::NewLRUCache(8 * 1024 * 1024); // 8MB cache
+            tableOptions.block_cache = store->blockCache;
+            if (bloomBitsPerKey > 0) {
+                tableOptions.filter_policy.reset(rocksdb::NewBloomFilterPolicy(bloomBitsPerKey));
+            }
+            tableOptions.cache_index_and_filter_blocks = true;
+            tableOptions.pin_l0_filter_and_index_blocks_in_cache = true;
             options.table_factory.reset(rocksdb::NewBlockBasedTableFactory(tableOptions));
-            
-            rocksdb::Status status = rocksdb::DB::Open(options, path, &db);
+
+            // RocksDB refuses to open unless every family on disk is listed,
+            // so reopen whatever exists in addition to the configured set
+            std::vector<std::string> names = {rocksdb::kDefaultColumnFamilyName};
+            std::vector<std::string> existing;
+            if (rocksdb::DB::ListColumnFamilies(rocksdb::DBOptions(options), path, &existing).ok()) {
+                columnFamilies.insert(columnFamilies.end(), existing.begin(), existing.end());
+            }
+            for (const auto& name : columnFamilies) {
+                if (std::find(names.begin(), names.end(), name) == names.end()) {
+                    names.push_back(name);
+                }
+            }
+
+            std::vector<rocksdb::ColumnFamilyDescriptor> descriptors;
+            for (const auto& name : names) {
+                rocksdb::ColumnFamilyOptions familyOptions(options);
+                size_t prefixLength = prefixLengths.value(name, size_t(0));
+                if (prefixLength > 0) {
+                    familyOptions.prefix_extractor.reset(rocksdb::NewFixedPrefixTransform(prefixLength));
+                    familyOptions.memtable_prefix_bloom_size_ratio = 0.1;
+                    store->prefixLengths[name] = prefixLength;
+                }
+                descriptors.emplace_back(name, familyOptions);
+            }
+
+            rocksdb::Status status = rocksdb::DB::Open(rocksdb::DBOptions(options), path, descriptors,
+                                                       &store->handles, &store->db);
             if (!status.ok()) {
                 setLastError("Failed to open RocksDB: " + status.ToString());
                 return false;
             }
+            for (size_t i = 0; i < names.size(); ++i) {
+                store->families[names[i]] = store->handles[i];
+            }
 
-            conn.handle = db;
+            conn.handle = store.release();
             conn.connected = true;
-            spdlog::info("RocksDB connected successfully to: {}", path);
+            spdlog::info("RocksDB connected successfully to: {} ({} column families)", path, names.size());
             return true;
         } catch (const std::exception& e) {
             setLastError("Failed to connect to RocksDB: " + std::string(e.what()));
@@ -1460,8 +1873,7 @@ private:
     bool disconnectRocksDB(DatabaseConnection& conn) {
         try {
             if (conn.handle) {
-                rocksdb::DB* db = static_cast<rocksdb::DB*>(conn.handle);
-                delete db;
+                delete static_cast<RocksDBStore*>(conn.handle);
                 conn.handle = nullptr;
             }
             conn.connected = false;
@@ -1473,9 +1885,74 @@ private:
         }
     }
 
+    // Resolves the query's "column_family" (default family when absent)
+    rocksdb::ColumnFamilyHandle* rocksDBFamily(const RocksDBStore& store, const json& queryJson) {
+        std::string name = queryJson.value("column_family", "");
+        rocksdb::ColumnFamilyHandle* family = store.family(name);
+        if (!family) {
+            setLastError("Unknown RocksDB column family: " + name);
+        }
+        return family;
+    }
+
+    // Values are stored as given when they are strings and as JSON text otherwise
+    static std::string rocksDBValue(const json& value) {
+        return value.is_string() ? value.get<std::string>() : value.dump();
+    }
+
+    // Adds one write operation to `batch`; used by write_batch and transactions
+    // so that writes to several column families commit atomically
+    bool appendRocksDBWrite(const RocksDBStore& store, const json& queryJson,
+                            rocksdb::WriteBatch& batch, int& affectedRows) {
+        std::string operation = queryJson.value("operation", "");
+        rocksdb::ColumnFamilyHandle* family = rocksDBFamily(store, queryJson);
+        if (!family) {
+            return false;
+        }
+
+        if (operation == "put" || operation == "delete") {
+            if (!queryJson.contains("key") || (operation == "put" && !queryJson.contains("value"))) {
+                setLastError("RocksDB " + operation + " requires key" + (operation == "put" ? " and value" : ""));
+                return false;
+            }
+            std::string key = queryJson["key"].get<std::string>();
+            if (operation == "put") {
+                batch.Put(family, key, rocksDBValue(queryJson["value"]));
+            } else {
+                batch.Delete(family, key);
+            }
+            affectedRows++;
+        } else if (operation == "put_multi") {
+            json keyValues = queryJson.value("key_values", json::object());
+            // put_multi has always stored JSON text, strings included;
+            // keep that encoding so existing databases read back unchanged
+            for (const auto& [k, v] : keyValues.items()) {
+                batch.Put(family, k, v.dump());
+                affectedRows++;
+            }
+        } else if (operation == "delete_multi") {
+            std::vector<std::string> keys = queryJson.value("keys", std::vector<std::string>());
+            for (const auto& k : keys) {
+                batch.Delete(family, k);
+                affectedRows++;
+            }
+        } else if (operation == "write_batch") {
+            for (const auto& op : queryJson.value("operations", json::array())) {
+                if (!appendRocksDBWrite(store, op, batch, affectedRows)) {
+                    return false;
+                }
+            }
+        } else {
+            setLastError("Unsupported RocksDB write operation: " + operation);
+            return false;
+        }
+        return true;
+    }
+
     bool executeRocksDBQuery(DatabaseConnection& conn, const std::string& query, json& result) {
         try {
-            rocksdb::DB* db = static_cast<rocksdb::DB*>(conn.handle);
+            auto* store = static_cast<RocksDBStore*>(conn.handle);
+            rocksdb::DB* db = store->db;
             
             // Parse query as JSON for key-value operations
             json queryJson;
@@ -1483,19 +1960,28 @@ private:
                 queryJson = json::parse(query);
             } catch (const json::exception& e) {
                 setLastError("Invalid RocksDB query format");
+                result["success"] = false;
+                result["error"] = "Invalid RocksDB query format";
                 return false;
             }
 
             std::string operation = queryJson.value("operation", "");
             std::string key = queryJson.value("key", "");
+            std::string familyName = queryJson.value("column_family", "");
+            rocksdb::ColumnFamilyHandle* family = rocksDBFamily(*store, queryJson);
+            if (!family) {
+                result["success"] = false;
+                result["error"] = "Unknown RocksDB column family: " + familyName;
+                return false;
+            }
             
             if (operation == "get") {
-                std::string value;
-                rocksdb::Status status = db->Get(rocksdb::ReadOptions(), key, &value);
+                rocksdb::PinnableSlice value;
+                rocksdb::Status status = db->Get(rocksdb::ReadOptions(), family, key, &value);
                 if (status.ok()) {
                     json row;
                     row["key"] = key;
-                    row["value"] = value;
+                    row["value"] = value.ToString();
                     result["rows"] = json::array({row});
                     result["success"] = true;
                 } else if (status.IsNotFound()) {
@@ -1505,32 +1991,47 @@ private:
                     result["success"] = false;
                     result["error"] = status.ToString();
                 }
-            } else if (operation == "put") {
-                std::string value = queryJson.value("value", "");
-                rocksdb::Status status = db->Put(rocksdb::WriteOptions(), key, value);
-                if (status.ok()) {
-                    result["success"] = true;
-                    result["affected_rows"] = 1;
-                } else {
+            } else if (operation == "put" || operation == "delete" || operation == "put_multi" ||
+                       operation == "delete_multi" || operation == "write_batch") {
+                // All writes go through one WriteBatch, so a multi-key or
+                // multi-family write is applied atomically or not at all
+                rocksdb::WriteBatch batch;
+                int affectedRows = 0;
+                if (!appendRocksDBWrite(*store, queryJson, batch, affectedRows)) {
                     result["success"] = false;
-                    result["error"] = status.ToString();
+                    result["error"] = lastError_;
+                    return false;
                 }
-            } else if (operation == "delete") {
-                rocksdb::Status status = db->Delete(rocksdb::WriteOptions(), key);
+                rocksdb::Status status = db->Write(rocksdb::WriteOptions(), &batch);
                 if (status.ok()) {
                     result["success"] = true;
-                    result["affected_rows"] = 1;
+                    result["affected_rows"] = affectedRows;
                 } else {
                     result["success"] = false;
                     result["error"] = status.ToString();
                 }
             } else if (operation == "scan") {
-                // Scan operation for range queries
+                // Range scan, or with "prefix" every key sharing that prefix
                 std::string startKey = queryJson.value("start_key", "");
                 std::string endKey = queryJson.value("end_key", "");
+                std::string prefix = queryJson.value("prefix", "");
                 int limit = queryJson.value("limit", 1000);
                 
-                rocksdb::Iterator* it = db->NewIterator(rocksdb::ReadOptions());
+                rocksdb::ReadOptions readOptions;
+                // The prefix extractor only applies when the requested prefix
+                // covers the family's fixed prefix; shorter prefixes need a
+                // total-order seek to see keys of every extracted prefix
+                size_t extractorLength = store->prefixLength(familyName);
+                if (!prefix.empty() && extractorLength > 0 && prefix.size() >= extractorLength) {
+                    readOptions.prefix_same_as_start = true;
+                } else {
+                    readOptions.total_order_seek = true;
+                }
+                if (!prefix.empty() && startKey.empty()) {
+                    startKey = prefix;
+                }
+
+                std::unique_ptr<rocksdb::Iterator> it(db->NewIterator(readOptions, family));
                 json rows = json::array();
                 int count = 0;
                 
@@ -1541,98 +2042,73 @@ private:
                 }
                 
                 while (it->Valid() && count < limit) {
-                    if (!endKey.empty() && it->key().ToString() >= endKey) {
+                    rocksdb::Slice current = it->key();
+                    if (!prefix.empty() && !current.starts_with(prefix)) {
+                        break;
+                    }
+                    if (!endKey.empty() && current.compare(endKey) >= 0) {
                         break;
                     }
                     
                     json row;
-                    row["key"] = it->key().ToString();
+                    row["key"] = current.ToString();
                     row["value"] = it->value().ToString();
-                    rows.push_back(row);
+                    rows.push_back(std::move(row));
                     count++;
                     it->Next();
                 }
                 
-                delete it;
-                result["rows"] = rows;
-                result["success"] = true;
-                result["count"] = count;
+                if (!it->status().ok()) {
+                    result["success"] = false;
+                    result["error"] = it->status().ToString();
+                } else {
+                    result["rows"] = rows;
+                    result["success"] = true;
+                    result["count"] = count;
+                }
                 
             } else if (operation == "exists") {
+                // The bloom filter answers most misses without touching a data block
                 std::string value;
-                rocksdb::Status status = db->Get(rocksdb::ReadOptions(), key, &value);
+                bool exists = false;
+                if (db->KeyMayExist(rocksdb::ReadOptions(), family, key, &value)) {
+                    rocksdb::PinnableSlice pinned;
+                    exists = db->Get(rocksdb::ReadOptions(), family, key, &pinned).ok();
+                }
                 result["success"] = true;
-                result["exists"] = status.ok();
+                result["exists"] = exists;
                 
             } else if (operation == "get_multi") {
-                // Get multiple keys
+                // Batched MultiGet: RocksDB looks the keys up together, so
+                // filter and data block reads are shared across the batch
                 std::vector<std::string> keys = queryJson.value("keys", std::vector<std::string>());
-                std::vector<rocksdb::Slice> keySlices;
-                std::vector<std::string> values;
-                std::vector<rocksdb::Status> statuses;
+                std::vector<rocksdb::Slice> keySlices(keys.begin(), keys.end());
+                std::vector<rocksdb::PinnableSlice> values(keys.size());
+                std::vector<rocksdb::Status> statuses(keys.size());
                 
-                for (const auto& k : keys) {
-                    keySlices.emplace_back(k);
-                }
-                
-                statuses = db->MultiGet(rocksdb::ReadOptions(), keySlices, &values);
+                db->MultiGet(rocksdb::ReadOptions(), family, keys.size(), keySlices.data(),
+                             values.data(), statuses.data());
                 
                 json rows = json::array();
                 for (size_t i = 0; i < keys.size(); i++) {
                     json row;
                     row["key"] = keys[i];
                     if (statuses[i].ok()) {
-                        row["value"] = values[i];
+                        row["value"] = values[i].ToString();
                         row["found"] = true;
                     } else {
                         row["value"] = "";
                         row["found"] = false;
                     }
-                    rows.push_back(row);
+                    rows.push_back(std::move(row));
                 }
                 
                 result["rows"] = rows;
                 result["success"] = true;
                 
-            } else if (operation == "put_multi") {
-                // Put multiple key-value pairs
-                json keyValues = queryJson.value("key_values", json::object());
-                rocksdb::WriteBatch batch;
-                
-                for (const auto& [k, v] : keyValues.items()) {
-                    batch.Put(k, v.dump());
-                }
-                
-                rocksdb::Status status = db->Write(rocksdb::WriteOptions(), &batch);
-                if (status.ok()) {
-                    result["success"] = true;
-                    result["affected_rows"] = keyValues.size();
-                } else {
-                    result["success"] = false;
-                    result["error"] = status.ToString();
-                }
-                
-            } else if (operation == "delete_multi") {
-                // Delete multiple keys
-                std::vector<std::string> keys = queryJson.value("keys", std::vector<std::string>());
-                rocksdb::WriteBatch batch;
-                
-                for (const auto& key : keys) {
-                    batch.Delete(key);
-                }
-                
-                rocksdb::Status status = db->Write(rocksdb::WriteOptions(), &batch);
-                if (status.ok()) {
-                    result["success"] = true;
-                    result["affected_rows"] = keys.size();
-                } else {
-                    result["success"] = false;
-                    result["error"] = status.ToString();
-                }
-                
             } else if (operation == "compact") {
-                // Compact the database
-                rocksdb::Status status = db->CompactRange(rocksdb::CompactRangeOptions(), nullptr, nullptr);
+                // Compact the column family
+                rocksdb::Status status = db->CompactRange(rocksdb::CompactRangeOptions(), family, nullptr, nullptr);
                 if (status.ok()) {
                     result["success"] = true;
                     result["message"] = "Database compaction completed";
@@ -1642,9 +2118,9 @@ private:
                 }
                 
             } else if (operation == "flush") {
-                // Flush memtable to disk
+                // Flush memtables of every family to disk
                 rocksdb::FlushOptions flushOptions;
-                rocksdb::Status status = db->Flush(flushOptions);
+                rocksdb::Status status = db->Flush(flushOptions, store->handles);
                 if (status.ok()) {
                     result["success"] = true;
                     result["message"] = "Database flush completed";
@@ -1657,7 +2133,7 @@ private:
                 // Get database properties
                 std::string property = queryJson.value("property", "rocksdb.stats");
                 std::string value;
-                bool success = db->GetProperty(property, &value);
+                bool success = db->GetProperty(family, property, &value);
                 if (success) {
                     result["success"] = true;
                     result["property"] = property;
@@ -1667,8 +2143,19 @@ private:
                     result["error"] = "Property not found or not supported";
                 }
                 
+            } else if (operation == "list_column_families") {
+                json names = json::array();
+                for (const auto* handle : store->handles) {
+                    names.push_back(handle->GetName());
+                }
+                result["success"] = true;
+                result["column_families"] = names;
+                result["block_cache_usage"] = store->blockCache->GetUsage();
+
             } else {
                 setLastError("Unsupported RocksDB operation: " + operation);
+                result["success"] = false;
+                result["error"] = "Unsupported RocksDB operation: " + operation;
                 return false;
             }
 
@@ -1681,41 +2168,19 @@ private:
 
     bool executeRocksDBTransaction(DatabaseConnection& conn, const std::vector<std::string>& queries, json& result) {
         try {
-            rocksdb::DB* db = static_cast<rocksdb::DB*>(conn.handle);
+            auto* store = static_cast<RocksDBStore*>(conn.handle);
             rocksdb::WriteBatch batch;
             int affectedRows = 0;
 
             for (const auto& query : queries) {
-                json queryJson = json::parse(query);
-                std::string operation = queryJson.value("operation", "");
-                std::string key = queryJson.value("key", "");
-
-                if (operation == "put") {
-                    std::string value = queryJson.value("value", "");
-                    batch.Put(key, value);
-                    affectedRows++;
-                } else if (operation == "delete") {
-                    batch.Delete(key);
-                    affectedRows++;
-                } else if (operation == "put_multi") {
-                    json keyValues = queryJson.value("key_values", json::object());
-                    for (const auto& [k, v] : keyValues.items()) {
-                        batch.Put(k, v.dump());
-                        affectedRows++;
-                    }
-                } else if (operation == "delete_multi") {
-                    std::vector<std::string> keys = queryJson.value("keys", std::vector<std::string>());
-                    for (const auto& k : keys) {
-                        batch.Delete(k);
-                        affectedRows++;
-                    }
-                } else {
-                    setLastError("Unsupported RocksDB transaction operation: " + operation);
+                if (!appendRocksDBWrite(*store, json::parse(query), batch, affectedRows)) {
+                    result["success"] = false;
+                    result["error"] = lastError_;
                     return false;
                 }
             }
 
-            rocksdb::Status status = db->Write(rocksdb::WriteOptions(), &batch);
+            rocksdb::Status status = store->db->Write(rocksdb::WriteOptions(), &batch);
             if (status.ok()) {
                 result["success"] = true;
                 result["affected_rows"] = affectedRows;
@@ -2109,6 +2574,21 @@ bool DatabaseManager::executeQuery(const std::string& id, const std::string& que
     return impl_->executeQuery(id, query, result);
 }
 
+bool DatabaseManager::executeQuery(const std::string& id, const std::string& query, const std::vector<QueryParam>& params,
+                                   json& result) {
+    return impl_->executeQuery(id, query, params, result);
+}
+
+bool DatabaseManager::streamQuery(const std::string& id, const std::string& query, const std::vector<QueryParam>& params,
+                                  const RowCallback& onRow) {
+    return impl_->streamQuery(id, query, params, onRow);
+}
+
+bool DatabaseManager::executeBatch(const std::string& id, const std::string& query,
+                                   const std::vector<std::vector<QueryParam>>& rows, json& result) {
+    return impl_->executeBatch(id, query, rows, result);
+}
+
 bool DatabaseManager::executeTransaction(const std::string& id, const std::vector<std::string>& queries, json& result) {
     return impl_->executeTransaction(id, queries, result);
 }
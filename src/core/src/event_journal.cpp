@@ -0,0 +1,734 @@
+/**
+ * @file event_journal.cpp
+ * @brief Append-only event journal behind EventManager::getEvents
+ * @copyright Copyright (c) 2025 Satoxcoin Core Developers
+ * @license MIT License
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "satox/core/event_journal.hpp"
+#include <algorithm>
+#include <array>
+#include <cctype>
+#include <cerrno>
+#include <cinttypes>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace satox::core {
+
+namespace {
+
+constexpr size_t kRecordHeaderSize = 8;  // u32 length | u32 crc32
+constexpr size_t kBodyFixedSize = 30;    // sequence .. data length
+constexpr size_t kSequenceOffset = kRecordHeaderSize;
+
+void putLE(uint8_t* out, uint64_t value, int bytes) {
+    for (int i = 0; i < bytes; ++i) {
+        out[i] = static_cast<uint8_t>(value >> (8 * i));
+    }
+}
+
+uint64_t getLE(const uint8_t* p, int bytes) {
+    uint64_t value = 0;
+    for (int i = bytes - 1; i >= 0; --i) {
+        value = value << 8 | p[i];
+    }
+    return value;
+}
+
+uint32_t crc32(const uint8_t* data, size_t size) {
+    static const auto table = [] {
+        std::array<uint32_t, 256> t{};
+        for (uint32_t i = 0; i < 256; ++i) {
+            uint32_t c = i;
+            for (int k = 0; k < 8; ++k) {
+                c = (c & 1) ? 0xEDB88320u ^ (c >> 1) : c >> 1;
+            }
+            t[i] = c;
+        }
+        return t;
+    }();
+    uint32_t crc = ~0u;
+    for (size_t i = 0; i < size; ++i) {
+        crc = table[(crc ^ data[i]) & 0xFF] ^ (crc >> 8);
+    }
+    return ~crc;
+}
+
+// `written` counts the bytes that reached the file, including on failure
+bool writeAll(int fd, const uint8_t* data, size_t size, size_t& written) {
+    written = 0;
+    while (written < size) {
+        ssize_t n = ::write(fd, data + written, size - written);
+        if (n < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            return false;
+        }
+        written += static_cast<size_t>(n);
+    }
+    return true;
+}
+
+bool writeAll(int fd, const uint8_t* data, size_t size) {
+    size_t written;
+    return writeAll(fd, data, size, written);
+}
+
+// Makes a rename or unlink in `directory` durable
+bool syncDirectory(const std::string& directory) {
+    int fd = ::open(directory.c_str(), O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+    if (fd < 0) {
+        return false;
+    }
+    bool ok = ::fsync(fd) == 0;
+    ::close(fd);
+    return ok;
+}
+
+int64_t toMicros(std::chrono::system_clock::time_point time) {
+    return std::chrono::duration_cast<std::chrono::microseconds>(time.time_since_epoch()).count();
+}
+
+std::chrono::system_clock::time_point fromMicros(int64_t micros) {
+    return std::chrono::system_clock::time_point(
+        std::chrono::duration_cast<std::chrono::system_clock::duration>(std::chrono::microseconds(micros)));
+}
+
+// Parses the body of a record whose length and checksum were already checked
+bool parseRecord(const uint8_t* body, size_t length, EventJournal::RecordView& record) {
+    if (length < kBodyFixedSize) {
+        return false;
+    }
+    size_t nameSize = getLE(body + 18, 2);
+    size_t sourceSize = getLE(body + 20, 2);
+    size_t correlationSize = getLE(body + 22, 2);
+    size_t traceSize = getLE(body + 24, 2);
+    size_t dataSize = getLE(body + 26, 4);
+    if (kBodyFixedSize + nameSize + sourceSize + correlationSize + traceSize + dataSize != length) {
+        return false;
+    }
+
+    record.sequence = getLE(body, 8);
+    record.timestamp = fromMicros(static_cast<int64_t>(getLE(body + 8, 8)));
+    record.type = body[16];
+    record.priority = body[17];
+    const char* text = reinterpret_cast<const char*>(body + kBodyFixedSize);
+    record.name = std::string_view(text, nameSize);
+    text += nameSize;
+    record.source = std::string_view(text, sourceSize);
+    text += sourceSize;
+    record.correlationId = std::string_view(text, correlationSize);
+    text += correlationSize;
+    record.traceId = std::string_view(text, traceSize);
+    text += traceSize;
+    record.data = reinterpret_cast<const uint8_t*>(text);
+    record.dataSize = dataSize;
+    return true;
+}
+
+} // namespace
+
+EventJournal::~EventJournal() {
+    close();
+}
+
+std::string EventJournal::segmentPath(uint64_t firstSequence) const {
+    char name[40];
+    std::snprintf(name, sizeof(name), "events-%020" PRIu64 ".log", firstSequence);
+    return (std::filesystem::path(config_.directory) / name).string();
+}
+
+bool EventJournal::open(const Config& config, std::string& error) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (open_) {
+        error = "Event journal already open";
+        return false;
+    }
+    if (config.directory.empty() || config.segmentSize == 0) {
+        error = "Event journal needs a directory and a segment size";
+        return false;
+    }
+
+    std::error_code ec;
+    std::filesystem::create_directories(config.directory, ec);
+    if (ec) {
+        error = "Cannot create event journal directory: " + ec.message();
+        return false;
+    }
+    config_ = config;
+
+    std::map<uint64_t, std::string> files;
+    std::vector<std::string> stale;
+    for (const auto& entry : std::filesystem::directory_iterator(config_.directory, ec)) {
+        const std::string name = entry.path().filename().string();
+        if (name.size() < 31 || name.compare(0, 7, "events-") != 0 || name.compare(27, 4, ".log") != 0 ||
+            !std::all_of(name.begin() + 7, name.begin() + 27, [](unsigned char c) { return std::isdigit(c); })) {
+            continue;
+        }
+        if (name.size() == 31) {
+            files.emplace(std::stoull(name.substr(7, 20)), entry.path().string());
+        } else if (name.compare(31, std::string::npos, ".tmp") == 0) {
+            // A compaction that never reached its rename
+            stale.push_back(entry.path().string());
+        }
+    }
+
+    // A compaction interrupted after its rename leaves the segments it merged
+    // behind; their live records already sit in the earlier merged segment
+    uint64_t coveredThrough = 0;
+    segments_.clear();
+    for (const auto& [firstSequence, path] : files) {
+        if (firstSequence <= coveredThrough) {
+            stale.push_back(path);
+            continue;
+        }
+        Segment segment;
+        segment.firstSequence = firstSequence;
+        segment.path = path;
+        // Only the newest segment can hold a torn append
+        bool last = firstSequence == files.rbegin()->first;
+        if (!loadSegment(segment, last, error)) {
+            for (auto& loaded : segments_) {
+                unmapSegment(loaded);
+            }
+            segments_.clear();
+            return false;
+        }
+        coveredThrough = std::max(coveredThrough, segment.lastSequence);
+        segments_.push_back(std::move(segment));
+    }
+    if (!stale.empty()) {
+        for (const auto& path : stale) {
+            std::filesystem::remove(path, ec);
+        }
+        syncDirectory(config_.directory);
+    }
+
+    nextSequence_ = 1;
+    for (const auto& segment : segments_) {
+        nextSequence_ = std::max(nextSequence_, segment.lastSequence + 1);
+    }
+
+    bool reuseLast = !segments_.empty() && segments_.back().bytes < config_.segmentSize;
+    if (reuseLast) {
+        fd_ = ::open(segments_.back().path.c_str(), O_WRONLY | O_APPEND | O_CLOEXEC);
+        if (fd_ < 0) {
+            error = "Cannot open event journal segment: " + std::string(std::strerror(errno));
+            return false;
+        }
+    } else if (!openActive(nextSequence_, error)) {
+        return false;
+    }
+
+    pending_.clear();
+    lastFlush_ = std::chrono::steady_clock::now();
+    open_ = true;
+    return true;
+}
+
+void EventJournal::close() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (!open_) {
+        return;
+    }
+    writePending();
+    if (fd_ >= 0) {
+        ::fdatasync(fd_);
+        ::close(fd_);
+        fd_ = -1;
+    }
+    for (auto& segment : segments_) {
+        unmapSegment(segment);
+    }
+    segments_.clear();
+    open_ = false;
+}
+
+bool EventJournal::isOpen() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return open_;
+}
+
+bool EventJournal::loadSegment(Segment& segment, bool truncateTail, std::string& error) {
+    int fd = ::open(segment.path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        error = "Cannot open event journal segment: " + std::string(std::strerror(errno));
+        return false;
+    }
+    struct stat info;
+    size_t size = ::fstat(fd, &info) == 0 ? static_cast<size_t>(info.st_size) : 0;
+    ::close(fd);
+
+    segment.fileBytes = size;
+    if (!mapSegment(segment)) {
+        error = "Cannot map event journal segment " + segment.path;
+        return false;
+    }
+
+    size_t offset = 0;
+    RecordView record;
+    while (size - offset >= kRecordHeaderSize) {
+        const uint8_t* p = segment.mapping + offset;
+        size_t length = getLE(p, 4);
+        if (length > size - offset - kRecordHeaderSize ||
+            crc32(p + kRecordHeaderSize, length) != static_cast<uint32_t>(getLE(p + 4, 4)) ||
+            !parseRecord(p + kRecordHeaderSize, length, record)) {
+            break;
+        }
+        indexRecord(segment, record, offset);
+        offset += kRecordHeaderSize + length;
+    }
+
+    segment.bytes = segment.fileBytes = offset;
+    if (offset < size) {
+        // A sealed segment is never appended to, so keep what is valid and
+        // leave the file alone; the active one is cut back to its last good record
+        unmapSegment(segment);
+        if (truncateTail && ::truncate(segment.path.c_str(), static_cast<off_t>(offset)) != 0) {
+            error = "Cannot truncate event journal segment: " + std::string(std::strerror(errno));
+            return false;
+        }
+    }
+    sortIndexes(segment);
+    return true;
+}
+
+void EventJournal::indexRecord(Segment& segment, const RecordView& record, uint64_t offset) {
+    IndexEntry entry{toMicros(record.timestamp), offset};
+    if (!segment.timeIndex.empty() && entry.timestamp < segment.timeIndex.back().timestamp) {
+        segment.sorted = false;
+    }
+    segment.timeIndex.push_back(entry);
+    segment.typeIndex[record.type].push_back(entry);
+    segment.nameIndex[std::string(record.name)].push_back(entry);
+    segment.minTimestamp = std::min(segment.minTimestamp, entry.timestamp);
+    segment.maxTimestamp = std::max(segment.maxTimestamp, entry.timestamp);
+    segment.lastSequence = std::max(segment.lastSequence, record.sequence);
+    segment.records++;
+}
+
+void EventJournal::sortIndexes(Segment& segment) {
+    if (segment.sorted) {
+        return;
+    }
+    std::stable_sort(segment.timeIndex.begin(), segment.timeIndex.end());
+    for (auto& [type, entries] : segment.typeIndex) {
+        std::stable_sort(entries.begin(), entries.end());
+    }
+    for (auto& [name, entries] : segment.nameIndex) {
+        std::stable_sort(entries.begin(), entries.end());
+    }
+    segment.sorted = true;
+}
+
+bool EventJournal::openActive(uint64_t firstSequence, std::string& error) {
+    Segment segment;
+    segment.firstSequence = firstSequence;
+    segment.path = segmentPath(firstSequence);
+    int fd = ::open(segment.path.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_APPEND | O_CLOEXEC, 0644);
+    if (fd < 0) {
+        error = "Cannot create event journal segment: " + std::string(std::strerror(errno));
+        return false;
+    }
+    if (fd_ >= 0) {
+        ::close(fd_);
+    }
+    fd_ = fd;
+    segments_.push_back(std::move(segment));
+    return true;
+}
+
+bool EventJournal::writePending() {
+    if (pending_.empty()) {
+        return true;
+    }
+    // Whatever reached the file leaves pending_ even when the write fails
+    // part way, so a retry resumes after it instead of writing it twice
+    size_t written = 0;
+    bool ok = writeAll(fd_, pending_.data(), pending_.size(), written);
+    segments_.back().fileBytes += written;
+    pending_.erase(pending_.begin(), pending_.begin() + static_cast<std::ptrdiff_t>(written));
+    ok = ok && (!config_.syncOnFlush || ::fdatasync(fd_) == 0);
+    if (!ok) {
+        lastError_ = "Event journal write failed: " + std::string(std::strerror(errno));
+        return false;
+    }
+    lastFlush_ = std::chrono::steady_clock::now();
+    return true;
+}
+
+bool EventJournal::mapSegment(Segment& segment) {
+    if (segment.mappingSize >= segment.fileBytes) {
+        return true;
+    }
+    unmapSegment(segment);
+
+    int fd = ::open(segment.path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        return false;
+    }
+    void* mapping = ::mmap(nullptr, segment.fileBytes, PROT_READ, MAP_SHARED, fd, 0);
+    ::close(fd);
+    if (mapping == MAP_FAILED) {
+        return false;
+    }
+    segment.mapping = static_cast<const uint8_t*>(mapping);
+    segment.mappingSize = segment.fileBytes;
+    return true;
+}
+
+void EventJournal::unmapSegment(Segment& segment) {
+    if (segment.mapping) {
+        ::munmap(const_cast<uint8_t*>(segment.mapping), segment.mappingSize);
+    }
+    segment.mapping = nullptr;
+    segment.mappingSize = 0;
+}
+
+uint64_t EventJournal::append(const RecordView& record) {
+    if (record.name.size() > UINT16_MAX || record.source.size() > UINT16_MAX ||
+        record.correlationId.size() > UINT16_MAX || record.traceId.size() > UINT16_MAX ||
+        record.dataSize > UINT32_MAX) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        lastError_ = "Event too large for the journal";
+        return 0;
+    }
+
+    // Encode outside the lock; the sequence and checksum are filled in below
+    size_t length = kBodyFixedSize + record.name.size() + record.source.size() +
+                    record.correlationId.size() + record.traceId.size() + record.dataSize;
+    std::vector<uint8_t> encoded(kRecordHeaderSize + length);
+    uint8_t* body = encoded.data() + kRecordHeaderSize;
+    putLE(encoded.data(), length, 4);
+    putLE(body + 8, static_cast<uint64_t>(toMicros(record.timestamp)), 8);
+    body[16] = record.type;
+    body[17] = record.priority;
+    putLE(body + 18, record.name.size(), 2);
+    putLE(body + 20, record.source.size(), 2);
+    putLE(body + 22, record.correlationId.size(), 2);
+    putLE(body + 24, record.traceId.size(), 2);
+    putLE(body + 26, record.dataSize, 4);
+    uint8_t* out = body + kBodyFixedSize;
+    for (std::string_view text : {record.name, record.source, record.correlationId, record.traceId}) {
+        if (!text.empty()) {
+            std::memcpy(out, text.data(), text.size());
+            out += text.size();
+        }
+    }
+    if (record.dataSize > 0) {
+        std::memcpy(out, record.data, record.dataSize);
+    }
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (!open_) {
+        lastError_ = "Event journal not open";
+        return 0;
+    }
+
+    Segment* active = &segments_.back();
+    if (active->bytes > 0 && active->bytes + encoded.size() > config_.segmentSize) {
+        std::string error;
+        if (!writePending() || !openActive(nextSequence_, error)) {
+            if (!error.empty()) {
+                lastError_ = error;
+            }
+            return 0;
+        }
+        active = &segments_.back();
+        applyRetentionLocked();
+        active = &segments_.back();
+    }
+
+    uint64_t sequence = nextSequence_++;
+    putLE(encoded.data() + kSequenceOffset, sequence, 8);
+    putLE(encoded.data() + 4, crc32(body, length), 4);
+
+    RecordView stored = record;
+    stored.sequence = sequence;
+    indexRecord(*active, stored, active->bytes);
+    active->bytes += encoded.size();
+    pending_.insert(pending_.end(), encoded.begin(), encoded.end());
+
+    if (pending_.size() >= config_.flushBytes ||
+        std::chrono::steady_clock::now() - lastFlush_ >= config_.flushInterval) {
+        writePending();
+    }
+    return sequence;
+}
+
+bool EventJournal::flush() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return open_ && writePending();
+}
+
+void EventJournal::replay(std::chrono::system_clock::time_point start,
+                          std::chrono::system_clock::time_point end,
+                          const RecordVisitor& visitor) {
+    replayIndexed([](const Segment& segment) { return &segment.timeIndex; },
+                  toMicros(start), toMicros(end), visitor);
+}
+
+void EventJournal::replayType(uint8_t type,
+                              std::chrono::system_clock::time_point start,
+                              std::chrono::system_clock::time_point end,
+                              const RecordVisitor& visitor) {
+    replayIndexed([type](const Segment& segment) -> const std::vector<IndexEntry>* {
+                      auto it = segment.typeIndex.find(type);
+                      return it == segment.typeIndex.end() ? nullptr : &it->second;
+                  },
+                  toMicros(start), toMicros(end), visitor);
+}
+
+void EventJournal::replayName(const std::string& name,
+                              std::chrono::system_clock::time_point start,
+                              std::chrono::system_clock::time_point end,
+                              const RecordVisitor& visitor) {
+    replayIndexed([&name](const Segment& segment) -> const std::vector<IndexEntry>* {
+                      auto it = segment.nameIndex.find(name);
+                      return it == segment.nameIndex.end() ? nullptr : &it->second;
+                  },
+                  toMicros(start), toMicros(end), visitor);
+}
+
+// Visitors run under the journal lock and must not call back into it
+void EventJournal::replayIndexed(const IndexSelector& select, int64_t start, int64_t end,
+                                 const RecordVisitor& visitor) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (!open_) {
+        return;
+    }
+    // If the write fails the unwritten tail of the active segment is still
+    // in pending_ and is read from there
+    writePending();
+
+    for (auto& segment : segments_) {
+        if (segment.records == 0 || segment.maxTimestamp < start || segment.minTimestamp > end) {
+            continue;
+        }
+        sortIndexes(segment);
+        const auto* entries = select(segment);
+        if (!entries || (segment.fileBytes > 0 && !mapSegment(segment))) {
+            continue;
+        }
+
+        auto first = std::lower_bound(entries->begin(), entries->end(), IndexEntry{start, 0});
+        auto last = std::upper_bound(entries->begin(), entries->end(), IndexEntry{end, 0});
+        RecordView record;
+        for (auto it = first; it != last; ++it) {
+            const uint8_t* p = it->offset < segment.fileBytes
+                ? segment.mapping + it->offset
+                : pending_.data() + (it->offset - segment.fileBytes);
+            if (!parseRecord(p + kRecordHeaderSize, getLE(p, 4), record)) {
+                continue;
+            }
+            if (!visitor(record)) {
+                return;
+            }
+        }
+    }
+}
+
+void EventJournal::applyRetention() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (open_) {
+        applyRetentionLocked();
+    }
+}
+
+void EventJournal::applyRetentionLocked() {
+    if (config_.maxAge.count() > 0) {
+        int64_t cutoff = toMicros(std::chrono::system_clock::now() - config_.maxAge);
+        while (segments_.size() > 1 && segments_.front().maxTimestamp < cutoff) {
+            removeSegment(0);
+        }
+    }
+    if (config_.maxBytes > 0) {
+        size_t total = 0;
+        for (const auto& segment : segments_) {
+            total += segment.bytes;
+        }
+        while (segments_.size() > 1 && total > config_.maxBytes) {
+            total -= segments_.front().bytes;
+            removeSegment(0);
+        }
+    }
+}
+
+void EventJournal::removeSegment(size_t index) {
+    unmapSegment(segments_[index]);
+    std::error_code ignored;
+    std::filesystem::remove(segments_[index].path, ignored);
+    segments_.erase(segments_.begin() + static_cast<std::ptrdiff_t>(index));
+}
+
+bool EventJournal::compact(std::string& error) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (!open_) {
+        error = "Event journal not open";
+        return false;
+    }
+    applyRetentionLocked();
+
+    int64_t cutoff = config_.maxAge.count() > 0
+        ? toMicros(std::chrono::system_clock::now() - config_.maxAge)
+        : INT64_MIN;
+
+    // Sealed segments only; the active one keeps taking appends
+    std::vector<Segment> compacted;
+    size_t sealed = segments_.size() - 1;
+    size_t i = 0;
+    while (i < sealed) {
+        size_t groupEnd = i + 1;
+        size_t groupBytes = segments_[i].bytes;
+        while (groupEnd < sealed && groupBytes + segments_[groupEnd].bytes <= config_.segmentSize) {
+            groupBytes += segments_[groupEnd].bytes;
+            groupEnd++;
+        }
+        bool expired = segments_[i].minTimestamp < cutoff;
+        for (size_t j = i + 1; j < groupEnd; ++j) {
+            expired = expired || segments_[j].minTimestamp < cutoff;
+        }
+        if (groupEnd == i + 1 && !expired) {
+            compacted.push_back(std::move(segments_[i]));
+            i = groupEnd;
+            continue;
+        }
+
+        // Copy the live records verbatim, in file order, into one new file
+        std::string target = segments_[i].path;
+        std::string temporary = target + ".tmp";
+        int fd = ::open(temporary.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+        if (fd < 0) {
+            error = "Cannot create compacted segment: " + std::string(std::strerror(errno));
+            for (size_t j = i; j < segments_.size(); ++j) {
+                compacted.push_back(std::move(segments_[j]));
+            }
+            segments_ = std::move(compacted);
+            return false;
+        }
+
+        std::vector<uint8_t> buffer;
+        bool ok = true;
+        size_t live = 0;
+        for (size_t j = i; j < groupEnd && ok; ++j) {
+            Segment& segment = segments_[j];
+            if (!mapSegment(segment)) {
+                ok = false;
+                break;
+            }
+            for (size_t offset = 0; offset < segment.fileBytes;) {
+                const uint8_t* p = segment.mapping + offset;
+                size_t recordSize = kRecordHeaderSize + getLE(p, 4);
+                if (static_cast<int64_t>(getLE(p + kRecordHeaderSize + 8, 8)) >= cutoff) {
+                    buffer.insert(buffer.end(), p, p + recordSize);
+                    live++;
+                }
+                offset += recordSize;
+                if (buffer.size() >= (1 << 20)) {
+                    ok = writeAll(fd, buffer.data(), buffer.size());
+                    buffer.clear();
+                }
+            }
+        }
+        ok = ok && writeAll(fd, buffer.data(), buffer.size()) && ::fsync(fd) == 0;
+        ::close(fd);
+
+        // Index the new file before anything on disk changes, so a failure
+        // up to the rename leaves the journal exactly as it was
+        Segment merged;
+        merged.firstSequence = segments_[i].firstSequence;
+        merged.path = temporary;
+        std::error_code ec;
+        if (!ok) {
+            error = "Cannot write compacted segment";
+        } else if (live > 0 && !loadSegment(merged, false, error)) {
+            ok = false;
+        } else if (live > 0) {
+            std::filesystem::rename(temporary, target, ec);
+            if (ec) {
+                error = "Cannot install compacted segment: " + ec.message();
+                ok = false;
+            }
+        }
+        if (!ok) {
+            unmapSegment(merged);
+            std::filesystem::remove(temporary, ec);
+            for (size_t j = i; j < segments_.size(); ++j) {
+                compacted.push_back(std::move(segments_[j]));
+            }
+            segments_ = std::move(compacted);
+            return false;
+        }
+
+        // The target now holds every live record of the group, so only
+        // after the rename are the segments it supersedes unlinked
+        for (size_t j = i; j < groupEnd; ++j) {
+            unmapSegment(segments_[j]);
+            if (j > i || live == 0) {
+                std::filesystem::remove(segments_[j].path, ec);
+            }
+        }
+        if (live == 0) {
+            std::filesystem::remove(temporary, ec);
+        } else {
+            merged.path = target;
+            compacted.push_back(std::move(merged));
+        }
+        syncDirectory(config_.directory);
+        i = groupEnd;
+    }
+
+    compacted.push_back(std::move(segments_.back()));
+    segments_ = std::move(compacted);
+    return true;
+}
+
+size_t EventJournal::getRecordCount() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    size_t count = 0;
+    for (const auto& segment : segments_) {
+        count += segment.records;
+    }
+    return count;
+}
+
+size_t EventJournal::getSizeBytes() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    size_t bytes = 0;
+    for (const auto& segment : segments_) {
+        bytes += segment.bytes;
+    }
+    return bytes;
+}
+
+std::string EventJournal::getLastError() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return lastError_;
+}
+
+} // namespace satox::core
@@ -23,7 +23,6 @@
  * SOFTWARE.
  */
 
-#include <future>
 #include "satox/core/event_manager.hpp"
 #include <algorithm>
 #include <chrono>
@@ -34,11 +33,69 @@
 
 namespace satox::core {
 
+EventManager::EventRing::EventRing(size_t capacity) {
+    size_t size = 2;
+    while (size < capacity) {
+        size <<= 1;
+    }
+    cells_ = std::make_unique<Cell[]>(size);
+    mask_ = size - 1;
+    for (size_t i = 0; i < size; ++i) {
+        cells_[i].sequence.store(i, std::memory_order_relaxed);
+    }
+}
+
+bool EventManager::EventRing::push(Event&& event) {
+    size_t position = tail_.load(std::memory_order_relaxed);
+    for (;;) {
+        Cell& cell = cells_[position & mask_];
+        size_t sequence = cell.sequence.load(std::memory_order_acquire);
+        intptr_t diff = static_cast<intptr_t>(sequence) - static_cast<intptr_t>(position);
+        if (diff == 0) {
+            if (tail_.compare_exchange_weak(position, position + 1, std::memory_order_relaxed)) {
+                cell.event = std::move(event);
+                cell.sequence.store(position + 1, std::memory_order_release);
+                return true;
+            }
+        } else if (diff < 0) {
+            return false;  // full
+        } else {
+            position = tail_.load(std::memory_order_relaxed);
+        }
+    }
+}
+
+bool EventManager::EventRing::pop(Event& event) {
+    size_t position = head_.load(std::memory_order_relaxed);
+    for (;;) {
+        Cell& cell = cells_[position & mask_];
+        size_t sequence = cell.sequence.load(std::memory_order_acquire);
+        intptr_t diff = static_cast<intptr_t>(sequence) - static_cast<intptr_t>(position + 1);
+        if (diff == 0) {
+            if (head_.compare_exchange_weak(position, position + 1, std::memory_order_relaxed)) {
+                event = std::move(cell.event);
+                cell.event = Event{};  // drop the moved-from payload now, not on slot reuse
+                cell.sequence.store(position + mask_ + 1, std::memory_order_release);
+                return true;
+            }
+        } else if (diff < 0) {
+            return false;  // empty
+        } else {
+            position = head_.load(std::memory_order_relaxed);
+        }
+    }
+}
+
 EventManager& EventManager::getInstance() {
     static EventManager instance;
     return instance;
 }
 
+EventManager::~EventManager() {
+    disableJournal();
+    shutdown();
+}
+
 bool EventManager::initialize(size_t maxQueueSize, size_t numWorkers) {
     std::lock_guard<std::mutex> lock(mutex_);
     
@@ -46,8 +103,18 @@ bool EventManager::initialize(size_t maxQueueSize, size_t numWorkers) {
         lastError_ = "EventManager already initialized";
         return false;
     }
+    if (maxQueueSize == 0 || numWorkers == 0) {
+        lastError_ = "Queue size and worker count must be non-zero";
+        return false;
+    }
     
+    // Each ring can hold the whole budget, so a reserved slot always finds room
     maxQueueSize_ = maxQueueSize;
+    for (auto& queue : queues_) {
+        queue = std::make_unique<EventRing>(maxQueueSize);
+    }
+    queuedEvents_ = 0;
+    availableEvents_ = 0;
     running_ = true;
     
     // Start worker threads
@@ -61,24 +128,43 @@ bool EventManager::initialize(size_t maxQueueSize, size_t numWorkers) {
 }
 
 void EventManager::shutdown() {
-    std::lock_guard<std::mutex> lock(mutex_);
-    
-    if (!initialized_) {
-        return;
+    std::vector<std::thread> workers;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (!initialized_) {
+            return;
+        }
+        initialized_ = false;
+        running_ = false;
+        workers.swap(workers_);
+    }
+    {
+        std::lock_guard<std::mutex> wakeLock(wakeMutex_);
+        condition_.notify_all();
     }
     
-    running_ = false;
-    condition_.notify_all();
-    
-    // Wait for worker threads to finish
-    for (auto& worker : workers_) {
+    // Wait for worker threads to finish; they may still be dispatching
+    for (auto& worker : workers) {
         if (worker.joinable()) {
             worker.join();
         }
     }
     
-    workers_.clear();
-    initialized_ = false;
+    // Events still queued are dropped
+    Event event;
+    for (auto& queue : queues_) {
+        while (queue->pop(event)) {
+        }
+    }
+    queuedEvents_ = 0;
+    availableEvents_ = 0;
+    
+    // Handlers often capture state that does not outlive the session
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        cleanupSubscriptions();
+        cleanupFilters();
+    }
     spdlog::info("EventManager shutdown complete");
 }
 
@@ -86,6 +172,17 @@ EventManager::SubscriptionToken EventManager::generateToken() {
     return nextToken_++;
 }
 
+std::shared_ptr<const EventManager::SubscriptionTable> EventManager::subscriptions() const {
+    return std::atomic_load(&subscriptions_);
+}
+
+// Copy-on-write; callers hold mutex_, so writers never lose each other's changes
+void EventManager::updateSubscriptions(const std::function<void(SubscriptionTable&)>& update) {
+    auto table = std::make_shared<SubscriptionTable>(*subscriptions_);
+    update(*table);
+    std::atomic_store(&subscriptions_, std::shared_ptr<const SubscriptionTable>(std::move(table)));
+}
+
 EventManager::SubscriptionToken EventManager::subscribe(EventType type, EventHandler handler,
                                         bool async, std::chrono::milliseconds timeout) {
     std::lock_guard<std::mutex> lock(mutex_);
@@ -96,8 +193,10 @@ EventManager::SubscriptionToken EventManager::subscribe(EventType type, EventHan
     }
     
     SubscriptionToken token = generateToken();
-    Subscription subscription{token, handler, nullptr, async, timeout};
-    typeSubscriptions_[type].push_back(subscription);
+    Subscription subscription{token, std::move(handler), nullptr, async, timeout};
+    updateSubscriptions([&](SubscriptionTable& table) {
+        table.typeSubscriptions[type].push_back(std::move(subscription));
+    });
     
     spdlog::debug("Event subscription created for type {} with token {}", 
                   static_cast<int>(type), token);
@@ -115,8 +214,11 @@ EventManager::SubscriptionToken EventManager::subscribe(EventType type, const st
     }
     
     SubscriptionToken token = generateToken();
-    Subscription subscription{token, handler, nullptr, async, timeout};
-    nameSubscriptions_[name].push_back(subscription);
+    EventFilter sameType = [type](const Event& event) { return event.type == type; };
+    Subscription subscription{token, std::move(handler), std::move(sameType), async, timeout};
+    updateSubscriptions([&](SubscriptionTable& table) {
+        table.nameSubscriptions[name].push_back(std::move(subscription));
+    });
     
     spdlog::debug("Event subscription created for name '{}' with token {}", name, token);
     return token;
@@ -132,8 +234,10 @@ EventManager::SubscriptionToken EventManager::subscribe(EventFilter filter, Even
     }
     
     SubscriptionToken token = generateToken();
-    Subscription subscription{token, handler, filter, async, timeout};
-    filterSubscriptions_.push_back(subscription);
+    Subscription subscription{token, std::move(handler), std::move(filter), async, timeout};
+    updateSubscriptions([&](SubscriptionTable& table) {
+        table.filterSubscriptions.push_back(std::move(subscription));
+    });
     
     spdlog::debug("Event subscription created with filter and token {}", token);
     return token;
@@ -147,33 +251,23 @@ bool EventManager::unsubscribe(SubscriptionToken token) {
         return false;
     }
     
-    // Remove from type subscriptions
-    for (auto& [type, subscriptions] : typeSubscriptions_) {
+    auto removeToken = [token](std::vector<Subscription>& subscriptions) {
         subscriptions.erase(
             std::remove_if(subscriptions.begin(), subscriptions.end(),
                           [token](const Subscription& sub) {
                               return sub.token == token;
                           }),
             subscriptions.end());
-    }
-    
-    // Remove from name subscriptions
-    for (auto& [name, subscriptions] : nameSubscriptions_) {
-        subscriptions.erase(
-            std::remove_if(subscriptions.begin(), subscriptions.end(),
-                          [token](const Subscription& sub) {
-                              return sub.token == token;
-                          }),
-            subscriptions.end());
-    }
-    
-    // Remove from filter subscriptions
-    filterSubscriptions_.erase(
-        std::remove_if(filterSubscriptions_.begin(), filterSubscriptions_.end(),
-                      [token](const Subscription& sub) {
-                          return sub.token == token;
-                      }),
-        filterSubscriptions_.end());
+    };
+    updateSubscriptions([&](SubscriptionTable& table) {
+        for (auto& [type, subscriptions] : table.typeSubscriptions) {
+            removeToken(subscriptions);
+        }
+        for (auto& [name, subscriptions] : table.nameSubscriptions) {
+            removeToken(subscriptions);
+        }
+        removeToken(table.filterSubscriptions);
+    });
     
     spdlog::debug("Event subscription with token {} removed", token);
     return true;
@@ -183,10 +277,11 @@ bool EventManager::unsubscribe(SubscriptionToken token) {
 void EventManager::unsubscribe(EventType type, EventHandler handler) {
     std::lock_guard<std::mutex> lock(mutex_);
     
-    auto it = typeSubscriptions_.find(type);
-    if (it != typeSubscriptions_.end()) {
+    if (subscriptions_->typeSubscriptions.count(type)) {
         // Remove all subscriptions for this type (legacy behavior)
-        it->second.clear();
+        updateSubscriptions([type](SubscriptionTable& table) {
+            table.typeSubscriptions[type].clear();
+        });
         spdlog::warn("Legacy unsubscribe called for type {} - all subscriptions removed", 
                      static_cast<int>(type));
     }
@@ -195,10 +290,11 @@ void EventManager::unsubscribe(EventType type, EventHandler handler) {
 void EventManager::unsubscribe(EventType type, const std::string& name, EventHandler handler) {
     std::lock_guard<std::mutex> lock(mutex_);
     
-    auto it = nameSubscriptions_.find(name);
-    if (it != nameSubscriptions_.end()) {
+    if (subscriptions_->nameSubscriptions.count(name)) {
         // Remove all subscriptions for this name (legacy behavior)
-        it->second.clear();
+        updateSubscriptions([&name](SubscriptionTable& table) {
+            table.nameSubscriptions[name].clear();
+        });
         spdlog::warn("Legacy unsubscribe called for name '{}' - all subscriptions removed", name);
     }
 }
@@ -207,65 +303,83 @@ void EventManager::unsubscribe(EventFilter filter, EventHandler handler) {
     std::lock_guard<std::mutex> lock(mutex_);
     
     // Remove all filter subscriptions (legacy behavior)
-    filterSubscriptions_.clear();
+    updateSubscriptions([](SubscriptionTable& table) {
+        table.filterSubscriptions.clear();
+    });
     spdlog::warn("Legacy unsubscribe called for filter - all filter subscriptions removed");
 }
 
 bool EventManager::publishEvent(const Event& event) {
+    return publishEvent(Event(event));
+}
+
+bool EventManager::publishEvent(Event&& event) {
     if (!initialized_) {
-        lastError_ = "EventManager not initialized";
+        setLastError("EventManager not initialized");
         return false;
     }
     
     if (!validateEvent(event)) {
+        setLastError("Invalid event");
         return false;
     }
     
-    std::lock_guard<std::mutex> lock(mutex_);
-    
-    if (eventQueue_.size() >= maxQueueSize_) {
-        lastError_ = "Event queue is full";
+    // Reserve a slot against the shared budget before touching a ring
+    if (queuedEvents_.fetch_add(1) >= maxQueueSize_) {
+        queuedEvents_.fetch_sub(1);
+        setLastError("Event queue is full");
         return false;
     }
     
-    eventQueue_.push(event);
-    condition_.notify_one();
+    spdlog::debug("Event published: type={}, name='{}', source='{}'", 
+                  static_cast<int>(event.type), event.name, event.source);
+    
+    if (getJournal()) {
+        queueForJournal(event);
+    }
+    queues_[static_cast<size_t>(event.priority)]->push(std::move(event));
+    availableEvents_.fetch_add(1);
+    if (sleepingWorkers_.load() > 0) {
+        std::lock_guard<std::mutex> wakeLock(wakeMutex_);
+        condition_.notify_one();
+    }
     
     if (statsEnabled_) {
+        std::lock_guard<std::mutex> statsLock(statsMutex_);
         stats_.totalEvents++;
-        stats_.queuedEvents++;
     }
-    
-    spdlog::debug("Event published: type={}, name='{}', source='{}'", 
-                  static_cast<int>(event.type), event.name, event.source);
     return true;
 }
 
 bool EventManager::publishEvent(EventType type, const std::string& name,
-                               const nlohmann::json& data, Priority priority) {
+                               nlohmann::json data, Priority priority) {
     Event event;
     event.type = type;
     event.name = name;
     event.source = "EventManager";
     event.priority = priority;
     event.timestamp = std::chrono::system_clock::now();
-    event.data = data;
+    event.data = std::move(data);
     
-    return publishEvent(event);
+    return publishEvent(std::move(event));
 }
 
 bool EventManager::publishEventAsync(const Event& event) {
     return publishEvent(event);
 }
 
+bool EventManager::publishEventAsync(Event&& event) {
+    return publishEvent(std::move(event));
+}
+
 bool EventManager::publishEventAsync(EventType type, const std::string& name,
-                                    const nlohmann::json& data, Priority priority) {
-    return publishEvent(type, name, data, priority);
+                                    nlohmann::json data, Priority priority) {
+    return publishEvent(type, name, std::move(data), priority);
 }
 
 bool EventManager::processEvent(const Event& event) {
     if (!initialized_) {
-        lastError_ = "EventManager not initialized";
+        setLastError("EventManager not initialized");
         return false;
     }
     
@@ -273,40 +387,42 @@ bool EventManager::processEvent(const Event& event) {
         return false;
     }
     
-    std::lock_guard<std::mutex> lock(mutex_);
+    // Dispatch from a snapshot: no lock is held while handlers run
+    auto table = subscriptions();
+    if (!passesFilters(event, *table)) {
+        return true;
+    }
+    
+    auto dispatch = [&](const Subscription& subscription) {
+        if (subscription.async) {
+            handleEventAsync(event, subscription);
+        } else {
+            handleEvent(event, subscription);
+        }
+    };
     
     // Process type subscriptions
-    auto typeIt = typeSubscriptions_.find(event.type);
-    if (typeIt != typeSubscriptions_.end()) {
+    auto typeIt = table->typeSubscriptions.find(event.type);
+    if (typeIt != table->typeSubscriptions.end()) {
         for (const auto& subscription : typeIt->second) {
-            if (subscription.async) {
-                handleEventAsync(event, subscription);
-            } else {
-                handleEvent(event, subscription);
-            }
+            dispatch(subscription);
         }
     }
     
     // Process name subscriptions
-    auto nameIt = nameSubscriptions_.find(event.name);
-    if (nameIt != nameSubscriptions_.end()) {
+    auto nameIt = table->nameSubscriptions.find(event.name);
+    if (nameIt != table->nameSubscriptions.end()) {
         for (const auto& subscription : nameIt->second) {
-            if (subscription.async) {
-                handleEventAsync(event, subscription);
-            } else {
-                handleEvent(event, subscription);
+            if (matchEvent(event, subscription)) {
+                dispatch(subscription);
             }
         }
     }
     
     // Process filter subscriptions
-    for (const auto& subscription : filterSubscriptions_) {
+    for (const auto& subscription : table->filterSubscriptions) {
         if (matchEvent(event, subscription)) {
-            if (subscription.async) {
-                handleEventAsync(event, subscription);
-            } else {
-                handleEvent(event, subscription);
-            }
+            dispatch(subscription);
         }
     }
     
@@ -317,29 +433,39 @@ bool EventManager::processEventAsync(const Event& event) {
     return processEvent(event);
 }
 
+bool EventManager::popEvent(Event& event) {
+    // Highest priority first, except that every STARVATION_INTERVAL-th pop
+    // goes to the levels below CRITICAL, starting at LOW, NORMAL or HIGH in turn
+    size_t tick = popTick_.fetch_add(1, std::memory_order_relaxed);
+    if (tick % STARVATION_INTERVAL == 0) {
+        size_t first = (tick / STARVATION_INTERVAL) % (PRIORITY_LEVELS - 1);
+        for (size_t i = 0; i < PRIORITY_LEVELS - 1; ++i) {
+            if (queues_[(first + i) % (PRIORITY_LEVELS - 1)]->pop(event)) {
+                return true;
+            }
+        }
+    }
+    for (size_t level = PRIORITY_LEVELS; level-- > 0;) {
+        if (queues_[level]->pop(event)) {
+            return true;
+        }
+    }
+    return false;
+}
+
 void EventManager::processEvents() {
+    Event event;
     while (running_) {
-        Event event;
-        {
-            std::unique_lock<std::mutex> lock(mutex_);
-            condition_.wait(lock, [this] { return !eventQueue_.empty() || !running_; });
-            
-            if (!running_) {
-                break;
-            }
-            
-            if (eventQueue_.empty()) {
-                continue;
-            }
-            
-            event = eventQueue_.front();
-            eventQueue_.pop();
-            
-            if (statsEnabled_) {
-                stats_.queuedEvents--;
-            }
+        if (!popEvent(event)) {
+            std::unique_lock<std::mutex> lock(wakeMutex_);
+            sleepingWorkers_.fetch_add(1);
+            condition_.wait(lock, [this] { return availableEvents_.load() > 0 || !running_; });
+            sleepingWorkers_.fetch_sub(1);
+            continue;
         }
         
+        availableEvents_.fetch_sub(1);
+        queuedEvents_.fetch_sub(1);
         processEvent(event);
     }
 }
@@ -349,77 +475,239 @@ void EventManager::workerThread() {
 }
 
 void EventManager::waitForEvents(std::chrono::milliseconds timeout) {
-    std::unique_lock<std::mutex> lock(mutex_);
+    std::unique_lock<std::mutex> lock(wakeMutex_);
+    sleepingWorkers_.fetch_add(1);
     if (timeout.count() > 0) {
-        condition_.wait_for(lock, timeout, [this] { return !eventQueue_.empty(); });
+        condition_.wait_for(lock, timeout, [this] { return availableEvents_.load() > 0; });
     } else {
-        condition_.wait(lock, [this] { return !eventQueue_.empty(); });
+        condition_.wait(lock, [this] { return availableEvents_.load() > 0; });
+    }
+    sleepingWorkers_.fetch_sub(1);
+}
+
+bool EventManager::enableJournal(const EventJournal::Config& config) {
+    auto journal = std::make_shared<EventJournal>();
+    std::string error;
+    if (!journal->open(config, error)) {
+        setLastError(error);
+        return false;
+    }
+    
+    // Events still queued for a previous journal go to it before it closes
+    drainJournalQueue();
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto previous = std::atomic_exchange(&journal_, journal);
+    if (previous) {
+        previous->close();
+    }
+    if (!journalWriter_.joinable()) {
+        {
+            std::lock_guard<std::mutex> queueLock(journalQueueMutex_);
+            journalStopping_ = false;
+        }
+        journalWriter_ = std::thread(&EventManager::journalWriterThread, this);
+    }
+    spdlog::info("Event journal enabled in {}", config.directory);
+    return true;
+}
+
+void EventManager::disableJournal() {
+    stopJournalWriter();
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto previous = std::atomic_exchange(&journal_, std::shared_ptr<EventJournal>());
+    if (previous) {
+        previous->close();
+    }
+}
+
+std::shared_ptr<EventJournal> EventManager::getJournal() const {
+    return std::atomic_load(&journal_);
+}
+
+void EventManager::queueForJournal(const Event& event) {
+    JournalRecord entry;
+    entry.timestamp = event.timestamp;
+    entry.type = static_cast<uint8_t>(event.type);
+    entry.priority = static_cast<uint8_t>(event.priority);
+    entry.name = event.name;
+    entry.source = event.source;
+    entry.correlationId = event.correlationId;
+    entry.traceId = event.traceId;
+    entry.data = nlohmann::json::to_cbor(event.data);
+    bool wasEmpty;
+    {
+        std::lock_guard<std::mutex> lock(journalQueueMutex_);
+        wasEmpty = journalQueue_.empty();
+        journalQueue_.push_back(std::move(entry));
+    }
+    if (wasEmpty) {
+        journalQueueCondition_.notify_one();
+    }
+}
+
+void EventManager::journalWriterThread() {
+    std::unique_lock<std::mutex> lock(journalQueueMutex_);
+    while (!journalStopping_) {
+        journalQueueCondition_.wait(lock, [this] { return journalStopping_ || !journalQueue_.empty(); });
+        lock.unlock();
+        drainJournalQueue();
+        lock.lock();
     }
 }
 
+// Appends everything queued so far; callers must not hold mutex_
+void EventManager::drainJournalQueue() {
+    std::lock_guard<std::mutex> writeLock(journalWriteMutex_);
+    std::vector<JournalRecord> batch;
+    {
+        std::lock_guard<std::mutex> lock(journalQueueMutex_);
+        batch.swap(journalQueue_);
+    }
+    for (const auto& entry : batch) {
+        journalEvent(entry);
+    }
+}
+
+void EventManager::stopJournalWriter() {
+    std::thread writer;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        writer.swap(journalWriter_);
+    }
+    {
+        std::lock_guard<std::mutex> lock(journalQueueMutex_);
+        journalStopping_ = true;
+    }
+    journalQueueCondition_.notify_all();
+    if (writer.joinable()) {
+        writer.join();
+    }
+    drainJournalQueue();
+}
+
+void EventManager::journalEvent(const JournalRecord& entry) {
+    auto journal = getJournal();
+    if (!journal) {
+        return;
+    }
+    
+    EventJournal::RecordView record;
+    record.timestamp = entry.timestamp;
+    record.type = entry.type;
+    record.priority = entry.priority;
+    record.name = entry.name;
+    record.source = entry.source;
+    record.correlationId = entry.correlationId;
+    record.traceId = entry.traceId;
+    record.data = entry.data.data();
+    record.dataSize = entry.data.size();
+    if (journal->append(record) == 0) {
+        setLastError("Event journal append failed: " + journal->getLastError());
+    }
+}
+
+EventManager::Event EventManager::decodeEvent(const EventJournal::RecordView& record) {
+    Event event;
+    event.type = static_cast<EventType>(record.type);
+    event.name = std::string(record.name);
+    event.source = std::string(record.source);
+    event.priority = static_cast<Priority>(record.priority);
+    event.timestamp = record.timestamp;
+    event.data = nlohmann::json::from_cbor(record.data, record.data + record.dataSize, true, false);
+    event.correlationId = std::string(record.correlationId);
+    event.traceId = std::string(record.traceId);
+    return event;
+}
+
 std::vector<EventManager::Event> EventManager::getEvents(EventType type,
                                          std::chrono::system_clock::time_point start,
                                          std::chrono::system_clock::time_point end) {
-    // This is a placeholder implementation
-    // In a real implementation, you would store events and filter them
-    return {};
+    std::vector<Event> events;
+    if (auto journal = getJournal()) {
+        drainJournalQueue();
+        journal->replayType(static_cast<uint8_t>(type), start, end, [&](const EventJournal::RecordView& record) {
+            events.push_back(decodeEvent(record));
+            return true;
+        });
+    }
+    return events;
 }
 
 std::vector<EventManager::Event> EventManager::getEvents(const std::string& name,
                                          std::chrono::system_clock::time_point start,
                                          std::chrono::system_clock::time_point end) {
-    // This is a placeholder implementation
-    return {};
+    std::vector<Event> events;
+    if (auto journal = getJournal()) {
+        drainJournalQueue();
+        journal->replayName(name, start, end, [&](const EventJournal::RecordView& record) {
+            events.push_back(decodeEvent(record));
+            return true;
+        });
+    }
+    return events;
 }
 
 std::vector<EventManager::Event> EventManager::getEvents(EventFilter filter,
                                          std::chrono::system_clock::time_point start,
                                          std::chrono::system_clock::time_point end) {
-    // This is a placeholder implementation
-    return {};
+    std::vector<Event> events;
+    if (auto journal = getJournal()) {
+        drainJournalQueue();
+        journal->replay(start, end, [&](const EventJournal::RecordView& record) {
+            Event event = decodeEvent(record);
+            if (!filter || filter(event)) {
+                events.push_back(std::move(event));
+            }
+            return true;
+        });
+    }
+    return events;
 }
 
 EventManager::EventStats EventManager::getStats() const {
-    std::lock_guard<std::mutex> lock(mutex_);
-    return stats_;
+    std::lock_guard<std::mutex> lock(statsMutex_);
+    EventStats stats = stats_;
+    stats.queuedEvents = queuedEvents_.load();
+    return stats;
 }
 
 void EventManager::resetStats() {
-    std::lock_guard<std::mutex> lock(mutex_);
+    std::lock_guard<std::mutex> lock(statsMutex_);
     stats_ = EventStats{};
 }
 
 void EventManager::enableStats(bool enable) {
-    std::lock_guard<std::mutex> lock(mutex_);
     statsEnabled_ = enable;
 }
 
 bool EventManager::addFilter(EventType type, EventFilter filter) {
     std::lock_guard<std::mutex> lock(mutex_);
-    typeFilters_[type].push_back(filter);
+    updateSubscriptions([&](SubscriptionTable& table) {
+        table.typeFilters[type].push_back(std::move(filter));
+    });
     return true;
 }
 
 bool EventManager::addFilter(const std::string& name, EventFilter filter) {
     std::lock_guard<std::mutex> lock(mutex_);
-    nameFilters_[name].push_back(filter);
+    updateSubscriptions([&](SubscriptionTable& table) {
+        table.nameFilters[name].push_back(std::move(filter));
+    });
     return true;
 }
 
 void EventManager::removeFilter(EventType type, EventFilter filter) {
     std::lock_guard<std::mutex> lock(mutex_);
-    auto it = typeFilters_.find(type);
-    if (it != typeFilters_.end()) {
-        it->second.clear();
-    }
+    updateSubscriptions([type](SubscriptionTable& table) {
+        table.typeFilters.erase(type);
+    });
 }
 
 void EventManager::removeFilter(const std::string& name, EventFilter filter) {
     std::lock_guard<std::mutex> lock(mutex_);
-    auto it = nameFilters_.find(name);
-    if (it != nameFilters_.end()) {
-        it->second.clear();
-    }
+    updateSubscriptions([&name](SubscriptionTable& table) {
+        table.nameFilters.erase(name);
+    });
 }
 
 std::string EventManager::getLastError() const {
@@ -432,8 +720,43 @@ void EventManager::clearLastError() {
     lastError_.clear();
 }
 
+void EventManager::setLastError(const std::string& error) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    lastError_ = error;
+}
+
 bool EventManager::validateEvent(const Event& event) const {
-    if (event.name.empty()) {
+    if (event.name.empty() || event.source.empty()) {
+        return false;
+    }
+    if (static_cast<size_t>(event.priority) >= PRIORITY_LEVELS) {
+        return false;
+    }
+    return true;
+}
+
+// Type and name filters gate delivery to every subscriber
+bool EventManager::passesFilters(const Event& event, const SubscriptionTable& table) const {
+    auto passes = [&event](const std::vector<EventFilter>& filters) {
+        for (const auto& filter : filters) {
+            try {
+                if (!filter(event)) {
+                    return false;
+                }
+            } catch (const std::exception& e) {
+                spdlog::error("Error in event filter: {}", e.what());
+                return false;
+            }
+        }
+        return true;
+    };
+    
+    auto typeIt = table.typeFilters.find(event.type);
+    if (typeIt != table.typeFilters.end() && !passes(typeIt->second)) {
+        return false;
+    }
+    auto nameIt = table.nameFilters.find(event.name);
+    if (nameIt != table.nameFilters.end() && !passes(nameIt->second)) {
         return false;
     }
     return true;
@@ -444,6 +767,7 @@ void EventManager::updateStats(const Event& event, std::chrono::milliseconds pro
         return;
     }
     
+    std::lock_guard<std::mutex> lock(statsMutex_);
     stats_.processedEvents++;
     stats_.averageProcessingTime = std::chrono::milliseconds(
         (stats_.averageProcessingTime.count() * (stats_.processedEvents - 1) + processingTime.count()) / stats_.processedEvents);
@@ -467,8 +791,10 @@ void EventManager::handleEvent(const Event& event, const Subscription& subscript
         updateStats(event, processingTime);
     } catch (const std::exception& e) {
         if (statsEnabled_) {
+            std::lock_guard<std::mutex> lock(statsMutex_);
             stats_.failedEvents++;
         }
+        setLastError(std::string("Error handling event: ") + e.what());
         spdlog::error("Error handling event: {}", e.what());
     }
 }
@@ -493,13 +819,18 @@ bool EventManager::matchEvent(const Event& event, const Subscription& subscripti
 }
 
 void EventManager::cleanupSubscriptions() {
-    // This method can be used to clean up expired or invalid subscriptions
-    // For now, it's a placeholder
+    updateSubscriptions([](SubscriptionTable& table) {
+        table.typeSubscriptions.clear();
+        table.nameSubscriptions.clear();
+        table.filterSubscriptions.clear();
+    });
 }
 
 void EventManager::cleanupFilters() {
-    // This method can be used to clean up expired or invalid filters
-    // For now, it's a placeholder
+    updateSubscriptions([](SubscriptionTable& table) {
+        table.typeFilters.clear();
+        table.nameFilters.clear();
+    });
 }
 
 } // namespace satox::core 
\ No newline at end of file
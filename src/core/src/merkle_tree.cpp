@@ -25,217 +25,470 @@
 
 #include "satox/core/merkle_tree.h"
 #include <algorithm>
-#include <sstream>
-#include <iomanip>
-#include <vector>
-#include <thread>
+#include <cstring>
+#include <functional>
+#include <map>
 #include <future>
+#include <thread>
+#include <vector>
+
+#if defined(__x86_64__) || defined(__i386__)
+#define SATOX_MERKLE_SHANI 1
+#include <cpuid.h>
 #include <immintrin.h>
+#endif
 
 namespace satox {
 namespace core {
 
-MerkleTree::MerkleTree() : root_(nullptr) {}
-
-void MerkleTree::buildTree(const std::vector<std::string>& transactions) {
-    if (transactions.empty()) {
-        root_ = nullptr;
+namespace {
+
+constexpr uint32_t SHA256_K[64] = {
+    0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5, 0x3956c25b, 0x59f111f1, 0x923f82a4, 0xab1c5ed5,
+    0xd807aa98, 0x12835b01, 0x243185be, 0x550c7dc3, 0x72be5d74, 0x80deb1fe, 0x9bdc06a7, 0xc19bf174,
+    0xe49b69c1, 0xefbe4786, 0x0fc19dc6, 0x240ca1cc, 0x2de92c6f, 0x4a7484aa, 0x5cb0a9dc, 0x76f988da,
+    0x983e5152, 0xa831c66d, 0xb00327c8, 0xbf597fc7, 0xc6e00bf3, 0xd5a79147, 0x06ca6351, 0x14292967,
+    0x27b70a85, 0x2e1b2138, 0x4d2c6dfc, 0x53380d13, 0x650a7354, 0x766a0abb, 0x81c2c92e, 0x92722c85,
+    0xa2bfe8a1, 0xa81a664b, 0xc24b8b70, 0xc76c51a3, 0xd192e819, 0xd6990624, 0xf40e3585, 0x106aa070,
+    0x19a4c116, 0x1e376c08, 0x2748774c, 0x34b0bcb5, 0x391c0cb3, 0x4ed8aa4a, 0x5b9cca4f, 0x682e6ff3,
+    0x748f82ee, 0x78a5636f, 0x84c87814, 0x8cc70208, 0x90befffa, 0xa4506ceb, 0xbef9a3f7, 0xc67178f2};
+
+constexpr uint32_t SHA256_IV[8] = {
+    0x6a09e667, 0xbb67ae85, 0x3c6ef372, 0xa54ff53a, 0x510e527f, 0x9b05688c, 0x1f83d9ab, 0x5be0cd19};
+
+// Runs fn(begin, end) over [0, count), split across threads once count
+// reaches `threshold`
+void forEachChunk(size_t count, size_t threshold, const std::function<void(size_t, size_t)>& fn) {
+    static const size_t threads = std::thread::hardware_concurrency();
+    if (count < threshold || threads <= 1) {
+        fn(0, count);
         return;
     }
 
-    // Create leaf nodes in parallel
-    const int numThreads = std::thread::hardware_concurrency();
-    std::vector<std::shared_ptr<Node>> nodes(transactions.size());
+    size_t chunkSize = (count + threads - 1) / threads;
     std::vector<std::future<void>> futures;
+    for (size_t start = chunkSize; start < count; start += chunkSize) {
+        futures.push_back(std::async(std::launch::async, fn, start, std::min(count, start + chunkSize)));
+    }
+    fn(0, std::min(count, chunkSize));
+    for (auto& future : futures) {
+        future.get();
+    }
+}
 
-    auto processChunk = [&](size_t start, size_t end) {
-        for (size_t i = start; i < end; i++) {
-            nodes[i] = std::make_shared<Node>(calculateHash(transactions[i]));
-            nodes[i]->data = transactions[i];
+void hashPairsPortable(const uint8_t* in, uint8_t* out, size_t count) {
+    for (size_t i = 0; i < count; i++) {
+        SHA256(in + 64 * i, 64, out + 32 * i);
+    }
+}
+
+#ifdef SATOX_MERKLE_SHANI
+
+bool cpuHasShaNi() {
+    unsigned int eax, ebx, ecx, edx;
+    if (!__get_cpuid(1, &eax, &ebx, &ecx, &edx) || !(ecx & bit_SSSE3) || !(ecx & bit_SSE4_1)) {
+        return false;
+    }
+    if (!__get_cpuid_count(7, 0, &eax, &ebx, &ecx, &edx)) {
+        return false;
+    }
+    return (ebx & bit_SHA) != 0;
+}
+
+// A 64-byte message is two compressions: the message itself, then a padding
+// block that is the same for every pair. Its message schedule plus round
+// constants is computed once.
+struct PaddingSchedule {
+    alignas(16) uint32_t wk[64];
+
+    PaddingSchedule() {
+        auto rotr = [](uint32_t x, int n) { return (x >> n) | (x << (32 - n)); };
+        uint32_t w[64] = {0x80000000};
+        w[15] = 512;  // message length in bits
+        for (int t = 16; t < 64; t++) {
+            uint32_t s0 = rotr(w[t - 15], 7) ^ rotr(w[t - 15], 18) ^ (w[t - 15] >> 3);
+            uint32_t s1 = rotr(w[t - 2], 17) ^ rotr(w[t - 2], 19) ^ (w[t - 2] >> 10);
+            w[t] = w[t - 16] + s0 + w[t - 7] + s1;
         }
-    };
+        for (int t = 0; t < 64; t++) {
+            wk[t] = w[t] + SHA256_K[t];
+        }
+    }
+};
+
+const PaddingSchedule PADDING_SCHEDULE;
+
+__attribute__((target("sha,sse4.1,ssse3")))
+void hashPairsShaNi(const uint8_t* in, uint8_t* out, size_t count) {
+    // Swaps the bytes of each 32-bit word (SHA-256 is big-endian)
+    const __m128i byteSwap = _mm_set_epi64x(0x0c0d0e0f08090a0bULL, 0x0405060700010203ULL);
+
+    // IV in the ABEF / CDGH layout the SHA instructions use
+    __m128i tmp = _mm_shuffle_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i*>(&SHA256_IV[0])), 0xB1);
+    __m128i ivCdgh = _mm_shuffle_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i*>(&SHA256_IV[4])), 0x1B);
+    const __m128i ivAbef = _mm_alignr_epi8(tmp, ivCdgh, 8);
+    ivCdgh = _mm_blend_epi16(ivCdgh, tmp, 0xF0);
+
+    for (size_t i = 0; i < count; i++, in += 64, out += 32) {
+        __m128i state0 = ivAbef;
+        __m128i state1 = ivCdgh;
+
+        // Block 1: the two digests
+        __m128i msgs[4];
+        for (int g = 0; g < 16; g++) {
+            __m128i msg;
+            if (g < 4) {
+                msg = _mm_shuffle_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(in + 16 * g)), byteSwap);
+            } else {
+                msg = _mm_sha256msg1_epu32(msgs[g & 3], msgs[(g + 1) & 3]);
+                msg = _mm_add_epi32(msg, _mm_alignr_epi8(msgs[(g + 3) & 3], msgs[(g + 2) & 3], 4));
+                msg = _mm_sha256msg2_epu32(msg, msgs[(g + 3) & 3]);
+            }
+            msgs[g & 3] = msg;
 
-    // Split work among threads
-    size_t chunkSize = transactions.size() / numThreads;
-    for (int i = 0; i < numThreads; i++) {
-        size_t start = i * chunkSize;
-        size_t end = (i == numThreads - 1) ? transactions.size() : (i + 1) * chunkSize;
-        futures.push_back(std::async(std::launch::async, processChunk, start, end));
+            __m128i wk = _mm_add_epi32(msg, _mm_loadu_si128(reinterpret_cast<const __m128i*>(&SHA256_K[4 * g])));
+            state1 = _mm_sha256rnds2_epu32(state1, state0, wk);
+            state0 = _mm_sha256rnds2_epu32(state0, state1, _mm_shuffle_epi32(wk, 0x0E));
+        }
+        state0 = _mm_add_epi32(state0, ivAbef);
+        state1 = _mm_add_epi32(state1, ivCdgh);
+
+        // Block 2: constant padding, schedule precomputed
+        const __m128i save0 = state0;
+        const __m128i save1 = state1;
+        for (int g = 0; g < 16; g++) {
+            __m128i wk = _mm_load_si128(reinterpret_cast<const __m128i*>(&PADDING_SCHEDULE.wk[4 * g]));
+            state1 = _mm_sha256rnds2_epu32(state1, state0, wk);
+            state0 = _mm_sha256rnds2_epu32(state0, state1, _mm_shuffle_epi32(wk, 0x0E));
+        }
+        state0 = _mm_add_epi32(state0, save0);
+        state1 = _mm_add_epi32(state1, save1);
+
+        // Back to ABCD / EFGH, big-endian
+        tmp = _mm_shuffle_epi32(state0, 0x1B);
+        state1 = _mm_shuffle_epi32(state1, 0xB1);
+        state0 = _mm_blend_epi16(tmp, state1, 0xF0);
+        state1 = _mm_alignr_epi8(state1, tmp, 8);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(out), _mm_shuffle_epi8(state0, byteSwap));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(out + 16), _mm_shuffle_epi8(state1, byteSwap));
     }
+}
 
-    // Wait for all threads to complete
-    for (auto& future : futures) {
-        future.wait();
+#endif
+
+using PairHasher = void (*)(const uint8_t*, uint8_t*, size_t);
+
+PairHasher selectPairHasher() {
+#ifdef SATOX_MERKLE_SHANI
+    if (cpuHasShaNi()) {
+        return hashPairsShaNi;
     }
+#endif
+    // OpenSSL picks its own SIMD code path for the one-shot hash
+    return hashPairsPortable;
+}
 
-    // Build the tree
-    buildTreeRecursive(nodes);
-    root_ = nodes[0];
+// Chosen on first use, so the CPU is probed after static initialization
+PairHasher& pairHasher() {
+    static PairHasher hasher = selectPairHasher();
+    return hasher;
+}
+
+} // namespace
+
+MerkleTree::MerkleTree() = default;
+
+void MerkleTree::buildTree(const std::vector<std::string>& transactions) {
+    std::vector<Digest> leaves(transactions.size());
+    forEachChunk(leaves.size(), PARALLEL_THRESHOLD, [&](size_t start, size_t end) {
+        for (size_t i = start; i < end; i++) {
+            leaves[i] = hashData(transactions[i]);
+        }
+    });
+    buildFromLeaves(std::move(leaves));
 }
 
 std::string MerkleTree::getRoot() const {
-    return root_ ? root_->hash : "";
+    return levels_.empty() ? "" : toHex(levels_.back().front());
 }
 
 std::vector<std::string> MerkleTree::getProof(const std::string& transaction) const {
-    if (!root_) {
+    size_t index = findLeaf(hashData(transaction));
+    if (index == getLeafCount()) {
         return {};
     }
 
     std::vector<std::string> proof;
-    getProofRecursive(root_, transaction, proof);
+    for (const auto& sibling : getProof(index)) {
+        proof.push_back(toHex(sibling));
+    }
     return proof;
 }
 
 bool MerkleTree::verifyProof(const std::string& transaction,
                            const std::string& root,
                            const std::vector<std::string>& proof) const {
-    if (proof.empty()) {
+    Digest leaf = hashData(transaction);
+    size_t index = findLeaf(leaf);
+    if (index == getLeafCount()) {
         return false;
     }
 
-    // Optimize hash calculation with SIMD
-    std::string currentHash = calculateHashOptimized(transaction);
-    for (const auto& siblingHash : proof) {
-        currentHash = combineHashesOptimized(currentHash, siblingHash);
+    Digest rootDigest;
+    if (!fromHex(root, rootDigest)) {
+        return false;
+    }
+    std::vector<Digest> siblings(proof.size());
+    for (size_t i = 0; i < proof.size(); i++) {
+        if (!fromHex(proof[i], siblings[i])) {
+            return false;
+        }
     }
+    return verifyProof(leaf, index, siblings, rootDigest);
+}
 
-    return currentHash == root;
+void MerkleTree::buildFromLeaves(std::vector<Digest> leaves) {
+    levels_.clear();
+    if (leaves.empty()) {
+        return;
+    }
+    size_t count = leaves.size();
+    levels_.push_back(std::move(leaves));
+    rehash(0, count);
 }
 
-std::string MerkleTree::calculateHash(const std::string& data) {
-    return calculateHashOptimized(data);
+const MerkleTree::Digest& MerkleTree::getRootDigest() const {
+    static const Digest empty{};
+    return levels_.empty() ? empty : levels_.back().front();
 }
 
-std::string MerkleTree::calculateHashOptimized(const std::string& data) {
-    unsigned char hash[SHA256_DIGEST_LENGTH];
-    SHA256_CTX sha256;
-    SHA256_Init(&sha256);
-    
-    // Process data in chunks for better cache utilization
-    const size_t chunkSize = 64; // SHA-256 block size
-    size_t remaining = data.size();
-    const char* ptr = data.c_str();
-    
-    while (remaining >= chunkSize) {
-        SHA256_Update(&sha256, ptr, chunkSize);
-        ptr += chunkSize;
-        remaining -= chunkSize;
+size_t MerkleTree::getLeafCount() const {
+    return levels_.empty() ? 0 : levels_.front().size();
+}
+
+std::vector<MerkleTree::Digest> MerkleTree::getProof(size_t leafIndex) const {
+    std::vector<Digest> proof;
+    if (leafIndex >= getLeafCount()) {
+        return proof;
     }
-    
-    if (remaining > 0) {
-        SHA256_Update(&sha256, ptr, remaining);
+
+    // Sibling of index i is i ^ 1; an unpaired last node is its own sibling
+    size_t index = leafIndex;
+    for (size_t level = 0; level + 1 < levels_.size(); level++) {
+        const auto& nodes = levels_[level];
+        proof.push_back(nodes[std::min(index ^ 1, nodes.size() - 1)]);
+        index >>= 1;
     }
-    
-    SHA256_Final(hash, &sha256);
+    return proof;
+}
 
-    // Optimize hex conversion with SIMD
-    std::string result;
-    result.reserve(SHA256_DIGEST_LENGTH * 2);
-    
-    const char* hex = "0123456789abcdef";
-    for (int i = 0; i < SHA256_DIGEST_LENGTH; i++) {
-        result += hex[(hash[i] >> 4) & 0xF];
-        result += hex[hash[i] & 0xF];
-    }
-    
-    return result;
+bool MerkleTree::verifyProof(const Digest& leaf, size_t leafIndex,
+                             const std::vector<Digest>& proof, const Digest& root) {
+    Digest current = leaf;
+    size_t index = leafIndex;
+    for (const auto& sibling : proof) {
+        current = (index & 1) ? hashPair(sibling, current) : hashPair(current, sibling);
+        index >>= 1;
+    }
+    // Leftover index bits mean the index does not fit a tree of this height
+    return index == 0 && current == root;
 }
 
-std::string MerkleTree::combineHashes(const std::string& left, const std::string& right) {
-    return combineHashesOptimized(left, right);
+bool MerkleTree::verifyProofs(const std::vector<Digest>& leaves,
+                              const std::vector<size_t>& leafIndices,
+                              const std::vector<std::vector<Digest>>& proofs,
+                              const Digest& root) {
+    if (leaves.size() != leafIndices.size() || leaves.size() != proofs.size()) {
+        return false;
+    }
+
+    // (level, index) -> node, for nodes on paths that reached the root. Both
+    // the computed nodes and the siblings they were hashed with are
+    // authenticated once the root matches.
+    std::map<std::pair<size_t, size_t>, Digest> verified;
+    std::vector<std::pair<std::pair<size_t, size_t>, Digest>> path;
+    size_t height = 0;  // proof length of the first proof to reach the root
+
+    for (size_t i = 0; i < leaves.size(); i++) {
+        const auto& proof = proofs[i];
+        Digest current = leaves[i];
+        size_t index = leafIndices[i];
+        bool reached = false;
+        path.clear();
+
+        for (size_t level = 0; level <= proof.size(); level++) {
+            auto known = verified.find({level, index});
+            if (known != verified.end()) {
+                if (known->second != current || proof.size() != height) {
+                    return false;
+                }
+                // The rest of the walk is a path already checked against the
+                // root, so the remaining siblings must be the ones it used
+                for (; level < proof.size(); level++, index >>= 1) {
+                    auto sibling = verified.find({level, index ^ 1});
+                    if (sibling == verified.end() || sibling->second != proof[level]) {
+                        return false;
+                    }
+                }
+                reached = true;
+                break;
+            }
+            if (level == proof.size()) {
+                reached = index == 0 && current == root;
+                height = proof.size();
+                break;
+            }
+
+            const Digest& sibling = proof[level];
+            path.push_back({{level, index}, current});
+            path.push_back({{level, index ^ 1}, sibling});
+            current = (index & 1) ? hashPair(sibling, current) : hashPair(current, sibling);
+            index >>= 1;
+        }
+
+        if (!reached) {
+            return false;
+        }
+        for (const auto& node : path) {
+            verified.emplace(node.first, node.second);
+        }
+    }
+    return true;
 }
 
-std::string MerkleTree::combineHashesOptimized(const std::string& left, const std::string& right) {
-    // Pre-allocate string to avoid reallocations
-    std::string combined;
-    combined.reserve(left.size() + right.size());
-    combined = left + right;
-    return calculateHashOptimized(combined);
+void MerkleTree::append(const Digest& leaf) {
+    appendLeaves({leaf});
 }
 
-void MerkleTree::buildTreeRecursive(std::vector<std::shared_ptr<Node>>& nodes) {
-    if (nodes.size() == 1) {
+void MerkleTree::appendLeaves(const std::vector<Digest>& leaves) {
+    if (leaves.empty()) {
         return;
     }
+    if (levels_.empty()) {
+        levels_.emplace_back();
+    }
+    size_t begin = levels_.front().size();
+    levels_.front().insert(levels_.front().end(), leaves.begin(), leaves.end());
+    rehash(begin, levels_.front().size());
+}
 
-    // Process nodes in parallel
-    const int numThreads = std::thread::hardware_concurrency();
-    std::vector<std::shared_ptr<Node>> newLevel((nodes.size() + 1) / 2);
-    std::vector<std::future<void>> futures;
+bool MerkleTree::updateLeaf(size_t leafIndex, const Digest& leaf) {
+    if (leafIndex >= getLeafCount()) {
+        return false;
+    }
+    levels_.front()[leafIndex] = leaf;
+    rehash(leafIndex, leafIndex + 1);
+    return true;
+}
 
-    auto processChunk = [&](size_t start, size_t end) {
-        for (size_t i = start; i < end; i++) {
-            size_t leftIdx = i * 2;
-            size_t rightIdx = leftIdx + 1;
-            
-            if (rightIdx < nodes.size()) {
-                // Create parent node from two children
-                newLevel[i] = std::make_shared<Node>(
-                    combineHashesOptimized(nodes[leftIdx]->hash, nodes[rightIdx]->hash)
-                );
-                newLevel[i]->left = nodes[leftIdx];
-                newLevel[i]->right = nodes[rightIdx];
-            } else {
-                // Handle odd number of nodes by duplicating the last node
-                newLevel[i] = std::make_shared<Node>(
-                    combineHashesOptimized(nodes[leftIdx]->hash, nodes[leftIdx]->hash)
-                );
-                newLevel[i]->left = nodes[leftIdx];
-                newLevel[i]->right = nodes[leftIdx];
-            }
+std::vector<MerkleTree::Digest> MerkleTree::getFrontier() const {
+    // Bit k of the leaf count marks a perfect subtree of 2^k leaves; its root
+    // is the last complete node of level k
+    std::vector<Digest> frontier;
+    size_t count = getLeafCount();
+    for (size_t level = levels_.size(); level-- > 0;) {
+        if ((count >> level) & 1) {
+            frontier.push_back(levels_[level][(count >> level) - 1]);
         }
-    };
-
-    // Split work among threads
-    size_t chunkSize = newLevel.size() / numThreads;
-    for (int i = 0; i < numThreads; i++) {
-        size_t start = i * chunkSize;
-        size_t end = (i == numThreads - 1) ? newLevel.size() : (i + 1) * chunkSize;
-        futures.push_back(std::async(std::launch::async, processChunk, start, end));
     }
+    return frontier;
+}
 
-    // Wait for all threads to complete
-    for (auto& future : futures) {
-        future.wait();
-    }
+void MerkleTree::hashPairs(const Digest* in, Digest* out, size_t count) {
+    pairHasher()(in->data(), out->data(), count);
+}
 
-    nodes = std::move(newLevel);
-    buildTreeRecursive(nodes);
+MerkleTree::Digest MerkleTree::hashPair(const Digest& left, const Digest& right) {
+    Digest pair[2] = {left, right};
+    Digest result;
+    hashPairs(pair, &result, 1);
+    return result;
 }
 
-std::vector<std::string> MerkleTree::getProofRecursive(const std::shared_ptr<Node>& node,
-                                                     const std::string& transaction,
-                                                     std::vector<std::string>& proof) const {
-    if (!node) {
-        return {};
-    }
+#ifdef TESTING
+bool MerkleTree::usesShaNiForTesting() {
+    return pairHasher() != hashPairsPortable;
+}
 
-    if (node->data == transaction) {
-        return proof;
-    }
+void MerkleTree::setPortableHashingForTesting(bool portable) {
+    pairHasher() = portable ? hashPairsPortable : selectPairHasher();
+}
+#endif
 
-    // Use binary search to find the transaction
-    if (node->left) {
-        proof.push_back(node->right->hash);
-        auto leftProof = getProofRecursive(node->left, transaction, proof);
-        if (!leftProof.empty()) {
-            return leftProof;
+void MerkleTree::rehash(size_t begin, size_t end) {
+    for (size_t level = 0; levels_[level].size() > 1; level++) {
+        if (levels_.size() == level + 1) {
+            levels_.emplace_back();
+        }
+        const auto& nodes = levels_[level];
+        auto& parents = levels_[level + 1];
+        parents.resize((nodes.size() + 1) / 2);
+
+        // Parents of [begin, end); a trailing unpaired node hashes with itself
+        size_t first = begin / 2;
+        size_t last = std::min(parents.size(), (end + 1) / 2);
+        size_t pairedEnd = std::min(last, nodes.size() / 2);
+        if (pairedEnd > first) {
+            forEachChunk(pairedEnd - first, PARALLEL_THRESHOLD, [&](size_t start, size_t stop) {
+                hashPairs(&nodes[2 * (first + start)], &parents[first + start], stop - start);
+            });
         }
-        proof.pop_back();
+        if (last > pairedEnd) {
+            parents[pairedEnd] = hashPair(nodes.back(), nodes.back());
+        }
+
+        begin = first;
+        end = last;
     }
+}
 
-    if (node->right) {
-        proof.push_back(node->left->hash);
-        auto rightProof = getProofRecursive(node->right, transaction, proof);
-        if (!rightProof.empty()) {
-            return rightProof;
+size_t MerkleTree::findLeaf(const Digest& leaf) const {
+    size_t count = getLeafCount();
+    for (size_t i = 0; i < count; i++) {
+        if (levels_.front()[i] == leaf) {
+            return i;
         }
-        proof.pop_back();
     }
+    return count;
+}
+
+MerkleTree::Digest MerkleTree::hashData(const std::string& data) {
+    Digest digest;
+    SHA256(reinterpret_cast<const unsigned char*>(data.data()), data.size(), digest.data());
+    return digest;
+}
 
-    return {};
+std::string MerkleTree::toHex(const Digest& digest) {
+    static const char* hex = "0123456789abcdef";
+    std::string result;
+    result.reserve(digest.size() * 2);
+    for (uint8_t byte : digest) {
+        result += hex[byte >> 4];
+        result += hex[byte & 0xF];
+    }
+    return result;
+}
+
+bool MerkleTree::fromHex(const std::string& hex, Digest& digest) {
+    if (hex.size() != digest.size() * 2) {
+        return false;
+    }
+    auto nibble = [](char c) -> int {
+        if (c >= '0' && c <= '9') return c - '0';
+        if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+        if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+        return -1;
+    };
+    for (size_t i = 0; i < digest.size(); i++) {
+        int high = nibble(hex[2 * i]);
+        int low = nibble(hex[2 * i + 1]);
+        if (high < 0 || low < 0) {
+            return false;
+        }
+        digest[i] = static_cast<uint8_t>((high << 4) | low);
+    }
+    return true;
 }
 
 } // namespace core
-} // namespace satox 
\ No newline at end of file
+} // namespace satox
@@ -23,8 +23,7 @@
  * SOFTWARE.
  */
 
-#include "proof_of_work.h"
-#include <random>
+#include "satox/core/proof_of_work.h"
 #include <sstream>
 #include <iomanip>
 #include <chrono>
@@ -32,46 +31,276 @@
 #include <algorithm>
 #include <vector>
 #include <atomic>
-#include <immintrin.h> // For AVX2 instructions
+#include <cstring>
+#include <mutex>
 #include <openssl/sha.h>
 #include <openssl/evp.h>
-#include <openssl/rand.h>
 #include <stdexcept>
 
 namespace satox {
 namespace core {
 
-ProofOfWork::ProofOfWork() {}
+namespace {
+
+// Nonces a mining thread claims at a time; also the granularity of cancellation
+constexpr uint64_t NONCE_CHUNK = 1 << 14;
+
+const char HEX_DIGITS[] = "0123456789abcdef";
+
+constexpr uint32_t SHA256_K[64] = {
+    0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5, 0x3956c25b, 0x59f111f1, 0x923f82a4, 0xab1c5ed5,
+    0xd807aa98, 0x12835b01, 0x243185be, 0x550c7dc3, 0x72be5d74, 0x80deb1fe, 0x9bdc06a7, 0xc19bf174,
+    0xe49b69c1, 0xefbe4786, 0x0fc19dc6, 0x240ca1cc, 0x2de92c6f, 0x4a7484aa, 0x5cb0a9dc, 0x76f988da,
+    0x983e5152, 0xa831c66d, 0xb00327c8, 0xbf597fc7, 0xc6e00bf3, 0xd5a79147, 0x06ca6351, 0x14292967,
+    0x27b70a85, 0x2e1b2138, 0x4d2c6dfc, 0x53380d13, 0x650a7354, 0x766a0abb, 0x81c2c92e, 0x92722c85,
+    0xa2bfe8a1, 0xa81a664b, 0xc24b8b70, 0xc76c51a3, 0xd192e819, 0xd6990624, 0xf40e3585, 0x106aa070,
+    0x19a4c116, 0x1e376c08, 0x2748774c, 0x34b0bcb5, 0x391c0cb3, 0x4ed8aa4a, 0x5b9cca4f, 0x682e6ff3,
+    0x748f82ee, 0x78a5636f, 0x84c87814, 0x8cc70208, 0x90befffa, 0xa4506ceb, 0xbef9a3f7, 0xc67178f2};
+
+constexpr uint32_t SHA256_IV[8] = {
+    0x6a09e667, 0xbb67ae85, 0x3c6ef372, 0xa54ff53a, 0x510e527f, 0x9b05688c, 0x1f83d9ab, 0x5be0cd19};
+
+// Plain-data SHA-256 state. Copying it is a struct copy, so the mining loop
+// restarts from the midstate without touching the heap.
+struct Sha256State {
+    uint32_t h[8];
+    uint8_t block[64];
+    size_t blockLength;
+    uint64_t totalLength;
+};
+
+void sha256Compress(uint32_t h[8], const uint8_t* block) {
+    auto rotr = [](uint32_t x, int n) { return (x >> n) | (x << (32 - n)); };
+    uint32_t w[64];
+    for (int t = 0; t < 16; t++) {
+        w[t] = uint32_t(block[4 * t]) << 24 | uint32_t(block[4 * t + 1]) << 16 |
+               uint32_t(block[4 * t + 2]) << 8 | uint32_t(block[4 * t + 3]);
+    }
+    for (int t = 16; t < 64; t++) {
+        uint32_t s0 = rotr(w[t - 15], 7) ^ rotr(w[t - 15], 18) ^ (w[t - 15] >> 3);
+        uint32_t s1 = rotr(w[t - 2], 17) ^ rotr(w[t - 2], 19) ^ (w[t - 2] >> 10);
+        w[t] = w[t - 16] + s0 + w[t - 7] + s1;
+    }
+
+    uint32_t a = h[0], b = h[1], c = h[2], d = h[3], e = h[4], f = h[5], g = h[6], k = h[7];
+    for (int t = 0; t < 64; t++) {
+        uint32_t t1 = k + (rotr(e, 6) ^ rotr(e, 11) ^ rotr(e, 25)) + ((e & f) ^ (~e & g)) + SHA256_K[t] + w[t];
+        uint32_t t2 = (rotr(a, 2) ^ rotr(a, 13) ^ rotr(a, 22)) + ((a & b) ^ (a & c) ^ (b & c));
+        k = g;
+        g = f;
+        f = e;
+        e = d + t1;
+        d = c;
+        c = b;
+        b = a;
+        a = t1 + t2;
+    }
+    h[0] += a;
+    h[1] += b;
+    h[2] += c;
+    h[3] += d;
+    h[4] += e;
+    h[5] += f;
+    h[6] += g;
+    h[7] += k;
+}
+
+void sha256Init(Sha256State& state) {
+    std::memcpy(state.h, SHA256_IV, sizeof(state.h));
+    state.blockLength = 0;
+    state.totalLength = 0;
+}
+
+void sha256Update(Sha256State& state, const uint8_t* data, size_t size) {
+    state.totalLength += size;
+    while (size > 0) {
+        size_t take = std::min(size, sizeof(state.block) - state.blockLength);
+        std::memcpy(state.block + state.blockLength, data, take);
+        state.blockLength += take;
+        data += take;
+        size -= take;
+        if (state.blockLength == sizeof(state.block)) {
+            sha256Compress(state.h, state.block);
+            state.blockLength = 0;
+        }
+    }
+}
+
+void sha256Final(Sha256State& state, uint8_t* digest) {
+    const uint64_t bits = state.totalLength * 8;
+    state.block[state.blockLength++] = 0x80;
+    if (state.blockLength > 56) {
+        std::memset(state.block + state.blockLength, 0, sizeof(state.block) - state.blockLength);
+        sha256Compress(state.h, state.block);
+        state.blockLength = 0;
+    }
+    std::memset(state.block + state.blockLength, 0, 56 - state.blockLength);
+    for (int i = 0; i < 8; i++) {
+        state.block[56 + i] = static_cast<uint8_t>(bits >> (56 - 8 * i));
+    }
+    sha256Compress(state.h, state.block);
+    for (int i = 0; i < 8; i++) {
+        digest[4 * i] = static_cast<uint8_t>(state.h[i] >> 24);
+        digest[4 * i + 1] = static_cast<uint8_t>(state.h[i] >> 16);
+        digest[4 * i + 2] = static_cast<uint8_t>(state.h[i] >> 8);
+        digest[4 * i + 3] = static_cast<uint8_t>(state.h[i]);
+    }
+}
+
+// One-shot SHA-256 of `size` bytes at `data`
+void sha256(const void* data, size_t size, unsigned char* digest) {
+    if (EVP_Digest(data, size, digest, nullptr, EVP_sha256(), nullptr) != 1) {
+        throw std::runtime_error("SHA-256 digest failed");
+    }
+}
+
+} // namespace
+
+ProofOfWork::ProofOfWork() : cancelled_(std::make_unique<std::atomic<bool>>(false)) {}
 
 std::string ProofOfWork::mineBlock(const std::string& previousHash,
                                  const std::string& merkleRoot,
                                  uint64_t timestamp,
                                  uint64_t difficulty) {
-    std::string target = std::string(difficulty, '0');
-    std::string nonce;
-    unsigned char randomBytes[32];
-    
-    while (true) {
-        // Generate random nonce
-        if (RAND_bytes(randomBytes, sizeof(randomBytes)) != 1) {
-            throw std::runtime_error("Failed to generate random nonce");
-        }
-        
-        std::stringstream ss;
-        for(int i = 0; i < sizeof(randomBytes); i++) {
-            ss << std::hex << std::setw(2) << std::setfill('0') << static_cast<int>(randomBytes[i]);
-        }
-        nonce = ss.str();
-        
-        // Calculate hash
-        std::string hash = calculateHash(previousHash + merkleRoot + 
-                                       std::to_string(timestamp) + nonce);
-        
-        // Check if hash meets difficulty target
-        if (hash.substr(0, difficulty) == target) {
-            return nonce;
+    std::string header = previousHash + merkleRoot + std::to_string(timestamp);
+    MiningResult result = search(std::vector<uint8_t>(header.begin(), header.end()),
+                                 difficultyToTarget(difficulty), MiningOptions(), NonceEncoding::HEX16);
+    if (!result.found) {
+        return std::string();
+    }
+
+    std::string nonce(16, '0');
+    for (int i = 0; i < 16; i++) {
+        nonce[i] = HEX_DIGITS[(result.nonce >> (60 - 4 * i)) & 0xF];
+    }
+    return nonce;
+}
+
+ProofOfWork::MiningResult ProofOfWork::mine(const std::vector<uint8_t>& headerPrefix,
+                                            const Hash& target,
+                                            const MiningOptions& options) {
+    return search(headerPrefix, target, options, NonceEncoding::BINARY_LE64);
+}
+
+ProofOfWork::MiningResult ProofOfWork::mine(const std::vector<uint8_t>& headerPrefix,
+                                            const Hash& target) {
+    return mine(headerPrefix, target, MiningOptions());
+}
+
+void ProofOfWork::cancel() {
+    cancelled_->store(true);
+}
+
+ProofOfWork::MiningResult ProofOfWork::search(const std::vector<uint8_t>& prefix,
+                                              const Hash& target,
+                                              const MiningOptions& options,
+                                              NonceEncoding encoding) {
+    MiningResult result;
+    if (options.startNonce > options.endNonce) {
+        return result;
+    }
+
+    // Midstate: the fixed prefix is absorbed once; every attempt copies the
+    // state and feeds only the nonce bytes
+    Sha256State midstate;
+    sha256Init(midstate);
+    sha256Update(midstate, prefix.data(), prefix.size());
+
+    size_t threadCount = options.threads;
+    if (threadCount == 0) {
+        threadCount = std::max(1u, std::thread::hardware_concurrency());
+    }
+
+    // Threads claim NONCE_CHUNK-sized pieces of [startNonce, endNonce] by
+    // index, in increasing order. Once a chunk holds a solution only the
+    // chunks below it are still searched, so the result is always the lowest
+    // qualifying nonce whatever the thread count.
+    const uint64_t lastChunk = (options.endNonce - options.startNonce) / NONCE_CHUNK;
+    std::atomic<uint64_t> nextChunk{0};
+    std::atomic<uint64_t> solvedChunk{std::numeric_limits<uint64_t>::max()};
+    std::atomic<uint64_t> hashes{0};
+    std::mutex resultMutex;
+
+    auto worker = [&]() {
+        uint8_t nonceBytes[16];
+        const size_t nonceLength = encoding == NonceEncoding::HEX16 ? 16 : 8;
+        Hash digest;
+        Sha256State state;
+        uint64_t attempts = 0;
+
+        while (!cancelled_->load(std::memory_order_relaxed)) {
+            uint64_t chunk = nextChunk.fetch_add(1, std::memory_order_relaxed);
+            if (chunk > lastChunk || chunk > solvedChunk.load(std::memory_order_relaxed)) {
+                break;
+            }
+            uint64_t first = options.startNonce + chunk * NONCE_CHUNK;
+            uint64_t last = options.endNonce - first < NONCE_CHUNK ? options.endNonce : first + NONCE_CHUNK - 1;
+
+            for (uint64_t nonce = first;; ++nonce) {
+                if (encoding == NonceEncoding::HEX16) {
+                    for (int i = 0; i < 16; i++) {
+                        nonceBytes[i] = HEX_DIGITS[(nonce >> (60 - 4 * i)) & 0xF];
+                    }
+                } else {
+                    for (int i = 0; i < 8; i++) {
+                        nonceBytes[i] = static_cast<uint8_t>(nonce >> (8 * i));
+                    }
+                }
+
+                state = midstate;
+                sha256Update(state, nonceBytes, nonceLength);
+                sha256Final(state, digest.data());
+                ++attempts;
+
+                // Big-endian comparison of the raw digest against the target
+                if (std::memcmp(digest.data(), target.data(), digest.size()) <= 0) {
+                    std::lock_guard<std::mutex> lock(resultMutex);
+                    if (!result.found || nonce < result.nonce) {
+                        result.found = true;
+                        result.nonce = nonce;
+                        result.hash = digest;
+                        solvedChunk.store(chunk, std::memory_order_relaxed);
+                    }
+                    break;
+                }
+                // A lower chunk was solved while this one was being searched
+                if (nonce == last || chunk > solvedChunk.load(std::memory_order_relaxed) ||
+                    cancelled_->load(std::memory_order_relaxed)) {
+                    break;
+                }
+            }
         }
+        hashes.fetch_add(attempts, std::memory_order_relaxed);
+    };
+
+    std::vector<std::thread> threads;
+    threads.reserve(threadCount - 1);
+    for (size_t i = 1; i < threadCount; i++) {
+        threads.emplace_back(worker);
+    }
+    worker();
+    for (auto& thread : threads) {
+        thread.join();
     }
+
+    // A cancel() only ever applies to one search: clearing it here rather
+    // than on entry means a cancel issued before the search got going still
+    // stops it, and the next job starts uncancelled
+    cancelled_->store(false);
+
+    result.hashes = hashes.load();
+    return result;
+}
+
+ProofOfWork::Hash ProofOfWork::difficultyToTarget(uint64_t difficulty) {
+    Hash target;
+    target.fill(0xff);
+    uint64_t digits = std::min<uint64_t>(difficulty, target.size() * 2);
+    std::fill(target.begin(), target.begin() + digits / 2, 0);
+    if (digits % 2 != 0) {
+        target[digits / 2] = 0x0f;
+    }
+    return target;
 }
 
 bool ProofOfWork::verifyBlock(const std::string& hash,
@@ -94,10 +323,7 @@ bool ProofOfWork::verifyBlock(const std::string& hash,
 
 std::string ProofOfWork::calculateHash(const std::string& input) {
     unsigned char hash[SHA256_DIGEST_LENGTH];
-    SHA256_CTX sha256;
-    SHA256_Init(&sha256);
-    SHA256_Update(&sha256, input.c_str(), input.size());
-    SHA256_Final(hash, &sha256);
+    sha256(input.data(), input.size(), hash);
     
     std::stringstream ss;
     for(int i = 0; i < SHA256_DIGEST_LENGTH; i++) {
@@ -108,25 +334,7 @@ std::string ProofOfWork::calculateHash(const std::string& input) {
 
 std::string ProofOfWork::calculateHashOptimized(const std::string& data) {
     unsigned char hash[SHA256_DIGEST_LENGTH];
-    SHA256_CTX sha256;
-    SHA256_Init(&sha256);
-    
-    // Process data in chunks for better cache utilization
-    const size_t chunkSize = 64; // SHA-256 block size
-    size_t remaining = data.size();
-    const char* ptr = data.c_str();
-    
-    while (remaining >= chunkSize) {
-        SHA256_Update(&sha256, ptr, chunkSize);
-        ptr += chunkSize;
-        remaining -= chunkSize;
-    }
-    
-    if (remaining > 0) {
-        SHA256_Update(&sha256, ptr, remaining);
-    }
-    
-    SHA256_Final(hash, &sha256);
+    sha256(data.data(), data.size(), hash);
 
     // Optimize hex conversion with SIMD
     std::string result;
@@ -142,34 +350,10 @@ std::string ProofOfWork::calculateHashOptimized(const std::string& data) {
 }
 
 bool ProofOfWork::meetsDifficulty(const std::string& hash, uint64_t difficulty) {
-    // Optimize difficulty check with SIMD
-    if (difficulty > hash.length() * 4) {
+    if (difficulty > hash.length()) {
         return false;
     }
-    
-    // Convert first few characters to binary using SIMD
-    __m256i zero = _mm256_setzero_si256();
-    __m256i ones = _mm256_set1_epi8(1);
-    
-    int i = 0;
-    while (i + 32 <= difficulty) {
-        __m256i chars = _mm256_loadu_si256((__m256i*)&hash[i/4]);
-        __m256i result = _mm256_cmpeq_epi8(chars, zero);
-        if (!_mm256_testz_si256(result, ones)) {
-            return false;
-        }
-        i += 32;
-    }
-    
-    // Handle remaining bits
-    while (i < difficulty) {
-        if (hash[i/4] != '0') {
-            return false;
-        }
-        i++;
-    }
-    
-    return true;
+    return std::all_of(hash.begin(), hash.begin() + difficulty, [](char c) { return c == '0'; });
 }
 
 uint64_t ProofOfWork::getDifficulty(uint64_t blockHeight) {
@@ -182,46 +366,13 @@ uint64_t ProofOfWork::getDifficulty(uint64_t blockHeight) {
     return INITIAL_DIFFICULTY + adjustment;
 }
 
-std::string ProofOfWork::generateNonce(std::mt19937& gen) {
-    static const char* hex = "0123456789abcdef";
-    static std::uniform_int_distribution<> dis(0, 15);
-    
-    std::string nonce;
-    nonce.reserve(32);
-    
-    // Generate nonce in chunks for better performance
-    for (int i = 0; i < 32; i += 4) {
-        uint32_t value = gen();
-        for (int j = 0; j < 4 && i + j < 32; j++) {
-            nonce += hex[(value >> (j * 4)) & 0xF];
-        }
-    }
-    
-    return nonce;
-}
-
 bool ProofOfWork::isValidNonce(const std::string& nonce) {
-    if (nonce.length() != 32) {
+    if (nonce.length() != 16) {
         return false;
     }
-
-    // Optimize nonce validation with SIMD
-    __m256i valid_chars = _mm256_setr_epi8(
-        '0', '1', '2', '3', '4', '5', '6', '7',
-        '8', '9', 'a', 'b', 'c', 'd', 'e', 'f',
-        '0', '1', '2', '3', '4', '5', '6', '7',
-        '8', '9', 'a', 'b', 'c', 'd', 'e', 'f'
-    );
-    
-    for (int i = 0; i < 32; i += 32) {
-        __m256i chars = _mm256_loadu_si256((__m256i*)&nonce[i]);
-        __m256i result = _mm256_cmpeq_epi8(chars, valid_chars);
-        if (!_mm256_testz_si256(result, _mm256_set1_epi8(1))) {
-            return false;
-        }
-    }
-    
-    return true;
+    return std::all_of(nonce.begin(), nonce.end(), [](char c) {
+        return (c >= '0' && c <= '9') || (c >= 'a' && c <= 'f');
+    });
 }
 
 } // namespace core
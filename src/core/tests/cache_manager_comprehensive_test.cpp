@@ -34,6 +34,8 @@
 
 using namespace satox::core;
 using namespace std::chrono_literals;
+using CacheConfig = CacheManager::CacheConfig;
+using CacheCallback = CacheManager::CacheCallback;
 
 class CacheManagerComprehensiveTest : public ::testing::Test {
 protected:
@@ -80,6 +82,7 @@ protected:
 // Basic Functionality Tests
 TEST_F(CacheManagerComprehensiveTest, Initialization) {
     // Test initialization with valid config
+    CacheManager::getInstance().shutdown();
     CacheConfig validConfig;
     validConfig.maxSize = 1024 * 1024;
     validConfig.maxEntries = 1000;
@@ -90,6 +93,7 @@ TEST_F(CacheManagerComprehensiveTest, Initialization) {
     EXPECT_TRUE(CacheManager::getInstance().initialize(validConfig));
 
     // Test initialization with invalid config
+    CacheManager::getInstance().shutdown();
     CacheConfig invalidConfig;
     invalidConfig.maxSize = 0;
     invalidConfig.maxEntries = 0;
@@ -99,7 +103,7 @@ TEST_F(CacheManagerComprehensiveTest, Initialization) {
 // Basic Cache Operations Tests
 TEST_F(CacheManagerComprehensiveTest, BasicOperations) {
     // Test set and get
-    EXPECT_TRUE(CacheManager::getInstance().set("key1", "value1"));
+    EXPECT_TRUE(CacheManager::getInstance().set("key1", std::string("value1")));
     auto value = CacheManager::getInstance().get("key1");
     EXPECT_TRUE(value.has_value());
     EXPECT_EQ(*value, "value1");
@@ -153,19 +157,19 @@ TEST_F(CacheManagerComprehensiveTest, BulkOperations) {
 // TTL and Expiry Tests
 TEST_F(CacheManagerComprehensiveTest, TTLAndExpiry) {
     // Test set with TTL
-    EXPECT_TRUE(CacheManager::getInstance().set("key1", "value1", 1s));
+    EXPECT_TRUE(CacheManager::getInstance().set("key1", std::string("value1"), 1s));
     EXPECT_TRUE(CacheManager::getInstance().exists("key1"));
     std::this_thread::sleep_for(1100ms);
     EXPECT_FALSE(CacheManager::getInstance().exists("key1"));
 
     // Test setTTL
-    EXPECT_TRUE(CacheManager::getInstance().set("key2", "value2"));
+    EXPECT_TRUE(CacheManager::getInstance().set("key2", std::string("value2")));
     EXPECT_TRUE(CacheManager::getInstance().setTTL("key2", 1s));
     std::this_thread::sleep_for(1100ms);
     EXPECT_FALSE(CacheManager::getInstance().exists("key2"));
 
     // Test getExpiry
-    EXPECT_TRUE(CacheManager::getInstance().set("key3", "value3", 3600s));
+    EXPECT_TRUE(CacheManager::getInstance().set("key3", std::string("value3"), 3600s));
     auto expiry = CacheManager::getInstance().getExpiry("key3");
     EXPECT_GT(expiry, std::chrono::system_clock::now());
 }
@@ -187,7 +191,7 @@ TEST_F(CacheManagerComprehensiveTest, SizeAndEntryCount) {
 // Statistics Tests
 TEST_F(CacheManagerComprehensiveTest, Statistics) {
     // Test hit and miss statistics
-    EXPECT_TRUE(CacheManager::getInstance().set("key1", "value1"));
+    EXPECT_TRUE(CacheManager::getInstance().set("key1", std::string("value1")));
     EXPECT_TRUE(CacheManager::getInstance().get("key1").has_value());
     EXPECT_FALSE(CacheManager::getInstance().get("key2").has_value());
 
@@ -209,24 +213,24 @@ TEST_F(CacheManagerComprehensiveTest, Callbacks) {
     CacheManager::getInstance().registerCallback(callback);
 
     // Test callback invocation
-    EXPECT_TRUE(CacheManager::getInstance().set("key1", "value1"));
+    EXPECT_TRUE(CacheManager::getInstance().set("key1", std::string("value1")));
     EXPECT_TRUE(callbackCalled);
 
     // Test unregisterCallback
     callbackCalled = false;
-    CacheManager::getInstance().unregisterCallback(callback);
-    EXPECT_TRUE(CacheManager::getInstance().set("key2", "value2"));
+    CacheManager::getInstance().unregisterCallback();
+    EXPECT_TRUE(CacheManager::getInstance().set("key2", std::string("value2")));
     EXPECT_FALSE(callbackCalled);
 }
 
 // Error Handling Tests
 TEST_F(CacheManagerComprehensiveTest, ErrorHandling) {
     // Test invalid key
-    EXPECT_FALSE(CacheManager::getInstance().set("", "value1"));
+    EXPECT_FALSE(CacheManager::getInstance().set("", std::string("value1")));
     EXPECT_FALSE(CacheManager::getInstance().getLastError().empty());
 
     // Test invalid value
-    EXPECT_FALSE(CacheManager::getInstance().set("key1", ""));
+    EXPECT_FALSE(CacheManager::getInstance().set("key1", std::string("")));
     EXPECT_FALSE(CacheManager::getInstance().getLastError().empty());
 
     // Test clearLastError
@@ -263,8 +267,9 @@ TEST_F(CacheManagerComprehensiveTest, Concurrency) {
 
 // Edge Cases Tests
 TEST_F(CacheManagerComprehensiveTest, EdgeCases) {
-    // Test maximum value size
-    std::string largeValue = createTestValue(1024 * 1024);  // 1MB
+    // Test maximum value size; the key and the entry's bookkeeping are charged too
+    EXPECT_FALSE(CacheManager::getInstance().set("key1", createTestValue(1024 * 1024)));
+    std::string largeValue = createTestValue(1023 * 1024);
     EXPECT_TRUE(CacheManager::getInstance().set("key1", largeValue));
 
     // Test maximum number of entries
@@ -286,7 +291,7 @@ TEST_F(CacheManagerComprehensiveTest, EdgeCases) {
 // Cleanup Tests
 TEST_F(CacheManagerComprehensiveTest, Cleanup) {
     // Test cleanup of expired entries
-    EXPECT_TRUE(CacheManager::getInstance().set("key1", "value1", 1s));
+    EXPECT_TRUE(CacheManager::getInstance().set("key1", std::string("value1"), 1s));
     std::this_thread::sleep_for(1100ms);
     CacheManager::getInstance().cleanup();
     EXPECT_FALSE(CacheManager::getInstance().exists("key1"));
@@ -324,4 +329,64 @@ TEST_F(CacheManagerComprehensiveTest, StressTest) {
                 break;
         }
     }
-} 
\ No newline at end of file
+} 
+// Eviction Policy Tests
+TEST_F(CacheManagerComprehensiveTest, LFUAdmissionResistsScans) {
+    // Build up access frequency for a small hot set
+    for (int round = 0; round < 10; ++round) {
+        for (int i = 0; i < 50; ++i) {
+            std::string key = "hot" + std::to_string(i);
+            EXPECT_TRUE(CacheManager::getInstance().set(key, std::string("value")));
+            EXPECT_TRUE(CacheManager::getInstance().get(key).has_value());
+        }
+    }
+
+    // A one-pass scan far larger than the cache must not flush the hot set
+    for (int i = 0; i < 10000; ++i) {
+        EXPECT_TRUE(CacheManager::getInstance().set("scan" + std::to_string(i), std::string("value")));
+    }
+
+    int hotHits = 0;
+    for (int i = 0; i < 50; ++i) {
+        hotHits += CacheManager::getInstance().exists("hot" + std::to_string(i)) ? 1 : 0;
+    }
+    EXPECT_GE(hotHits, 45);
+    EXPECT_LE(CacheManager::getInstance().getEntryCount(), 1000);
+    EXPECT_GT(CacheManager::getInstance().getStats().evictionCount, 0);
+}
+
+// Background Expiry Tests
+TEST_F(CacheManagerComprehensiveTest, BackgroundExpiry) {
+    CacheManager::getInstance().shutdown();
+    CacheConfig config;
+    config.maxSize = 1024 * 1024;
+    config.maxEntries = 1000;
+    config.defaultTTL = 3600s;
+    config.enableLRU = true;
+    config.enableLFU = false;
+    config.cleanupInterval = 1;
+    ASSERT_TRUE(CacheManager::getInstance().initialize(config));
+
+    EXPECT_TRUE(CacheManager::getInstance().set("short", std::string("value"), 1s));
+    EXPECT_TRUE(CacheManager::getInstance().set("long", std::string("value")));
+
+    // Expired entries are dropped without anyone touching them
+    std::this_thread::sleep_for(3500ms);
+    EXPECT_EQ(CacheManager::getInstance().getEntryCount(), 1);
+    EXPECT_EQ(CacheManager::getInstance().getStats().expiredCount, 1);
+    EXPECT_TRUE(CacheManager::getInstance().exists("long"));
+}
+
+// Memory Accounting Tests
+TEST_F(CacheManagerComprehensiveTest, SizeIncludesOverhead) {
+    // Bookkeeping is charged even for tiny values
+    EXPECT_TRUE(CacheManager::getInstance().set("k", std::string("v")));
+    EXPECT_GT(CacheManager::getInstance().getSize("k"), 2 * sizeof(void*));
+
+    // Large values are charged at least their allocation
+    std::string value = createTestValue(4096);
+    EXPECT_TRUE(CacheManager::getInstance().set("big", value));
+    EXPECT_GE(CacheManager::getInstance().getSize("big"), 4096 + 1);
+    EXPECT_EQ(CacheManager::getInstance().getTotalSize(),
+              CacheManager::getInstance().getSize("k") + CacheManager::getInstance().getSize("big"));
+}
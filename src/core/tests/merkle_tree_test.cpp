@@ -0,0 +1,207 @@
+/**
+ * @file $(basename "$1")
+ * @brief $(basename "$1" | sed 's/\./_/g' | tr '[:lower:]' '[:upper:]')
+ * @copyright Copyright (c) 2025 Satoxcoin Core Developers
+ * @license MIT License
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <gtest/gtest.h>
+#include "satox/core/merkle_tree.h"
+#include <openssl/evp.h>
+#include <vector>
+
+using namespace satox::core;
+
+namespace {
+
+using Digest = MerkleTree::Digest;
+
+Digest referenceHash(const uint8_t* data, size_t size) {
+    Digest digest{};
+    EVP_Digest(data, size, digest.data(), nullptr, EVP_sha256(), nullptr);
+    return digest;
+}
+
+Digest referencePair(const Digest& left, const Digest& right) {
+    uint8_t message[64];
+    std::copy(left.begin(), left.end(), message);
+    std::copy(right.begin(), right.end(), message + 32);
+    return referenceHash(message, sizeof(message));
+}
+
+// Root computed level by level with OpenSSL, pairing an odd last node with itself
+Digest referenceRoot(std::vector<Digest> level) {
+    while (level.size() > 1) {
+        std::vector<Digest> parents;
+        for (size_t i = 0; i < level.size(); i += 2) {
+            parents.push_back(referencePair(level[i], level[std::min(i + 1, level.size() - 1)]));
+        }
+        level = std::move(parents);
+    }
+    return level.front();
+}
+
+std::vector<Digest> makeLeaves(size_t count) {
+    std::vector<Digest> leaves(count);
+    for (size_t i = 0; i < count; i++) {
+        uint64_t seed = i * 0x9e3779b97f4a7c15ULL + 1;
+        leaves[i] = referenceHash(reinterpret_cast<const uint8_t*>(&seed), sizeof(seed));
+    }
+    return leaves;
+}
+
+const size_t LEAF_COUNTS[] = {1, 2, 3, 4, 5, 6, 7, 8, 9, 16, 17, 31, 32, 33, 255, 256, 1000, 1025};
+
+} // namespace
+
+class MerkleTreeTest : public ::testing::Test {
+protected:
+    void TearDown() override {
+        MerkleTree::setPortableHashingForTesting(false);
+    }
+};
+
+TEST_F(MerkleTreeTest, ShaNiMatchesPortableRoots) {
+    if (!MerkleTree::usesShaNiForTesting()) {
+        GTEST_SKIP() << "CPU has no SHA-NI; PortableFallback covers this build";
+    }
+
+    for (size_t count : LEAF_COUNTS) {
+        std::vector<Digest> leaves = makeLeaves(count);
+
+        MerkleTree::setPortableHashingForTesting(false);
+        MerkleTree shaNiTree;
+        shaNiTree.buildFromLeaves(leaves);
+
+        MerkleTree::setPortableHashingForTesting(true);
+        MerkleTree portableTree;
+        portableTree.buildFromLeaves(leaves);
+
+        EXPECT_EQ(shaNiTree.getRootDigest(), portableTree.getRootDigest()) << count << " leaves";
+        EXPECT_EQ(shaNiTree.getRootDigest(), referenceRoot(leaves)) << count << " leaves";
+    }
+}
+
+TEST_F(MerkleTreeTest, ShaNiBatchMatchesOpenSSL) {
+    if (!MerkleTree::usesShaNiForTesting()) {
+        GTEST_SKIP() << "CPU has no SHA-NI";
+    }
+
+    // Batch sizes around the kernel's unrolling, odd and even
+    std::vector<Digest> nodes = makeLeaves(2 * 9);
+    for (size_t count = 1; count <= 9; count++) {
+        std::vector<Digest> parents(count);
+        MerkleTree::hashPairs(nodes.data(), parents.data(), count);
+        for (size_t i = 0; i < count; i++) {
+            EXPECT_EQ(parents[i], referencePair(nodes[2 * i], nodes[2 * i + 1])) << "pair " << i << " of " << count;
+        }
+    }
+}
+
+TEST_F(MerkleTreeTest, PortableFallback) {
+    MerkleTree::setPortableHashingForTesting(true);
+    EXPECT_FALSE(MerkleTree::usesShaNiForTesting());
+
+    std::vector<Digest> pair = makeLeaves(2);
+    EXPECT_EQ(MerkleTree::hashPair(pair[0], pair[1]), referencePair(pair[0], pair[1]));
+
+    for (size_t count : LEAF_COUNTS) {
+        std::vector<Digest> leaves = makeLeaves(count);
+        MerkleTree tree;
+        tree.buildFromLeaves(leaves);
+        EXPECT_EQ(tree.getRootDigest(), referenceRoot(leaves)) << count << " leaves";
+    }
+}
+
+TEST_F(MerkleTreeTest, ParallelLevelsMatchReference) {
+    // Large enough that the lowest levels are hashed on several threads
+    std::vector<Digest> leaves = makeLeaves((1 << 15) + 3);
+    MerkleTree tree;
+    tree.buildFromLeaves(leaves);
+    EXPECT_EQ(tree.getRootDigest(), referenceRoot(leaves));
+}
+
+TEST_F(MerkleTreeTest, AppendMatchesRebuild) {
+    std::vector<Digest> leaves = makeLeaves(70);
+    MerkleTree incremental;
+    for (size_t i = 0; i < leaves.size(); i++) {
+        incremental.append(leaves[i]);
+
+        std::vector<Digest> prefix(leaves.begin(), leaves.begin() + i + 1);
+        MerkleTree rebuilt;
+        rebuilt.buildFromLeaves(prefix);
+        ASSERT_EQ(incremental.getLeafCount(), i + 1);
+        EXPECT_EQ(incremental.getRootDigest(), rebuilt.getRootDigest()) << "after " << i + 1 << " appends";
+        EXPECT_EQ(incremental.getProof(i), rebuilt.getProof(i)) << "after " << i + 1 << " appends";
+    }
+
+    // Batched appends and in-place updates land on the same roots
+    MerkleTree batched;
+    batched.appendLeaves(std::vector<Digest>(leaves.begin(), leaves.begin() + 33));
+    batched.appendLeaves(std::vector<Digest>(leaves.begin() + 33, leaves.end()));
+    EXPECT_EQ(batched.getRootDigest(), incremental.getRootDigest());
+
+    Digest replacement = makeLeaves(71).back();
+    leaves[17] = replacement;
+    ASSERT_TRUE(batched.updateLeaf(17, replacement));
+    EXPECT_EQ(batched.getRootDigest(), referenceRoot(leaves));
+    EXPECT_FALSE(batched.updateLeaf(leaves.size(), replacement));
+}
+
+TEST_F(MerkleTreeTest, BatchedVerificationRejectsTamperedProof) {
+    std::vector<Digest> leaves = makeLeaves(13);
+    MerkleTree tree;
+    tree.buildFromLeaves(leaves);
+    const Digest& root = tree.getRootDigest();
+
+    std::vector<size_t> indices = {0, 1, 6, 12};
+    std::vector<Digest> batchLeaves;
+    std::vector<std::vector<Digest>> proofs;
+    for (size_t index : indices) {
+        batchLeaves.push_back(leaves[index]);
+        proofs.push_back(tree.getProof(index));
+    }
+    ASSERT_TRUE(MerkleTree::verifyProofs(batchLeaves, indices, proofs, root));
+
+    // A flipped bit in any sibling of any proof fails the whole batch, even
+    // where an earlier proof already authenticated part of the path
+    for (size_t p = 0; p < proofs.size(); p++) {
+        for (size_t level = 0; level < proofs[p].size(); level++) {
+            auto tampered = proofs;
+            tampered[p][level][0] ^= 0x01;
+            EXPECT_FALSE(MerkleTree::verifyProofs(batchLeaves, indices, tampered, root))
+                << "proof " << p << " level " << level;
+        }
+    }
+
+    // So does a wrong leaf, a wrong index or a wrong root
+    auto wrongLeaves = batchLeaves;
+    wrongLeaves[2][31] ^= 0x80;
+    EXPECT_FALSE(MerkleTree::verifyProofs(wrongLeaves, indices, proofs, root));
+
+    auto wrongIndices = indices;
+    wrongIndices[1] = 2;
+    EXPECT_FALSE(MerkleTree::verifyProofs(batchLeaves, wrongIndices, proofs, root));
+
+    Digest wrongRoot = root;
+    wrongRoot[0] ^= 0x01;
+    EXPECT_FALSE(MerkleTree::verifyProofs(batchLeaves, indices, proofs, wrongRoot));
+}
@@ -0,0 +1,168 @@
+/**
+ * @file $(basename "$1")
+ * @brief $(basename "$1" | sed 's/\./_/g' | tr '[:lower:]' '[:upper:]')
+ * @copyright Copyright (c) 2025 Satoxcoin Core Developers
+ * @license MIT License
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <gtest/gtest.h>
+#include "satox/core/proof_of_work.h"
+#include <openssl/evp.h>
+#include <chrono>
+#include <cstring>
+#include <thread>
+
+using namespace satox::core;
+
+namespace {
+
+ProofOfWork::Hash referenceHash(const std::vector<uint8_t>& prefix, uint64_t nonce) {
+    std::vector<uint8_t> message = prefix;
+    for (int i = 0; i < 8; i++) {
+        message.push_back(static_cast<uint8_t>(nonce >> (8 * i)));
+    }
+    ProofOfWork::Hash digest{};
+    EVP_Digest(message.data(), message.size(), digest.data(), nullptr, EVP_sha256(), nullptr);
+    return digest;
+}
+
+bool meetsTarget(const ProofOfWork::Hash& digest, const ProofOfWork::Hash& target) {
+    return std::memcmp(digest.data(), target.data(), digest.size()) <= 0;
+}
+
+} // namespace
+
+class ProofOfWorkTest : public ::testing::Test {
+protected:
+    ProofOfWork pow;
+    const std::vector<uint8_t> prefix = std::vector<uint8_t>(76, 0x5a);
+};
+
+TEST_F(ProofOfWorkTest, FoundNonceMeetsTarget) {
+    ProofOfWork::Hash target = ProofOfWork::difficultyToTarget(4);
+    ProofOfWork::MiningOptions options;
+    options.threads = 1;
+
+    ProofOfWork::MiningResult result = pow.mine(prefix, target, options);
+    ASSERT_TRUE(result.found);
+    EXPECT_EQ(result.hash, referenceHash(prefix, result.nonce));
+    EXPECT_TRUE(meetsTarget(result.hash, target));
+    EXPECT_EQ(result.hashes, result.nonce + 1);
+
+    // Every nonce below the answer misses the target
+    for (uint64_t nonce = 0; nonce < result.nonce; nonce++) {
+        EXPECT_FALSE(meetsTarget(referenceHash(prefix, nonce), target));
+    }
+}
+
+TEST_F(ProofOfWorkTest, DigestMatchesAcrossBlockBoundaries) {
+    ProofOfWork::Hash target;
+    target.fill(0xff);
+    ProofOfWork::MiningOptions options;
+    options.threads = 1;
+    options.startNonce = 0x0123456789abcdefULL;
+
+    // Prefix lengths around the 55/56/64-byte padding edges
+    for (size_t length = 0; length <= 130; length++) {
+        std::vector<uint8_t> shortPrefix(length);
+        for (size_t i = 0; i < length; i++) {
+            shortPrefix[i] = static_cast<uint8_t>(i * 7 + 1);
+        }
+        ProofOfWork::MiningResult result = pow.mine(shortPrefix, target, options);
+        ASSERT_TRUE(result.found);
+        EXPECT_EQ(result.hash, referenceHash(shortPrefix, result.nonce)) << "prefix length " << length;
+    }
+}
+
+TEST_F(ProofOfWorkTest, MineBlockVerifies) {
+    const std::string previousHash(64, 'a');
+    const std::string merkleRoot(64, 'b');
+    const uint64_t timestamp = 1700000000;
+
+    std::string nonce = pow.mineBlock(previousHash, merkleRoot, timestamp, 3);
+    ASSERT_EQ(nonce.size(), 16u);
+    std::string hash = ProofOfWork::calculateHash(previousHash + merkleRoot + std::to_string(timestamp) + nonce);
+    EXPECT_TRUE(ProofOfWork::meetsDifficulty(hash, 3));
+    EXPECT_TRUE(pow.verifyBlock(hash, previousHash, merkleRoot, timestamp, 3, nonce));
+}
+
+TEST_F(ProofOfWorkTest, MultiThreadedMatchesSingleThreaded) {
+    ProofOfWork::Hash target = ProofOfWork::difficultyToTarget(5);
+    ProofOfWork::MiningOptions options;
+    options.startNonce = 1000;
+
+    options.threads = 1;
+    ProofOfWork::MiningResult single = pow.mine(prefix, target, options);
+    ASSERT_TRUE(single.found);
+
+    for (size_t threads : {2, 4, 8}) {
+        options.threads = threads;
+        ProofOfWork::MiningResult multi = pow.mine(prefix, target, options);
+        ASSERT_TRUE(multi.found) << threads << " threads";
+        EXPECT_EQ(multi.nonce, single.nonce) << threads << " threads";
+        EXPECT_EQ(multi.hash, single.hash) << threads << " threads";
+    }
+}
+
+TEST_F(ProofOfWorkTest, RangeWithoutSolution) {
+    // The all-zero target cannot be met
+    ProofOfWork::Hash target{};
+    ProofOfWork::MiningOptions options;
+    options.threads = 2;
+    options.startNonce = 10;
+    options.endNonce = 50000;
+
+    ProofOfWork::MiningResult result = pow.mine(prefix, target, options);
+    EXPECT_FALSE(result.found);
+    EXPECT_EQ(result.hashes, options.endNonce - options.startNonce + 1);
+}
+
+TEST_F(ProofOfWorkTest, CancelStopsRunningSearch) {
+    ProofOfWork::Hash target{};
+    ProofOfWork::MiningOptions options;
+    options.threads = 2;
+
+    ProofOfWork::MiningResult result;
+    std::thread miner([&]() { result = pow.mine(prefix, target, options); });
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    pow.cancel();
+    miner.join();
+
+    EXPECT_FALSE(result.found);
+    EXPECT_LT(result.hashes, options.endNonce);
+}
+
+TEST_F(ProofOfWorkTest, CancelBeforeStartIsNotLost) {
+    ProofOfWork::Hash target{};
+    ProofOfWork::MiningOptions options;
+    options.threads = 1;
+
+    pow.cancel();
+    ProofOfWork::MiningResult cancelled = pow.mine(prefix, target, options);
+    EXPECT_FALSE(cancelled.found);
+    EXPECT_EQ(cancelled.hashes, 0u);
+
+    // The cancel was consumed by that search; the next one runs to the end
+    options.endNonce = 1000;
+    ProofOfWork::MiningResult next = pow.mine(prefix, target, options);
+    EXPECT_FALSE(next.found);
+    EXPECT_EQ(next.hashes, 1001u);
+}
@@ -29,6 +29,8 @@
 #include <filesystem>
 #include <chrono>
 #include <thread>
+#include <atomic>
+#include <memory>
 
 using namespace satox::core;
 using json = nlohmann::json;
@@ -40,15 +42,8 @@ protected:
         std::filesystem::remove_all("./test_rocksdb");
         
         // Initialize database manager
-        DatabaseConfig config;
-        config.type = DatabaseType::ROCKSDB;
-        config.database = "./test_rocksdb";
-        config.additionalOptions["create_if_missing"] = true;
-        config.additionalOptions["enable_compression"] = true;
-        config.additionalOptions["compression_type"] = "snappy";
-        
-        manager = &DatabaseManager::getInstance();
-        EXPECT_TRUE(manager->initialize(config));
+        manager = std::make_unique<DatabaseManager>();
+        EXPECT_TRUE(manager->initialize(DatabaseManager::DatabaseConfig{}));
         
         // Connect to RocksDB
         connectionId = manager->connect(DatabaseType::ROCKSDB, {
@@ -68,7 +63,7 @@ protected:
         std::filesystem::remove_all("./test_rocksdb");
     }
 
-    DatabaseManager* manager;
+    std::unique_ptr<DatabaseManager> manager;
     std::string connectionId;
 };
 
@@ -142,13 +137,13 @@ TEST_F(RocksDBTest, MultiOperations) {
     EXPECT_TRUE(result["success"].get<bool>());
     EXPECT_EQ(result["rows"].size(), 4);
     
-    // Check that existing keys are found
+    // Check that existing keys are found; put_multi stores values as JSON text
     bool foundKey1 = false, foundKey2 = false, foundKey3 = false;
     for (const auto& row : result["rows"]) {
         std::string key = row["key"].get<std::string>();
-        if (key == "key1" && row["value"].get<std::string>() == "value1") foundKey1 = true;
-        if (key == "key2" && row["value"].get<std::string>() == "value2") foundKey2 = true;
-        if (key == "key3" && row["value"].get<std::string>() == "value3") foundKey3 = true;
+        if (key == "key1" && row["value"].get<std::string>() == json("value1").dump()) foundKey1 = true;
+        if (key == "key2" && row["value"].get<std::string>() == json("value2").dump()) foundKey2 = true;
+        if (key == "key3" && row["value"].get<std::string>() == json("value3").dump()) foundKey3 = true;
     }
     EXPECT_TRUE(foundKey1);
     EXPECT_TRUE(foundKey2);
@@ -472,7 +467,78 @@ TEST_F(RocksDBTest, CompressionTypes) {
     }
 }
 
-int main(int argc, char** argv) {
-    ::testing::InitGoogleTest(&argc, argv);
-    return RUN_ALL_TESTS();
-} 
\ No newline at end of file
+TEST_F(RocksDBTest, ColumnFamiliesAndPrefixSeek) {
+    const std::vector<std::string> families = {"blocks", "transactions", "assets", "nfts", "utxos"};
+    std::string familyConnectionId = manager->connect(DatabaseType::ROCKSDB, {
+        {"path", "./test_rocksdb_families"},
+        {"create_if_missing", true},
+        {"column_families", families},
+        {"block_cache_size", 16 * 1024 * 1024},
+        {"bloom_bits_per_key", 10},
+        {"prefix_lengths", {{"utxos", 8}}}
+    });
+    ASSERT_FALSE(familyConnectionId.empty());
+
+    json result;
+    EXPECT_TRUE(manager->executeQuery(familyConnectionId, json{{"operation", "list_column_families"}}.dump(), result));
+    // The configured families plus RocksDB's own "default" family
+    EXPECT_EQ(result["column_families"].size(), families.size() + 1);
+
+    // One atomic batch spanning two families
+    json batchQuery = {
+        {"operation", "write_batch"},
+        {"operations", {
+            {{"operation", "put"}, {"column_family", "utxos"}, {"key", "aaaaaaaa:0"}, {"value", "100"}},
+            {{"operation", "put"}, {"column_family", "utxos"}, {"key", "aaaaaaaa:1"}, {"value", "200"}},
+            {{"operation", "put"}, {"column_family", "utxos"}, {"key", "bbbbbbbb:0"}, {"value", "300"}},
+            {{"operation", "put"}, {"column_family", "transactions"}, {"key", "aaaaaaaa"}, {"value", "raw"}}
+        }}
+    };
+    result.clear();
+    EXPECT_TRUE(manager->executeQuery(familyConnectionId, batchQuery.dump(), result));
+    EXPECT_EQ(result["affected_rows"].get<int>(), 4);
+
+    // A batch naming an unknown family writes nothing
+    json badBatch = {
+        {"operation", "write_batch"},
+        {"operations", {
+            {{"operation", "put"}, {"column_family", "utxos"}, {"key", "cccccccc:0"}, {"value", "1"}},
+            {{"operation", "put"}, {"column_family", "missing"}, {"key", "x"}, {"value", "1"}}
+        }}
+    };
+    result.clear();
+    EXPECT_FALSE(manager->executeQuery(familyConnectionId, badBatch.dump(), result));
+    result.clear();
+    EXPECT_TRUE(manager->executeQuery(familyConnectionId,
+        json{{"operation", "exists"}, {"column_family", "utxos"}, {"key", "cccccccc:0"}}.dump(), result));
+    EXPECT_FALSE(result["exists"].get<bool>());
+
+    // Families are separate key spaces
+    result.clear();
+    EXPECT_FALSE(manager->executeQuery(familyConnectionId,
+        json{{"operation", "get"}, {"key", "aaaaaaaa:0"}}.dump(), result));
+
+    // Prefix seek stops at the end of the prefix
+    result.clear();
+    EXPECT_TRUE(manager->executeQuery(familyConnectionId,
+        json{{"operation", "scan"}, {"column_family", "utxos"}, {"prefix", "aaaaaaaa"}}.dump(), result));
+    EXPECT_EQ(result["count"].get<int>(), 2);
+
+    // Prefixes shorter than the extractor still see every match
+    result.clear();
+    EXPECT_TRUE(manager->executeQuery(familyConnectionId,
+        json{{"operation", "scan"}, {"column_family", "utxos"}, {"prefix", "b"}}.dump(), result));
+    EXPECT_EQ(result["count"].get<int>(), 1);
+
+    result.clear();
+    EXPECT_TRUE(manager->executeQuery(familyConnectionId,
+        json{{"operation", "get_multi"}, {"column_family", "utxos"},
+             {"keys", {"bbbbbbbb:0", "aaaaaaaa:1", "zzzzzzzz:0"}}}.dump(), result));
+    ASSERT_EQ(result["rows"].size(), 3);
+    EXPECT_EQ(result["rows"][0]["value"].get<std::string>(), "300");
+    EXPECT_EQ(result["rows"][1]["value"].get<std::string>(), "200");
+    EXPECT_FALSE(result["rows"][2]["found"].get<bool>());
+
+    manager->disconnect(familyConnectionId);
+    std::filesystem::remove_all("./test_rocksdb_families");
+}
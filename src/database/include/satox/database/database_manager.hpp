@@ -9,12 +9,17 @@
 #include <vector>
 #include <unordered_map>
 #include <mutex>
+#include <condition_variable>
+#include <thread>
 #include <memory>
 #include <functional>
 #include <chrono>
 #include <nlohmann/json.hpp>
 #include "types.hpp"
 #include "error.hpp"
+#include "undo_log.hpp"
+#include "snapshot.hpp"
+#include "storage_engine.hpp"
 #include <atomic>
 #include <spdlog/spdlog.h>
 
@@ -50,6 +55,17 @@ public:
     void shutdown();
     bool isInitialized() const;
 
+    // Durable storage
+    // With DatabaseConfig::storagePath set, initialize() recovers the last
+    // checkpoint plus the write-ahead log, and every write returns only once
+    // it is logged as the sync policy requires; a write the log loses is
+    // reverted in memory and reported as failed. Checkpoints run in the
+    // background when the log grows past checkpointLogBytes or
+    // checkpointIntervalMs elapses. A custom engine may be installed before
+    // initialize(); it is released on shutdown().
+    void setStorageEngine(std::unique_ptr<StorageEngine> engine);
+    bool checkpoint();
+
     // Configuration
     void setConfig(const DatabaseConfig& config);
     DatabaseConfig getConfig() const;
@@ -77,17 +93,29 @@ public:
     std::vector<nlohmann::json> query(const std::string& table, const nlohmann::json& query);
 
     // Transaction operations
+    // Writes inside a transaction apply in place and are undo-logged; commit
+    // returns once the transaction's log batch is durable and rolls the
+    // transaction back if it cannot be written. Readers
+    // on other threads keep seeing the last committed rows, tables and
+    // databases, and writers on other threads wait (up to the connection
+    // timeout) for commit/rollback. A writer called from inside a callback
+    // fails instead of waiting, since its caller still holds the lock.
     bool beginTransaction();
     bool commitTransaction();
     bool rollbackTransaction();
     bool isInTransaction() const;
 
     // Index operations
-    bool createIndex(const std::string& table, const std::string& field);
+    // HASH indexes serve equality/$in predicates; ORDERED indexes also serve
+    // $gt/$gte/$lt/$lte. Every table has an implicit index on "id"/"_id".
+    bool createIndex(const std::string& table, const std::string& field, IndexType type = IndexType::HASH);
     bool dropIndex(const std::string& table, const std::string& field);
     std::vector<std::string> listIndexes(const std::string& table);
 
     // Backup and restore
+    // Backups use the chunked binary snapshot format (see snapshot.hpp); the
+    // global lock is held only while row images are captured. Restore also
+    // accepts JSON backups written by earlier releases.
     bool createBackup(const std::string& backupPath);
     bool restoreFromBackup(const std::string& backupPath);
 
@@ -143,6 +171,36 @@ private:
     std::string generateUniqueId();
     bool hasRecentErrors() const;
 
+    // Transaction helpers
+    bool waitForWriteAccess(std::unique_lock<std::recursive_mutex>& lock, const std::string& operation);
+    bool readsCommittedState() const;
+    void undoTransaction();
+    void revertChanges(const std::vector<UndoEntry>& entries);
+    const TableData* visibleTable(const std::string& tableName, const std::map<RowId, RecordPtr>** images) const;
+    const TableData* committedTable(const std::string& database, const std::string& tableName,
+                                    const std::map<RowId, RecordPtr>** images) const;
+    bool committedDatabaseExists(const std::string& database) const;
+    std::vector<std::string> committedTableNames(const std::string& database) const;
+    std::map<std::string, IndexType> committedIndexes(const std::string& database, const std::string& tableName,
+                                                      const TableData& table) const;
+    std::vector<nlohmann::json> selectCommitted(const TableData& table, const std::map<RowId, RecordPtr>* images,
+                                                const nlohmann::json& query) const;
+    const nlohmann::json* findCommitted(const TableData& table, const std::map<RowId, RecordPtr>* images,
+                                        const std::string& id) const;
+    std::vector<std::pair<RowId, RecordPtr>> visibleRows(const TableData& table,
+                                                         const std::map<RowId, RecordPtr>* images) const;
+    void captureSnapshot(std::vector<std::string>& databases, std::vector<SnapshotTable>& tables) const;
+
+    // Storage helpers
+    bool loggingChanges() const;
+    uint64_t logChange(nlohmann::json change);
+    bool makeDurable(std::unique_lock<std::recursive_mutex>& lock, uint64_t lsn,
+                     std::vector<UndoEntry> undo, const std::string& operation);
+    bool writeCheckpoint(std::unique_lock<std::recursive_mutex>& lock, std::string& error);
+    void startCheckpointer();
+    void stopCheckpointer();
+    void requestCheckpoint();
+
     // Member variables
     mutable std::recursive_mutex mutex_;
     std::atomic<bool> initialized_ = false;
@@ -155,10 +213,24 @@ private:
     size_t maxConnections_ = 10;
     size_t connectionTimeout_ = 5000;  // 5 seconds
     bool inTransaction_ = false;
+    std::thread::id transactionOwner_;
+    UndoLog undoLog_;
+    std::condition_variable_any transactionDone_;
+    std::vector<nlohmann::json> transactionChanges_;   // logged as one batch on commit
+    bool transactionCommitting_ = false;               // commit batch appended, waiting to be durable
+    std::map<uint64_t, std::vector<UndoEntry>> undurable_; // applied changes not yet durable, by LSN
+
+    // Storage engine and background checkpointer
+    std::shared_ptr<StorageEngine> storage_;
+    std::mutex checkpointRunMutex_;                    // serialises checkpoints; taken before mutex_
+    std::mutex checkpointMutex_;
+    std::condition_variable checkpointWake_;
+    bool checkpointStop_ = false;
+    bool checkpointRequested_ = false;
+    std::thread checkpointThread_;
     
     // Database storage
     std::map<std::string, DatabaseData> databases_;
-    std::map<std::string, DatabaseData> transactionSnapshot_;
     
     // Callbacks
     DatabaseCallback databaseCallback_;
@@ -0,0 +1,82 @@
+/*
+ * MIT License
+ * Copyright(c) 2025 Satoxcoin Core Developer
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <map>
+#include <set>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include <nlohmann/json.hpp>
+
+namespace satox::database {
+
+// Stable, monotonically increasing row handle inside a table.
+// Iterating rows in RowId order yields insertion order.
+using RowId = uint64_t;
+
+// Index kinds supported by DatabaseManager::createIndex
+enum class IndexType {
+    HASH,     // equality and $in lookups
+    ORDERED   // equality, $in and range lookups ($gt/$gte/$lt/$lte)
+};
+
+std::string indexTypeToString(IndexType type);
+IndexType indexTypeFromString(const std::string& name);
+
+// Hash/equality functors that agree with nlohmann::json::operator==,
+// which compares integers and floats numerically (1 == 1.0).
+struct IndexKeyHash {
+    size_t operator()(const nlohmann::json& key) const;
+};
+
+struct IndexKeyEqual {
+    bool operator()(const nlohmann::json& lhs, const nlohmann::json& rhs) const {
+        return lhs == rhs;
+    }
+};
+
+/**
+ * @brief Secondary index over a single field of a table
+ *
+ * Maps field values to the set of rows holding that value. HASH indexes
+ * serve equality predicates in O(1); ORDERED indexes additionally serve
+ * range predicates in O(log n + k). Rows lacking the field are not indexed.
+ */
+class RecordIndex {
+public:
+    explicit RecordIndex(IndexType type = IndexType::HASH);
+
+    IndexType type() const { return type_; }
+
+    void add(const nlohmann::json& key, RowId row);
+    void remove(const nlohmann::json& key, RowId row);
+    void clear();
+    size_t keyCount() const;
+
+    // Collects candidate rows (sorted, unique) for a predicate on the indexed
+    // field. Returns false when the predicate cannot be served by this index.
+    bool lookup(const nlohmann::json& predicate, std::vector<RowId>& rows) const;
+
+private:
+    void collect(const std::set<RowId>& rows, std::vector<RowId>& out) const;
+
+    IndexType type_;
+    std::unordered_map<nlohmann::json, std::set<RowId>, IndexKeyHash, IndexKeyEqual> hash_;
+    std::map<nlohmann::json, std::set<RowId>> ordered_;
+};
+
+// Predicate helpers shared by indexed and scanning query paths.
+//
+// A query is an object of field -> predicate. A predicate is either a plain
+// value (equality) or an object whose keys are all operators:
+//   {"$eq": v}, {"$in": [v...]}, {"$gt": v}, {"$gte": v}, {"$lt": v}, {"$lte": v}
+bool isOperatorPredicate(const nlohmann::json& predicate);
+bool matchesPredicate(const nlohmann::json& value, const nlohmann::json& predicate);
+bool matchesQuery(const nlohmann::json& record, const nlohmann::json& query);
+
+} // namespace satox::database
@@ -0,0 +1,141 @@
+/*
+ * MIT License
+ * Copyright(c) 2025 Satoxcoin Core Developer
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <fstream>
+#include <map>
+#include <string>
+#include <vector>
+#include <nlohmann/json.hpp>
+#include "types.hpp"
+
+namespace satox::database {
+
+/**
+ * @brief Binary snapshot format used by DatabaseManager backups
+ *
+ * Layout (all integers little-endian):
+ *   header   "SATXSNAP" | u32 version | u32 flags
+ *   chunks   u32 length | u32 crc32 | { u32 length | u64 row id | CBOR record }*
+ *   footer   CBOR directory of databases, tables, schemas, indexes and chunk offsets
+ *   trailer  u64 footer offset | u32 footer length | u32 footer crc32 | "SATXEND\0"
+ *
+ * Records are streamed into bounded chunks, so writing never materialises
+ * more than one chunk. The footer lets readers locate every table directly
+ * and load tables independently. Row ids are present when kFlagRowIds is set
+ * (files written before it renumber rows on load); the record length does not
+ * include them.
+ */
+namespace snapshot {
+
+constexpr char kMagic[8] = {'S', 'A', 'T', 'X', 'S', 'N', 'A', 'P'};
+constexpr char kTrailerMagic[8] = {'S', 'A', 'T', 'X', 'E', 'N', 'D', '\0'};
+constexpr uint32_t kVersion = 1;
+constexpr size_t kHeaderSize = 16;
+constexpr size_t kTrailerSize = 24;
+constexpr size_t kDefaultChunkSize = 1 << 20;
+constexpr uint32_t kFlagRowIds = 1;
+
+uint32_t crc32(const uint8_t* data, size_t size, uint32_t crc = 0);
+
+// True if the file starts with the snapshot magic (as opposed to a legacy JSON backup)
+bool isSnapshotFile(const std::string& path);
+
+// Reads a backup written by earlier releases as one JSON document
+bool loadJsonBackup(const std::string& path, std::map<std::string, DatabaseData>& databases, std::string& error);
+
+} // namespace snapshot
+
+// Row images of one table captured for writing, see DatabaseManager::captureSnapshot
+struct SnapshotTable {
+    std::string database;
+    std::string table;
+    nlohmann::json schema;
+    nlohmann::json indexes;
+    std::vector<std::pair<RowId, RecordPtr>> rows;
+};
+
+// Writes a complete snapshot to `path` via a temporary file and rename.
+// Row images are released as they are written. With `sync` the file and its
+// directory are fsync'ed before returning.
+bool writeSnapshotFile(const std::string& path, const std::vector<std::string>& databases,
+                       std::vector<SnapshotTable>& tables, const nlohmann::json& metadata,
+                       bool sync, std::string& error);
+
+class SnapshotWriter {
+public:
+    explicit SnapshotWriter(size_t chunkSize = snapshot::kDefaultChunkSize);
+    ~SnapshotWriter();
+
+    bool open(const std::string& path);
+    void setMetadata(const nlohmann::json& metadata);
+    void addDatabase(const std::string& name);
+    void beginTable(const std::string& database, const std::string& table,
+                    const nlohmann::json& schema, const nlohmann::json& indexes);
+    void writeRecord(RowId row, const nlohmann::json& record);
+    void endTable();
+    bool finish();
+    void abort();                                // closes without a footer; the caller removes the file
+
+    const std::string& error() const { return error_; }
+
+private:
+    void flushChunk();
+    void writeBytes(const void* data, size_t size);
+
+    size_t chunkSize_;
+    std::ofstream out_;
+    uint64_t offset_ = 0;
+    std::vector<uint8_t> chunk_;
+    size_t chunkRecords_ = 0;
+    nlohmann::json directory_ = nlohmann::json::object();
+    nlohmann::json* table_ = nullptr;
+    std::string error_;
+};
+
+class SnapshotReader {
+public:
+    struct TableEntry {
+        std::string database;
+        std::string table;
+        nlohmann::json schema;
+        nlohmann::json indexes;
+        nlohmann::json chunks;
+    };
+
+    SnapshotReader() = default;
+    ~SnapshotReader();
+    SnapshotReader(const SnapshotReader&) = delete;
+    SnapshotReader& operator=(const SnapshotReader&) = delete;
+
+    // Maps the file read-only and validates header, trailer and footer
+    bool open(const std::string& path);
+    void close();
+
+    const std::vector<std::string>& databases() const { return databases_; }
+    const std::vector<TableEntry>& tables() const { return tables_; }
+    const nlohmann::json& metadata() const { return metadata_; }
+
+    // Decodes one table straight from the mapping; safe to call concurrently
+    bool loadTable(const TableEntry& entry, TableData& table, std::string& error) const;
+
+    // Loads every table on up to `threads` workers
+    bool loadAll(std::map<std::string, DatabaseData>& databases, std::string& error, size_t threads = 0) const;
+
+    const std::string& error() const { return error_; }
+
+private:
+    const uint8_t* data_ = nullptr;
+    size_t size_ = 0;
+    uint32_t flags_ = 0;
+    std::vector<std::string> databases_;
+    std::vector<TableEntry> tables_;
+    nlohmann::json metadata_;
+    std::string error_;
+};
+
+} // namespace satox::database
@@ -0,0 +1,140 @@
+/*
+ * MIT License
+ * Copyright(c) 2025 Satoxcoin Core Developer
+ */
+
+#pragma once
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <map>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include <nlohmann/json.hpp>
+#include "snapshot.hpp"
+#include "types.hpp"
+
+namespace satox::database {
+
+/**
+ * @brief Persistence behind DatabaseManager
+ *
+ * The manager keeps its working set in memory and hands every committed change
+ * to the engine as a JSON array of change records (see storage_engine.cpp for
+ * the record layout). A batch is atomic: recovery applies all of it or none.
+ *
+ * Calls are made in this order: open, recover, then any mix of append /
+ * waitDurable / checkpoints, then close.
+ */
+class StorageEngine {
+public:
+    virtual ~StorageEngine() = default;
+
+    virtual bool open(const DatabaseConfig& config, std::string& error) = 0;
+    virtual void close() = 0;
+
+    // False when nothing outlives the process; the manager then skips building change records
+    virtual bool durable() const = 0;
+
+    // Rebuilds the last durable state into `databases`
+    virtual bool recover(std::map<std::string, DatabaseData>& databases, std::string& error) = 0;
+
+    // Appends one batch and returns its log sequence number. Called with the
+    // manager lock held, so log order is apply order.
+    virtual uint64_t append(const nlohmann::json& changes) = 0;
+
+    // Blocks until `lsn` is as durable as the sync policy promises. Called
+    // without the manager lock so concurrent commits can share one flush.
+    virtual bool waitDurable(uint64_t lsn, std::string& error) = 0;
+
+    // Checkpointing. beginCheckpoint runs under the manager lock together with
+    // the state capture and reports the LSN that capture reflects;
+    // completeCheckpoint persists the capture and discards the log it covers.
+    virtual bool needsCheckpoint() const = 0;
+    virtual bool beginCheckpoint(uint64_t& lsn, std::string& error) = 0;
+    virtual bool completeCheckpoint(uint64_t lsn, const std::vector<std::string>& databases,
+                                    std::vector<SnapshotTable>& tables, std::string& error) = 0;
+};
+
+// Default engine: data lives only as long as the process
+class MemoryStorageEngine : public StorageEngine {
+public:
+    bool open(const DatabaseConfig& config, std::string& error) override;
+    void close() override;
+    bool durable() const override;
+    bool recover(std::map<std::string, DatabaseData>& databases, std::string& error) override;
+    uint64_t append(const nlohmann::json& changes) override;
+    bool waitDurable(uint64_t lsn, std::string& error) override;
+    bool needsCheckpoint() const override;
+    bool beginCheckpoint(uint64_t& lsn, std::string& error) override;
+    bool completeCheckpoint(uint64_t lsn, const std::vector<std::string>& databases,
+                            std::vector<SnapshotTable>& tables, std::string& error) override;
+};
+
+/**
+ * @brief Write-ahead log plus checkpoint snapshots in DatabaseConfig::storagePath
+ *
+ * Files:
+ *   checkpoint.snap        last checkpoint (snapshot format, metadata {"lsn": n})
+ *   wal-<first lsn>.log    log segments of  u32 length | u32 crc32 | u64 lsn | CBOR batch
+ *
+ * Appends only encode into a buffer. The first committer to wait becomes the
+ * flush leader: it writes everything buffered so far with one write() and
+ * one fdatasync(), while later committers queue behind it and are usually
+ * covered by the next flush (group commit). Each checkpoint starts a new
+ * segment, so the segments it covers can simply be deleted.
+ *
+ * Recovery loads the checkpoint, replays newer records in LSN order and stops
+ * at the first torn or corrupt record, truncating the log there.
+ */
+class WalStorageEngine : public StorageEngine {
+public:
+    WalStorageEngine() = default;
+    ~WalStorageEngine() override;
+    WalStorageEngine(const WalStorageEngine&) = delete;
+    WalStorageEngine& operator=(const WalStorageEngine&) = delete;
+
+    bool open(const DatabaseConfig& config, std::string& error) override;
+    void close() override;
+    bool durable() const override;
+    bool recover(std::map<std::string, DatabaseData>& databases, std::string& error) override;
+    uint64_t append(const nlohmann::json& changes) override;
+    bool waitDurable(uint64_t lsn, std::string& error) override;
+    bool needsCheckpoint() const override;
+    bool beginCheckpoint(uint64_t& lsn, std::string& error) override;
+    bool completeCheckpoint(uint64_t lsn, const std::vector<std::string>& databases,
+                            std::vector<SnapshotTable>& tables, std::string& error) override;
+
+private:
+    std::string segmentPath(uint64_t firstLsn) const;
+    std::map<uint64_t, std::string> listSegments() const;
+    bool openSegment(uint64_t firstLsn, std::string& error);
+    bool flushLocked(std::unique_lock<std::mutex>& lock, bool sync);
+    void syncLoop();
+
+    std::string directory_;
+    SyncPolicy policy_ = SyncPolicy::EVERY_COMMIT;
+    std::chrono::milliseconds syncInterval_{100};
+    size_t checkpointBytes_ = 0;
+    std::chrono::milliseconds checkpointInterval_{0};
+
+    mutable std::mutex mutex_;
+    std::condition_variable cv_;
+    int fd_ = -1;
+    uint64_t segmentStart_ = 0;
+    std::vector<uint8_t> pending_;
+    uint64_t nextLsn_ = 1;
+    uint64_t writtenLsn_ = 0;   // handed to the OS
+    uint64_t syncedLsn_ = 0;    // on stable storage
+    bool flushing_ = false;
+    std::string ioError_;
+    size_t bytesSinceCheckpoint_ = 0;
+    std::chrono::steady_clock::time_point lastCheckpoint_;
+    bool stopping_ = false;
+    std::thread syncThread_;
+};
+
+} // namespace satox::database
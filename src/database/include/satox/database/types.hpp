@@ -28,8 +28,12 @@
 #include <string>
 #include <vector>
 #include <map>
+#include <memory>
+#include <set>
+#include <unordered_map>
 #include <chrono>
 #include <nlohmann/json.hpp>
+#include "record_index.hpp"
 
 namespace satox::database {
 
@@ -46,6 +50,13 @@ struct Version {
     }
 };
 
+// When the write-ahead log is forced to disk
+enum class SyncPolicy {
+    EVERY_COMMIT,   // commits return once their log record is fsync'ed (grouped across threads)
+    INTERVAL,       // fsync every syncIntervalMs; a crash may lose that window
+    OS              // written on commit, flushed whenever the OS decides
+};
+
 // Configuration structures
 struct DatabaseConfig {
     std::string name = "satox_database";
@@ -54,6 +65,13 @@ struct DatabaseConfig {
     int maxConnections = 10;
     int connectionTimeout = 5000;
     nlohmann::json additionalConfig;
+
+    // Durable storage; an empty storagePath keeps all data in memory only
+    std::string storagePath;
+    SyncPolicy syncPolicy = SyncPolicy::EVERY_COMMIT;
+    int syncIntervalMs = 100;
+    size_t checkpointLogBytes = 64 * 1024 * 1024;  // checkpoint once the log grows this much
+    int checkpointIntervalMs = 60000;              // or this long after the last checkpoint
 };
 
 // Statistics structures
@@ -113,10 +131,37 @@ struct DatabaseHealth {
 };
 
 // Database storage structures
+
+// Records are immutable once stored; an update swaps in a new image. Sharing
+// images lets transactions and snapshots hold versions without deep copies.
+using RecordPtr = std::shared_ptr<const nlohmann::json>;
+
 struct TableData {
     nlohmann::json schema;
-    std::vector<nlohmann::json> records;
-    std::map<std::string, std::vector<std::string>> indexes;
+    std::map<RowId, RecordPtr> rows;                                // ordered by insertion
+    RowId nextRowId = 0;
+    std::unordered_map<std::string, std::set<RowId>> primaryIndex;  // implicit index on "id"/"_id"
+    std::map<std::string, RecordIndex> indexes;                     // secondary indexes by field
+
+    // Row maintenance; every mutation keeps primaryIndex and indexes in sync.
+    // replaceRow/eraseRow return the previous image.
+    RowId insertRow(nlohmann::json record);
+    void restoreRow(RowId row, RecordPtr record);
+    RecordPtr replaceRow(RowId row, RecordPtr record);
+    RecordPtr eraseRow(RowId row);
+
+    // Lookups
+    const nlohmann::json* findRow(const std::string& id, RowId* row = nullptr) const;
+    std::vector<RowId> selectRows(const nlohmann::json& query) const;
+    std::vector<nlohmann::json> records() const;
+
+    // Index management
+    void addIndex(const std::string& field, IndexType type);
+    void rebuildIndexes();
+
+private:
+    void indexRow(RowId row, const nlohmann::json& record);
+    void unindexRow(RowId row, const nlohmann::json& record);
 };
 
 struct DatabaseData {
@@ -0,0 +1,85 @@
+/*
+ * MIT License
+ * Copyright(c) 2025 Satoxcoin Core Developer
+ */
+
+#pragma once
+
+#include <map>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+#include "types.hpp"
+
+namespace satox::database {
+
+// One reversible change made while a transaction is open
+struct UndoEntry {
+    enum class Kind {
+        INSERT_ROW,
+        UPDATE_ROW,
+        ERASE_ROW,
+        CREATE_TABLE,
+        DROP_TABLE,
+        CREATE_INDEX,
+        DROP_INDEX,
+        CREATE_DATABASE,
+        DROP_DATABASE
+    };
+
+    UndoEntry(Kind kind, std::string database, std::string table = {})
+        : kind(kind), database(std::move(database)), table(std::move(table)) {}
+
+    Kind kind;
+    std::string database;
+    std::string table;
+    RowId row = 0;
+    RecordPtr before;                            // UPDATE_ROW / ERASE_ROW
+    std::shared_ptr<TableData> droppedTable;     // DROP_TABLE
+    std::shared_ptr<DatabaseData> droppedDatabase; // DROP_DATABASE
+    std::string field;                           // CREATE_INDEX / DROP_INDEX
+    bool hadIndex = false;                       // CREATE_INDEX replaced an existing index
+    IndexType indexType = IndexType::HASH;       // previous (CREATE_INDEX) or dropped (DROP_INDEX) type
+    std::map<std::string, std::map<RowId, RecordPtr>> droppedImages; // DROP_TABLE / DROP_DATABASE, by table
+};
+
+/**
+ * @brief Undo log backing DatabaseManager transactions
+ *
+ * Writes inside a transaction are applied in place and recorded here, so
+ * begin/commit cost O(1) and rollback costs O(changes). Because records are
+ * immutable shared images, remembering a before-image is a pointer copy.
+ *
+ * The first before-image of every touched row is also kept per table, which
+ * lets readers outside the transaction see the last committed state. Dropping
+ * a table or database moves its images into the drop entry, so a table
+ * recreated under the same name inside the transaction starts clean.
+ */
+class UndoLog {
+public:
+    void recordInsert(const std::string& database, const std::string& table, RowId row);
+    void recordUpdate(const std::string& database, const std::string& table, RowId row, RecordPtr before);
+    void recordErase(const std::string& database, const std::string& table, RowId row, RecordPtr before);
+    void record(UndoEntry entry);
+
+    const std::vector<UndoEntry>& entries() const { return entries_; }
+    bool empty() const { return entries_.empty(); }
+    void clear();
+
+    // Committed images of rows touched in this transaction, keyed by row.
+    // A null image means the row did not exist before the transaction.
+    const std::map<RowId, RecordPtr>* committedImages(const std::string& database, const std::string& table) const;
+
+    // Oldest CREATE/DROP of the table (or, with an empty table, of the
+    // database) in this transaction; it decides what the committed view sees.
+    const UndoEntry* firstSchemaChange(const std::string& database, const std::string& table) const;
+
+private:
+    void touch(const std::string& database, const std::string& table, RowId row, RecordPtr before);
+
+    std::vector<UndoEntry> entries_;
+    std::map<std::pair<std::string, std::string>, std::map<RowId, RecordPtr>> committedImages_;
+};
+
+} // namespace satox::database
@@ -4,11 +4,14 @@
  */
 
 #include "satox/database/database_manager.hpp"
+#include "satox/database/snapshot.hpp"
 #include <iostream>
 #include <fstream>
 #include <filesystem>
 #include <algorithm>
 #include <sstream>
+#include <iterator>
+#include <set>
 #include <spdlog/spdlog.h>
 #include <spdlog/sinks/rotating_file_sink.h>
 #include <spdlog/sinks/stdout_color_sinks.h>
@@ -21,6 +24,30 @@ const Version DatabaseManager::VERSION{0, 1, 0, "build", "commit"};
 
 template<typename T> using atomic_t = std::atomic<T>;
 
+namespace {
+
+// Callbacks run with mutex_ held by their caller. Waiting on transactionDone_
+// releases only one level of a recursive hold, so a callback that re-enters a
+// writer while another thread's transaction is open must not wait for it.
+thread_local int callbackDepth = 0;
+
+struct CallbackScope {
+    CallbackScope() { ++callbackDepth; }
+    ~CallbackScope() { --callbackDepth; }
+};
+
+// checkpointRunMutex_ is taken before mutex_. A callback already holds mutex_,
+// so it may only take the checkpoint lock when no other checkpoint is running.
+bool acquireCheckpointLock(std::unique_lock<std::mutex>& checkpointLock) {
+    if (callbackDepth > 0) {
+        return checkpointLock.try_lock();
+    }
+    checkpointLock.lock();
+    return true;
+}
+
+} // namespace
+
 DatabaseManager& DatabaseManager::getInstance() {
     static DatabaseManager instance;
     return instance;
@@ -79,6 +106,24 @@ bool DatabaseManager::initialize(const DatabaseConfig& config) {
         // if (logger_) logger_->debug("Clearing currentDatabase_");
         currentDatabase_.clear();
         
+        // Recover durable state: last checkpoint plus the write-ahead log
+        if (!storage_) {
+            if (config_.storagePath.empty()) {
+                storage_ = std::make_unique<MemoryStorageEngine>();
+            } else {
+                storage_ = std::make_unique<WalStorageEngine>();
+            }
+        }
+        std::string storageError;
+        if (!storage_->open(config_, storageError) || !storage_->recover(databases_, storageError)) {
+            storage_->close();
+            storage_.reset();
+            databases_.clear();
+            if (logger_) logger_->error("Storage recovery failed: {}", storageError);
+            handleError("initialize", DatabaseErrorCode::INITIALIZATION_ERROR, "Storage recovery failed: " + storageError);
+            return false;
+        }
+        
         stats_ = DatabaseStats{};
         stats_.lastOperation = std::chrono::system_clock::now();
         health_ = DatabaseHealth{};
@@ -90,6 +135,9 @@ bool DatabaseManager::initialize(const DatabaseConfig& config) {
         isConnected_ = true;
         
         initialized_.store(true);
+        if (storage_->durable()) {
+            startCheckpointer();
+        }
         
         auto duration = std::chrono::duration_cast<std::chrono::milliseconds>(
             std::chrono::high_resolution_clock::now() - start);
@@ -109,14 +157,20 @@ bool DatabaseManager::initialize(const DatabaseConfig& config) {
 
 void DatabaseManager::shutdown() {
     std::cerr << "[DEBUG] DatabaseManager::shutdown() called" << std::endl;
+    // The checkpointer takes mutex_ itself, so stop it before locking
+    stopCheckpointer();
+    std::unique_lock<std::mutex> checkpointLock(checkpointRunMutex_);
     std::lock_guard<std::recursive_mutex> lock(mutex_);
     
     if (!initialized_.load()) {
         return;
     }
     
-    // Mark as not initialized first to prevent new operations
+    // Mark as not initialized first to prevent new operations. Checkpoints
+    // queued behind us now see that, and callbacks fired by disconnect()
+    // may call checkpoint() without deadlocking on checkpointRunMutex_.
     initialized_.store(false);
+    checkpointLock.unlock();
     
     try {
         // Disconnect first if connected
@@ -143,11 +197,26 @@ void DatabaseManager::shutdown() {
             tableSchemas_.clear();
             tableIndexes_.clear();
             databases_.clear();
-            transactionSnapshot_.clear();
+            undoLog_.clear();
+            undurable_.clear();
+            transactionChanges_.clear();
+            inTransaction_ = false;
+            transactionCommitting_ = false;
+            transactionDone_.notify_all();
         } catch (const std::exception& e) {
             // Ignore data structure clearing errors during shutdown
         }
         
+        // Flush and close the log; uncommitted transaction changes were never logged
+        try {
+            if (storage_) {
+                storage_->close();
+                storage_.reset();
+            }
+        } catch (const std::exception& e) {
+            // Ignore storage errors during shutdown
+        }
+        
         // Update stats without logging to avoid logger issues
         try {
             stats_.totalOperations++;
@@ -180,6 +249,7 @@ void DatabaseManager::shutdown() {
 }
 
 void DatabaseManager::invokeCallbacks(const std::string& operation, bool success, const std::string& error) {
+    CallbackScope scope;
     if (databaseCallback_) {
         try {
             databaseCallback_(operation, success, error);
@@ -198,7 +268,10 @@ void DatabaseManager::invokeCallbacks(const std::string& operation, bool success
 }
 
 bool DatabaseManager::createDatabase(const std::string& name) {
-    std::lock_guard<std::recursive_mutex> lock(mutex_);
+    std::unique_lock<std::recursive_mutex> lock(mutex_);
+    if (!waitForWriteAccess(lock, "createDatabase")) {
+        return false;
+    }
     
     // if (logger_) logger_->debug("DatabaseManager::createDatabase() - ENTRY: {}", name);
     
@@ -222,6 +295,14 @@ bool DatabaseManager::createDatabase(const std::string& name) {
         DatabaseData db;
         db.name = name;
         databases_[name] = db;
+        UndoEntry undo{UndoEntry::Kind::CREATE_DATABASE, name};
+        if (inTransaction_) {
+            undoLog_.record(undo);
+        }
+        uint64_t lsn = loggingChanges() ? logChange({{"op", "create_database"}, {"db", name}}) : 0;
+        if (!makeDurable(lock, lsn, {std::move(undo)}, "createDatabase")) {
+            return false;
+        }
         // if (logger_) logger_->info("Database '{}' created successfully", name);
         logOperation("createDatabase", true, "Database created: " + name);
         invokeCallbacks("createDatabase", true, "");
@@ -268,7 +349,7 @@ bool DatabaseManager::databaseExists(const std::string& name) {
         return false;
     }
     
-    bool exists = databases_.find(name) != databases_.end();
+    bool exists = readsCommittedState() ? committedDatabaseExists(name) : databases_.find(name) != databases_.end();
     
     // if (logger_) logger_->debug("DatabaseManager::databaseExists() - EXIT: {}", exists);
     return exists;
@@ -286,6 +367,24 @@ std::vector<std::string> DatabaseManager::listDatabases() {
     }
     
     std::vector<std::string> databaseNames;
+    if (readsCommittedState()) {
+        // Committed view: hide databases the open transaction created, keep the ones it dropped
+        std::set<std::string> candidates;
+        for (const auto& [name, _] : databases_) {
+            candidates.insert(name);
+        }
+        for (const auto& entry : undoLog_.entries()) {
+            if (entry.kind == UndoEntry::Kind::DROP_DATABASE) {
+                candidates.insert(entry.database);
+            }
+        }
+        for (const auto& name : candidates) {
+            if (committedDatabaseExists(name)) {
+                databaseNames.push_back(name);
+            }
+        }
+        return databaseNames;
+    }
     for (const auto& [name, _] : databases_) {
         databaseNames.push_back(name);
     }
@@ -295,7 +394,10 @@ std::vector<std::string> DatabaseManager::listDatabases() {
 }
 
 bool DatabaseManager::deleteDatabase(const std::string& name) {
-    std::lock_guard<std::recursive_mutex> lock(mutex_);
+    std::unique_lock<std::recursive_mutex> lock(mutex_);
+    if (!waitForWriteAccess(lock, "deleteDatabase")) {
+        return false;
+    }
     
     // if (logger_) logger_->debug("DatabaseManager::deleteDatabase() - ENTRY: {}", name);
     
@@ -313,7 +415,16 @@ bool DatabaseManager::deleteDatabase(const std::string& name) {
             return false;
         }
         
+        UndoEntry undo{UndoEntry::Kind::DROP_DATABASE, name};
+        undo.droppedDatabase = std::make_shared<DatabaseData>(std::move(it->second));
+        if (inTransaction_) {
+            undoLog_.record(undo);
+        }
         databases_.erase(it);
+        uint64_t lsn = loggingChanges() ? logChange({{"op", "drop_database"}, {"db", name}}) : 0;
+        if (!makeDurable(lock, lsn, {std::move(undo)}, "deleteDatabase")) {
+            return false;
+        }
         
         // if (logger_) logger_->info("Database '{}' deleted successfully", name);
         logOperation("deleteDatabase", true, "Database deleted: " + name);
@@ -421,13 +532,8 @@ bool DatabaseManager::tableExists(const std::string& tableName) {
         return false;
     }
     
-    auto dbIt = databases_.find(currentDatabase_);
-    if (dbIt == databases_.end()) {
-        // if (logger_) logger_->debug("DatabaseManager::tableExists() - EXIT (current database not found)");
-        return false;
-    }
-    
-    bool exists = dbIt->second.tables.find(tableName) != dbIt->second.tables.end();
+    const std::map<RowId, RecordPtr>* images = nullptr;
+    bool exists = visibleTable(tableName, &images) != nullptr;
     
     // if (logger_) logger_->debug("DatabaseManager::tableExists() - EXIT: {}", exists);
     return exists;
@@ -444,6 +550,10 @@ std::vector<std::string> DatabaseManager::listTables() {
         return {};
     }
     
+    if (readsCommittedState()) {
+        return committedTableNames(currentDatabase_);
+    }
+    
     auto dbIt = databases_.find(currentDatabase_);
     if (dbIt == databases_.end()) {
         // if (logger_) logger_->debug("DatabaseManager::listTables() - EXIT (current database not found)");
@@ -460,7 +570,10 @@ std::vector<std::string> DatabaseManager::listTables() {
 }
 
 bool DatabaseManager::deleteTable(const std::string& tableName) {
-    std::lock_guard<std::recursive_mutex> lock(mutex_);
+    std::unique_lock<std::recursive_mutex> lock(mutex_);
+    if (!waitForWriteAccess(lock, "deleteTable")) {
+        return false;
+    }
     
     // if (logger_) logger_->debug("DatabaseManager::deleteTable() - ENTRY: {}", tableName);
     
@@ -484,7 +597,17 @@ bool DatabaseManager::deleteTable(const std::string& tableName) {
             return false;
         }
         
+        UndoEntry undo{UndoEntry::Kind::DROP_TABLE, currentDatabase_, tableName};
+        undo.droppedTable = std::make_shared<TableData>(std::move(tableIt->second));
+        if (inTransaction_) {
+            undoLog_.record(undo);
+        }
         dbIt->second.tables.erase(tableIt);
+        uint64_t lsn = loggingChanges()
+            ? logChange({{"op", "drop_table"}, {"db", currentDatabase_}, {"table", tableName}}) : 0;
+        if (!makeDurable(lock, lsn, {std::move(undo)}, "deleteTable")) {
+            return false;
+        }
         
         // if (logger_) logger_->info("Table '{}' deleted successfully from database '{}'", tableName, currentDatabase_);
         logOperation("deleteTable", true, "Table deleted: " + tableName);
@@ -502,7 +625,10 @@ bool DatabaseManager::deleteTable(const std::string& tableName) {
 
 // Record operations
 bool DatabaseManager::insert(const std::string& tableName, const nlohmann::json& data) {
-    std::lock_guard<std::recursive_mutex> lock(mutex_);
+    std::unique_lock<std::recursive_mutex> lock(mutex_);
+    if (!waitForWriteAccess(lock, "insert")) {
+        return false;
+    }
     // if (logger_) logger_->debug("DatabaseManager::insert() - ENTRY: table={}, data_size={}", tableName, data.size());
     if (!initialized_.load() || currentDatabase_.empty()) {
         // if (logger_) logger_->debug("DatabaseManager::insert() - EXIT (not initialized or no current database)");
@@ -543,7 +669,20 @@ bool DatabaseManager::insert(const std::string& tableName, const nlohmann::json&
             id = generateUniqueId();
             recordData["_id"] = id;
         }
-        tableIt->second.records.push_back(recordData);
+        RowId row = tableIt->second.insertRow(std::move(recordData));
+        if (inTransaction_) {
+            undoLog_.recordInsert(currentDatabase_, tableName, row);
+        }
+        uint64_t lsn = 0;
+        if (loggingChanges()) {
+            lsn = logChange({{"op", "insert"}, {"db", currentDatabase_}, {"table", tableName},
+                             {"row", row}, {"record", *tableIt->second.rows.at(row)}});
+        }
+        UndoEntry undo{UndoEntry::Kind::INSERT_ROW, currentDatabase_, tableName};
+        undo.row = row;
+        if (!makeDurable(lock, lsn, {std::move(undo)}, "insert")) {
+            return false;
+        }
         // if (logger_) logger_->info("Record inserted successfully into table '{}' with ID '{}'", tableName, id);
         logOperation("insert", true, "Record inserted: " + id);
         invokeCallbacks("insert", true, id);
@@ -569,14 +708,9 @@ std::vector<nlohmann::json> DatabaseManager::query(const std::string& tableName,
     }
     
     try {
-        auto dbIt = databases_.find(currentDatabase_);
-        if (dbIt == databases_.end()) {
-            // if (logger_) logger_->debug("DatabaseManager::query() - EXIT (current database not found)");
-            return {};
-        }
-        
-        auto tableIt = dbIt->second.tables.find(tableName);
-        if (tableIt == dbIt->second.tables.end()) {
+        const std::map<RowId, RecordPtr>* images = nullptr;
+        const TableData* table = visibleTable(tableName, &images);
+        if (!table) {
             // if (logger_) logger_->debug("DatabaseManager::query() - EXIT (table not found)");
             handleError("query", DatabaseErrorCode::OPERATION_FAILED, "Table not found");
             return {};
@@ -584,22 +718,16 @@ std::vector<nlohmann::json> DatabaseManager::query(const std::string& tableName,
         
         std::vector<nlohmann::json> results;
         
-        if (query.empty()) {
+        if (readsCommittedState()) {
+            // Another thread has a transaction open; don't expose its writes
+            results = selectCommitted(*table, images, query);
+        } else if (query.empty()) {
             // Return all records
-            results = tableIt->second.records;
+            results = table->records();
         } else {
-            // Simple query matching (for demo purposes)
-            for (const auto& record : tableIt->second.records) {
-                bool matches = true;
-                for (const auto& [key, value] : query.items()) {
-                    if (!record.contains(key) || record[key] != value) {
-                        matches = false;
-                        break;
-                    }
-                }
-                if (matches) {
-                    results.push_back(record);
-                }
+            // Served from the most selective index available, else a scan
+            for (RowId row : table->selectRows(query)) {
+                results.push_back(*table->rows.at(row));
             }
         }
         
@@ -618,7 +746,10 @@ std::vector<nlohmann::json> DatabaseManager::query(const std::string& tableName,
 }
 
 bool DatabaseManager::update(const std::string& tableName, const std::string& id, const nlohmann::json& data) {
-    std::lock_guard<std::recursive_mutex> lock(mutex_);
+    std::unique_lock<std::recursive_mutex> lock(mutex_);
+    if (!waitForWriteAccess(lock, "update")) {
+        return false;
+    }
     
     // if (logger_) logger_->debug("DatabaseManager::update() - ENTRY: table={}, id={}", tableName, id);
     
@@ -643,21 +774,34 @@ bool DatabaseManager::update(const std::string& tableName, const std::string& id
         }
         
         // Find record by ID (check both "id" and "_id" fields)
-        for (auto& record : tableIt->second.records) {
-            if ((record.contains("id") && record["id"] == id) || 
-                (record.contains("_id") && record["_id"] == id)) {
-                // Update record
-                for (const auto& [key, value] : data.items()) {
-                    record[key] = value;
-                }
-                
-                // if (logger_) logger_->info("Record '{}' updated successfully in table '{}'", id, tableName);
-                logOperation("update", true, "Record updated: " + id);
-                invokeCallbacks("update", true, id);
-                
-                // if (logger_) logger_->debug("DatabaseManager::update() - EXIT (success)");
-                return true;
+        RowId row;
+        if (const auto* current = tableIt->second.findRow(id, &row)) {
+            // Update record
+            nlohmann::json record = *current;
+            for (const auto& [key, value] : data.items()) {
+                record[key] = value;
+            }
+            UndoEntry undo{UndoEntry::Kind::UPDATE_ROW, currentDatabase_, tableName};
+            undo.row = row;
+            undo.before = tableIt->second.replaceRow(row, std::make_shared<const nlohmann::json>(std::move(record)));
+            if (inTransaction_) {
+                undoLog_.recordUpdate(currentDatabase_, tableName, row, undo.before);
+            }
+            uint64_t lsn = 0;
+            if (loggingChanges()) {
+                lsn = logChange({{"op", "update"}, {"db", currentDatabase_}, {"table", tableName},
+                                 {"row", row}, {"record", *tableIt->second.rows.at(row)}});
             }
+            if (!makeDurable(lock, lsn, {std::move(undo)}, "update")) {
+                return false;
+            }
+            
+            // if (logger_) logger_->info("Record '{}' updated successfully in table '{}'", id, tableName);
+            logOperation("update", true, "Record updated: " + id);
+            invokeCallbacks("update", true, id);
+            
+            // if (logger_) logger_->debug("DatabaseManager::update() - EXIT (success)");
+            return true;
         }
         
         // if (logger_) logger_->debug("DatabaseManager::update() - EXIT (record not found)");
@@ -672,7 +816,10 @@ bool DatabaseManager::update(const std::string& tableName, const std::string& id
 }
 
 bool DatabaseManager::remove(const std::string& tableName, const std::string& id) {
-    std::lock_guard<std::recursive_mutex> lock(mutex_);
+    std::unique_lock<std::recursive_mutex> lock(mutex_);
+    if (!waitForWriteAccess(lock, "remove")) {
+        return false;
+    }
     
     // if (logger_) logger_->debug("DatabaseManager::remove() - ENTRY: table={}, id={}", tableName, id);
     
@@ -697,19 +844,26 @@ bool DatabaseManager::remove(const std::string& tableName, const std::string& id
         }
         
         // Find and remove record by ID (check both "id" and "_id" fields)
-        auto& records = tableIt->second.records;
-        for (auto it = records.begin(); it != records.end(); ++it) {
-            if ((it->contains("id") && (*it)["id"] == id) || 
-                (it->contains("_id") && (*it)["_id"] == id)) {
-                records.erase(it);
-                
-                // if (logger_) logger_->info("Record '{}' removed successfully from table '{}'", id, tableName);
-                logOperation("remove", true, "Record removed: " + id);
-                invokeCallbacks("remove", true, id);
-                
-                // if (logger_) logger_->debug("DatabaseManager::remove() - EXIT (success)");
-                return true;
+        RowId row;
+        if (tableIt->second.findRow(id, &row)) {
+            UndoEntry undo{UndoEntry::Kind::ERASE_ROW, currentDatabase_, tableName};
+            undo.row = row;
+            undo.before = tableIt->second.eraseRow(row);
+            if (inTransaction_) {
+                undoLog_.recordErase(currentDatabase_, tableName, row, undo.before);
+            }
+            uint64_t lsn = loggingChanges()
+                ? logChange({{"op", "erase"}, {"db", currentDatabase_}, {"table", tableName}, {"row", row}}) : 0;
+            if (!makeDurable(lock, lsn, {std::move(undo)}, "remove")) {
+                return false;
             }
+            
+            // if (logger_) logger_->info("Record '{}' removed successfully from table '{}'", id, tableName);
+            logOperation("remove", true, "Record removed: " + id);
+            invokeCallbacks("remove", true, id);
+            
+            // if (logger_) logger_->debug("DatabaseManager::remove() - EXIT (success)");
+            return true;
         }
         
         // if (logger_) logger_->debug("DatabaseManager::remove() - EXIT (record not found)");
@@ -735,30 +889,23 @@ nlohmann::json DatabaseManager::find(const std::string& tableName, const std::st
     }
     
     try {
-        auto dbIt = databases_.find(currentDatabase_);
-        if (dbIt == databases_.end()) {
-            // if (logger_) logger_->debug("DatabaseManager::find() - EXIT (current database not found)");
-            return nlohmann::json();
-        }
-        
-        auto tableIt = dbIt->second.tables.find(tableName);
-        if (tableIt == dbIt->second.tables.end()) {
+        const std::map<RowId, RecordPtr>* images = nullptr;
+        const TableData* table = visibleTable(tableName, &images);
+        if (!table) {
             // if (logger_) logger_->debug("DatabaseManager::find() - EXIT (table not found)");
             handleError("find", DatabaseErrorCode::OPERATION_FAILED, "Table not found");
             return nlohmann::json();
         }
         
         // Find record by ID (check both "id" and "_id" fields)
-        for (const auto& record : tableIt->second.records) {
-            if ((record.contains("id") && record["id"] == id) || 
-                (record.contains("_id") && record["_id"] == id)) {
-                // if (logger_) logger_->info("Record '{}' found successfully in table '{}'", id, tableName);
-                logOperation("find", true, "Record found: " + id);
-                invokeCallbacks("find", true, id);
-                
-                // if (logger_) logger_->debug("DatabaseManager::find() - EXIT (success)");
-                return record;
-            }
+        const auto* record = readsCommittedState() ? findCommitted(*table, images, id) : table->findRow(id);
+        if (record) {
+            // if (logger_) logger_->info("Record '{}' found successfully in table '{}'", id, tableName);
+            logOperation("find", true, "Record found: " + id);
+            invokeCallbacks("find", true, id);
+            
+            // if (logger_) logger_->debug("DatabaseManager::find() - EXIT (success)");
+            return *record;
         }
         
         if (logger_) logger_->debug("DatabaseManager::find() - EXIT (record not found)");
@@ -791,12 +938,10 @@ bool DatabaseManager::beginTransaction() {
     }
     
     try {
-        // Create snapshot of current database state
-        auto dbIt = databases_.find(currentDatabase_);
-        if (dbIt != databases_.end()) {
-            transactionSnapshot_[currentDatabase_] = dbIt->second;
-        }
-        
+        // Nothing is copied: writes are undo-logged as they happen
+        undoLog_.clear();
+        transactionChanges_.clear();
+        transactionOwner_ = std::this_thread::get_id();
         inTransaction_ = true;
         
         if (logger_) logger_->info("Transaction begun successfully");
@@ -814,7 +959,7 @@ bool DatabaseManager::beginTransaction() {
 }
 
 bool DatabaseManager::commitTransaction() {
-    std::lock_guard<std::recursive_mutex> lock(mutex_);
+    std::unique_lock<std::recursive_mutex> lock(mutex_);
     
     if (logger_) logger_->debug("DatabaseManager::commitTransaction() - ENTRY");
     
@@ -824,10 +969,33 @@ bool DatabaseManager::commitTransaction() {
         return false;
     }
     
+    if (transactionCommitting_) {
+        handleError("commitTransaction", DatabaseErrorCode::INVALID_STATE, "Transaction is already committing");
+        return false;
+    }
+    
     try {
-        // Transaction is already committed (changes are applied immediately in this implementation)
+        // Changes are already applied in place; committing logs the buffered
+        // changes as one atomic batch. The transaction stays open, and its undo
+        // log kept, until that batch is durable: other threads keep reading the
+        // committed state meanwhile, and a failed log write rolls it back.
+        uint64_t lsn = 0;
+        if (!transactionChanges_.empty()) {
+            lsn = storage_->append(nlohmann::json(std::move(transactionChanges_)));
+            transactionChanges_.clear();
+            if (storage_->needsCheckpoint()) {
+                requestCheckpoint();
+            }
+        }
+        transactionCommitting_ = true;
+        bool durable = makeDurable(lock, lsn, undoLog_.entries(), "commitTransaction");
+        transactionCommitting_ = false;
         inTransaction_ = false;
-        transactionSnapshot_.clear();
+        undoLog_.clear();
+        transactionDone_.notify_all();
+        if (!durable) {
+            return false;
+        }
         
         if (logger_) logger_->info("Transaction committed successfully");
         logOperation("commitTransaction", true, "Transaction committed");
@@ -854,17 +1022,18 @@ bool DatabaseManager::rollbackTransaction() {
         return false;
     }
     
+    if (transactionCommitting_) {
+        handleError("rollbackTransaction", DatabaseErrorCode::INVALID_STATE, "Transaction is committing");
+        return false;
+    }
+    
     try {
-        // Restore database state from snapshot
-        if (!currentDatabase_.empty()) {
-            auto snapshotIt = transactionSnapshot_.find(currentDatabase_);
-            if (snapshotIt != transactionSnapshot_.end()) {
-                databases_[currentDatabase_] = snapshotIt->second;
-            }
-        }
+        // Replay the undo log newest-first; nothing was logged yet
+        undoTransaction();
+        transactionChanges_.clear();
         
         inTransaction_ = false;
-        transactionSnapshot_.clear();
+        transactionDone_.notify_all();
         
         if (logger_) logger_->info("Transaction rolled back successfully");
         logOperation("rollbackTransaction", true, "Transaction rolled back");
@@ -885,9 +1054,348 @@ bool DatabaseManager::isInTransaction() const {
     return inTransaction_;
 }
 
+bool DatabaseManager::waitForWriteAccess(std::unique_lock<std::recursive_mutex>& lock, const std::string& operation) {
+    if (!inTransaction_ || transactionOwner_ == std::this_thread::get_id()) {
+        return true;
+    }
+    
+    if (callbackDepth > 0) {
+        handleError(operation, DatabaseErrorCode::INVALID_STATE,
+                    "Cannot wait for an open transaction from inside a callback");
+        return false;
+    }
+    
+    // Single writer: other threads queue behind the open transaction
+    bool released = transactionDone_.wait_for(lock, std::chrono::milliseconds(connectionTimeout_), [this] {
+        return !inTransaction_ || !initialized_.load();
+    });
+    if (!released) {
+        handleError(operation, DatabaseErrorCode::TIMEOUT_ERROR, "Timed out waiting for open transaction");
+    }
+    return released;
+}
+
+bool DatabaseManager::readsCommittedState() const {
+    return inTransaction_ && transactionOwner_ != std::this_thread::get_id();
+}
+
+void DatabaseManager::undoTransaction() {
+    revertChanges(undoLog_.entries());
+    undoLog_.clear();
+}
+
+void DatabaseManager::revertChanges(const std::vector<UndoEntry>& entries) {
+    for (auto it = entries.rbegin(); it != entries.rend(); ++it) {
+        const UndoEntry& entry = *it;
+        
+        if (entry.kind == UndoEntry::Kind::CREATE_DATABASE) {
+            databases_.erase(entry.database);
+            continue;
+        }
+        if (entry.kind == UndoEntry::Kind::DROP_DATABASE) {
+            databases_[entry.database] = std::move(*entry.droppedDatabase);
+            continue;
+        }
+        
+        auto dbIt = databases_.find(entry.database);
+        if (dbIt == databases_.end()) {
+            continue;
+        }
+        auto& tables = dbIt->second.tables;
+        
+        if (entry.kind == UndoEntry::Kind::CREATE_TABLE) {
+            tables.erase(entry.table);
+            continue;
+        }
+        if (entry.kind == UndoEntry::Kind::DROP_TABLE) {
+            tables[entry.table] = std::move(*entry.droppedTable);
+            continue;
+        }
+        
+        auto tableIt = tables.find(entry.table);
+        if (tableIt == tables.end()) {
+            continue;
+        }
+        auto& table = tableIt->second;
+        
+        switch (entry.kind) {
+            case UndoEntry::Kind::INSERT_ROW:
+                table.eraseRow(entry.row);
+                break;
+            case UndoEntry::Kind::UPDATE_ROW:
+                table.replaceRow(entry.row, entry.before);
+                break;
+            case UndoEntry::Kind::ERASE_ROW:
+                table.restoreRow(entry.row, entry.before);
+                break;
+            case UndoEntry::Kind::CREATE_INDEX:
+                if (entry.hadIndex) {
+                    table.addIndex(entry.field, entry.indexType);
+                } else {
+                    table.indexes.erase(entry.field);
+                }
+                break;
+            case UndoEntry::Kind::DROP_INDEX:
+                table.addIndex(entry.field, entry.indexType);
+                break;
+            default:
+                break;
+        }
+    }
+}
+
+const TableData* DatabaseManager::visibleTable(const std::string& tableName,
+                                              const std::map<RowId, RecordPtr>** images) const {
+    *images = nullptr;
+    if (readsCommittedState()) {
+        return committedTable(currentDatabase_, tableName, images);
+    }
+    auto dbIt = databases_.find(currentDatabase_);
+    if (dbIt == databases_.end()) {
+        return nullptr;
+    }
+    auto tableIt = dbIt->second.tables.find(tableName);
+    return tableIt == dbIt->second.tables.end() ? nullptr : &tableIt->second;
+}
+
+const TableData* DatabaseManager::committedTable(const std::string& database, const std::string& tableName,
+                                                 const std::map<RowId, RecordPtr>** images) const {
+    *images = nullptr;
+    const UndoEntry* change = undoLog_.firstSchemaChange(database, tableName);
+    if (!change) {
+        auto dbIt = databases_.find(database);
+        if (dbIt == databases_.end()) {
+            return nullptr;
+        }
+        auto tableIt = dbIt->second.tables.find(tableName);
+        if (tableIt == dbIt->second.tables.end()) {
+            return nullptr;
+        }
+        *images = undoLog_.committedImages(database, tableName);
+        return &tableIt->second;
+    }
+    
+    // A table the transaction dropped lives on in its drop entry; one it
+    // created first did not exist at the last commit
+    const TableData* table = nullptr;
+    if (change->kind == UndoEntry::Kind::DROP_TABLE) {
+        table = change->droppedTable.get();
+    } else if (change->kind == UndoEntry::Kind::DROP_DATABASE && change->droppedDatabase) {
+        auto tableIt = change->droppedDatabase->tables.find(tableName);
+        if (tableIt != change->droppedDatabase->tables.end()) {
+            table = &tableIt->second;
+        }
+    }
+    if (table) {
+        auto dropped = change->droppedImages.find(tableName);
+        if (dropped != change->droppedImages.end()) {
+            *images = &dropped->second;
+        }
+    }
+    return table;
+}
+
+bool DatabaseManager::committedDatabaseExists(const std::string& database) const {
+    if (const UndoEntry* change = undoLog_.firstSchemaChange(database, {})) {
+        return change->kind == UndoEntry::Kind::DROP_DATABASE;
+    }
+    return databases_.find(database) != databases_.end();
+}
+
+std::vector<std::string> DatabaseManager::committedTableNames(const std::string& database) const {
+    std::set<std::string> candidates;
+    auto dbIt = databases_.find(database);
+    if (dbIt != databases_.end()) {
+        for (const auto& [name, _] : dbIt->second.tables) {
+            candidates.insert(name);
+        }
+    }
+    for (const auto& entry : undoLog_.entries()) {
+        if (entry.database != database) {
+            continue;
+        }
+        if (entry.kind == UndoEntry::Kind::DROP_TABLE) {
+            candidates.insert(entry.table);
+        } else if (entry.kind == UndoEntry::Kind::DROP_DATABASE && entry.droppedDatabase) {
+            for (const auto& [name, _] : entry.droppedDatabase->tables) {
+                candidates.insert(name);
+            }
+        }
+    }
+    
+    std::vector<std::string> names;
+    const std::map<RowId, RecordPtr>* images = nullptr;
+    for (const auto& name : candidates) {
+        if (committedTable(database, name, &images)) {
+            names.push_back(name);
+        }
+    }
+    return names;
+}
+
+std::map<std::string, IndexType> DatabaseManager::committedIndexes(const std::string& database,
+                                                                   const std::string& tableName,
+                                                                   const TableData& table) const {
+    std::map<std::string, IndexType> indexes;
+    for (const auto& [field, index] : table.indexes) {
+        indexes.emplace(field, index.type());
+    }
+    
+    // Undo index changes made to this table instance, newest first; entries
+    // after its first CREATE/DROP belong to a later instance of the name
+    const auto& entries = undoLog_.entries();
+    const UndoEntry* boundary = undoLog_.firstSchemaChange(database, tableName);
+    auto end = boundary ? entries.begin() + (boundary - entries.data()) : entries.end();
+    for (auto it = std::make_reverse_iterator(end); it != entries.rend(); ++it) {
+        if (it->database != database || it->table != tableName) {
+            continue;
+        }
+        if (it->kind == UndoEntry::Kind::CREATE_INDEX && !it->hadIndex) {
+            indexes.erase(it->field);
+        } else if (it->kind == UndoEntry::Kind::CREATE_INDEX || it->kind == UndoEntry::Kind::DROP_INDEX) {
+            indexes[it->field] = it->indexType;
+        }
+    }
+    return indexes;
+}
+
+std::vector<nlohmann::json> DatabaseManager::selectCommitted(const TableData& table,
+                                                             const std::map<RowId, RecordPtr>* images,
+                                                             const nlohmann::json& query) const {
+    // Current rows the transaction has not touched, merged in row order with
+    // the committed images of the rows it has
+    std::map<RowId, const nlohmann::json*> visible;
+    for (RowId row : table.selectRows(query)) {
+        if (!images || images->find(row) == images->end()) {
+            visible.emplace(row, table.rows.at(row).get());
+        }
+    }
+    if (images) {
+        for (const auto& [row, image] : *images) {
+            if (image && matchesQuery(*image, query)) {
+                visible.emplace(row, image.get());
+            }
+        }
+    }
+    
+    std::vector<nlohmann::json> results;
+    results.reserve(visible.size());
+    for (const auto& [_, record] : visible) {
+        results.push_back(*record);
+    }
+    return results;
+}
+
+const nlohmann::json* DatabaseManager::findCommitted(const TableData& table, const std::map<RowId, RecordPtr>* images,
+                                                     const std::string& id) const {
+    const nlohmann::json* found = nullptr;
+    RowId foundRow = 0;
+    
+    auto pk = table.primaryIndex.find(id);
+    if (pk != table.primaryIndex.end()) {
+        for (RowId row : pk->second) {
+            if (!images || images->find(row) == images->end()) {
+                found = table.rows.at(row).get();
+                foundRow = row;
+                break;
+            }
+        }
+    }
+    
+    if (images) {
+        nlohmann::json key = id;
+        for (const auto& [row, image] : *images) {
+            if (found && row > foundRow) {
+                break;
+            }
+            if (image && (image->value("id", nlohmann::json()) == key || image->value("_id", nlohmann::json()) == key)) {
+                found = image.get();
+                break;
+            }
+        }
+    }
+    return found;
+}
+
+std::vector<std::pair<RowId, RecordPtr>> DatabaseManager::visibleRows(const TableData& table,
+                                                                      const std::map<RowId, RecordPtr>* images) const {
+    std::vector<std::pair<RowId, RecordPtr>> rows;
+    rows.reserve(table.rows.size());
+    if (!images) {
+        rows.assign(table.rows.begin(), table.rows.end());
+        return rows;
+    }
+    
+    // Merge current rows with committed images of rows the open transaction touched
+    auto current = table.rows.begin();
+    auto image = images->begin();
+    while (current != table.rows.end() || image != images->end()) {
+        if (image == images->end() || (current != table.rows.end() && current->first < image->first)) {
+            rows.push_back(*current);
+            ++current;
+            continue;
+        }
+        if (current != table.rows.end() && current->first == image->first) {
+            ++current;
+        }
+        if (image->second) {
+            rows.push_back(*image);
+        }
+        ++image;
+    }
+    return rows;
+}
+
+void DatabaseManager::captureSnapshot(std::vector<std::string>& databases, std::vector<SnapshotTable>& tables) const {
+    if (!readsCommittedState()) {
+        for (const auto& [name, db] : databases_) {
+            databases.push_back(name);
+            for (const auto& [tableName, table] : db.tables) {
+                SnapshotTable capture{name, tableName, table.schema, nlohmann::json::object(), {}};
+                for (const auto& [field, index] : table.indexes) {
+                    capture.indexes[field] = indexTypeToString(index.type());
+                }
+                capture.rows = visibleRows(table, nullptr);
+                tables.push_back(std::move(capture));
+            }
+        }
+        return;
+    }
+    
+    // Another thread's transaction is open: capture the committed view
+    std::set<std::string> candidates;
+    for (const auto& [name, _] : databases_) {
+        candidates.insert(name);
+    }
+    for (const auto& entry : undoLog_.entries()) {
+        if (entry.kind == UndoEntry::Kind::DROP_DATABASE) {
+            candidates.insert(entry.database);
+        }
+    }
+    for (const auto& name : candidates) {
+        if (!committedDatabaseExists(name)) {
+            continue;
+        }
+        databases.push_back(name);
+        for (const auto& tableName : committedTableNames(name)) {
+            const std::map<RowId, RecordPtr>* images = nullptr;
+            const TableData* table = committedTable(name, tableName, &images);
+            SnapshotTable capture{name, tableName, table->schema, nlohmann::json::object(), {}};
+            for (const auto& [field, type] : committedIndexes(name, tableName, *table)) {
+                capture.indexes[field] = indexTypeToString(type);
+            }
+            capture.rows = visibleRows(*table, images);
+            tables.push_back(std::move(capture));
+        }
+    }
+}
+
 // Index operations
-bool DatabaseManager::createIndex(const std::string& tableName, const std::string& columnName) {
-    std::lock_guard<std::recursive_mutex> lock(mutex_);
+bool DatabaseManager::createIndex(const std::string& tableName, const std::string& columnName, IndexType type) {
+    std::unique_lock<std::recursive_mutex> lock(mutex_);
+    if (!waitForWriteAccess(lock, "createIndex")) {
+        return false;
+    }
     
     if (logger_) logger_->debug("DatabaseManager::createIndex() - ENTRY: table={}, column={}", tableName, columnName);
     
@@ -911,8 +1419,27 @@ bool DatabaseManager::createIndex(const std::string& tableName, const std::strin
             return false;
         }
         
-        // Add index to table
-        tableIt->second.indexes[columnName] = std::vector<std::string>();
+        UndoEntry undo{UndoEntry::Kind::CREATE_INDEX, currentDatabase_, tableName};
+        undo.field = columnName;
+        auto existing = tableIt->second.indexes.find(columnName);
+        if (existing != tableIt->second.indexes.end()) {
+            undo.hadIndex = true;
+            undo.indexType = existing->second.type();
+        }
+        if (inTransaction_) {
+            undoLog_.record(undo);
+        }
+        
+        // Build the index over existing rows; it is maintained on every write from here on
+        tableIt->second.addIndex(columnName, type);
+        uint64_t lsn = 0;
+        if (loggingChanges()) {
+            lsn = logChange({{"op", "create_index"}, {"db", currentDatabase_}, {"table", tableName},
+                             {"field", columnName}, {"type", indexTypeToString(type)}});
+        }
+        if (!makeDurable(lock, lsn, {std::move(undo)}, "createIndex")) {
+            return false;
+        }
         
         if (logger_) logger_->info("Index created successfully on column '{}' in table '{}'", columnName, tableName);
         logOperation("createIndex", true, "Index created: " + columnName);
@@ -929,7 +1456,10 @@ bool DatabaseManager::createIndex(const std::string& tableName, const std::strin
 }
 
 bool DatabaseManager::dropIndex(const std::string& tableName, const std::string& columnName) {
-    std::lock_guard<std::recursive_mutex> lock(mutex_);
+    std::unique_lock<std::recursive_mutex> lock(mutex_);
+    if (!waitForWriteAccess(lock, "dropIndex")) {
+        return false;
+    }
     
     if (logger_) logger_->debug("DatabaseManager::dropIndex() - ENTRY: table={}, column={}", tableName, columnName);
     
@@ -960,7 +1490,18 @@ bool DatabaseManager::dropIndex(const std::string& tableName, const std::string&
             return false;
         }
         
+        UndoEntry undo{UndoEntry::Kind::DROP_INDEX, currentDatabase_, tableName};
+        undo.field = columnName;
+        undo.indexType = indexIt->second.type();
+        if (inTransaction_) {
+            undoLog_.record(undo);
+        }
         tableIt->second.indexes.erase(indexIt);
+        uint64_t lsn = loggingChanges()
+            ? logChange({{"op", "drop_index"}, {"db", currentDatabase_}, {"table", tableName}, {"field", columnName}}) : 0;
+        if (!makeDurable(lock, lsn, {std::move(undo)}, "dropIndex")) {
+            return false;
+        }
         
         if (logger_) logger_->info("Index dropped successfully from column '{}' in table '{}'", columnName, tableName);
         logOperation("dropIndex", true, "Index dropped: " + columnName);
@@ -987,22 +1528,23 @@ std::vector<std::string> DatabaseManager::listIndexes(const std::string& tableNa
         return {};
     }
     
-    auto dbIt = databases_.find(currentDatabase_);
-    if (dbIt == databases_.end()) {
-        if (logger_) logger_->debug("DatabaseManager::listIndexes() - EXIT (current database not found)");
-        return {};
-    }
-    
-    auto tableIt = dbIt->second.tables.find(tableName);
-    if (tableIt == dbIt->second.tables.end()) {
+    const std::map<RowId, RecordPtr>* images = nullptr;
+    const TableData* table = visibleTable(tableName, &images);
+    if (!table) {
         if (logger_) logger_->debug("DatabaseManager::listIndexes() - EXIT (table not found)");
         handleError("listIndexes", DatabaseErrorCode::OPERATION_FAILED, "Table not found");
         return {};
     }
     
     std::vector<std::string> indexes;
-    for (const auto& [name, _] : tableIt->second.indexes) {
-        indexes.push_back(name);
+    if (readsCommittedState()) {
+        for (const auto& [name, _] : committedIndexes(currentDatabase_, tableName, *table)) {
+            indexes.push_back(name);
+        }
+    } else {
+        for (const auto& [name, _] : table->indexes) {
+            indexes.push_back(name);
+        }
     }
     
     if (logger_) logger_->debug("DatabaseManager::listIndexes() - EXIT: {} indexes", indexes.size());
@@ -1011,7 +1553,7 @@ std::vector<std::string> DatabaseManager::listIndexes(const std::string& tableNa
 
 // Backup operations
 bool DatabaseManager::createBackup(const std::string& backupPath) {
-    std::lock_guard<std::recursive_mutex> lock(mutex_);
+    std::unique_lock<std::recursive_mutex> lock(mutex_);
     
     if (logger_) logger_->debug("DatabaseManager::createBackup() - ENTRY: path={}", backupPath);
     
@@ -1022,33 +1564,23 @@ bool DatabaseManager::createBackup(const std::string& backupPath) {
     }
     
     try {
-        // Create backup data
-        nlohmann::json backupData;
-        backupData["databases"] = nlohmann::json::object();
-        
-        for (const auto& [name, db] : databases_) {
-            backupData["databases"][name] = nlohmann::json::object();
-            backupData["databases"][name]["tables"] = nlohmann::json::object();
-            
-            for (const auto& [tableName, table] : db.tables) {
-                backupData["databases"][name]["tables"][tableName] = nlohmann::json::object();
-                backupData["databases"][name]["tables"][tableName]["records"] = table.records;
-                backupData["databases"][name]["tables"][tableName]["indexes"] = table.indexes;
-                backupData["databases"][name]["tables"][tableName]["schema"] = table.schema;
-            }
-        }
-        
-        // Write backup to file
-        std::ofstream file(backupPath);
-        if (!file.is_open()) {
-            if (logger_) logger_->debug("DatabaseManager::createBackup() - EXIT (cannot open file)");
-            handleError("createBackup", DatabaseErrorCode::OPERATION_FAILED, "Cannot open backup file");
+        // Capture shared row images under the lock; encoding and I/O run without it
+        std::vector<std::string> databaseNames;
+        std::vector<SnapshotTable> captures;
+        captureSnapshot(databaseNames, captures);
+        lock.unlock();
+        
+        // Stream into a temporary file and rename it over the target when complete
+        std::string error;
+        bool written = writeSnapshotFile(backupPath, databaseNames, captures, nullptr, false, error);
+        
+        lock.lock();
+        if (!written) {
+            if (logger_) logger_->debug("DatabaseManager::createBackup() - EXIT (write failed)");
+            handleError("createBackup", DatabaseErrorCode::OPERATION_FAILED, error);
             return false;
         }
         
-        file << backupData.dump(2);
-        file.close();
-        
         if (logger_) logger_->info("Backup created successfully at '{}'", backupPath);
         logOperation("createBackup", true, "Backup created: " + backupPath);
         invokeCallbacks("createBackup", true, backupPath);
@@ -1056,6 +1588,7 @@ bool DatabaseManager::createBackup(const std::string& backupPath) {
         if (logger_) logger_->debug("DatabaseManager::createBackup() - EXIT (success)");
         return true;
     } catch (const std::exception& e) {
+        if (!lock.owns_lock()) lock.lock();
         if (logger_) logger_->error("Failed to create backup: {}", e.what());
         handleError("createBackup", DatabaseErrorCode::OPERATION_FAILED, e.what());
         if (logger_) logger_->debug("DatabaseManager::createBackup() - EXIT (exception)");
@@ -1064,7 +1597,13 @@ bool DatabaseManager::createBackup(const std::string& backupPath) {
 }
 
 bool DatabaseManager::restoreFromBackup(const std::string& backupPath) {
-    std::lock_guard<std::recursive_mutex> lock(mutex_);
+    // A restore is made durable by an immediate checkpoint. The checkpoint
+    // lock is dropped before any callback runs, so callbacks may checkpoint.
+    std::unique_lock<std::mutex> checkpointLock(checkpointRunMutex_, std::defer_lock);
+    std::unique_lock<std::recursive_mutex> lock(mutex_);
+    if (!waitForWriteAccess(lock, "restoreFromBackup")) {
+        return false;
+    }
     
     if (logger_) logger_->debug("DatabaseManager::restoreFromBackup() - ENTRY: path={}", backupPath);
     
@@ -1074,50 +1613,58 @@ bool DatabaseManager::restoreFromBackup(const std::string& backupPath) {
         return false;
     }
     
+    if (inTransaction_) {
+        if (logger_) logger_->debug("DatabaseManager::restoreFromBackup() - EXIT (in transaction)");
+        handleError("restoreFromBackup", DatabaseErrorCode::INVALID_STATE, "Cannot restore while a transaction is open");
+        return false;
+    }
+    
     try {
-        // Read backup from file
-        std::ifstream file(backupPath);
-        if (!file.is_open()) {
-            if (logger_) logger_->debug("DatabaseManager::restoreFromBackup() - EXIT (cannot open file)");
-            handleError("restoreFromBackup", DatabaseErrorCode::OPERATION_FAILED, "Cannot open backup file");
-            return false;
+        // Decode without the lock; binary snapshots load their tables in parallel
+        lock.unlock();
+        std::map<std::string, DatabaseData> restored;
+        std::string error;
+        bool loaded;
+        if (snapshot::isSnapshotFile(backupPath)) {
+            SnapshotReader reader;
+            loaded = reader.open(backupPath) && reader.loadAll(restored, error);
+            if (error.empty()) {
+                error = reader.error();
+            }
+        } else {
+            loaded = snapshot::loadJsonBackup(backupPath, restored, error);
         }
+        lock.lock();
         
-        nlohmann::json backupData;
-        file >> backupData;
-        file.close();
-        
-        // Clear current databases
-        databases_.clear();
+        if (!loaded) {
+            if (logger_) logger_->debug("DatabaseManager::restoreFromBackup() - EXIT (load failed)");
+            handleError("restoreFromBackup", DatabaseErrorCode::OPERATION_FAILED, error);
+            return false;
+        }
+        if (!waitForWriteAccess(lock, "restoreFromBackup")) {
+            return false;
+        }
+        // The checkpoint lock comes before mutex_
+        lock.unlock();
+        const bool acquired = acquireCheckpointLock(checkpointLock);
+        lock.lock();
+        if (!acquired) {
+            handleError("restoreFromBackup", DatabaseErrorCode::INVALID_STATE, "Cannot wait for a running checkpoint from inside a callback");
+            return false;
+        }
+        if (inTransaction_) {
+            checkpointLock.unlock();
+            handleError("restoreFromBackup", DatabaseErrorCode::INVALID_STATE, "Cannot restore while a transaction is open");
+            return false;
+        }
         
-        // Restore databases from backup
-        if (backupData.contains("databases")) {
-            for (const auto& [name, dbData] : backupData["databases"].items()) {
-                DatabaseData db;
-                db.name = name;
-                
-                if (dbData.contains("tables")) {
-                    for (const auto& [tableName, tableData] : dbData["tables"].items()) {
-                        TableData table;
-                        
-                        if (tableData.contains("records")) {
-                            table.records = tableData["records"].get<std::vector<nlohmann::json>>();
-                        }
-                        
-                        if (tableData.contains("indexes")) {
-                            table.indexes = tableData["indexes"].get<std::map<std::string, std::vector<std::string>>>();
-                        }
-                        
-                        if (tableData.contains("schema")) {
-                            table.schema = tableData["schema"];
-                        }
-                        
-                        db.tables[tableName] = table;
-                    }
-                }
-                
-                databases_[name] = db;
-            }
+        databases_.swap(restored);
+        const bool checkpointed = !loggingChanges() || writeCheckpoint(lock, error);
+        checkpointLock.unlock();
+        if (!checkpointed) {
+            if (logger_) logger_->debug("DatabaseManager::restoreFromBackup() - EXIT (checkpoint failed)");
+            handleError("restoreFromBackup", DatabaseErrorCode::OPERATION_FAILED, "Restored data could not be checkpointed: " + error);
+            return false;
         }
         
         if (logger_) logger_->info("Backup restored successfully from '{}'", backupPath);
@@ -1127,6 +1674,8 @@ bool DatabaseManager::restoreFromBackup(const std::string& backupPath) {
         if (logger_) logger_->debug("DatabaseManager::restoreFromBackup() - EXIT (success)");
         return true;
     } catch (const std::exception& e) {
+        if (checkpointLock.owns_lock()) checkpointLock.unlock();
+        if (!lock.owns_lock()) lock.lock();
         if (logger_) logger_->error("Failed to restore backup: {}", e.what());
         handleError("restoreFromBackup", DatabaseErrorCode::OPERATION_FAILED, e.what());
         if (logger_) logger_->debug("DatabaseManager::restoreFromBackup() - EXIT (exception)");
@@ -1134,6 +1683,183 @@ bool DatabaseManager::restoreFromBackup(const std::string& backupPath) {
     }
 }
 
+// Storage operations
+void DatabaseManager::setStorageEngine(std::unique_ptr<StorageEngine> engine) {
+    std::lock_guard<std::recursive_mutex> lock(mutex_);
+    
+    if (initialized_.load()) {
+        handleError("setStorageEngine", DatabaseErrorCode::INVALID_STATE, "Storage engine cannot change while initialized");
+        return;
+    }
+    storage_ = std::move(engine);
+}
+
+bool DatabaseManager::checkpoint() {
+    // Released before any callback runs, so callbacks may checkpoint again
+    std::unique_lock<std::mutex> checkpointLock(checkpointRunMutex_, std::defer_lock);
+    if (!acquireCheckpointLock(checkpointLock)) {
+        std::lock_guard<std::recursive_mutex> guard(mutex_);
+        handleError("checkpoint", DatabaseErrorCode::INVALID_STATE, "Cannot wait for a running checkpoint from inside a callback");
+        return false;
+    }
+    std::unique_lock<std::recursive_mutex> lock(mutex_);
+    
+    if (logger_) logger_->debug("DatabaseManager::checkpoint() - ENTRY");
+    
+    if (!initialized_.load()) {
+        checkpointLock.unlock();
+        if (logger_) logger_->debug("DatabaseManager::checkpoint() - EXIT (not initialized)");
+        handleError("checkpoint", DatabaseErrorCode::NOT_INITIALIZED, "Database manager not initialized");
+        return false;
+    }
+    
+    if (inTransaction_) {
+        checkpointLock.unlock();
+        if (logger_) logger_->debug("DatabaseManager::checkpoint() - EXIT (in transaction)");
+        handleError("checkpoint", DatabaseErrorCode::INVALID_STATE, "Cannot checkpoint while a transaction is open");
+        return false;
+    }
+    
+    try {
+        std::string error;
+        const bool written = !loggingChanges() || writeCheckpoint(lock, error);
+        checkpointLock.unlock();
+        if (!written) {
+            if (logger_) logger_->debug("DatabaseManager::checkpoint() - EXIT (write failed)");
+            handleError("checkpoint", DatabaseErrorCode::OPERATION_FAILED, error);
+            return false;
+        }
+        
+        logOperation("checkpoint", true, "Checkpoint written");
+        invokeCallbacks("checkpoint", true, "");
+        
+        if (logger_) logger_->debug("DatabaseManager::checkpoint() - EXIT (success)");
+        return true;
+    } catch (const std::exception& e) {
+        if (checkpointLock.owns_lock()) checkpointLock.unlock();
+        if (!lock.owns_lock()) lock.lock();
+        if (logger_) logger_->error("Failed to write checkpoint: {}", e.what());
+        handleError("checkpoint", DatabaseErrorCode::OPERATION_FAILED, e.what());
+        if (logger_) logger_->debug("DatabaseManager::checkpoint() - EXIT (exception)");
+        return false;
+    }
+}
+
+bool DatabaseManager::loggingChanges() const {
+    return storage_ && storage_->durable();
+}
+
+uint64_t DatabaseManager::logChange(nlohmann::json change) {
+    // Transactions log all their changes as one batch on commit
+    if (inTransaction_) {
+        transactionChanges_.push_back(std::move(change));
+        return 0;
+    }
+    uint64_t lsn = storage_->append(nlohmann::json::array({std::move(change)}));
+    if (storage_->needsCheckpoint()) {
+        requestCheckpoint();
+    }
+    return lsn;
+}
+
+bool DatabaseManager::makeDurable(std::unique_lock<std::recursive_mutex>& lock, uint64_t lsn,
+                                  std::vector<UndoEntry> undo, const std::string& operation) {
+    if (lsn == 0) {
+        return true;
+    }
+    
+    // The change is applied in memory already; keep its undo until it is durable
+    undurable_.emplace(lsn, std::move(undo));
+    
+    // Wait without the lock so concurrent writers can share the same flush
+    auto storage = storage_;
+    std::string error;
+    lock.unlock();
+    bool durable = storage->waitDurable(lsn, error);
+    lock.lock();
+    if (durable) {
+        undurable_.erase(lsn);
+        return true;
+    }
+    
+    // Log I/O errors are sticky, so every record from this one on is lost too.
+    // Revert them newest first; their writers find their entries gone and fail.
+    auto first = undurable_.lower_bound(lsn);
+    for (auto it = undurable_.rbegin(); it != std::make_reverse_iterator(first); ++it) {
+        revertChanges(it->second);
+    }
+    undurable_.erase(first, undurable_.end());
+    handleError(operation, DatabaseErrorCode::OPERATION_FAILED, error);
+    return false;
+}
+
+bool DatabaseManager::writeCheckpoint(std::unique_lock<std::recursive_mutex>& lock, std::string& error) {
+    // The capture and the checkpoint LSN must be taken under the same lock hold
+    auto storage = storage_;
+    uint64_t lsn = 0;
+    if (!storage->beginCheckpoint(lsn, error)) {
+        return false;
+    }
+    std::vector<std::string> databaseNames;
+    std::vector<SnapshotTable> captures;
+    captureSnapshot(databaseNames, captures);
+    
+    lock.unlock();
+    bool written = storage->completeCheckpoint(lsn, databaseNames, captures, error);
+    lock.lock();
+    if (written && logger_) logger_->info("Checkpoint written at log sequence {}", lsn);
+    return written;
+}
+
+void DatabaseManager::startCheckpointer() {
+    checkpointStop_ = false;
+    checkpointRequested_ = false;
+    const auto interval = std::chrono::milliseconds(config_.checkpointIntervalMs > 0 ? config_.checkpointIntervalMs : 1000);
+    checkpointThread_ = std::thread([this, interval] {
+        std::unique_lock<std::mutex> wake(checkpointMutex_);
+        while (!checkpointStop_) {
+            checkpointWake_.wait_for(wake, interval, [this] { return checkpointStop_ || checkpointRequested_; });
+            if (checkpointStop_) {
+                break;
+            }
+            checkpointRequested_ = false;
+            wake.unlock();
+            {
+                std::unique_lock<std::mutex> checkpointLock(checkpointRunMutex_);
+                std::unique_lock<std::recursive_mutex> lock(mutex_);
+                // Skipped while a transaction is open; its changes are not logged yet
+                if (initialized_.load() && !inTransaction_ && loggingChanges() && storage_->needsCheckpoint()) {
+                    std::string error;
+                    if (!writeCheckpoint(lock, error)) {
+                        checkpointLock.unlock();
+                        handleError("checkpoint", DatabaseErrorCode::OPERATION_FAILED, error);
+                    }
+                }
+            }
+            wake.lock();
+        }
+    });
+}
+
+void DatabaseManager::stopCheckpointer() {
+    {
+        std::lock_guard<std::mutex> wake(checkpointMutex_);
+        checkpointStop_ = true;
+    }
+    checkpointWake_.notify_all();
+    if (checkpointThread_.joinable()) {
+        checkpointThread_.join();
+    }
+}
+
+void DatabaseManager::requestCheckpoint() {
+    {
+        std::lock_guard<std::mutex> wake(checkpointMutex_);
+        checkpointRequested_ = true;
+    }
+    checkpointWake_.notify_all();
+}
+
 // Callback management
 void DatabaseManager::setDatabaseCallback(DatabaseCallback callback) {
     std::lock_guard<std::recursive_mutex> lock(mutex_);
@@ -1241,6 +1967,7 @@ bool DatabaseManager::performHealthCheck() {
     
     if (healthCallback_) {
         try {
+            CallbackScope scope;
             healthCallback_(health_);
         } catch (const std::exception& e) {
             if (logger_) logger_->error("Health callback execution failed: {}", e.what());
@@ -1303,7 +2030,8 @@ bool DatabaseManager::validateConfig(const DatabaseConfig& config) const {
     
     bool valid = !config.name.empty() && 
                  config.maxConnections > 0 && 
-                 config.connectionTimeout > 0;
+                 config.connectionTimeout > 0 &&
+                 (config.syncPolicy != SyncPolicy::INTERVAL || config.syncIntervalMs > 0);
     
     if (logger_) logger_->debug("DatabaseManager::validateConfig() - EXIT: {}", valid);
     return valid;
@@ -1360,7 +2088,10 @@ void DatabaseManager::setConnectionTimeout(size_t milliseconds) {
 
 // Table operations
 bool DatabaseManager::createTable(const std::string& name, const nlohmann::json& schema) {
-    std::lock_guard<std::recursive_mutex> lock(mutex_);
+    std::unique_lock<std::recursive_mutex> lock(mutex_);
+    if (!waitForWriteAccess(lock, "createTable")) {
+        return false;
+    }
     if (logger_) logger_->debug("DatabaseManager::createTable() - ENTRY: table={}", name);
     if (!initialized_.load() || currentDatabase_.empty()) {
         if (logger_) logger_->debug("DatabaseManager::createTable() - EXIT (not initialized or no current database)");
@@ -1392,6 +2123,15 @@ bool DatabaseManager::createTable(const std::string& name, const nlohmann::json&
         TableData table;
         table.schema = schema;
         dbIt->second.tables[name] = table;
+        UndoEntry undo{UndoEntry::Kind::CREATE_TABLE, currentDatabase_, name};
+        if (inTransaction_) {
+            undoLog_.record(undo);
+        }
+        uint64_t lsn = loggingChanges()
+            ? logChange({{"op", "create_table"}, {"db", currentDatabase_}, {"table", name}, {"schema", schema}}) : 0;
+        if (!makeDurable(lock, lsn, {std::move(undo)}, "createTable")) {
+            return false;
+        }
         if (logger_) logger_->info("Table '{}' created successfully in database '{}'", name, currentDatabase_);
         logOperation("createTable", true, "Table created: " + name);
         invokeCallbacks("createTable", true, name);
@@ -1416,21 +2156,16 @@ nlohmann::json DatabaseManager::getTableSchema(const std::string& name) {
         return nlohmann::json();
     }
     
-    auto dbIt = databases_.find(currentDatabase_);
-    if (dbIt == databases_.end()) {
-        if (logger_) logger_->debug("DatabaseManager::getTableSchema() - EXIT (current database not found)");
-        return nlohmann::json();
-    }
-    
-    auto tableIt = dbIt->second.tables.find(name);
-    if (tableIt == dbIt->second.tables.end()) {
+    const std::map<RowId, RecordPtr>* images = nullptr;
+    const TableData* table = visibleTable(name, &images);
+    if (!table) {
         if (logger_) logger_->debug("DatabaseManager::getTableSchema() - EXIT (table not found)");
         handleError("getTableSchema", DatabaseErrorCode::OPERATION_FAILED, "Table not found");
         return nlohmann::json();
     }
     
     if (logger_) logger_->debug("DatabaseManager::getTableSchema() - EXIT (success)");
-    return tableIt->second.schema;
+    return table->schema;
 }
 
 // Utility methods
@@ -0,0 +1,218 @@
+/*
+ * MIT License
+ * Copyright(c) 2025 Satoxcoin Core Developer
+ */
+
+#include "satox/database/record_index.hpp"
+#include <algorithm>
+#include <limits>
+
+namespace satox::database {
+
+namespace {
+
+const char* const kOperators[] = {"$eq", "$in", "$gt", "$gte", "$lt", "$lte"};
+
+bool isKnownOperator(const std::string& key) {
+    return std::find(std::begin(kOperators), std::end(kOperators), key) != std::end(kOperators);
+}
+
+// Range operators only relate values of the same kind; "10" is not > 5.
+bool comparable(const nlohmann::json& lhs, const nlohmann::json& rhs) {
+    if (lhs.is_number() && rhs.is_number()) {
+        return true;
+    }
+    return lhs.type() == rhs.type() && (lhs.is_string() || lhs.is_boolean());
+}
+
+// Smallest key of the kind of `value` under nlohmann::json ordering, so a
+// range scan bounded only from above can start at the right place.
+nlohmann::json lowestOfKind(const nlohmann::json& value) {
+    if (value.is_number()) {
+        return -std::numeric_limits<double>::infinity();
+    }
+    if (value.is_string()) {
+        return "";
+    }
+    return false;
+}
+
+} // namespace
+
+std::string indexTypeToString(IndexType type) {
+    return type == IndexType::ORDERED ? "ordered" : "hash";
+}
+
+IndexType indexTypeFromString(const std::string& name) {
+    return name == "ordered" ? IndexType::ORDERED : IndexType::HASH;
+}
+
+size_t IndexKeyHash::operator()(const nlohmann::json& key) const {
+    if (key.is_number()) {
+        return std::hash<double>{}(key.get<double>());
+    }
+    return std::hash<nlohmann::json>{}(key);
+}
+
+RecordIndex::RecordIndex(IndexType type) : type_(type) {}
+
+void RecordIndex::add(const nlohmann::json& key, RowId row) {
+    if (type_ == IndexType::ORDERED) {
+        ordered_[key].insert(row);
+    } else {
+        hash_[key].insert(row);
+    }
+}
+
+void RecordIndex::remove(const nlohmann::json& key, RowId row) {
+    if (type_ == IndexType::ORDERED) {
+        auto it = ordered_.find(key);
+        if (it != ordered_.end()) {
+            it->second.erase(row);
+            if (it->second.empty()) {
+                ordered_.erase(it);
+            }
+        }
+    } else {
+        auto it = hash_.find(key);
+        if (it != hash_.end()) {
+            it->second.erase(row);
+            if (it->second.empty()) {
+                hash_.erase(it);
+            }
+        }
+    }
+}
+
+void RecordIndex::clear() {
+    hash_.clear();
+    ordered_.clear();
+}
+
+size_t RecordIndex::keyCount() const {
+    return type_ == IndexType::ORDERED ? ordered_.size() : hash_.size();
+}
+
+void RecordIndex::collect(const std::set<RowId>& rows, std::vector<RowId>& out) const {
+    out.insert(out.end(), rows.begin(), rows.end());
+}
+
+bool RecordIndex::lookup(const nlohmann::json& predicate, std::vector<RowId>& rows) const {
+    rows.clear();
+
+    auto collectEqual = [this, &rows](const nlohmann::json& key) {
+        if (type_ == IndexType::ORDERED) {
+            auto it = ordered_.find(key);
+            if (it != ordered_.end()) collect(it->second, rows);
+        } else {
+            auto it = hash_.find(key);
+            if (it != hash_.end()) collect(it->second, rows);
+        }
+    };
+
+    if (!isOperatorPredicate(predicate)) {
+        collectEqual(predicate);
+        return true;
+    }
+
+    if (predicate.contains("$eq")) {
+        collectEqual(predicate["$eq"]);
+        return true;
+    }
+
+    if (predicate.contains("$in")) {
+        const auto& values = predicate["$in"];
+        if (!values.is_array()) {
+            return false;
+        }
+        for (const auto& value : values) {
+            collectEqual(value);
+        }
+        std::sort(rows.begin(), rows.end());
+        rows.erase(std::unique(rows.begin(), rows.end()), rows.end());
+        return true;
+    }
+
+    if (type_ != IndexType::ORDERED) {
+        return false;
+    }
+
+    const nlohmann::json* lower = nullptr;
+    const nlohmann::json* upper = nullptr;
+    bool lowerInclusive = false;
+    bool upperInclusive = false;
+    if (predicate.contains("$gte")) { lower = &predicate["$gte"]; lowerInclusive = true; }
+    if (predicate.contains("$gt"))  { lower = &predicate["$gt"];  lowerInclusive = false; }
+    if (predicate.contains("$lte")) { upper = &predicate["$lte"]; upperInclusive = true; }
+    if (predicate.contains("$lt"))  { upper = &predicate["$lt"];  upperInclusive = false; }
+    if (!lower && !upper) {
+        return false;
+    }
+
+    const nlohmann::json& reference = lower ? *lower : *upper;
+    auto it = lower ? (lowerInclusive ? ordered_.lower_bound(*lower) : ordered_.upper_bound(*lower))
+                    : ordered_.lower_bound(lowestOfKind(*upper));
+    for (; it != ordered_.end(); ++it) {
+        if (!comparable(it->first, reference)) {
+            break;
+        }
+        if (upper) {
+            if (upperInclusive ? (*upper < it->first) : !(it->first < *upper)) {
+                break;
+            }
+        }
+        collect(it->second, rows);
+    }
+    std::sort(rows.begin(), rows.end());
+    return true;
+}
+
+bool isOperatorPredicate(const nlohmann::json& predicate) {
+    if (!predicate.is_object() || predicate.empty()) {
+        return false;
+    }
+    for (const auto& [key, _] : predicate.items()) {
+        if (!isKnownOperator(key)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool matchesPredicate(const nlohmann::json& value, const nlohmann::json& predicate) {
+    if (!isOperatorPredicate(predicate)) {
+        return value == predicate;
+    }
+    for (const auto& [op, arg] : predicate.items()) {
+        bool ok = false;
+        if (op == "$eq") {
+            ok = value == arg;
+        } else if (op == "$in") {
+            ok = arg.is_array() && std::find(arg.begin(), arg.end(), value) != arg.end();
+        } else if (op == "$gt") {
+            ok = comparable(value, arg) && arg < value;
+        } else if (op == "$gte") {
+            ok = comparable(value, arg) && !(value < arg);
+        } else if (op == "$lt") {
+            ok = comparable(value, arg) && value < arg;
+        } else if (op == "$lte") {
+            ok = comparable(value, arg) && !(arg < value);
+        }
+        if (!ok) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool matchesQuery(const nlohmann::json& record, const nlohmann::json& query) {
+    for (const auto& [key, predicate] : query.items()) {
+        auto it = record.find(key);
+        if (it == record.end() || !matchesPredicate(*it, predicate)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+} // namespace satox::database
@@ -0,0 +1,499 @@
+/*
+ * MIT License
+ * Copyright(c) 2025 Satoxcoin Core Developer
+ */
+
+#include "satox/database/snapshot.hpp"
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstring>
+#include <filesystem>
+#include <mutex>
+#include <thread>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace satox::database {
+
+namespace {
+
+const std::array<uint32_t, 256>& crcTable() {
+    static const std::array<uint32_t, 256> table = [] {
+        std::array<uint32_t, 256> t{};
+        for (uint32_t i = 0; i < 256; ++i) {
+            uint32_t c = i;
+            for (int k = 0; k < 8; ++k) {
+                c = (c & 1) ? 0xEDB88320u ^ (c >> 1) : c >> 1;
+            }
+            t[i] = c;
+        }
+        return t;
+    }();
+    return table;
+}
+
+void putU32(std::vector<uint8_t>& out, uint32_t value) {
+    for (int i = 0; i < 4; ++i) {
+        out.push_back(static_cast<uint8_t>(value >> (8 * i)));
+    }
+}
+
+void putU64(std::vector<uint8_t>& out, uint64_t value) {
+    for (int i = 0; i < 8; ++i) {
+        out.push_back(static_cast<uint8_t>(value >> (8 * i)));
+    }
+}
+
+uint32_t getU32(const uint8_t* p) {
+    return uint32_t(p[0]) | uint32_t(p[1]) << 8 | uint32_t(p[2]) << 16 | uint32_t(p[3]) << 24;
+}
+
+uint64_t getU64(const uint8_t* p) {
+    return uint64_t(getU32(p)) | uint64_t(getU32(p + 4)) << 32;
+}
+
+} // namespace
+
+namespace snapshot {
+
+uint32_t crc32(const uint8_t* data, size_t size, uint32_t crc) {
+    const auto& table = crcTable();
+    crc = ~crc;
+    for (size_t i = 0; i < size; ++i) {
+        crc = table[(crc ^ data[i]) & 0xFF] ^ (crc >> 8);
+    }
+    return ~crc;
+}
+
+bool isSnapshotFile(const std::string& path) {
+    std::ifstream in(path, std::ios::binary);
+    char magic[sizeof(kMagic)] = {};
+    return in.read(magic, sizeof(magic)) && std::memcmp(magic, kMagic, sizeof(kMagic)) == 0;
+}
+
+bool loadJsonBackup(const std::string& path, std::map<std::string, DatabaseData>& databases, std::string& error) {
+    std::ifstream file(path);
+    if (!file.is_open()) {
+        error = "Cannot open backup file";
+        return false;
+    }
+
+    nlohmann::json backupData;
+    try {
+        file >> backupData;
+    } catch (const std::exception& e) {
+        error = e.what();
+        return false;
+    }
+
+    if (!backupData.contains("databases")) {
+        return true;
+    }
+    for (const auto& [name, dbData] : backupData["databases"].items()) {
+        DatabaseData db;
+        db.name = name;
+
+        if (dbData.contains("tables")) {
+            for (const auto& [tableName, tableData] : dbData["tables"].items()) {
+                TableData table;
+
+                if (tableData.contains("records")) {
+                    for (const auto& record : tableData["records"]) {
+                        table.insertRow(record);
+                    }
+                }
+
+                if (tableData.contains("indexes")) {
+                    // Older backups stored an (always empty) row list per index
+                    for (const auto& [field, spec] : tableData["indexes"].items()) {
+                        table.addIndex(field, spec.is_string() ? indexTypeFromString(spec.get<std::string>())
+                                                               : IndexType::HASH);
+                    }
+                }
+
+                if (tableData.contains("schema")) {
+                    table.schema = tableData["schema"];
+                }
+
+                db.tables[tableName] = std::move(table);
+            }
+        }
+
+        databases[name] = std::move(db);
+    }
+    return true;
+}
+
+} // namespace snapshot
+
+namespace {
+
+bool syncPath(const std::string& path, bool directory) {
+    int fd = ::open(path.c_str(), directory ? O_RDONLY | O_DIRECTORY : O_RDONLY);
+    if (fd < 0) {
+        return false;
+    }
+    bool ok = ::fsync(fd) == 0;
+    ::close(fd);
+    return ok;
+}
+
+} // namespace
+
+bool writeSnapshotFile(const std::string& path, const std::vector<std::string>& databases,
+                       std::vector<SnapshotTable>& tables, const nlohmann::json& metadata,
+                       bool sync, std::string& error) {
+    // A unique temp file per writer, so concurrent backups to the same
+    // target never interleave; the last rename wins with a whole file
+    std::string tempPath = path + ".tmp.XXXXXX";
+    int fd = ::mkstemp(&tempPath[0]);
+    if (fd < 0) {
+        error = "Cannot create backup file";
+        return false;
+    }
+    ::fchmod(fd, 0644);
+    ::close(fd);
+    SnapshotWriter writer;
+    bool written = writer.open(tempPath);
+    if (written) {
+        if (!metadata.is_null()) {
+            writer.setMetadata(metadata);
+        }
+        for (const auto& name : databases) {
+            writer.addDatabase(name);
+        }
+        for (auto& table : tables) {
+            writer.beginTable(table.database, table.table, table.schema, table.indexes);
+            for (auto& [row, record] : table.rows) {
+                writer.writeRecord(row, *record);
+                record.reset();
+            }
+            writer.endTable();
+        }
+        written = writer.finish();
+    }
+    if (!written) {
+        // Never finish a failed writer; that would append a footer to a partial file
+        writer.abort();
+        error = writer.error();
+        std::error_code ignored;
+        std::filesystem::remove(tempPath, ignored);
+        return false;
+    }
+    if (sync && !syncPath(tempPath, false)) {
+        error = "Failed to sync snapshot file";
+        std::error_code ignored;
+        std::filesystem::remove(tempPath, ignored);
+        return false;
+    }
+
+    std::error_code ec;
+    std::filesystem::rename(tempPath, path, ec);
+    if (ec) {
+        error = ec.message();
+        return false;
+    }
+    if (sync) {
+        auto parent = std::filesystem::path(path).parent_path();
+        syncPath(parent.empty() ? "." : parent.string(), true);
+    }
+    return true;
+}
+
+// --- SnapshotWriter ---
+
+SnapshotWriter::SnapshotWriter(size_t chunkSize) : chunkSize_(chunkSize) {}
+
+SnapshotWriter::~SnapshotWriter() = default;
+
+bool SnapshotWriter::open(const std::string& path) {
+    out_.open(path, std::ios::binary | std::ios::trunc);
+    if (!out_.is_open()) {
+        error_ = "Cannot open backup file";
+        return false;
+    }
+    std::vector<uint8_t> header(snapshot::kMagic, snapshot::kMagic + sizeof(snapshot::kMagic));
+    putU32(header, snapshot::kVersion);
+    putU32(header, snapshot::kFlagRowIds);
+    writeBytes(header.data(), header.size());
+    directory_["databases"] = nlohmann::json::object();
+    return true;
+}
+
+void SnapshotWriter::setMetadata(const nlohmann::json& metadata) {
+    directory_["meta"] = metadata;
+}
+
+void SnapshotWriter::addDatabase(const std::string& name) {
+    auto& databases = directory_["databases"];
+    if (!databases.contains(name)) {
+        databases[name] = {{"tables", nlohmann::json::object()}};
+    }
+}
+
+void SnapshotWriter::beginTable(const std::string& database, const std::string& table,
+                                const nlohmann::json& schema, const nlohmann::json& indexes) {
+    addDatabase(database);
+    table_ = &directory_["databases"][database]["tables"][table];
+    *table_ = {
+        {"schema", schema},
+        {"indexes", indexes},
+        {"records", 0},
+        {"chunks", nlohmann::json::array()}
+    };
+}
+
+void SnapshotWriter::writeRecord(RowId row, const nlohmann::json& record) {
+    auto encoded = nlohmann::json::to_cbor(record);
+    putU32(chunk_, static_cast<uint32_t>(encoded.size()));
+    putU64(chunk_, row);
+    chunk_.insert(chunk_.end(), encoded.begin(), encoded.end());
+    ++chunkRecords_;
+    if (chunk_.size() >= chunkSize_) {
+        flushChunk();
+    }
+}
+
+void SnapshotWriter::endTable() {
+    flushChunk();
+    table_ = nullptr;
+}
+
+void SnapshotWriter::flushChunk() {
+    if (chunkRecords_ == 0 || !table_) {
+        return;
+    }
+    std::vector<uint8_t> prefix;
+    putU32(prefix, static_cast<uint32_t>(chunk_.size()));
+    putU32(prefix, snapshot::crc32(chunk_.data(), chunk_.size()));
+
+    (*table_)["chunks"].push_back({
+        {"offset", offset_},
+        {"length", chunk_.size()},
+        {"records", chunkRecords_}
+    });
+    (*table_)["records"] = (*table_)["records"].get<size_t>() + chunkRecords_;
+
+    writeBytes(prefix.data(), prefix.size());
+    writeBytes(chunk_.data(), chunk_.size());
+    chunk_.clear();
+    chunkRecords_ = 0;
+}
+
+void SnapshotWriter::writeBytes(const void* data, size_t size) {
+    out_.write(static_cast<const char*>(data), static_cast<std::streamsize>(size));
+    offset_ += size;
+}
+
+bool SnapshotWriter::finish() {
+    if (table_) {
+        endTable();
+    }
+    auto footer = nlohmann::json::to_cbor(directory_);
+    uint64_t footerOffset = offset_;
+    writeBytes(footer.data(), footer.size());
+
+    std::vector<uint8_t> trailer;
+    putU64(trailer, footerOffset);
+    putU32(trailer, static_cast<uint32_t>(footer.size()));
+    putU32(trailer, snapshot::crc32(footer.data(), footer.size()));
+    trailer.insert(trailer.end(), snapshot::kTrailerMagic, snapshot::kTrailerMagic + sizeof(snapshot::kTrailerMagic));
+    writeBytes(trailer.data(), trailer.size());
+
+    out_.flush();
+    bool ok = out_.good();
+    out_.close();
+    if (!ok) {
+        error_ = "Failed to write backup file";
+    }
+    return ok;
+}
+
+void SnapshotWriter::abort() {
+    if (out_.is_open()) {
+        out_.close();
+    }
+    chunk_.clear();
+    chunkRecords_ = 0;
+    table_ = nullptr;
+}
+
+// --- SnapshotReader ---
+
+SnapshotReader::~SnapshotReader() {
+    close();
+}
+
+bool SnapshotReader::open(const std::string& path) {
+    close();
+
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        error_ = "Cannot open backup file";
+        return false;
+    }
+    struct stat st {};
+    if (::fstat(fd, &st) != 0 || static_cast<size_t>(st.st_size) < snapshot::kHeaderSize + snapshot::kTrailerSize) {
+        ::close(fd);
+        error_ = "Backup file is truncated";
+        return false;
+    }
+    size_ = static_cast<size_t>(st.st_size);
+    void* mapping = ::mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd);
+    if (mapping == MAP_FAILED) {
+        size_ = 0;
+        error_ = "Cannot map backup file";
+        return false;
+    }
+    data_ = static_cast<const uint8_t*>(mapping);
+    ::madvise(mapping, size_, MADV_WILLNEED);
+
+    if (std::memcmp(data_, snapshot::kMagic, sizeof(snapshot::kMagic)) != 0 ||
+        getU32(data_ + 8) != snapshot::kVersion) {
+        error_ = "Unsupported backup format";
+        close();
+        return false;
+    }
+    flags_ = getU32(data_ + 12);
+
+    const uint8_t* trailer = data_ + size_ - snapshot::kTrailerSize;
+    if (std::memcmp(trailer + 16, snapshot::kTrailerMagic, sizeof(snapshot::kTrailerMagic)) != 0) {
+        error_ = "Backup file is truncated";
+        close();
+        return false;
+    }
+    uint64_t footerOffset = getU64(trailer);
+    uint32_t footerLength = getU32(trailer + 8);
+    if (footerOffset < snapshot::kHeaderSize || footerOffset + footerLength > size_ - snapshot::kTrailerSize ||
+        snapshot::crc32(data_ + footerOffset, footerLength) != getU32(trailer + 12)) {
+        error_ = "Backup footer is corrupt";
+        close();
+        return false;
+    }
+
+    try {
+        auto directory = nlohmann::json::from_cbor(data_ + footerOffset, data_ + footerOffset + footerLength);
+        metadata_ = directory.value("meta", nlohmann::json::object());
+        for (const auto& [dbName, db] : directory.at("databases").items()) {
+            databases_.push_back(dbName);
+            for (const auto& [tableName, table] : db.at("tables").items()) {
+                tables_.push_back({dbName, tableName, table.at("schema"), table.at("indexes"), table.at("chunks")});
+            }
+        }
+    } catch (const std::exception& e) {
+        error_ = std::string("Backup footer is corrupt: ") + e.what();
+        close();
+        return false;
+    }
+    return true;
+}
+
+void SnapshotReader::close() {
+    if (data_) {
+        ::munmap(const_cast<uint8_t*>(data_), size_);
+    }
+    data_ = nullptr;
+    size_ = 0;
+    databases_.clear();
+    tables_.clear();
+    metadata_ = nlohmann::json();
+}
+
+bool SnapshotReader::loadTable(const TableEntry& entry, TableData& table, std::string& error) const {
+    try {
+        table.schema = entry.schema;
+        for (const auto& chunk : entry.chunks) {
+            uint64_t offset = chunk.at("offset").get<uint64_t>();
+            uint64_t length = chunk.at("length").get<uint64_t>();
+            if (offset + 8 + length > size_) {
+                error = "Chunk out of bounds in table " + entry.table;
+                return false;
+            }
+            const uint8_t* p = data_ + offset;
+            if (getU32(p) != length || snapshot::crc32(p + 8, length) != getU32(p + 4)) {
+                error = "Checksum mismatch in table " + entry.table;
+                return false;
+            }
+            const bool rowIds = (flags_ & snapshot::kFlagRowIds) != 0;
+            const size_t prefix = rowIds ? 12 : 4;
+            const uint8_t* pos = p + 8;
+            const uint8_t* end = pos + length;
+            while (pos < end) {
+                if (static_cast<size_t>(end - pos) < prefix) {
+                    error = "Corrupt record in table " + entry.table;
+                    return false;
+                }
+                uint32_t recordLength = getU32(pos);
+                RowId row = rowIds ? getU64(pos + 4) : 0;
+                pos += prefix;
+                if (static_cast<size_t>(end - pos) < recordLength) {
+                    error = "Corrupt record in table " + entry.table;
+                    return false;
+                }
+                auto record = nlohmann::json::from_cbor(pos, pos + recordLength);
+                if (rowIds) {
+                    table.restoreRow(row, std::make_shared<const nlohmann::json>(std::move(record)));
+                } else {
+                    table.insertRow(std::move(record));
+                }
+                pos += recordLength;
+            }
+        }
+        for (const auto& [field, type] : entry.indexes.items()) {
+            table.addIndex(field, indexTypeFromString(type.get<std::string>()));
+        }
+        return true;
+    } catch (const std::exception& e) {
+        error = std::string("Failed to decode table ") + entry.table + ": " + e.what();
+        return false;
+    }
+}
+
+bool SnapshotReader::loadAll(std::map<std::string, DatabaseData>& databases, std::string& error, size_t threads) const {
+    std::vector<TableData> loaded(tables_.size());
+    std::atomic<size_t> next{0};
+    std::atomic<bool> failed{false};
+    std::mutex errorMutex;
+
+    auto worker = [&]() {
+        for (size_t i = next++; i < tables_.size() && !failed; i = next++) {
+            std::string tableError;
+            if (!loadTable(tables_[i], loaded[i], tableError)) {
+                std::lock_guard<std::mutex> lock(errorMutex);
+                if (!failed.exchange(true)) {
+                    error = tableError;
+                }
+            }
+        }
+    };
+
+    if (threads == 0) {
+        threads = std::max(1u, std::thread::hardware_concurrency());
+    }
+    threads = std::min(threads, tables_.size());
+    std::vector<std::thread> workers;
+    for (size_t i = 1; i < threads; ++i) {
+        workers.emplace_back(worker);
+    }
+    worker();
+    for (auto& t : workers) {
+        t.join();
+    }
+    if (failed) {
+        return false;
+    }
+
+    for (const auto& name : databases_) {
+        databases[name].name = name;
+    }
+    for (size_t i = 0; i < tables_.size(); ++i) {
+        databases[tables_[i].database].tables[tables_[i].table] = std::move(loaded[i]);
+    }
+    return true;
+}
+
+} // namespace satox::database
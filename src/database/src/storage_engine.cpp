@@ -0,0 +1,434 @@
+/*
+ * MIT License
+ * Copyright(c) 2025 Satoxcoin Core Developer
+ */
+
+#include "satox/database/storage_engine.hpp"
+#include <algorithm>
+#include <cerrno>
+#include <cinttypes>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <fcntl.h>
+#include <unistd.h>
+
+namespace satox::database {
+
+namespace {
+
+constexpr size_t kRecordHeaderSize = 16;  // u32 length | u32 crc32 | u64 lsn
+const char* const kCheckpointFile = "checkpoint.snap";
+
+void putLE(std::vector<uint8_t>& out, uint64_t value, int bytes) {
+    for (int i = 0; i < bytes; ++i) {
+        out.push_back(static_cast<uint8_t>(value >> (8 * i)));
+    }
+}
+
+uint64_t getLE(const uint8_t* p, int bytes) {
+    uint64_t value = 0;
+    for (int i = bytes - 1; i >= 0; --i) {
+        value = value << 8 | p[i];
+    }
+    return value;
+}
+
+bool writeAll(int fd, const std::vector<uint8_t>& buffer) {
+    size_t done = 0;
+    while (done < buffer.size()) {
+        ssize_t n = ::write(fd, buffer.data() + done, buffer.size() - done);
+        if (n < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            return false;
+        }
+        done += static_cast<size_t>(n);
+    }
+    return true;
+}
+
+void syncDirectory(const std::string& path) {
+    int fd = ::open(path.c_str(), O_RDONLY | O_DIRECTORY);
+    if (fd >= 0) {
+        ::fsync(fd);
+        ::close(fd);
+    }
+}
+
+/*
+ * Change records, as produced by DatabaseManager:
+ *   {"op": "create_database" | "drop_database", "db"}
+ *   {"op": "create_table", "db", "table", "schema"}   {"op": "drop_table", "db", "table"}
+ *   {"op": "insert" | "update", "db", "table", "row", "record"}   {"op": "erase", "db", "table", "row"}
+ *   {"op": "create_index", "db", "table", "field", "type"}   {"op": "drop_index", "db", "table", "field"}
+ * Rows are addressed by RowId so replay reproduces the exact row layout.
+ */
+void applyChange(std::map<std::string, DatabaseData>& databases, const nlohmann::json& change) {
+    const auto& op = change.at("op").get_ref<const std::string&>();
+    const auto& dbName = change.at("db").get_ref<const std::string&>();
+
+    if (op == "create_database") {
+        databases[dbName].name = dbName;
+        return;
+    }
+    if (op == "drop_database") {
+        databases.erase(dbName);
+        return;
+    }
+
+    auto db = databases.find(dbName);
+    if (db == databases.end()) {
+        return;
+    }
+    const auto& tableName = change.at("table").get_ref<const std::string&>();
+    if (op == "create_table") {
+        TableData table;
+        table.schema = change.at("schema");
+        db->second.tables[tableName] = std::move(table);
+        return;
+    }
+    if (op == "drop_table") {
+        db->second.tables.erase(tableName);
+        return;
+    }
+
+    auto table = db->second.tables.find(tableName);
+    if (table == db->second.tables.end()) {
+        return;
+    }
+    if (op == "insert") {
+        table->second.restoreRow(change.at("row").get<RowId>(), std::make_shared<const nlohmann::json>(change.at("record")));
+    } else if (op == "update") {
+        table->second.replaceRow(change.at("row").get<RowId>(), std::make_shared<const nlohmann::json>(change.at("record")));
+    } else if (op == "erase") {
+        table->second.eraseRow(change.at("row").get<RowId>());
+    } else if (op == "create_index") {
+        table->second.addIndex(change.at("field").get<std::string>(),
+                               indexTypeFromString(change.at("type").get<std::string>()));
+    } else if (op == "drop_index") {
+        table->second.indexes.erase(change.at("field").get<std::string>());
+    }
+}
+
+} // namespace
+
+// --- MemoryStorageEngine ---
+
+bool MemoryStorageEngine::open(const DatabaseConfig&, std::string&) {
+    return true;
+}
+
+void MemoryStorageEngine::close() {}
+
+bool MemoryStorageEngine::durable() const {
+    return false;
+}
+
+bool MemoryStorageEngine::recover(std::map<std::string, DatabaseData>&, std::string&) {
+    return true;
+}
+
+uint64_t MemoryStorageEngine::append(const nlohmann::json&) {
+    return 0;
+}
+
+bool MemoryStorageEngine::waitDurable(uint64_t, std::string&) {
+    return true;
+}
+
+bool MemoryStorageEngine::needsCheckpoint() const {
+    return false;
+}
+
+bool MemoryStorageEngine::beginCheckpoint(uint64_t& lsn, std::string&) {
+    lsn = 0;
+    return true;
+}
+
+bool MemoryStorageEngine::completeCheckpoint(uint64_t, const std::vector<std::string>&,
+                                             std::vector<SnapshotTable>&, std::string&) {
+    return true;
+}
+
+// --- WalStorageEngine ---
+
+WalStorageEngine::~WalStorageEngine() {
+    close();
+}
+
+bool WalStorageEngine::open(const DatabaseConfig& config, std::string& error) {
+    directory_ = config.storagePath;
+    policy_ = config.syncPolicy;
+    syncInterval_ = std::chrono::milliseconds(std::max(1, config.syncIntervalMs));
+    checkpointBytes_ = config.checkpointLogBytes;
+    checkpointInterval_ = std::chrono::milliseconds(std::max(0, config.checkpointIntervalMs));
+
+    std::error_code ec;
+    std::filesystem::create_directories(directory_, ec);
+    if (ec) {
+        error = "Cannot create storage directory: " + ec.message();
+        return false;
+    }
+    return true;
+}
+
+void WalStorageEngine::close() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stopping_ = true;
+    }
+    cv_.notify_all();
+    if (syncThread_.joinable()) {
+        syncThread_.join();
+    }
+
+    std::unique_lock<std::mutex> lock(mutex_);
+    cv_.wait(lock, [this] { return !flushing_; });
+    if (fd_ >= 0) {
+        if (ioError_.empty() && (!pending_.empty() || syncedLsn_ + 1 < nextLsn_)) {
+            flushLocked(lock, true);
+        }
+        ::close(fd_);
+        fd_ = -1;
+    }
+    pending_.clear();
+    stopping_ = false;
+}
+
+bool WalStorageEngine::durable() const {
+    return true;
+}
+
+std::string WalStorageEngine::segmentPath(uint64_t firstLsn) const {
+    char name[32];
+    std::snprintf(name, sizeof(name), "wal-%020" PRIu64 ".log", firstLsn);
+    return (std::filesystem::path(directory_) / name).string();
+}
+
+std::map<uint64_t, std::string> WalStorageEngine::listSegments() const {
+    std::map<uint64_t, std::string> segments;
+    std::error_code ec;
+    for (const auto& entry : std::filesystem::directory_iterator(directory_, ec)) {
+        const std::string name = entry.path().filename().string();
+        if (name.size() == 28 && name.compare(0, 4, "wal-") == 0 && name.compare(24, 4, ".log") == 0) {
+            segments.emplace(std::stoull(name.substr(4, 20)), entry.path().string());
+        }
+    }
+    return segments;
+}
+
+bool WalStorageEngine::recover(std::map<std::string, DatabaseData>& databases, std::string& error) {
+    // Start from the last checkpoint, if any
+    uint64_t lastLsn = 0;
+    const std::string checkpointPath = (std::filesystem::path(directory_) / kCheckpointFile).string();
+    if (std::filesystem::exists(checkpointPath)) {
+        SnapshotReader reader;
+        if (!reader.open(checkpointPath) || !reader.loadAll(databases, error)) {
+            if (error.empty()) {
+                error = reader.error();
+            }
+            return false;
+        }
+        lastLsn = reader.metadata().value("lsn", uint64_t{0});
+    }
+
+    // Replay newer log records; everything after the first bad record is discarded
+    bool intact = true;
+    for (const auto& [firstLsn, path] : listSegments()) {
+        if (!intact) {
+            std::filesystem::remove(path);
+            continue;
+        }
+        std::ifstream in(path, std::ios::binary);
+        std::vector<uint8_t> data((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+        size_t pos = 0;
+        while (pos < data.size()) {
+            if (data.size() - pos < kRecordHeaderSize) {
+                intact = false;
+                break;
+            }
+            const uint8_t* p = data.data() + pos;
+            uint32_t length = static_cast<uint32_t>(getLE(p, 4));
+            if (data.size() - pos - kRecordHeaderSize < length ||
+                snapshot::crc32(p + 8, 8 + length) != static_cast<uint32_t>(getLE(p + 4, 4))) {
+                intact = false;
+                break;
+            }
+            uint64_t lsn = getLE(p + 8, 8);
+            if (lsn > lastLsn) {
+                try {
+                    auto changes = nlohmann::json::from_cbor(p + kRecordHeaderSize, p + kRecordHeaderSize + length);
+                    for (const auto& change : changes) {
+                        applyChange(databases, change);
+                    }
+                } catch (const std::exception& e) {
+                    error = "Cannot replay log record " + std::to_string(lsn) + ": " + e.what();
+                    return false;
+                }
+                lastLsn = lsn;
+            }
+            pos += kRecordHeaderSize + length;
+        }
+        if (!intact && ::truncate(path.c_str(), static_cast<off_t>(pos)) != 0) {
+            error = "Cannot truncate torn log segment: " + std::string(std::strerror(errno));
+            return false;
+        }
+    }
+
+    std::unique_lock<std::mutex> lock(mutex_);
+    nextLsn_ = lastLsn + 1;
+    writtenLsn_ = syncedLsn_ = lastLsn;
+    bytesSinceCheckpoint_ = 0;
+    lastCheckpoint_ = std::chrono::steady_clock::now();
+    ioError_.clear();
+    if (!openSegment(nextLsn_, error)) {
+        return false;
+    }
+    if (policy_ == SyncPolicy::INTERVAL) {
+        syncThread_ = std::thread(&WalStorageEngine::syncLoop, this);
+    }
+    return true;
+}
+
+bool WalStorageEngine::openSegment(uint64_t firstLsn, std::string& error) {
+    int fd = ::open(segmentPath(firstLsn).c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_APPEND | O_CLOEXEC, 0644);
+    if (fd < 0) {
+        error = "Cannot open log segment: " + std::string(std::strerror(errno));
+        return false;
+    }
+    syncDirectory(directory_);
+    if (fd_ >= 0) {
+        ::close(fd_);
+    }
+    fd_ = fd;
+    segmentStart_ = firstLsn;
+    return true;
+}
+
+uint64_t WalStorageEngine::append(const nlohmann::json& changes) {
+    auto payload = nlohmann::json::to_cbor(changes);
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    uint64_t lsn = nextLsn_++;
+    size_t start = pending_.size();
+    putLE(pending_, payload.size(), 4);
+    putLE(pending_, 0, 4);
+    putLE(pending_, lsn, 8);
+    pending_.insert(pending_.end(), payload.begin(), payload.end());
+    uint32_t crc = snapshot::crc32(pending_.data() + start + 8, 8 + payload.size());
+    for (int i = 0; i < 4; ++i) {
+        pending_[start + 4 + i] = static_cast<uint8_t>(crc >> (8 * i));
+    }
+    bytesSinceCheckpoint_ += pending_.size() - start;
+    return lsn;
+}
+
+bool WalStorageEngine::flushLocked(std::unique_lock<std::mutex>& lock, bool sync) {
+    // Leader: take everything buffered so far and write it with the lock released
+    flushing_ = true;
+    std::vector<uint8_t> buffer;
+    buffer.swap(pending_);
+    const uint64_t upTo = nextLsn_ - 1;
+    const int fd = fd_;
+
+    lock.unlock();
+    bool ok = writeAll(fd, buffer) && (!sync || ::fdatasync(fd) == 0);
+    int savedErrno = errno;
+    lock.lock();
+
+    flushing_ = false;
+    if (ok) {
+        writtenLsn_ = std::max(writtenLsn_, upTo);
+        if (sync) {
+            syncedLsn_ = std::max(syncedLsn_, upTo);
+        }
+    } else {
+        ioError_ = "Write-ahead log I/O failed: " + std::string(std::strerror(savedErrno));
+    }
+    cv_.notify_all();
+    return ok;
+}
+
+bool WalStorageEngine::waitDurable(uint64_t lsn, std::string& error) {
+    if (lsn == 0) {
+        return true;
+    }
+    std::unique_lock<std::mutex> lock(mutex_);
+    const bool sync = policy_ == SyncPolicy::EVERY_COMMIT;
+    while ((sync ? syncedLsn_ : writtenLsn_) < lsn) {
+        if (!ioError_.empty()) {
+            error = ioError_;
+            return false;
+        }
+        if (flushing_) {
+            // Followers wait; whatever they appended meanwhile goes out with the next flush
+            cv_.wait(lock);
+            continue;
+        }
+        flushLocked(lock, sync);
+    }
+    return true;
+}
+
+void WalStorageEngine::syncLoop() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    while (!stopping_) {
+        cv_.wait_for(lock, syncInterval_, [this] { return stopping_; });
+        if (stopping_) {
+            break;
+        }
+        if (!flushing_ && ioError_.empty() && syncedLsn_ + 1 < nextLsn_) {
+            flushLocked(lock, true);
+        }
+    }
+}
+
+bool WalStorageEngine::needsCheckpoint() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (checkpointBytes_ > 0 && bytesSinceCheckpoint_ >= checkpointBytes_) {
+        return true;
+    }
+    return bytesSinceCheckpoint_ > 0 && checkpointInterval_.count() > 0 &&
+           std::chrono::steady_clock::now() - lastCheckpoint_ >= checkpointInterval_;
+}
+
+bool WalStorageEngine::beginCheckpoint(uint64_t& lsn, std::string& error) {
+    std::unique_lock<std::mutex> lock(mutex_);
+    cv_.wait(lock, [this] { return !flushing_; });
+
+    // The retiring segment must be complete on disk before anything after it is trusted
+    if (!flushLocked(lock, true)) {
+        error = ioError_;
+        return false;
+    }
+    lsn = nextLsn_ - 1;
+    if (segmentStart_ != nextLsn_ && !openSegment(nextLsn_, error)) {
+        return false;
+    }
+    bytesSinceCheckpoint_ = 0;
+    lastCheckpoint_ = std::chrono::steady_clock::now();
+    return true;
+}
+
+bool WalStorageEngine::completeCheckpoint(uint64_t lsn, const std::vector<std::string>& databases,
+                                          std::vector<SnapshotTable>& tables, std::string& error) {
+    const std::string checkpointPath = (std::filesystem::path(directory_) / kCheckpointFile).string();
+    if (!writeSnapshotFile(checkpointPath, databases, tables, {{"lsn", lsn}}, true, error)) {
+        return false;
+    }
+
+    // Segments that start at or below the checkpoint LSN hold nothing newer than it
+    for (const auto& [firstLsn, path] : listSegments()) {
+        if (firstLsn <= lsn) {
+            std::error_code ignored;
+            std::filesystem::remove(path, ignored);
+        }
+    }
+    return true;
+}
+
+} // namespace satox::database
@@ -0,0 +1,204 @@
+/*
+ * MIT License
+ * Copyright(c) 2025 Satoxcoin Core Developer
+ */
+
+#include "satox/database/types.hpp"
+#include <algorithm>
+
+namespace satox::database {
+
+namespace {
+
+// Primary keys are the string values of "id" and "_id" (see DatabaseManager::find)
+template<typename Fn>
+void forEachPrimaryKey(const nlohmann::json& record, Fn&& fn) {
+    for (const char* field : {"id", "_id"}) {
+        auto it = record.find(field);
+        if (it != record.end() && it->is_string()) {
+            fn(it->template get_ref<const std::string&>());
+        }
+    }
+}
+
+// Extracts the string a predicate on "id"/"_id" pins the key to, if any
+const nlohmann::json* primaryKeyOf(const nlohmann::json& predicate) {
+    if (predicate.is_string()) {
+        return &predicate;
+    }
+    if (isOperatorPredicate(predicate) && predicate.contains("$eq") && predicate["$eq"].is_string()) {
+        return &predicate["$eq"];
+    }
+    return nullptr;
+}
+
+} // namespace
+
+RowId TableData::insertRow(nlohmann::json record) {
+    RowId row = nextRowId++;
+    restoreRow(row, std::make_shared<const nlohmann::json>(std::move(record)));
+    return row;
+}
+
+void TableData::restoreRow(RowId row, RecordPtr record) {
+    auto [it, inserted] = rows.emplace(row, std::move(record));
+    if (inserted) {
+        indexRow(row, *it->second);
+        nextRowId = std::max(nextRowId, row + 1);
+    }
+}
+
+RecordPtr TableData::replaceRow(RowId row, RecordPtr record) {
+    auto it = rows.find(row);
+    if (it == rows.end()) {
+        return nullptr;
+    }
+    unindexRow(row, *it->second);
+    std::swap(it->second, record);
+    indexRow(row, *it->second);
+    return record;
+}
+
+RecordPtr TableData::eraseRow(RowId row) {
+    auto it = rows.find(row);
+    if (it == rows.end()) {
+        return nullptr;
+    }
+    unindexRow(row, *it->second);
+    RecordPtr previous = std::move(it->second);
+    rows.erase(it);
+    return previous;
+}
+
+const nlohmann::json* TableData::findRow(const std::string& id, RowId* row) const {
+    auto pk = primaryIndex.find(id);
+    if (pk == primaryIndex.end()) {
+        return nullptr;
+    }
+    // Several rows may share a key; like the linear scan, the oldest wins.
+    for (RowId candidate : pk->second) {
+        auto it = rows.find(candidate);
+        if (it == rows.end()) {
+            continue;
+        }
+        if (row) {
+            *row = candidate;
+        }
+        return it->second.get();
+    }
+    return nullptr;
+}
+
+std::vector<RowId> TableData::selectRows(const nlohmann::json& query) const {
+    std::vector<RowId> result;
+
+    // Pick the most selective index the predicates allow
+    bool indexed = false;
+    std::vector<RowId> candidates;
+    std::vector<RowId> scratch;
+    for (const auto& [field, predicate] : query.items()) {
+        bool usable = false;
+        if (field == "id" || field == "_id") {
+            if (const auto* key = primaryKeyOf(predicate)) {
+                scratch.clear();
+                auto pk = primaryIndex.find(key->get_ref<const std::string&>());
+                if (pk != primaryIndex.end()) {
+                    scratch.assign(pk->second.begin(), pk->second.end());
+                }
+                usable = true;
+            }
+        }
+        if (!usable) {
+            auto idx = indexes.find(field);
+            usable = idx != indexes.end() && idx->second.lookup(predicate, scratch);
+        }
+        if (usable && (!indexed || scratch.size() < candidates.size())) {
+            candidates.swap(scratch);
+            indexed = true;
+            if (candidates.empty()) {
+                return result;
+            }
+        }
+    }
+
+    if (indexed) {
+        for (RowId row : candidates) {
+            auto it = rows.find(row);
+            if (it != rows.end() && matchesQuery(*it->second, query)) {
+                result.push_back(row);
+            }
+        }
+        return result;
+    }
+
+    for (const auto& [row, record] : rows) {
+        if (matchesQuery(*record, query)) {
+            result.push_back(row);
+        }
+    }
+    return result;
+}
+
+std::vector<nlohmann::json> TableData::records() const {
+    std::vector<nlohmann::json> result;
+    result.reserve(rows.size());
+    for (const auto& [_, record] : rows) {
+        result.push_back(*record);
+    }
+    return result;
+}
+
+void TableData::addIndex(const std::string& field, IndexType type) {
+    auto& index = indexes.insert_or_assign(field, RecordIndex(type)).first->second;
+    for (const auto& [row, record] : rows) {
+        auto it = record->find(field);
+        if (it != record->end()) {
+            index.add(*it, row);
+        }
+    }
+}
+
+void TableData::rebuildIndexes() {
+    primaryIndex.clear();
+    for (auto& [_, index] : indexes) {
+        index.clear();
+    }
+    for (const auto& [row, record] : rows) {
+        indexRow(row, *record);
+    }
+    if (!rows.empty()) {
+        nextRowId = std::max(nextRowId, rows.rbegin()->first + 1);
+    }
+}
+
+void TableData::indexRow(RowId row, const nlohmann::json& record) {
+    forEachPrimaryKey(record, [&](const std::string& key) {
+        primaryIndex[key].insert(row);
+    });
+    for (auto& [field, index] : indexes) {
+        auto it = record.find(field);
+        if (it != record.end()) {
+            index.add(*it, row);
+        }
+    }
+}
+
+void TableData::unindexRow(RowId row, const nlohmann::json& record) {
+    forEachPrimaryKey(record, [&](const std::string& key) {
+        auto pk = primaryIndex.find(key);
+        if (pk != primaryIndex.end()) {
+            pk->second.erase(row);
+            if (pk->second.empty()) {
+                primaryIndex.erase(pk);
+            }
+        }
+    });
+    for (auto& [field, index] : indexes) {
+        auto it = record.find(field);
+        if (it != record.end()) {
+            index.remove(*it, row);
+        }
+    }
+}
+
+} // namespace satox::database
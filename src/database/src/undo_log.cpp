@@ -0,0 +1,88 @@
+/*
+ * MIT License
+ * Copyright(c) 2025 Satoxcoin Core Developer
+ */
+
+#include "satox/database/undo_log.hpp"
+
+namespace satox::database {
+
+void UndoLog::recordInsert(const std::string& database, const std::string& table, RowId row) {
+    touch(database, table, row, nullptr);
+    UndoEntry entry{UndoEntry::Kind::INSERT_ROW, database, table};
+    entry.row = row;
+    entries_.push_back(std::move(entry));
+}
+
+void UndoLog::recordUpdate(const std::string& database, const std::string& table, RowId row, RecordPtr before) {
+    touch(database, table, row, before);
+    UndoEntry entry{UndoEntry::Kind::UPDATE_ROW, database, table};
+    entry.row = row;
+    entry.before = std::move(before);
+    entries_.push_back(std::move(entry));
+}
+
+void UndoLog::recordErase(const std::string& database, const std::string& table, RowId row, RecordPtr before) {
+    touch(database, table, row, before);
+    UndoEntry entry{UndoEntry::Kind::ERASE_ROW, database, table};
+    entry.row = row;
+    entry.before = std::move(before);
+    entries_.push_back(std::move(entry));
+}
+
+void UndoLog::record(UndoEntry entry) {
+    // Images of a dropped table belong to that table instance, not its name
+    if (entry.kind == UndoEntry::Kind::DROP_TABLE || entry.kind == UndoEntry::Kind::DROP_DATABASE) {
+        for (auto it = committedImages_.begin(); it != committedImages_.end();) {
+            const auto& [database, table] = it->first;
+            bool dropped = database == entry.database &&
+                           (entry.kind == UndoEntry::Kind::DROP_DATABASE || table == entry.table);
+            if (!dropped) {
+                ++it;
+                continue;
+            }
+            entry.droppedImages.emplace(table, std::move(it->second));
+            it = committedImages_.erase(it);
+        }
+    }
+    entries_.push_back(std::move(entry));
+}
+
+void UndoLog::clear() {
+    entries_.clear();
+    committedImages_.clear();
+}
+
+const std::map<RowId, RecordPtr>* UndoLog::committedImages(const std::string& database, const std::string& table) const {
+    auto it = committedImages_.find({database, table});
+    return it == committedImages_.end() ? nullptr : &it->second;
+}
+
+const UndoEntry* UndoLog::firstSchemaChange(const std::string& database, const std::string& table) const {
+    for (const auto& entry : entries_) {
+        if (entry.database != database) {
+            continue;
+        }
+        switch (entry.kind) {
+            case UndoEntry::Kind::CREATE_DATABASE:
+            case UndoEntry::Kind::DROP_DATABASE:
+                return &entry;
+            case UndoEntry::Kind::CREATE_TABLE:
+            case UndoEntry::Kind::DROP_TABLE:
+                if (!table.empty() && entry.table == table) {
+                    return &entry;
+                }
+                break;
+            default:
+                break;
+        }
+    }
+    return nullptr;
+}
+
+void UndoLog::touch(const std::string& database, const std::string& table, RowId row, RecordPtr before) {
+    // Only the first touch holds the committed image
+    committedImages_[{database, table}].emplace(row, std::move(before));
+}
+
+} // namespace satox::database
@@ -278,6 +278,9 @@ TEST_F(DatabaseManagerComprehensiveTest, ConnectionManagement) {
     // Test reconnection
     EXPECT_TRUE(DatabaseManager::getInstance().reconnect());
     EXPECT_TRUE(callback_called);
+    
+    // The callback captures a local; don't let shutdown() invoke it after this scope
+    DatabaseManager::getInstance().clearCallbacks();
 }
 
 // Error Handling Tests
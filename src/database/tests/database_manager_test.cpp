@@ -26,12 +26,15 @@
 #include <gtest/gtest.h>
 // #include <gmock/gmock.h>  // Removed to avoid compilation issues
 #include <memory>
+#include <atomic>
 #include <mutex>
 #include <thread>
 #include <chrono>
 #include <random>
 #include <fstream>
+#include <filesystem>
 #include <string>
+#include <vector>
 #include "satox/database/database_manager.hpp"
 
 using namespace satox::database;
@@ -191,6 +194,128 @@ TEST_F(DatabaseManagerTest, TransactionOperations) {
     EXPECT_EQ(results.size(), 2);
 }
 
+TEST_F(DatabaseManagerTest, TransactionIsolation) {
+    ASSERT_TRUE(dbManager.createTable("accounts", {
+        {"fields", {
+            {"id", "string"},
+            {"balance", "integer"}
+        }},
+        {"required", {"id", "balance"}}
+    }));
+    ASSERT_TRUE(dbManager.createIndex("accounts", "balance", IndexType::ORDERED));
+    ASSERT_TRUE(dbManager.insert("accounts", {{"id", "1"}, {"balance", 100}}));
+    ASSERT_TRUE(dbManager.insert("accounts", {{"id", "2"}, {"balance", 200}}));
+
+    ASSERT_TRUE(dbManager.beginTransaction());
+    EXPECT_TRUE(dbManager.update("accounts", "1", {{"balance", 150}}));
+    EXPECT_TRUE(dbManager.remove("accounts", "2"));
+    EXPECT_TRUE(dbManager.insert("accounts", {{"id", "3"}, {"balance", 300}}));
+    EXPECT_TRUE(dbManager.createTable("scratch", {{"fields", {{"id", "string"}}}}));
+
+    // The transaction sees its own writes
+    EXPECT_EQ(dbManager.find("accounts", "1")["balance"], 150);
+    EXPECT_TRUE(dbManager.find("accounts", "2").empty());
+
+    // Readers on other threads see committed rows, without blocking
+    std::thread reader([&]() {
+        EXPECT_EQ(dbManager.find("accounts", "1")["balance"], 100);
+        EXPECT_EQ(dbManager.find("accounts", "2")["balance"], 200);
+        EXPECT_TRUE(dbManager.find("accounts", "3").empty());
+        auto rows = dbManager.query("accounts", {{"balance", {{"$gte", 100}}}});
+        ASSERT_EQ(rows.size(), 2);
+        EXPECT_EQ(rows[0]["id"], "1");
+        EXPECT_EQ(rows[1]["id"], "2");
+    });
+    reader.join();
+
+    // Rollback restores rows, indexes and schema
+    EXPECT_TRUE(dbManager.rollbackTransaction());
+    EXPECT_FALSE(dbManager.tableExists("scratch"));
+    EXPECT_EQ(dbManager.find("accounts", "1")["balance"], 100);
+    EXPECT_EQ(dbManager.find("accounts", "2")["balance"], 200);
+    EXPECT_TRUE(dbManager.find("accounts", "3").empty());
+    EXPECT_EQ(dbManager.query("accounts", {{"balance", 150}}).size(), 0);
+    EXPECT_EQ(dbManager.query("accounts", {{"balance", {{"$gt", 0}}}}).size(), 2);
+
+    // Writers on other threads wait for the transaction to finish
+    ASSERT_TRUE(dbManager.beginTransaction());
+    std::thread writer([&]() {
+        EXPECT_TRUE(dbManager.insert("accounts", {{"id", "4"}, {"balance", 400}}));
+    });
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    EXPECT_TRUE(dbManager.find("accounts", "4").empty());
+    EXPECT_TRUE(dbManager.commitTransaction());
+    writer.join();
+    EXPECT_EQ(dbManager.find("accounts", "4")["balance"], 400);
+}
+
+TEST_F(DatabaseManagerTest, TransactionIsolationAcrossSchemaChanges) {
+    nlohmann::json schema = {{"fields", {{"id", "string"}, {"balance", "integer"}}}};
+    ASSERT_TRUE(dbManager.createTable("accounts", schema));
+    ASSERT_TRUE(dbManager.createIndex("accounts", "balance", IndexType::ORDERED));
+    ASSERT_TRUE(dbManager.insert("accounts", {{"id", "1"}, {"balance", 100}}));
+    ASSERT_TRUE(dbManager.insert("accounts", {{"id", "2"}, {"balance", 200}}));
+
+    // Touch rows, drop the table and recreate it under the same name
+    ASSERT_TRUE(dbManager.beginTransaction());
+    EXPECT_TRUE(dbManager.update("accounts", "1", {{"balance", 150}}));
+    EXPECT_TRUE(dbManager.deleteTable("accounts"));
+    EXPECT_TRUE(dbManager.createTable("accounts", {{"fields", {{"id", "string"}}}}));
+    EXPECT_TRUE(dbManager.insert("accounts", {{"id", "9"}}));
+    EXPECT_TRUE(dbManager.update("accounts", "9", {{"note", "new"}}));
+    EXPECT_TRUE(dbManager.createTable("scratch", schema));
+    EXPECT_TRUE(dbManager.createDatabase("other_db"));
+
+    std::thread reader([&]() {
+        // The committed table, its schema and indexes, not the recreated one
+        EXPECT_EQ(dbManager.find("accounts", "1")["balance"], 100);
+        EXPECT_EQ(dbManager.find("accounts", "2")["balance"], 200);
+        EXPECT_TRUE(dbManager.find("accounts", "9").empty());
+        EXPECT_EQ(dbManager.query("accounts", {}).size(), 2);
+        EXPECT_EQ(dbManager.getTableSchema("accounts"), schema);
+        EXPECT_TRUE(contains(dbManager.listIndexes("accounts"), std::string("balance")));
+
+        // Tables and databases the transaction created are not visible yet
+        EXPECT_FALSE(dbManager.tableExists("scratch"));
+        EXPECT_EQ(dbManager.listTables(), std::vector<std::string>{"accounts"});
+        EXPECT_FALSE(dbManager.databaseExists("other_db"));
+        EXPECT_FALSE(contains(dbManager.listDatabases(), std::string("other_db")));
+    });
+    reader.join();
+
+    EXPECT_TRUE(dbManager.rollbackTransaction());
+    EXPECT_EQ(dbManager.find("accounts", "1")["balance"], 100);
+    EXPECT_TRUE(dbManager.find("accounts", "9").empty());
+    EXPECT_FALSE(dbManager.tableExists("scratch"));
+    EXPECT_FALSE(dbManager.databaseExists("other_db"));
+}
+
+TEST_F(DatabaseManagerTest, CallbackWriterDoesNotWaitForTransaction) {
+    ASSERT_TRUE(dbManager.createTable("events", {{"fields", {{"id", "string"}}}}));
+    ASSERT_TRUE(dbManager.beginTransaction());
+
+    // The callback runs with the manager locked by the reader's find(); a
+    // write from it must fail fast instead of blocking the transaction owner
+    std::atomic<bool> reentered{false};
+    std::atomic<bool> written{true};
+    dbManager.setDatabaseCallback([&](const std::string& operation, bool, const std::string&) {
+        if (operation == "find" && !reentered.exchange(true)) {
+            written = dbManager.insert("events", {{"id", "from-callback"}});
+        }
+    });
+    std::thread reader([&]() {
+        dbManager.find("events", "missing");
+    });
+    reader.join();
+    dbManager.setDatabaseCallback(nullptr);
+
+    EXPECT_TRUE(reentered);
+    EXPECT_FALSE(written);
+    EXPECT_EQ(dbManager.getLastErrorCode(), DatabaseErrorCode::INVALID_STATE);
+    EXPECT_TRUE(dbManager.commitTransaction());
+    EXPECT_TRUE(dbManager.find("events", "from-callback").empty());
+}
+
 // Index Tests
 TEST_F(DatabaseManagerTest, IndexOperations) {
     ASSERT_TRUE(dbManager.createTable("products", {
@@ -211,6 +336,50 @@ TEST_F(DatabaseManagerTest, IndexOperations) {
     EXPECT_FALSE(contains(indexes, std::string("price")));
 }
 
+TEST_F(DatabaseManagerTest, IndexedQueries) {
+    ASSERT_TRUE(dbManager.createTable("assets", {
+        {"fields", {
+            {"id", "string"},
+            {"owner", "string"},
+            {"amount", "integer"}
+        }},
+        {"required", {"id", "owner", "amount"}}
+    }));
+
+    for (int i = 0; i < 100; ++i) {
+        ASSERT_TRUE(dbManager.insert("assets", {
+            {"id", "asset_" + std::to_string(i)},
+            {"owner", i % 2 == 0 ? "alice" : "bob"},
+            {"amount", i}
+        }));
+    }
+
+    ASSERT_TRUE(dbManager.createIndex("assets", "owner"));
+    ASSERT_TRUE(dbManager.createIndex("assets", "amount", IndexType::ORDERED));
+
+    // Equality through the hash index, in insertion order
+    auto results = dbManager.query("assets", {{"owner", "alice"}});
+    ASSERT_EQ(results.size(), 50);
+    EXPECT_EQ(results.front()["id"], "asset_0");
+    EXPECT_EQ(results.back()["id"], "asset_98");
+
+    // Range through the ordered index, combined with a residual predicate
+    results = dbManager.query("assets", {{"amount", {{"$gte", 10}, {"$lt", 20}}}, {"owner", "bob"}});
+    ASSERT_EQ(results.size(), 5);
+    EXPECT_EQ(results.front()["amount"], 11);
+
+    // Indexes follow updates and removals
+    ASSERT_TRUE(dbManager.update("assets", "asset_1", {{"owner", "alice"}, {"amount", 1000}}));
+    ASSERT_TRUE(dbManager.remove("assets", "asset_0"));
+    EXPECT_EQ(dbManager.query("assets", {{"owner", "alice"}}).size(), 50);
+    EXPECT_EQ(dbManager.query("assets", {{"amount", {{"$gt", 99}}}}).size(), 1);
+    EXPECT_TRUE(dbManager.query("assets", {{"amount", 0}}).empty());
+    EXPECT_EQ(dbManager.query("assets", {{"id", "asset_1"}}).size(), 1);
+
+    // Set membership through the ordered index
+    EXPECT_EQ(dbManager.query("assets", {{"amount", {{"$in", {2, 4, 6}}}}}).size(), 3);
+}
+
 // Backup and Restore Tests
 TEST_F(DatabaseManagerTest, BackupAndRestore) {
     // Create test data
@@ -239,6 +408,304 @@ TEST_F(DatabaseManagerTest, BackupAndRestore) {
     EXPECT_EQ(found["value"], "test1");
 }
 
+TEST_F(DatabaseManagerTest, BinarySnapshotBackup) {
+    ASSERT_TRUE(dbManager.createTable("blocks", {
+        {"fields", {
+            {"id", "string"},
+            {"height", "integer"},
+            {"hash", "string"}
+        }},
+        {"required", {"id", "height"}}
+    }));
+    ASSERT_TRUE(dbManager.createTable("empty", {{"fields", {{"id", "string"}}}}));
+    ASSERT_TRUE(dbManager.createIndex("blocks", "height", IndexType::ORDERED));
+    for (int i = 0; i < 2000; ++i) {
+        ASSERT_TRUE(dbManager.insert("blocks", {
+            {"id", "block_" + std::to_string(i)},
+            {"height", i},
+            {"hash", std::string(64, 'a' + i % 26)}
+        }));
+    }
+    ASSERT_TRUE(dbManager.createDatabase("other_db"));
+
+    const std::string path = "test_snapshot.bin";
+    ASSERT_TRUE(dbManager.createBackup(path));
+    {
+        std::ifstream in(path, std::ios::binary);
+        char magic[8] = {};
+        in.read(magic, sizeof(magic));
+        EXPECT_EQ(std::string(magic, 8), "SATXSNAP");
+    }
+
+    ASSERT_TRUE(dbManager.deleteTable("blocks"));
+    ASSERT_TRUE(dbManager.restoreFromBackup(path));
+    ASSERT_TRUE(dbManager.useDatabase("test_db"));
+    EXPECT_TRUE(dbManager.databaseExists("other_db"));
+    EXPECT_TRUE(dbManager.tableExists("empty"));
+    EXPECT_EQ(dbManager.find("blocks", "block_1999")["height"], 1999);
+    EXPECT_EQ(dbManager.query("blocks", {}).size(), 2000);
+    EXPECT_EQ(dbManager.query("blocks", {{"height", {{"$gte", 1990}}}}).size(), 10);
+    auto indexes = dbManager.listIndexes("blocks");
+    EXPECT_TRUE(contains(indexes, std::string("height")));
+
+    // A flipped byte inside a record chunk is caught by its checksum
+    {
+        std::fstream file(path, std::ios::in | std::ios::out | std::ios::binary);
+        file.seekp(64);
+        file.put('\xff');
+    }
+    EXPECT_FALSE(dbManager.restoreFromBackup(path));
+    EXPECT_TRUE(dbManager.tableExists("blocks"));
+
+    // JSON backups from earlier releases still restore
+    {
+        std::ofstream legacy(path, std::ios::trunc);
+        legacy << nlohmann::json{{"databases", {{"legacy_db", {{"tables", {{"items", {
+            {"records", {{{"id", "1"}, {"value", "x"}}}},
+            {"indexes", {{"value", nlohmann::json::array()}}},
+            {"schema", {{"fields", {{"id", "string"}, {"value", "string"}}}}}
+        }}}}}}}}}.dump();
+    }
+    ASSERT_TRUE(dbManager.restoreFromBackup(path));
+    ASSERT_TRUE(dbManager.useDatabase("legacy_db"));
+    EXPECT_EQ(dbManager.query("items", {{"value", "x"}}).size(), 1);
+    std::filesystem::remove(path);
+
+    // A failed write reports its error and leaves no partial file behind
+    EXPECT_FALSE(dbManager.createBackup("missing_dir/test_backup.snap"));
+    EXPECT_FALSE(std::filesystem::exists("missing_dir"));
+    if (std::filesystem::exists("/dev/full")) {
+        SnapshotWriter writer;
+        ASSERT_TRUE(writer.open("/dev/full"));
+        writer.addDatabase("db");
+        EXPECT_FALSE(writer.finish());
+        EXPECT_FALSE(writer.error().empty());
+        writer.abort();
+    }
+}
+
+TEST_F(DatabaseManagerTest, ConcurrentBackupsToOneTarget) {
+    ASSERT_TRUE(dbManager.createTable("items", {{"fields", {{"id", "string"}, {"value", "string"}}}}));
+    for (int i = 0; i < 200; ++i) {
+        ASSERT_TRUE(dbManager.insert("items", {{"id", std::to_string(i)}, {"value", std::string(64, 'x')}}));
+    }
+
+    const std::string path = "test_concurrent_backup.snap";
+    std::atomic<int> succeeded{0};
+    std::vector<std::thread> writers;
+    for (int t = 0; t < 4; ++t) {
+        writers.emplace_back([&] {
+            for (int i = 0; i < 5; ++i) {
+                succeeded += dbManager.createBackup(path) ? 1 : 0;
+            }
+        });
+    }
+    for (auto& writer : writers) {
+        writer.join();
+    }
+    EXPECT_EQ(succeeded, 20);
+
+    // Every writer had its own temp file, so the survivor is one whole snapshot
+    for (const auto& entry : std::filesystem::directory_iterator(".")) {
+        EXPECT_EQ(entry.path().filename().string().find(path + ".tmp"), std::string::npos);
+    }
+    ASSERT_TRUE(dbManager.remove("items", "0"));
+    ASSERT_TRUE(dbManager.restoreFromBackup(path));
+    EXPECT_EQ(dbManager.find("items", "0")["value"], std::string(64, 'x'));
+    EXPECT_EQ(dbManager.query("items", nlohmann::json::object()).size(), 200);
+    std::filesystem::remove(path);
+}
+
+TEST_F(DatabaseManagerTest, DurableStorageRecovery) {
+    const std::string storage = "test_storage";
+    std::filesystem::remove_all(storage);
+    DatabaseConfig config;
+    config.name = "test_db";
+    config.storagePath = storage;
+    config.syncPolicy = SyncPolicy::EVERY_COMMIT;
+
+    dbManager.shutdown();
+    ASSERT_TRUE(dbManager.initialize(config));
+    ASSERT_TRUE(dbManager.createDatabase("chain"));
+    ASSERT_TRUE(dbManager.useDatabase("chain"));
+    ASSERT_TRUE(dbManager.createTable("utxos", {{"fields", {{"id", "string"}, {"amount", "integer"}}}}));
+    ASSERT_TRUE(dbManager.createIndex("utxos", "amount", IndexType::ORDERED));
+
+    // Concurrent committers share log flushes
+    std::vector<std::thread> writers;
+    for (int t = 0; t < 4; ++t) {
+        writers.emplace_back([this, t] {
+            for (int i = 0; i < 25; ++i) {
+                EXPECT_TRUE(dbManager.insert("utxos", {{"id", "u" + std::to_string(t * 25 + i)}, {"amount", t * 25 + i}}));
+            }
+        });
+    }
+    for (auto& writer : writers) {
+        writer.join();
+    }
+    ASSERT_TRUE(dbManager.update("utxos", "u1", {{"amount", 1000}}));
+    ASSERT_TRUE(dbManager.remove("utxos", "u2"));
+    ASSERT_TRUE(dbManager.beginTransaction());
+    ASSERT_TRUE(dbManager.insert("utxos", {{"id", "committed"}, {"amount", 7}}));
+    ASSERT_TRUE(dbManager.commitTransaction());
+    ASSERT_TRUE(dbManager.beginTransaction());
+    ASSERT_TRUE(dbManager.insert("utxos", {{"id", "abandoned"}, {"amount", 8}}));
+    dbManager.shutdown();
+
+    // Replaying the log restores every committed change and nothing else
+    ASSERT_TRUE(dbManager.initialize(config));
+    ASSERT_TRUE(dbManager.useDatabase("chain"));
+    EXPECT_EQ(dbManager.query("utxos", {}).size(), 100);
+    EXPECT_EQ(dbManager.find("utxos", "u1")["amount"], 1000);
+    EXPECT_TRUE(dbManager.find("utxos", "u2").is_null());
+    EXPECT_FALSE(dbManager.find("utxos", "committed").is_null());
+    EXPECT_TRUE(dbManager.find("utxos", "abandoned").is_null());
+    EXPECT_EQ(dbManager.query("utxos", {{"amount", {{"$gte", 99}}}}).size(), 2);
+
+    // After a checkpoint only the newer log is replayed
+    ASSERT_TRUE(dbManager.checkpoint());
+    ASSERT_TRUE(dbManager.insert("utxos", {{"id", "after"}, {"amount", 9}}));
+    dbManager.shutdown();
+    EXPECT_TRUE(std::filesystem::exists(storage + "/checkpoint.snap"));
+
+    // A torn record at the tail is discarded
+    std::filesystem::path lastSegment;
+    for (const auto& entry : std::filesystem::directory_iterator(storage)) {
+        if (entry.path().extension() == ".log" && entry.path() > lastSegment) {
+            lastSegment = entry.path();
+        }
+    }
+    {
+        std::ofstream torn(lastSegment, std::ios::binary | std::ios::app);
+        torn << std::string("\x40\x00\x00\x00garbage", 11);
+    }
+    ASSERT_TRUE(dbManager.initialize(config));
+    ASSERT_TRUE(dbManager.useDatabase("chain"));
+    EXPECT_EQ(dbManager.query("utxos", {}).size(), 101);
+    EXPECT_EQ(dbManager.find("utxos", "after")["amount"], 9);
+    EXPECT_EQ(dbManager.listIndexes("utxos").size(), 1);
+    dbManager.shutdown();
+
+    std::filesystem::remove_all(storage);
+    ASSERT_TRUE(dbManager.initialize(DatabaseConfig{}));
+}
+
+TEST_F(DatabaseManagerTest, CallbackMayCheckpointAgain) {
+    const std::string storage = "test_storage";
+    std::filesystem::remove_all(storage);
+    DatabaseConfig config;
+    config.name = "test_db";
+    config.storagePath = storage;
+    config.syncPolicy = SyncPolicy::EVERY_COMMIT;
+
+    dbManager.shutdown();
+    ASSERT_TRUE(dbManager.initialize(config));
+    ASSERT_TRUE(dbManager.createDatabase("chain"));
+    ASSERT_TRUE(dbManager.useDatabase("chain"));
+    ASSERT_TRUE(dbManager.createTable("utxos", {{"fields", {{"id", "string"}}}}));
+    ASSERT_TRUE(dbManager.insert("utxos", {{"id", "u1"}}));
+    ASSERT_TRUE(dbManager.createBackup("callback_backup.snap"));
+
+    // Both operations must release the checkpoint lock before the callback runs
+    int nested = 0;
+    bool reentering = false;
+    dbManager.setDatabaseCallback([&](const std::string& operation, bool success, const std::string&) {
+        if (success && !reentering && (operation == "checkpoint" || operation == "restoreFromBackup")) {
+            reentering = true;
+            EXPECT_TRUE(dbManager.checkpoint());
+            reentering = false;
+            ++nested;
+        }
+    });
+    EXPECT_TRUE(dbManager.checkpoint());
+    EXPECT_TRUE(dbManager.restoreFromBackup("callback_backup.snap"));
+    dbManager.setDatabaseCallback(nullptr);
+    EXPECT_EQ(nested, 2);
+    EXPECT_FALSE(dbManager.find("utxos", "u1").is_null());
+    dbManager.shutdown();
+
+    std::filesystem::remove("callback_backup.snap");
+    std::filesystem::remove_all(storage);
+    ASSERT_TRUE(dbManager.initialize(DatabaseConfig{}));
+}
+
+// Durable engine whose log writes start failing on demand
+class FailingLogEngine : public StorageEngine {
+public:
+    explicit FailingLogEngine(std::shared_ptr<std::atomic<bool>> failing) : failing_(std::move(failing)) {}
+
+    bool open(const DatabaseConfig&, std::string&) override { return true; }
+    void close() override {}
+    bool durable() const override { return true; }
+    bool recover(std::map<std::string, DatabaseData>&, std::string&) override { return true; }
+    uint64_t append(const nlohmann::json&) override { return ++lsn_; }
+    bool waitDurable(uint64_t, std::string& error) override {
+        if (*failing_) {
+            error = "No space left on device";
+            return false;
+        }
+        return true;
+    }
+    bool needsCheckpoint() const override { return false; }
+    bool beginCheckpoint(uint64_t&, std::string& error) override {
+        error = "Checkpoints are not supported";
+        return false;
+    }
+    bool completeCheckpoint(uint64_t, const std::vector<std::string>&, std::vector<SnapshotTable>&,
+                            std::string& error) override {
+        error = "Checkpoints are not supported";
+        return false;
+    }
+
+private:
+    std::shared_ptr<std::atomic<bool>> failing_;
+    uint64_t lsn_ = 0;
+};
+
+TEST_F(DatabaseManagerTest, FailedLogWritesAreReverted) {
+    auto failing = std::make_shared<std::atomic<bool>>(false);
+    DatabaseConfig config;
+    config.name = "test_db";
+    dbManager.shutdown();
+    dbManager.setStorageEngine(std::make_unique<FailingLogEngine>(failing));
+    ASSERT_TRUE(dbManager.initialize(config));
+    ASSERT_TRUE(dbManager.createDatabase("test_db"));
+    ASSERT_TRUE(dbManager.useDatabase("test_db"));
+    ASSERT_TRUE(dbManager.createTable("accounts", {{"fields", {{"id", "string"}, {"balance", "integer"}}}}));
+    ASSERT_TRUE(dbManager.insert("accounts", {{"id", "1"}, {"balance", 100}}));
+
+    // Writes the log cannot take fail and leave nothing behind in memory
+    *failing = true;
+    EXPECT_FALSE(dbManager.insert("accounts", {{"id", "2"}, {"balance", 200}}));
+    EXPECT_TRUE(dbManager.find("accounts", "2").empty());
+    EXPECT_FALSE(dbManager.update("accounts", "1", {{"balance", 150}}));
+    EXPECT_EQ(dbManager.find("accounts", "1")["balance"], 100);
+    EXPECT_FALSE(dbManager.remove("accounts", "1"));
+    EXPECT_EQ(dbManager.find("accounts", "1")["balance"], 100);
+    EXPECT_FALSE(dbManager.createIndex("accounts", "balance"));
+    EXPECT_TRUE(dbManager.listIndexes("accounts").empty());
+    EXPECT_FALSE(dbManager.createTable("other", {{"fields", {{"id", "string"}}}}));
+    EXPECT_FALSE(dbManager.tableExists("other"));
+    EXPECT_FALSE(dbManager.deleteTable("accounts"));
+    EXPECT_TRUE(dbManager.tableExists("accounts"));
+    EXPECT_FALSE(dbManager.createDatabase("other_db"));
+    EXPECT_FALSE(dbManager.databaseExists("other_db"));
+
+    // A transaction whose commit batch is lost is rolled back
+    ASSERT_TRUE(dbManager.beginTransaction());
+    EXPECT_TRUE(dbManager.insert("accounts", {{"id", "3"}, {"balance", 300}}));
+    EXPECT_TRUE(dbManager.update("accounts", "1", {{"balance", 175}}));
+    EXPECT_FALSE(dbManager.commitTransaction());
+    EXPECT_FALSE(dbManager.isInTransaction());
+    EXPECT_TRUE(dbManager.find("accounts", "3").empty());
+    EXPECT_EQ(dbManager.find("accounts", "1")["balance"], 100);
+
+    // Once the log recovers writes go through again
+    *failing = false;
+    EXPECT_TRUE(dbManager.insert("accounts", {{"id", "4"}, {"balance", 400}}));
+    EXPECT_EQ(dbManager.query("accounts", {}).size(), 2);
+}
+
 // Concurrency Tests
 TEST_F(DatabaseManagerTest, Concurrency) {
     ASSERT_TRUE(dbManager.createTable("concurrent_test", {
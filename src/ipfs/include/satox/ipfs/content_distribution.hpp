@@ -25,6 +25,7 @@
 
 #pragma once
 
+#include <cstdint>
 #include <string>
 #include <vector>
 #include <unordered_map>
@@ -37,8 +38,30 @@
 namespace satox {
 namespace ipfs {
 
+class TransferScheduler;
+class IoExecutor;
+
+/**
+ * Pushes content to remote nodes through a shared transfer scheduler (see
+ * TransferScheduler): chunks go out under one global bandwidth limit, shared
+ * between distributions in proportion to their priority, with at most
+ * setMaxTransfersPerNode() chunks in flight per node. A distribution that
+ * failed or was cancelled resumes from the last acknowledged chunk of each
+ * node when it is started again before shutdown().
+ *
+ * Files are keyed by the SHA-256 of their bytes, hashed on HASH_THREADS
+ * background threads; distributeFile() and distributeDirectory() return
+ * before the hashing is done.
+ *
+ * Chunks are delivered by the ChunkTransport. The default one writes each
+ * chunk at its offset into /satox-distribution/<contentHash> in the node's
+ * MFS through its IPFS HTTP API (/api/v0/files/write).
+ */
 class ContentDistribution {
 public:
+    static constexpr size_t TRANSFER_THREADS = 4;
+    static constexpr size_t HASH_THREADS = 2;
+
     // Singleton instance
     static ContentDistribution& getInstance();
 
@@ -68,6 +91,10 @@ public:
         std::vector<std::string> failedNodes;
         std::string startTime;
         std::string endTime;
+        // Throughput, reported to the StatusCallback while data moves
+        uint64_t totalBytes = 0;             // content size times target nodes
+        uint64_t bytesTransferred = 0;
+        double bytesPerSecond = 0;
     };
 
     DistributionStatus getDistributionStatus(const std::string& contentHash) const;
@@ -79,10 +106,21 @@ public:
     size_t getBandwidthLimit() const;
     size_t getCurrentBandwidthUsage() const;
 
-    // Priority management
+    // Concurrent chunks sent to one node, across all distributions
+    void setMaxTransfersPerNode(size_t maxTransfers);
+    size_t getMaxTransfersPerNode() const;
+
+    // Priority management; a distribution's bandwidth share grows with its
+    // priority (0 is the default, negative values shrink it)
     void setDistributionPriority(const std::string& contentHash, int priority);
     int getDistributionPriority(const std::string& contentHash) const;
 
+    // Sends one chunk of content to a node; true once the node has it
+    using ChunkTransport = std::function<bool(const std::string& nodeId, const std::string& address,
+                                              const std::string& contentHash, uint64_t offset,
+                                              const std::string& chunk)>;
+    void setChunkTransport(ChunkTransport transport);
+
     // Event callbacks
     using StatusCallback = std::function<void(const DistributionStatus&)>;
     void setStatusCallback(StatusCallback callback);
@@ -97,8 +135,8 @@ public:
     void clearLastError();
 
 private:
-    ContentDistribution() = default;
-    ~ContentDistribution() = default;
+    ContentDistribution();
+    ~ContentDistribution();
     ContentDistribution(const ContentDistribution&) = delete;
     ContentDistribution& operator=(const ContentDistribution&) = delete;
 
@@ -107,6 +145,15 @@ private:
     bool updateDistributionStatus(const std::string& contentHash, const DistributionStatus& status);
     void notifyStatusCallback(const DistributionStatus& status);
     bool handleError(const std::string& operation, const std::string& error);
+    using ChunkReader = std::function<bool(uint64_t offset, size_t size, std::string& chunk)>;
+    std::future<bool> schedule(const std::string& contentHash, uint64_t size,
+                               std::function<ChunkReader()> open,
+                               const std::vector<std::string>& targetNodes);
+    // Settles result instead of returning a new future
+    void schedule(const std::string& contentHash, uint64_t size,
+                  std::function<ChunkReader()> open,
+                  const std::vector<std::string>& targetNodes,
+                  std::promise<bool> result);
 
     // Member variables
     mutable std::mutex mutex_;
@@ -116,7 +163,11 @@ private:
     std::unordered_map<std::string, DistributionStatus> activeDistributions_;
     std::unordered_map<std::string, int> distributionPriorities_;
     size_t bandwidthLimit_ = 1024 * 1024;  // 1MB/s default
+    size_t maxTransfersPerNode_ = 2;
     StatusCallback statusCallback_;
+    ChunkTransport transport_;
+    std::unique_ptr<TransferScheduler> scheduler_;
+    std::shared_ptr<IoExecutor> hasher_;
     Error lastError_;
 };
 
@@ -1,6 +1,6 @@
 /**
- * @file $(basename "$1")
- * @brief $(basename "$1" | sed 's/\./_/g' | tr '[:lower:]' '[:upper:]')
+ * @file content_storage.hpp
+ * @brief Chunked, content-addressed local storage for IPFS content
  * @copyright Copyright (c) 2025 Satoxcoin Core Developers
  * @license MIT License
  * 
@@ -25,6 +25,11 @@
 
 #pragma once
 
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <istream>
+#include <ostream>
 #include <string>
 #include <vector>
 #include <memory>
@@ -33,13 +38,46 @@
 #include <unordered_map>
 #include <functional>
 #include <future>
+#include <thread>
 #include <nlohmann/json.hpp>
 
 namespace satox {
 namespace ipfs {
 
+class IoExecutor;
+class ContentIndex;
+class ContentCache;
+
+/**
+ * Local content-addressed store.
+ *
+ * Objects are split into content-defined chunks (FastCDC over a gear hash),
+ * so an insertion only changes the chunks around it. Each distinct chunk is
+ * stored once under chunks/<sha256> and reference counted; objects/<sha256>
+ * is the object's manifest listing its chunks. The object hash is the SHA-256
+ * of the whole content, computed incrementally while it streams through.
+ * Both directories fan out on the first two hash bytes (chunks/ab/cd/abcd...)
+ * so no directory grows past a few hundred entries per million objects.
+ *
+ * Chunk lists and ContentInfo are also kept in index.log (see ContentIndex),
+ * so startup replays that one file instead of touching every object. The
+ * manifests are only read to rebuild a missing index. Tag and MIME indexes
+ * are built on the first query that needs them.
+ *
+ * Writers and readers move one chunk at a time, so memory stays bounded by
+ * CHUNK_MAX_SIZE no matter how large the object is. The std::future
+ * operations run on a small fixed pool of I/O threads.
+ *
+ * Whole objects read through getContent / getContentBuffer are kept in a
+ * segmented LRU cache (see ContentCache) bounded by setCacheSize() bytes.
+ */
 class ContentStorage {
 public:
+    static constexpr size_t CHUNK_MIN_SIZE = 64 * 1024;
+    static constexpr size_t CHUNK_AVG_SIZE = 256 * 1024;
+    static constexpr size_t CHUNK_MAX_SIZE = 1024 * 1024;
+    static constexpr size_t IO_THREADS = 4;
+
     static ContentStorage& getInstance();
 
     // Prevent copying
@@ -63,13 +101,64 @@ public:
         nlohmann::json metadata;
     };
 
+    // Streams an object into the store. Nothing is visible until finish();
+    // destroying an unfinished writer discards it.
+    class ContentWriter {
+    public:
+        ~ContentWriter();
+        ContentWriter(const ContentWriter&) = delete;
+        ContentWriter& operator=(const ContentWriter&) = delete;
+
+        bool write(const void* data, size_t size);
+        // Returns the stored object's info, with an empty hash on failure
+        ContentInfo finish();
+        void abort();
+
+    private:
+        friend class ContentStorage;
+        struct State;
+        explicit ContentWriter(std::unique_ptr<State> state);
+        std::unique_ptr<State> state_;
+    };
+
+    // Reads an object back chunk by chunk. read() returns 0 at the end or on
+    // error; good() tells the two apart. The reader holds references on its
+    // chunks, so deleting the object does not pull them from under it.
+    class ContentReader {
+    public:
+        ~ContentReader();
+        ContentReader(const ContentReader&) = delete;
+        ContentReader& operator=(const ContentReader&) = delete;
+
+        size_t read(void* buffer, size_t size);
+        // Moves the next read to offset; only the chunk holding it is loaded
+        bool seek(uint64_t offset);
+        uint64_t size() const;
+        bool good() const;
+
+    private:
+        friend class ContentStorage;
+        struct State;
+        explicit ContentReader(std::unique_ptr<State> state);
+        std::unique_ptr<State> state_;
+    };
+
+    // nullptr when not initialized or the object is unknown
+    std::unique_ptr<ContentWriter> openWriter(const std::string& name = "");
+    std::unique_ptr<ContentReader> openReader(const std::string& hash);
+
     // Store content
     std::future<ContentInfo> storeContent(const std::string& content, const std::string& name = "");
     std::future<ContentInfo> storeFile(const std::string& filePath);
     std::future<std::vector<ContentInfo>> storeDirectory(const std::string& directoryPath);
 
     // Retrieve content
+    using ContentBuffer = std::shared_ptr<const std::string>;
     std::future<std::string> getContent(const std::string& hash);
+    // The cached buffer itself when there is one (ready immediately, no
+    // copy); otherwise read once on the I/O pool and cached. nullptr if the
+    // object cannot be read.
+    std::future<ContentBuffer> getContentBuffer(const std::string& hash);
     std::future<bool> getFile(const std::string& hash, const std::string& outputPath);
     std::future<bool> getDirectory(const std::string& hash, const std::string& outputPath);
 
@@ -86,13 +175,44 @@ public:
     std::vector<ContentInfo> getContentByMimeType(const std::string& mimeType) const;
     std::vector<ContentInfo> searchContent(const std::string& query) const;
     std::vector<ContentInfo> getPinnedContent() const;
+    // Distinct chunks on disk, shared between objects
+    size_t getChunkCount() const;
+
+    // Integrity scrubbing
+    struct ScrubReport {
+        uint64_t objectsChecked = 0;
+        uint64_t chunksChecked = 0;
+        uint64_t bytesChecked = 0;
+        std::vector<std::string> corruptChunks;     // moved to quarantine/
+        std::vector<std::string> missingChunks;
+        std::vector<std::string> damagedObjects;    // reference a corrupt or missing chunk
+        uint64_t orphansRemoved = 0;                // chunks and manifests no object owns
+        std::string finishedAt;
+    };
+    // Re-hashes every chunk and removes files left behind by interrupted
+    // writes. Runs on the calling thread; 0 reads as fast as the disk allows.
+    ScrubReport scrub(uint64_t maxBytesPerSecond = 0);
+    // Repeats scrub() every interval on a background thread
+    void startScrubber(std::chrono::seconds interval, uint64_t maxBytesPerSecond);
+    void stopScrubber();
+    ScrubReport getLastScrubReport() const;
 
     // Cache management
     void enableCache(bool enable);
     void clearCache();
     void setCacheSize(size_t maxSize);
     size_t getCacheSize() const;
-    size_t getCacheUsage() const;
+    struct CacheUsage {
+        size_t bytes = 0;           // held by cached objects
+        size_t capacity = 0;
+        size_t entries = 0;
+        size_t protectedBytes = 0;  // in the protected (re-used) segment
+        uint64_t hits = 0;
+        uint64_t misses = 0;
+        uint64_t evictions = 0;
+        uint64_t bytesServed = 0;   // returned from memory instead of disk
+    };
+    CacheUsage getCacheUsage() const;
 
     // Backup and restore
     bool createBackup(const std::string& backupPath);
@@ -107,8 +227,13 @@ public:
     void clearLastError();
 
 private:
-    ContentStorage() = default;
-    ~ContentStorage() = default;
+    struct ChunkRef {
+        std::string hash;
+        uint32_t size;
+    };
+
+    ContentStorage();
+    ~ContentStorage();
 
     // Internal helper methods
     bool validateStoragePath(const std::string& path);
@@ -116,21 +241,57 @@ private:
     bool validateContentHash(const std::string& hash);
     bool updateContentInfo(const std::string& hash, const ContentInfo& info);
     bool removeContentInfo(const std::string& hash);
-    void updateCache(const std::string& hash, const std::string& content);
+    void updateCache(const std::string& hash, ContentBuffer content);
     void removeFromCache(const std::string& hash);
     bool handleError(const std::string& operation, const std::string& error);
+    void setError(int code, const std::string& message);
+
+    // Synchronous bodies of the std::future operations
+    ContentInfo storeStream(std::istream& in, const std::string& name);
+    bool streamContent(const std::string& hash, std::ostream& out);
+    std::string readContent(const std::string& hash);
+    ContentBuffer loadBuffer(const std::string& hash);
+    bool readFile(const std::string& hash, const std::string& outputPath);
+    std::shared_ptr<IoExecutor> executor() const;
+
+    std::string objectPath(const std::string& hash) const;
+    std::string chunkPath(const std::string& hash) const;
+    bool loadManifest(const std::string& hash, std::vector<ChunkRef>& chunks, uint64_t& size,
+                      nlohmann::json* fields = nullptr) const;
+    bool loadChunkList(const std::string& hash, std::vector<ChunkRef>& chunks, uint64_t& size) const;
+    bool storeChunk(const uint8_t* data, size_t size, ChunkRef& ref);
+    void releaseChunks(const std::vector<ChunkRef>& chunks);
+    bool publishObject(ContentInfo& info, const std::vector<ChunkRef>& chunks);
+    void persistInfo(const ContentInfo& info, bool commit = true);
+    bool openIndex();
+    bool rebuildIndex();
+    void migrateFlatLayout();
+    void importLegacyFiles();
+    void loadSecondaryIndexes() const;
+    void indexInfo(const ContentInfo& info);
+    void unindexInfo(const ContentInfo& info);
+    bool waitScrubber(std::chrono::steady_clock::duration delay);
 
     // Member variables
-    std::mutex mutex_;
+    mutable std::mutex mutex_;
     std::string storagePath_;
     std::unordered_map<std::string, ContentInfo> contentInfo_;
-    std::unordered_map<std::string, std::string> contentCache_;
-    std::unordered_map<std::string, std::vector<std::string>> tagIndex_;
-    std::unordered_map<std::string, std::vector<std::string>> mimeTypeIndex_;
-    size_t maxCacheSize_;
-    bool cacheEnabled_;
-    Error lastError_;
-    bool initialized_;
+    std::unordered_map<std::string, uint32_t> chunkRefs_;  // objects and open readers
+    uint64_t chunkRefsGeneration_ = 0;                      // bumped when chunkRefs_ is rebuilt
+    std::unique_ptr<ContentCache> cache_;
+    // Derived from contentInfo_ on first use
+    mutable std::unordered_map<std::string, std::vector<std::string>> tagIndex_;
+    mutable std::unordered_map<std::string, std::vector<std::string>> mimeTypeIndex_;
+    mutable bool secondaryIndexesLoaded_ = false;
+    std::unique_ptr<ContentIndex> index_;
+    std::shared_ptr<IoExecutor> executor_;
+    ScrubReport lastScrubReport_;
+    std::mutex scrubberMutex_;
+    std::condition_variable scrubberWake_;
+    std::thread scrubberThread_;
+    bool scrubberStop_ = false;
+    Error lastError_{0, ""};
+    bool initialized_ = false;
 };
 
 } // namespace ipfs
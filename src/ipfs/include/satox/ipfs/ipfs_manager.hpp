@@ -25,7 +25,9 @@
 
 #pragma once
 
+#include <cstdint>
 #include <memory>
+#include <mutex>
 #include <string>
 #include <vector>
 #include <unordered_map>
@@ -42,8 +44,20 @@ struct Config {
     int timeout_seconds;
     bool enable_pinning;
     std::string pinning_service;
+    size_t max_concurrent_requests = 16;  // requests in flight to the daemon
 };
 
+struct TransferStats {
+    uint64_t completed = 0;
+    uint64_t failed = 0;                  // transport errors
+    uint64_t connectionsOpened = 0;       // stays flat while keep-alive works
+    size_t queued = 0;
+    size_t inFlight = 0;
+    size_t peakInFlight = 0;
+};
+
+class HttpTransferPool;
+
 class IPFSManager {
 public:
     static IPFSManager& getInstance();
@@ -73,6 +87,17 @@ public:
     bool getPinnedFiles(std::vector<std::string>& pinnedFiles);
     std::string getLastError() const;
 
+    // Streams the file behind fd from its start; the descriptor stays open
+    bool addFileDescriptor(int fd, std::string& hash);
+
+    // Batch operations run up to max_concurrent_requests requests at a time
+    // over kept-alive connections. hashes/failed line up with the input;
+    // the return value is true when every item succeeded.
+    bool addFiles(const std::vector<std::string>& filePaths, std::vector<std::string>& hashes);
+    bool addDataBatch(const std::vector<std::vector<uint8_t>>& items, std::vector<std::string>& hashes);
+    bool pinFiles(const std::vector<std::string>& hashes, std::vector<std::string>& failed);
+    TransferStats getTransferStats() const;
+
     // Additional operations (to be implemented)
     std::string addData(const std::vector<uint8_t>& data);
     std::vector<uint8_t> getData(const std::string& ipfs_hash);
@@ -98,22 +123,33 @@ private:
         ~Impl();
         
         bool initialize(const Config& config);
+        void shutdown();
         bool addFile(const std::string& filePath, std::string& hash);
+        bool addFileDescriptor(int fd, std::string& hash);
+        bool addFiles(const std::vector<std::string>& filePaths, std::vector<std::string>& hashes);
+        bool addBuffers(const std::vector<std::pair<const char*, size_t>>& buffers,
+                        std::vector<std::string>& hashes);
         bool getFile(const std::string& hash, const std::string& outputPath);
-        bool pinFile(const std::string& hash);
-        bool unpinFile(const std::string& hash);
+        bool getData(const std::string& hash, std::string& data);
+        bool pinFiles(const std::string& command, const std::vector<std::string>& hashes,
+                      std::vector<std::string>& failed);
         std::string getLastError() const;
         bool isInitialized() const;
-        std::string getApiEndpoint() const;
+        bool isHealthy();
         bool getPinnedFiles(std::vector<std::string>& pinnedFiles);
+        TransferStats getTransferStats() const;
 
     private:
-        static size_t writeCallback(void* contents, size_t size, size_t nmemb, std::string* userp);
-        static size_t writeFileCallback(void* contents, size_t size, size_t nmemb, std::ofstream* file);
+        // Pool and endpoint of the current session; false when not initialized
+        bool session(std::shared_ptr<HttpTransferPool>& pool, std::string& endpoint);
+        long timeoutSeconds() const;
+        void setError(const std::string& error);
 
+        mutable std::mutex mutex_;
         Config config_;
         bool initialized_;
         std::string lastError_;
+        std::shared_ptr<HttpTransferPool> pool_;
     };
 
     std::unique_ptr<Impl> pimpl_;
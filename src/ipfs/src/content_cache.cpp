@@ -0,0 +1,153 @@
+/**
+ * @file content_cache.cpp
+ * @brief Segmented LRU cache of shared object buffers for ContentStorage
+ * @copyright Copyright (c) 2025 Satoxcoin Core Developers
+ * @license MIT License
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "content_cache.hpp"
+
+namespace satox {
+namespace ipfs {
+
+ContentCache::ContentCache(size_t capacity) : capacity_(capacity) {}
+
+ContentCache::Buffer ContentCache::get(const std::string& hash) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (!enabled_) {
+        return nullptr;
+    }
+    auto found = entries_.find(hash);
+    if (found == entries_.end()) {
+        ++misses_;
+        return nullptr;
+    }
+    auto it = found->second;
+    const size_t size = it->buffer->size();
+    ++hits_;
+    bytesServed_ += size;
+
+    if (it->isProtected) {
+        protected_.splice(protected_.begin(), protected_, it);
+        return it->buffer;
+    }
+
+    // Second use: promote, demoting the coldest protected entries to make room
+    it->isProtected = true;
+    protected_.splice(protected_.begin(), probation_, it);
+    probationBytes_ -= size;
+    protectedBytes_ += size;
+    const auto protectedLimit = static_cast<size_t>(static_cast<double>(capacity_) * PROTECTED_SHARE);
+    while (protectedBytes_ > protectedLimit && protected_.size() > 1) {
+        auto coldest = std::prev(protected_.end());
+        coldest->isProtected = false;
+        protectedBytes_ -= coldest->buffer->size();
+        probationBytes_ += coldest->buffer->size();
+        probation_.splice(probation_.begin(), protected_, coldest);
+    }
+    return it->buffer;
+}
+
+void ContentCache::put(const std::string& hash, Buffer buffer) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (!enabled_ || !buffer || buffer->size() > capacity_ / MAX_ENTRY_FRACTION) {
+        return;
+    }
+    auto found = entries_.find(hash);
+    if (found != entries_.end()) {
+        // Content addressed, so the bytes are the same; keep the entry's place
+        return;
+    }
+    probationBytes_ += buffer->size();
+    probation_.push_front({hash, std::move(buffer), false});
+    entries_[hash] = probation_.begin();
+    evict();
+}
+
+void ContentCache::erase(const std::string& hash) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto found = entries_.find(hash);
+    if (found != entries_.end()) {
+        removeEntry(found->second);
+    }
+}
+
+void ContentCache::clear() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    probation_.clear();
+    protected_.clear();
+    entries_.clear();
+    probationBytes_ = protectedBytes_ = 0;
+}
+
+void ContentCache::setEnabled(bool enabled) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    enabled_ = enabled;
+    if (!enabled) {
+        probation_.clear();
+        protected_.clear();
+        entries_.clear();
+        probationBytes_ = protectedBytes_ = 0;
+    }
+}
+
+void ContentCache::setCapacity(size_t capacity) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    capacity_ = capacity;
+    evict();
+}
+
+size_t ContentCache::capacity() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return capacity_;
+}
+
+ContentStorage::CacheUsage ContentCache::usage() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    ContentStorage::CacheUsage usage;
+    usage.bytes = probationBytes_ + protectedBytes_;
+    usage.capacity = capacity_;
+    usage.entries = entries_.size();
+    usage.protectedBytes = protectedBytes_;
+    usage.hits = hits_;
+    usage.misses = misses_;
+    usage.evictions = evictions_;
+    usage.bytesServed = bytesServed_;
+    return usage;
+}
+
+void ContentCache::removeEntry(List::iterator it) {
+    // Caller holds mutex_
+    (it->isProtected ? protectedBytes_ : probationBytes_) -= it->buffer->size();
+    entries_.erase(it->hash);
+    (it->isProtected ? protected_ : probation_).erase(it);
+}
+
+void ContentCache::evict() {
+    // Caller holds mutex_
+    while (probationBytes_ + protectedBytes_ > capacity_) {
+        removeEntry(std::prev(probation_.empty() ? protected_.end() : probation_.end()));
+        ++evictions_;
+    }
+}
+
+} // namespace ipfs
+} // namespace satox
@@ -0,0 +1,98 @@
+/**
+ * @file content_cache.hpp
+ * @brief Segmented LRU cache of shared object buffers for ContentStorage
+ * @copyright Copyright (c) 2025 Satoxcoin Core Developers
+ * @license MIT License
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#pragma once
+
+#include "satox/ipfs/content_storage.hpp"
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+namespace satox {
+namespace ipfs {
+
+/**
+ * Byte-budgeted segmented LRU over shared, immutable object buffers.
+ *
+ * New entries start in the probationary segment. A hit there promotes the
+ * entry to the protected segment, which may hold up to PROTECTED_SHARE of
+ * the budget; entries pushed out of it drop back to probation. Eviction
+ * takes the least recent probationary entry first, so a sweep of one-off
+ * reads cannot flush objects that are read repeatedly. Objects over
+ * capacity / MAX_ENTRY_FRACTION are never cached.
+ *
+ * Hits hand out the cached buffer itself; callers share it, nothing is copied.
+ */
+class ContentCache {
+public:
+    using Buffer = ContentStorage::ContentBuffer;
+
+    static constexpr double PROTECTED_SHARE = 0.8;
+    static constexpr size_t MAX_ENTRY_FRACTION = 4;
+
+    explicit ContentCache(size_t capacity);
+    ContentCache(const ContentCache&) = delete;
+    ContentCache& operator=(const ContentCache&) = delete;
+
+    // nullptr on a miss or while disabled
+    Buffer get(const std::string& hash);
+    void put(const std::string& hash, Buffer buffer);
+    void erase(const std::string& hash);
+    void clear();
+
+    void setEnabled(bool enabled);
+    void setCapacity(size_t capacity);
+    size_t capacity() const;
+    ContentStorage::CacheUsage usage() const;
+
+private:
+    struct Entry {
+        std::string hash;
+        Buffer buffer;
+        bool isProtected;
+    };
+    using List = std::list<Entry>;
+
+    void removeEntry(List::iterator it);
+    void evict();
+
+    mutable std::mutex mutex_;
+    bool enabled_ = true;
+    size_t capacity_;
+    List probation_;                // front is the most recent
+    List protected_;
+    std::unordered_map<std::string, List::iterator> entries_;
+    size_t probationBytes_ = 0;
+    size_t protectedBytes_ = 0;
+    uint64_t hits_ = 0;
+    uint64_t misses_ = 0;
+    uint64_t evictions_ = 0;
+    uint64_t bytesServed_ = 0;
+};
+
+} // namespace ipfs
+} // namespace satox
@@ -24,6 +24,15 @@
  */
 
 #include "satox/ipfs/content_distribution.hpp"
+#include "satox/ipfs/content_storage.hpp"
+#include "http_transfer_pool.hpp"
+#include "io_executor.hpp"
+#include "transfer_scheduler.hpp"
+#include <openssl/evp.h>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <cerrno>
 #include <filesystem>
 #include <fstream>
 #include <sstream>
@@ -47,9 +56,106 @@ namespace {
         return ss.str();
     }
 
-    // Helper function to calculate bandwidth usage
-    size_t calculateBandwidthUsage(size_t bytes, std::chrono::milliseconds duration) {
-        return (bytes * 1000) / duration.count(); // bytes per second
+    // Lowercase hex SHA-256 of the whole file, the same key ContentStorage gives
+    // identical bytes; empty on a read error
+    std::string sha256File(int fd) {
+        std::unique_ptr<EVP_MD_CTX, decltype(&EVP_MD_CTX_free)> digest(EVP_MD_CTX_new(), EVP_MD_CTX_free);
+        if (!digest || EVP_DigestInit_ex(digest.get(), EVP_sha256(), nullptr) != 1) {
+            return {};
+        }
+        std::vector<char> buffer(1024 * 1024);
+        off_t offset = 0;
+        while (true) {
+            ssize_t got = ::pread(fd, buffer.data(), buffer.size(), offset);
+            if (got < 0 && errno == EINTR) {
+                continue;
+            }
+            if (got < 0) {
+                return {};
+            }
+            if (got == 0) {
+                break;
+            }
+            EVP_DigestUpdate(digest.get(), buffer.data(), static_cast<size_t>(got));
+            offset += got;
+        }
+
+        unsigned char hash[EVP_MAX_MD_SIZE];
+        unsigned int length = 0;
+        EVP_DigestFinal_ex(digest.get(), hash, &length);
+        static const char digits[] = "0123456789abcdef";
+        std::string hex;
+        hex.reserve(length * 2);
+        for (unsigned int i = 0; i < length; ++i) {
+            hex += digits[hash[i] >> 4];
+            hex += digits[hash[i] & 0xf];
+        }
+        return hex;
+    }
+
+    std::future<bool> readyFuture(bool value) {
+        std::promise<bool> promise;
+        promise.set_value(value);
+        return promise.get_future();
+    }
+
+    // Closes the descriptor once the last stream reading it is gone
+    struct FileHandle {
+        int fd;
+        explicit FileHandle(int descriptor) : fd(descriptor) {}
+        ~FileHandle() { ::close(fd); }
+    };
+
+    // Nullptr unless path names a regular file
+    std::shared_ptr<FileHandle> openRegularFile(const std::string& path, uint64_t& size) {
+        int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+        struct stat info;
+        if (fd < 0 || ::fstat(fd, &info) != 0 || !S_ISREG(info.st_mode)) {
+            if (fd >= 0) {
+                ::close(fd);
+            }
+            return nullptr;
+        }
+        size = static_cast<uint64_t>(info.st_size);
+        return std::make_shared<FileHandle>(fd);
+    }
+
+    // Every stream of a file reads it with pread through the shared descriptor
+    TransferScheduler::ReaderFactory fileReader(std::shared_ptr<FileHandle> file) {
+        return [file]() -> TransferScheduler::Reader {
+            return [file](uint64_t offset, size_t size, std::string& chunk) {
+                chunk.resize(size);
+                size_t done = 0;
+                while (done < size) {
+                    ssize_t got = ::pread(file->fd, &chunk[done], size - done, static_cast<off_t>(offset + done));
+                    if (got < 0 && errno == EINTR) {
+                        continue;
+                    }
+                    if (got <= 0) {
+                        return false;
+                    }
+                    done += static_cast<size_t>(got);
+                }
+                return true;
+            };
+        };
+    }
+
+    // Writes each chunk at its offset into /satox-distribution/<contentHash>
+    // in the node's MFS, so the node ends up with the whole object. Rewriting
+    // a chunk after a retry or a resume leaves the same bytes in place.
+    ContentDistribution::ChunkTransport mfsWriteTransport(std::shared_ptr<HttpTransferPool> pool) {
+        return [pool](const std::string&, const std::string& address, const std::string& contentHash,
+                      uint64_t offset, const std::string& chunk) {
+            HttpTransferPool::Request request;
+            request.url = address + "/api/v0/files/write?arg=/satox-distribution/" + contentHash +
+                          "&offset=" + std::to_string(offset) + "&create=true&parents=true";
+            request.upload = true;
+            request.data = chunk.data();
+            request.size = chunk.size();
+            request.stallSeconds = 30;
+            return pool->submit(std::move(request)).get().ok();
+        };
     }
 }
 
@@ -58,6 +164,12 @@ ContentDistribution& ContentDistribution::getInstance() {
     return instance;
 }
 
+ContentDistribution::ContentDistribution() = default;
+
+ContentDistribution::~ContentDistribution() {
+    shutdown();
+}
+
 bool ContentDistribution::initialize(const std::string& configPath) {
     std::lock_guard<std::mutex> lock(mutex_);
     if (initialized_) {
@@ -84,6 +196,51 @@ bool ContentDistribution::initialize(const std::string& configPath) {
         if (config.contains("bandwidthLimit")) {
             bandwidthLimit_ = config["bandwidthLimit"];
         }
+        if (config.contains("maxTransfersPerNode")) {
+            maxTransfersPerNode_ = config["maxTransfersPerNode"];
+        }
+
+        if (!transport_) {
+            transport_ = mfsWriteTransport(std::make_shared<HttpTransferPool>(TRANSFER_THREADS, 10));
+        }
+        // The transport is looked up per chunk so setChunkTransport applies to running distributions
+        auto transport = [this](const std::string& nodeId, const std::string& address,
+                                const std::string& contentHash, uint64_t offset, const std::string& chunk) {
+            ChunkTransport current;
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+                current = transport_;
+            }
+            return current && current(nodeId, address, contentHash, offset, chunk);
+        };
+        auto onProgress = [this](const TransferScheduler::Progress& progress) {
+            DistributionStatus status;
+            status.contentHash = progress.contentHash;
+            if (!progress.finished) {
+                status.status = "in_progress";
+            } else if (progress.cancelled) {
+                status.status = "cancelled";
+            } else {
+                status.status = progress.failedNodes.empty() ? "completed" : "failed";
+            }
+            status.totalBytes = progress.totalBytes;
+            status.bytesTransferred = progress.bytesTransferred;
+            status.bytesPerSecond = progress.bytesPerSecond;
+            status.progress = progress.totalBytes == 0
+                ? (progress.finished ? 100 : 0)
+                : static_cast<size_t>(progress.bytesTransferred * 100 / progress.totalBytes);
+            status.error = progress.error;
+            status.completedNodes = progress.completedNodes;
+            status.failedNodes = progress.failedNodes;
+            if (progress.finished) {
+                status.endTime = getCurrentTimestamp();
+            }
+            updateDistributionStatus(progress.contentHash, status);
+        };
+        scheduler_ = std::make_unique<TransferScheduler>(TRANSFER_THREADS, transport, onProgress);
+        hasher_ = std::make_shared<IoExecutor>(HASH_THREADS);
+        scheduler_->setBandwidthLimit(bandwidthLimit_);
+        scheduler_->setMaxTransfersPerNode(maxTransfersPerNode_);
 
         configPath_ = configPath;
         initialized_ = true;
@@ -95,127 +252,155 @@ bool ContentDistribution::initialize(const std::string& configPath) {
 }
 
 void ContentDistribution::shutdown() {
+    std::shared_ptr<IoExecutor> hasher;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        hasher = std::move(hasher_);
+    }
+    // Files still being hashed are scheduled before the scheduler goes
+    hasher.reset();
+
+    std::unique_ptr<TransferScheduler> scheduler;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        scheduler = std::move(scheduler_);
+    }
+    // Stops the workers; they call back into this object, so not under the lock
+    scheduler.reset();
+
     std::lock_guard<std::mutex> lock(mutex_);
     nodes_.clear();
     activeDistributions_.clear();
     distributionPriorities_.clear();
     statusCallback_ = nullptr;
+    transport_ = nullptr;
     initialized_ = false;
 }
 
 std::future<bool> ContentDistribution::distributeContent(const std::string& contentHash, const std::vector<std::string>& targetNodes) {
-    return std::async(std::launch::async, [this, contentHash, targetNodes]() {
-        if (!initialized_) {
-            lastError_ = {3, "Content Distribution not initialized"};
-            return false;
-        }
-
-        // Initialize distribution status
-        DistributionStatus status;
-        status.contentHash = contentHash;
-        status.status = "pending";
-        status.progress = 0;
-        status.startTime = getCurrentTimestamp();
+    auto reader = ContentStorage::getInstance().openReader(contentHash);
+    if (!reader) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        lastError_ = {11, "Content not found in local storage"};
+        return readyFuture(false);
+    }
 
-        if (!updateDistributionStatus(contentHash, status)) {
-            return false;
+    // Every stream reads through its own reader, seeking to where its node resumes
+    auto open = [contentHash]() -> ChunkReader {
+        std::shared_ptr<ContentStorage::ContentReader> reader = ContentStorage::getInstance().openReader(contentHash);
+        if (!reader) {
+            return nullptr;
         }
-
-        // Validate target nodes
-        std::vector<std::string> validNodes;
-        for (const auto& nodeId : targetNodes) {
-            if (isNodeAvailable(nodeId)) {
-                validNodes.push_back(nodeId);
+        return [reader](uint64_t offset, size_t size, std::string& chunk) {
+            if (!reader->seek(offset)) {
+                return false;
             }
-        }
-
-        if (validNodes.empty()) {
-            status.status = "failed";
-            status.error = "No valid target nodes available";
-            status.endTime = getCurrentTimestamp();
-            updateDistributionStatus(contentHash, status);
-            return false;
-        }
+            chunk.resize(size);
+            chunk.resize(reader->read(&chunk[0], size));
+            return reader->good();
+        };
+    };
+    return schedule(contentHash, reader->size(), std::move(open), targetNodes);
+}
 
-        // Start distribution process
-        status.status = "in_progress";
-        updateDistributionStatus(contentHash, status);
+std::future<bool> ContentDistribution::distributeFile(const std::string& filePath, const std::vector<std::string>& targetNodes) {
+    uint64_t size = 0;
+    auto file = openRegularFile(filePath, size);
+    if (!file) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        lastError_ = {4, "File not found"};
+        return readyFuture(false);
+    }
+    std::shared_ptr<IoExecutor> hasher;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        hasher = hasher_;
+    }
+    if (!hasher) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        lastError_ = {3, "Content Distribution not initialized"};
+        return readyFuture(false);
+    }
 
-        // Simulate distribution process
-        for (const auto& nodeId : validNodes) {
-            // Check if distribution was cancelled
+    // Keyed by content, so a moved or renamed file resumes from its
+    // checkpoints and different files never share them. Hashing reads the
+    // whole file, so it runs on the hasher and the caller only gets a future.
+    auto result = std::make_shared<std::promise<bool>>();
+    auto future = result->get_future();
+    hasher->submit([this, file, size, targetNodes, result]() {
+        std::string contentHash = sha256File(file->fd);
+        if (contentHash.empty()) {
             {
                 std::lock_guard<std::mutex> lock(mutex_);
-                auto it = activeDistributions_.find(contentHash);
-                if (it == activeDistributions_.end() || it->second.status == "cancelled") {
-                    return false;
-                }
+                lastError_ = {4, "Failed to read file"};
             }
-
-            // Simulate node transfer
-            std::this_thread::sleep_for(std::chrono::milliseconds(100));
-            
-            // Update progress
-            status.completedNodes.push_back(nodeId);
-            status.progress = (status.completedNodes.size() * 100) / validNodes.size();
-            updateDistributionStatus(contentHash, status);
-        }
-
-        // Mark distribution as completed
-        status.status = "completed";
-        status.progress = 100;
-        status.endTime = getCurrentTimestamp();
-        updateDistributionStatus(contentHash, status);
-
-        return true;
-    });
-}
-
-std::future<bool> ContentDistribution::distributeFile(const std::string& filePath, const std::vector<std::string>& targetNodes) {
-    return std::async(std::launch::async, [this, filePath, targetNodes]() {
-        if (!initialized_) {
-            lastError_ = {3, "Content Distribution not initialized"};
-            return false;
-        }
-
-        if (!std::filesystem::exists(filePath)) {
-            lastError_ = {4, "File not found"};
-            return false;
+            result->set_value(false);
+            return;
         }
-
-        // Read file content and calculate hash
-        std::ifstream file(filePath, std::ios::binary);
-        std::string content((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
-        
-        // TODO: Calculate content hash
-        std::string contentHash = "file_" + std::filesystem::path(filePath).filename().string();
-
-        return distributeContent(contentHash, targetNodes).get();
+        schedule(contentHash, size, fileReader(file), targetNodes, std::move(*result));
     });
+    return future;
 }
 
 std::future<bool> ContentDistribution::distributeDirectory(const std::string& directoryPath, const std::vector<std::string>& targetNodes) {
-    return std::async(std::launch::async, [this, directoryPath, targetNodes]() {
-        if (!initialized_) {
+    std::shared_ptr<IoExecutor> hasher;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (!initialized_ || !hasher_) {
             lastError_ = {3, "Content Distribution not initialized"};
-            return false;
+            return readyFuture(false);
         }
+        hasher = hasher_;
+    }
+    if (!std::filesystem::exists(directoryPath)) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        lastError_ = {5, "Directory not found"};
+        return readyFuture(false);
+    }
 
-        if (!std::filesystem::exists(directoryPath)) {
-            lastError_ = {5, "Directory not found"};
-            return false;
+    struct Pending {
+        std::shared_ptr<FileHandle> file;
+        uint64_t size = 0;
+        std::future<std::string> hash;
+    };
+    std::vector<Pending> files;
+    for (const auto& entry : std::filesystem::recursive_directory_iterator(directoryPath)) {
+        if (!entry.is_regular_file()) {
+            continue;
+        }
+        Pending pending;
+        pending.file = openRegularFile(entry.path().string(), pending.size);
+        if (!pending.file) {
+            std::lock_guard<std::mutex> lock(mutex_);
+            lastError_ = {4, "File not found"};
+            return readyFuture(false);
         }
+        pending.hash = hasher->submit([file = pending.file]() { return sha256File(file->fd); });
+        files.push_back(std::move(pending));
+    }
 
+    // Every file is hashed and scheduled before any is waited for; files
+    // with the same bytes are one distribution
+    return std::async(std::launch::async, [this, files = std::move(files), targetNodes]() mutable {
+        std::unordered_map<std::string, std::future<bool>> scheduled;
         bool success = true;
-        for (const auto& entry : std::filesystem::recursive_directory_iterator(directoryPath)) {
-            if (entry.is_regular_file()) {
-                if (!distributeFile(entry.path().string(), targetNodes).get()) {
-                    success = false;
-                    break;
-                }
+        for (auto& pending : files) {
+            std::string contentHash = pending.hash.get();
+            if (contentHash.empty()) {
+                std::lock_guard<std::mutex> lock(mutex_);
+                lastError_ = {4, "Failed to read file"};
+                success = false;
+                continue;
+            }
+            if (!scheduled.count(contentHash)) {
+                std::promise<bool> result;
+                scheduled[contentHash] = result.get_future();
+                schedule(contentHash, pending.size, fileReader(pending.file), targetNodes, std::move(result));
             }
         }
-
+        for (auto& [contentHash, result] : scheduled) {
+            success = result.get() && success;
+        }
         return success;
     });
 }
@@ -272,9 +457,7 @@ std::vector<std::string> ContentDistribution::getAvailableNodes() const {
     std::lock_guard<std::mutex> lock(mutex_);
     std::vector<std::string> availableNodes;
     for (const auto& [nodeId, address] : nodes_) {
-        if (isNodeAvailable(nodeId)) {
-            availableNodes.push_back(nodeId);
-        }
+        availableNodes.push_back(nodeId);
     }
     return availableNodes;
 }
@@ -311,42 +494,69 @@ std::vector<ContentDistribution::DistributionStatus> ContentDistribution::getAct
 }
 
 bool ContentDistribution::cancelDistribution(const std::string& contentHash) {
-    std::lock_guard<std::mutex> lock(mutex_);
-    auto it = activeDistributions_.find(contentHash);
-    if (it == activeDistributions_.end()) {
-        lastError_ = {8, "Distribution not found"};
-        return false;
-    }
+    DistributionStatus status;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto it = activeDistributions_.find(contentHash);
+        if (it == activeDistributions_.end()) {
+            lastError_ = {8, "Distribution not found"};
+            return false;
+        }
 
-    if (it->second.status == "completed" || it->second.status == "failed") {
-        lastError_ = {9, "Cannot cancel completed or failed distribution"};
-        return false;
-    }
+        if (it->second.status == "completed" || it->second.status == "failed") {
+            lastError_ = {9, "Cannot cancel completed or failed distribution"};
+            return false;
+        }
 
-    it->second.status = "cancelled";
-    it->second.endTime = getCurrentTimestamp();
-    notifyStatusCallback(it->second);
+        it->second.status = "cancelled";
+        it->second.endTime = getCurrentTimestamp();
+        status = it->second;
+        // Chunks already in flight finish; nothing new is sent
+        if (scheduler_) {
+            scheduler_->cancel(contentHash);
+        }
+    }
+    notifyStatusCallback(status);
     return true;
 }
 
 void ContentDistribution::setBandwidthLimit(size_t bytesPerSecond) {
     std::lock_guard<std::mutex> lock(mutex_);
     bandwidthLimit_ = bytesPerSecond;
+    if (scheduler_) {
+        scheduler_->setBandwidthLimit(bytesPerSecond);
+    }
 }
 
 size_t ContentDistribution::getBandwidthLimit() const {
+    std::lock_guard<std::mutex> lock(mutex_);
     return bandwidthLimit_;
 }
 
 size_t ContentDistribution::getCurrentBandwidthUsage() const {
     std::lock_guard<std::mutex> lock(mutex_);
-    // TODO: Implement actual bandwidth usage calculation
-    return 0;
+    return scheduler_ ? static_cast<size_t>(scheduler_->getBandwidthUsage()) : 0;
+}
+
+void ContentDistribution::setMaxTransfersPerNode(size_t maxTransfers) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    maxTransfersPerNode_ = std::max<size_t>(1, maxTransfers);
+    if (scheduler_) {
+        scheduler_->setMaxTransfersPerNode(maxTransfersPerNode_);
+    }
+}
+
+size_t ContentDistribution::getMaxTransfersPerNode() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return maxTransfersPerNode_;
 }
 
 void ContentDistribution::setDistributionPriority(const std::string& contentHash, int priority) {
     std::lock_guard<std::mutex> lock(mutex_);
     distributionPriorities_[contentHash] = priority;
+    if (scheduler_) {
+        scheduler_->setPriority(contentHash, priority);
+    }
 }
 
 int ContentDistribution::getDistributionPriority(const std::string& contentHash) const {
@@ -365,6 +575,11 @@ void ContentDistribution::clearStatusCallback() {
     statusCallback_ = nullptr;
 }
 
+void ContentDistribution::setChunkTransport(ChunkTransport transport) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    transport_ = std::move(transport);
+}
+
 ContentDistribution::Error ContentDistribution::getLastError() const {
     return lastError_;
 }
@@ -384,15 +599,37 @@ bool ContentDistribution::validateNode(const std::string& nodeId, const std::str
 }
 
 bool ContentDistribution::updateDistributionStatus(const std::string& contentHash, const DistributionStatus& status) {
-    std::lock_guard<std::mutex> lock(mutex_);
-    activeDistributions_[contentHash] = status;
-    notifyStatusCallback(status);
+    DistributionStatus updated = status;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto& stored = activeDistributions_[contentHash];
+        // Progress still arriving from chunks in flight does not undo a
+        // cancel, nor a finish another worker reported first
+        if (updated.status == "in_progress" && (stored.status == "cancelled" ||
+                                                stored.status == "completed" || stored.status == "failed")) {
+            return false;
+        }
+        if (updated.startTime.empty()) {
+            updated.startTime = stored.startTime;
+        }
+        if (updated.endTime.empty()) {
+            updated.endTime = stored.endTime;
+        }
+        stored = updated;
+    }
+    notifyStatusCallback(updated);
     return true;
 }
 
+// Called without mutex_ held, so the callback may query this object
 void ContentDistribution::notifyStatusCallback(const DistributionStatus& status) {
-    if (statusCallback_) {
-        statusCallback_(status);
+    StatusCallback callback;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        callback = statusCallback_;
+    }
+    if (callback) {
+        callback(status);
     }
 }
 
@@ -401,5 +638,68 @@ bool ContentDistribution::handleError(const std::string& operation, const std::s
     return false;
 }
 
+std::future<bool> ContentDistribution::schedule(const std::string& contentHash, uint64_t size,
+                                                std::function<ChunkReader()> open,
+                                                const std::vector<std::string>& targetNodes) {
+    std::promise<bool> result;
+    auto future = result.get_future();
+    schedule(contentHash, size, std::move(open), targetNodes, std::move(result));
+    return future;
+}
+
+void ContentDistribution::schedule(const std::string& contentHash, uint64_t size,
+                                   std::function<ChunkReader()> open,
+                                   const std::vector<std::string>& targetNodes,
+                                   std::promise<bool> result) {
+    DistributionStatus status;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (!initialized_ || !scheduler_) {
+            lastError_ = {3, "Content Distribution not initialized"};
+            result.set_value(false);
+            return;
+        }
+        auto existing = activeDistributions_.find(contentHash);
+        if (existing != activeDistributions_.end() &&
+            (existing->second.status == "pending" || existing->second.status == "in_progress")) {
+            lastError_ = {12, "Distribution already in progress"};
+            result.set_value(false);
+            return;
+        }
+
+        // Validate target nodes
+        std::vector<TransferScheduler::Target> targets;
+        for (const auto& nodeId : targetNodes) {
+            auto node = nodes_.find(nodeId);
+            if (node != nodes_.end()) {
+                targets.push_back({nodeId, node->second});
+            }
+        }
+
+        status.contentHash = contentHash;
+        status.progress = 0;
+        status.startTime = getCurrentTimestamp();
+        status.totalBytes = size * targets.size();
+        if (targets.empty()) {
+            status.status = "failed";
+            status.error = "No valid target nodes available";
+            status.endTime = status.startTime;
+            activeDistributions_[contentHash] = status;
+            lastError_ = {13, status.error};
+            result.set_value(false);
+        } else {
+            status.status = "in_progress";
+            activeDistributions_[contentHash] = status;
+            auto priority = distributionPriorities_.find(contentHash);
+            scheduler_->submit(contentHash, size, std::move(open), std::move(targets),
+                               priority != distributionPriorities_.end() ? priority->second : 0,
+                               std::move(result));
+        }
+    }
+    if (status.status == "failed") {
+        notifyStatusCallback(status);
+    }
+}
+
 } // namespace ipfs
 } // namespace satox 
\ No newline at end of file
@@ -0,0 +1,376 @@
+/**
+ * @file content_index.cpp
+ * @brief Append-only key/value log holding ContentStorage metadata
+ * @copyright Copyright (c) 2025 Satoxcoin Core Developers
+ * @license MIT License
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "content_index.hpp"
+#include <array>
+#include <cerrno>
+#include <cstring>
+#include <vector>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace satox {
+namespace ipfs {
+
+namespace {
+    constexpr size_t RECORD_HEADER_SIZE = 8;     // u32 length | u32 crc32
+    constexpr size_t BODY_FIXED_SIZE = 3;        // u8 op | u16 key length
+    constexpr uint8_t OP_PUT = 1;
+    constexpr uint8_t OP_ERASE = 2;
+    // Compact once the log is this large and mostly superseded records
+    constexpr uint64_t COMPACT_MIN_BYTES = 4 * 1024 * 1024;
+
+    // Makes a rename or create inside the directory durable
+    bool syncDirectory(const std::string& path) {
+        const auto slash = path.find_last_of('/');
+        const std::string directory = slash == std::string::npos ? "." : slash == 0 ? "/" : path.substr(0, slash);
+        int fd = ::open(directory.c_str(), O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+        if (fd < 0) {
+            return false;
+        }
+        bool ok = ::fsync(fd) == 0;
+        ::close(fd);
+        return ok;
+    }
+
+    void putLE(uint8_t* out, uint64_t value, int bytes) {
+        for (int i = 0; i < bytes; ++i) {
+            out[i] = static_cast<uint8_t>(value >> (8 * i));
+        }
+    }
+
+    uint64_t getLE(const uint8_t* p, int bytes) {
+        uint64_t value = 0;
+        for (int i = bytes - 1; i >= 0; --i) {
+            value = value << 8 | p[i];
+        }
+        return value;
+    }
+
+    uint32_t crc32(const uint8_t* data, size_t size) {
+        static const auto table = [] {
+            std::array<uint32_t, 256> t{};
+            for (uint32_t i = 0; i < 256; ++i) {
+                uint32_t c = i;
+                for (int k = 0; k < 8; ++k) {
+                    c = (c & 1) ? 0xEDB88320u ^ (c >> 1) : c >> 1;
+                }
+                t[i] = c;
+            }
+            return t;
+        }();
+        uint32_t crc = ~0u;
+        for (size_t i = 0; i < size; ++i) {
+            crc = table[(crc ^ data[i]) & 0xFF] ^ (crc >> 8);
+        }
+        return ~crc;
+    }
+
+    bool writeAll(int fd, const uint8_t* data, size_t size) {
+        size_t done = 0;
+        while (done < size) {
+            ssize_t n = ::write(fd, data + done, size - done);
+            if (n < 0) {
+                if (errno == EINTR) {
+                    continue;
+                }
+                return false;
+            }
+            done += static_cast<size_t>(n);
+        }
+        return true;
+    }
+
+    std::vector<uint8_t> encodeRecord(uint8_t op, const std::string& key, const std::string& value) {
+        const size_t length = BODY_FIXED_SIZE + key.size() + value.size();
+        std::vector<uint8_t> record(RECORD_HEADER_SIZE + length);
+        uint8_t* body = record.data() + RECORD_HEADER_SIZE;
+        body[0] = op;
+        putLE(body + 1, key.size(), 2);
+        std::memcpy(body + BODY_FIXED_SIZE, key.data(), key.size());
+        std::memcpy(body + BODY_FIXED_SIZE + key.size(), value.data(), value.size());
+        putLE(record.data(), length, 4);
+        putLE(record.data() + 4, crc32(body, length), 4);
+        return record;
+    }
+
+    // Checks one record at p; false for a torn or corrupt one
+    bool decodeRecord(const uint8_t* p, size_t available, uint8_t& op, std::string& key,
+                      const uint8_t*& value, size_t& valueSize, size_t& recordSize) {
+        if (available < RECORD_HEADER_SIZE) {
+            return false;
+        }
+        const size_t length = getLE(p, 4);
+        if (length < BODY_FIXED_SIZE || length > available - RECORD_HEADER_SIZE ||
+            crc32(p + RECORD_HEADER_SIZE, length) != static_cast<uint32_t>(getLE(p + 4, 4))) {
+            return false;
+        }
+        const uint8_t* body = p + RECORD_HEADER_SIZE;
+        const size_t keySize = getLE(body + 1, 2);
+        if (BODY_FIXED_SIZE + keySize > length) {
+            return false;
+        }
+        op = body[0];
+        key.assign(reinterpret_cast<const char*>(body + BODY_FIXED_SIZE), keySize);
+        value = body + BODY_FIXED_SIZE + keySize;
+        valueSize = length - BODY_FIXED_SIZE - keySize;
+        recordSize = RECORD_HEADER_SIZE + length;
+        return true;
+    }
+
+    // Whether a valid record starts anywhere in [from, size)
+    bool findRecord(const uint8_t* mapping, size_t from, size_t size) {
+        uint8_t op;
+        std::string key;
+        const uint8_t* value;
+        size_t valueSize, recordSize;
+        for (size_t offset = from; offset + RECORD_HEADER_SIZE <= size; ++offset) {
+            if (decodeRecord(mapping + offset, size - offset, op, key, value, valueSize, recordSize)) {
+                return true;
+            }
+        }
+        return false;
+    }
+}
+
+ContentIndex::~ContentIndex() {
+    close();
+}
+
+bool ContentIndex::open(const std::string& path, bool syncWrites, const Visitor& visitor, std::string& error) {
+    close();
+    path_ = path;
+    sync_ = syncWrites;
+    corrupt_ = false;
+
+    int fd = ::open(path.c_str(), O_RDWR | O_CREAT | O_APPEND | O_CLOEXEC, 0644);
+    if (fd < 0) {
+        error = "Cannot open content index: " + std::string(std::strerror(errno));
+        return false;
+    }
+    struct stat info;
+    size_t size = ::fstat(fd, &info) == 0 ? static_cast<size_t>(info.st_size) : 0;
+    const uint8_t* mapping = nullptr;
+    if (size > 0) {
+        void* p = ::mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (p == MAP_FAILED) {
+            ::close(fd);
+            error = "Cannot map content index: " + std::string(std::strerror(errno));
+            return false;
+        }
+        mapping = static_cast<const uint8_t*>(p);
+        ::madvise(p, size, MADV_SEQUENTIAL);
+    }
+
+    // First pass finds the live record of every key, the second hands them out
+    size_t offset = 0;
+    uint8_t op;
+    std::string key;
+    const uint8_t* value;
+    size_t valueSize, recordSize;
+    while (decodeRecord(mapping + offset, size - offset, op, key, value, valueSize, recordSize)) {
+        if (op == OP_PUT) {
+            live_[key] = {offset, static_cast<uint32_t>(recordSize)};
+        } else {
+            live_.erase(key);
+        }
+        offset += recordSize;
+    }
+    // Good records past a bad one mean damage mid-log; replaying up to it
+    // would silently lose everything after, so leave the log as it is
+    if (offset < size && findRecord(mapping, offset + 1, size)) {
+        ::munmap(const_cast<uint8_t*>(mapping), size);
+        ::close(fd);
+        live_.clear();
+        corrupt_ = true;
+        error = "Content index is corrupt at offset " + std::to_string(offset);
+        return false;
+    }
+    for (const auto& [liveKey, location] : live_) {
+        decodeRecord(mapping + location.offset, location.length, op, key, value, valueSize, recordSize);
+        liveBytes_ += location.length;
+        visitor(liveKey, std::string(reinterpret_cast<const char*>(value), valueSize));
+    }
+    if (mapping) {
+        ::munmap(const_cast<uint8_t*>(mapping), size);
+    }
+
+    // Cut a torn tail back to the last good record
+    if (offset < size && ::ftruncate(fd, static_cast<off_t>(offset)) != 0) {
+        ::close(fd);
+        live_.clear();
+        error = "Cannot truncate content index: " + std::string(std::strerror(errno));
+        return false;
+    }
+    // A new log is only found again after a crash once its entry is durable
+    if (size == 0 && !syncDirectory(path)) {
+        ::close(fd);
+        live_.clear();
+        error = "Cannot sync content index directory: " + std::string(std::strerror(errno));
+        return false;
+    }
+    fd_ = fd;
+    fileBytes_ = offset;
+    return true;
+}
+
+void ContentIndex::close() {
+    if (fd_ >= 0) {
+        ::close(fd_);
+        fd_ = -1;
+    }
+    live_.clear();
+    fileBytes_ = 0;
+    liveBytes_ = 0;
+}
+
+bool ContentIndex::put(const std::string& key, const std::string& value) {
+    return append(OP_PUT, key, value);
+}
+
+bool ContentIndex::erase(const std::string& key) {
+    if (!live_.count(key)) {
+        return true;
+    }
+    return append(OP_ERASE, key, {});
+}
+
+bool ContentIndex::get(const std::string& key, std::string& value) const {
+    auto it = live_.find(key);
+    if (it == live_.end()) {
+        return false;
+    }
+    std::vector<uint8_t> record(it->second.length);
+    if (::pread(fd_, record.data(), record.size(), static_cast<off_t>(it->second.offset)) !=
+        static_cast<ssize_t>(record.size())) {
+        return false;
+    }
+    uint8_t op;
+    std::string storedKey;
+    const uint8_t* data;
+    size_t size, recordSize;
+    if (!decodeRecord(record.data(), record.size(), op, storedKey, data, size, recordSize) || storedKey != key) {
+        return false;
+    }
+    value.assign(reinterpret_cast<const char*>(data), size);
+    return true;
+}
+
+bool ContentIndex::append(uint8_t op, const std::string& key, const std::string& value) {
+    if (fd_ < 0) {
+        return false;
+    }
+    auto record = encodeRecord(op, key, value);
+    if (!writeAll(fd_, record.data(), record.size()) || (sync_ && ::fdatasync(fd_) != 0)) {
+        // Drop whatever part made it so the next append starts clean
+        (void)::ftruncate(fd_, static_cast<off_t>(fileBytes_));
+        return false;
+    }
+
+    auto it = live_.find(key);
+    if (it != live_.end()) {
+        liveBytes_ -= it->second.length;
+    }
+    if (op == OP_PUT) {
+        live_[key] = {fileBytes_, static_cast<uint32_t>(record.size())};
+        liveBytes_ += record.size();
+    } else {
+        live_.erase(key);
+    }
+    fileBytes_ += record.size();
+
+    if (fileBytes_ >= COMPACT_MIN_BYTES && fileBytes_ > 2 * liveBytes_) {
+        std::string error;
+        compact(error);
+    }
+    return true;
+}
+
+bool ContentIndex::sync() {
+    if (fd_ < 0) {
+        return false;
+    }
+    return sync_ || ::fdatasync(fd_) == 0;
+}
+
+bool ContentIndex::compact(std::string& error) {
+    if (fd_ < 0) {
+        error = "Content index not open";
+        return false;
+    }
+    const std::string temp = path_ + ".compact";
+    int out = ::open(temp.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+    if (out < 0) {
+        error = "Cannot create compacted content index: " + std::string(std::strerror(errno));
+        return false;
+    }
+
+    std::unordered_map<std::string, Location> moved;
+    moved.reserve(live_.size());
+    std::vector<uint8_t> record;
+    uint64_t offset = 0;
+    bool ok = true;
+    for (const auto& [key, location] : live_) {
+        record.resize(location.length);
+        if (::pread(fd_, record.data(), record.size(), static_cast<off_t>(location.offset)) !=
+                static_cast<ssize_t>(record.size()) ||
+            !writeAll(out, record.data(), record.size())) {
+            ok = false;
+            break;
+        }
+        moved[key] = {offset, location.length};
+        offset += location.length;
+    }
+    ok = ok && ::fdatasync(out) == 0;
+    ::close(out);
+    if (!ok || ::rename(temp.c_str(), path_.c_str()) != 0) {
+        error = "Cannot write compacted content index: " + std::string(std::strerror(errno));
+        ::unlink(temp.c_str());
+        return false;
+    }
+
+    // The old descriptor now points at the replaced file
+    ::close(fd_);
+    fd_ = ::open(path_.c_str(), O_RDWR | O_APPEND | O_CLOEXEC);
+    if (fd_ < 0) {
+        error = "Cannot reopen content index: " + std::string(std::strerror(errno));
+        live_.clear();
+        return false;
+    }
+    live_ = std::move(moved);
+    fileBytes_ = liveBytes_ = offset;
+
+    // Until the directory is synced a crash may bring back the old log
+    if (!syncDirectory(path_)) {
+        error = "Cannot sync compacted content index: " + std::string(std::strerror(errno));
+        return false;
+    }
+    return true;
+}
+
+} // namespace ipfs
+} // namespace satox
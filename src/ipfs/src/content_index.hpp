@@ -0,0 +1,97 @@
+/**
+ * @file content_index.hpp
+ * @brief Append-only key/value log holding ContentStorage metadata
+ * @copyright Copyright (c) 2025 Satoxcoin Core Developers
+ * @license MIT License
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <unordered_map>
+
+namespace satox {
+namespace ipfs {
+
+/**
+ * Crash-safe key/value log behind ContentStorage's metadata.
+ *
+ * The file holds records of  u32 length | u32 crc32 | body,  where
+ * body = u8 op | u16 key length | key | value. A later record for a key
+ * replaces the earlier one, and op 2 deletes the key. open() replays the log
+ * once, so startup reads the index and nothing else. It also cuts off a torn
+ * tail left by a crash: a bad record with nothing valid after it. A bad
+ * record followed by good ones is damage, not a torn append; open() then
+ * fails and sets corrupt(), leaving the file untouched.
+ *
+ * Once superseded records make up most of the file, compact() writes the
+ * live records to a new file and renames it over the log.
+ *
+ * Not thread-safe: ContentStorage calls it under its own mutex.
+ */
+class ContentIndex {
+public:
+    using Visitor = std::function<void(const std::string& key, const std::string& value)>;
+
+    ContentIndex() = default;
+    ~ContentIndex();
+    ContentIndex(const ContentIndex&) = delete;
+    ContentIndex& operator=(const ContentIndex&) = delete;
+
+    // Calls visitor once for every live key
+    bool open(const std::string& path, bool syncWrites, const Visitor& visitor, std::string& error);
+    void close();
+    bool isOpen() const { return fd_ >= 0; }
+    // Whether the last open() failed on damage before the end of the log
+    bool corrupt() const { return corrupt_; }
+
+    bool put(const std::string& key, const std::string& value);
+    bool erase(const std::string& key);
+    bool get(const std::string& key, std::string& value) const;
+    // Makes every record appended so far durable; a no-op with syncWrites
+    bool sync();
+    bool contains(const std::string& key) const { return live_.count(key) != 0; }
+
+    bool compact(std::string& error);
+    size_t size() const { return live_.size(); }
+    uint64_t fileBytes() const { return fileBytes_; }
+
+private:
+    struct Location {
+        uint64_t offset;
+        uint32_t length;        // whole record, header included
+    };
+
+    bool append(uint8_t op, const std::string& key, const std::string& value);
+
+    std::string path_;
+    int fd_ = -1;
+    bool sync_ = false;
+    bool corrupt_ = false;
+    uint64_t fileBytes_ = 0;
+    uint64_t liveBytes_ = 0;
+    std::unordered_map<std::string, Location> live_;
+};
+
+} // namespace ipfs
+} // namespace satox
@@ -1,6 +1,6 @@
 /**
- * @file $(basename "$1")
- * @brief $(basename "$1" | sed 's/\./_/g' | tr '[:lower:]' '[:upper:]')
+ * @file content_storage.cpp
+ * @brief Chunked, content-addressed local storage for IPFS content
  * @copyright Copyright (c) 2025 Satoxcoin Core Developers
  * @license MIT License
  * 
@@ -24,21 +24,41 @@
  */
 
 #include "satox/ipfs/content_storage.hpp"
+#include "content_cache.hpp"
+#include "content_index.hpp"
+#include "io_executor.hpp"
 #include <filesystem>
 #include <fstream>
 #include <sstream>
 #include <chrono>
 #include <ctime>
 #include <algorithm>
+#include <array>
+#include <atomic>
 #include <cctype>
+#include <cerrno>
+#include <cstring>
 #include <iomanip>
-#include <sstream>
-#include <openssl/sha.h>
+#include <thread>
+#include <unordered_set>
+#include <openssl/evp.h>
+#include <fcntl.h>
+#include <unistd.h>
 
 namespace satox {
 namespace ipfs {
 
 namespace {
+    constexpr size_t MIME_SNIFF_SIZE = 8192;
+    constexpr size_t STREAM_BUFFER_SIZE = 256 * 1024;
+    constexpr int MANIFEST_VERSION = 1;
+    constexpr size_t DEFAULT_CACHE_SIZE = 1024 * 1024 * 100; // 100MB
+    // Index keys: the chunk list is written once, ContentInfo on every change
+    const std::string CHUNKS_KEY = "o:";
+    const std::string INFO_KEY = "m:";
+    // Temporary files younger than this may belong to a running writer
+    constexpr auto TEMP_FILE_GRACE = std::chrono::hours(1);
+
     // Helper function to get current timestamp
     std::string getCurrentTimestamp() {
         auto now = std::chrono::system_clock::now();
@@ -48,144 +68,615 @@ namespace {
         return ss.str();
     }
 
+    std::string toHex(const unsigned char* data, size_t size) {
+        static const char digits[] = "0123456789abcdef";
+        std::string hex(size * 2, '0');
+        for (size_t i = 0; i < size; ++i) {
+            hex[2 * i] = digits[data[i] >> 4];
+            hex[2 * i + 1] = digits[data[i] & 0x0f];
+        }
+        return hex;
+    }
+
+    std::string sha256Hex(const void* data, size_t size) {
+        unsigned char hash[EVP_MAX_MD_SIZE];
+        unsigned int length = 0;
+        EVP_Digest(data, size, hash, &length, EVP_sha256(), nullptr);
+        return toHex(hash, length);
+    }
+
     // Helper function to calculate SHA-256 hash
     std::string calculateHash(const std::string& content) {
-        unsigned char hash[SHA256_DIGEST_LENGTH];
-        SHA256_CTX sha256;
-        SHA256_Init(&sha256);
-        SHA256_Update(&sha256, content.c_str(), content.length());
-        SHA256_Final(hash, &sha256);
+        return sha256Hex(content.data(), content.size());
+    }
 
-        std::stringstream ss;
-        for(int i = 0; i < SHA256_DIGEST_LENGTH; i++) {
-            ss << std::hex << std::setw(2) << std::setfill('0') << static_cast<int>(hash[i]);
+    // Gear table for FastCDC, filled from a fixed splitmix64 sequence so chunk
+    // boundaries (and therefore dedup) are stable across builds and hosts
+    constexpr std::array<uint64_t, 256> makeGearTable() {
+        std::array<uint64_t, 256> table{};
+        uint64_t state = 0x5341544f58434443ULL;
+        for (size_t i = 0; i < table.size(); ++i) {
+            state += 0x9e3779b97f4a7c15ULL;
+            uint64_t z = state;
+            z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+            z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+            table[i] = z ^ (z >> 31);
         }
-        return ss.str();
+        return table;
+    }
+    constexpr std::array<uint64_t, 256> GEAR = makeGearTable();
+
+    // Normalized chunking: a stricter mask before the average size and a
+    // looser one after it pull chunk sizes towards CHUNK_AVG_SIZE. The gear
+    // hash shifts left, so its top bits cover the most input.
+    constexpr uint64_t topBits(int count) { return ~uint64_t(0) << (64 - count); }
+    constexpr uint64_t MASK_SMALL = topBits(20);
+    constexpr uint64_t MASK_LARGE = topBits(16);
+    static_assert(ContentStorage::CHUNK_AVG_SIZE == (size_t(1) << 18), "masks assume a 256 KiB average");
+
+    // Length of the chunk starting at data. Only called with at least
+    // CHUNK_MAX_SIZE bytes available, or with the tail of the object.
+    size_t findChunkBoundary(const uint8_t* data, size_t size) {
+        if (size <= ContentStorage::CHUNK_MIN_SIZE) {
+            return size;
+        }
+        const size_t limit = std::min(size, ContentStorage::CHUNK_MAX_SIZE);
+        const size_t normal = std::min(limit, ContentStorage::CHUNK_AVG_SIZE);
+        uint64_t hash = 0;
+        size_t i = ContentStorage::CHUNK_MIN_SIZE;
+        for (; i < normal; ++i) {
+            hash = (hash << 1) + GEAR[data[i]];
+            if ((hash & MASK_SMALL) == 0) {
+                return i + 1;
+            }
+        }
+        for (; i < limit; ++i) {
+            hash = (hash << 1) + GEAR[data[i]];
+            if ((hash & MASK_LARGE) == 0) {
+                return i + 1;
+            }
+        }
+        return limit;
     }
 
-    // Helper function to detect MIME type
-    std::string detectMimeType(const std::string& content) {
-        // Basic MIME type detection based on content
-        if (content.empty()) return "application/octet-stream";
-        
+    // Helper function to detect MIME type from the first bytes of the content
+    std::string detectMimeType(const std::string& head, uint64_t totalSize) {
+        if (totalSize == 0) return "application/octet-stream";
+
+        struct Signature {
+            const char* bytes;
+            size_t length;
+            const char* mimeType;
+        };
+        static const Signature signatures[] = {
+            {"\x89PNG\r\n\x1a\n", 8, "image/png"},
+            {"\xff\xd8\xff", 3, "image/jpeg"},
+            {"GIF87a", 6, "image/gif"},
+            {"GIF89a", 6, "image/gif"},
+            {"%PDF-", 5, "application/pdf"},
+            {"PK\x03\x04", 4, "application/zip"},
+            {"\x1a\x45\xdf\xa3", 4, "video/webm"},
+        };
+        for (const auto& signature : signatures) {
+            if (head.compare(0, signature.length, signature.bytes, signature.length) == 0) {
+                return signature.mimeType;
+            }
+        }
+        if (head.size() >= 12 && head.compare(0, 4, "RIFF") == 0 && head.compare(8, 4, "WEBP") == 0) {
+            return "image/webp";
+        }
+        if (head.size() >= 12 && head.compare(4, 4, "ftyp") == 0) {
+            return "video/mp4";
+        }
+
         // Check for text content
-        bool isText = true;
-        for (char c : content) {
-            if (!std::isprint(c) && !std::isspace(c)) {
-                isText = false;
-                break;
+        for (char c : head) {
+            auto byte = static_cast<unsigned char>(c);
+            if (!std::isprint(byte) && !std::isspace(byte)) {
+                return "application/octet-stream";
             }
         }
-        if (isText) return "text/plain";
 
-        // Check for JSON
-        if (content[0] == '{' || content[0] == '[') {
-            try {
-                nlohmann::json::parse(content);
+        // Check for JSON when the whole content was sniffed
+        if (totalSize == head.size() && (head[0] == '{' || head[0] == '[')) {
+            if (nlohmann::json::accept(head)) {
                 return "application/json";
-            } catch (...) {}
+            }
+        }
+        return "text/plain";
+    }
+
+    // Distinguishes temporary files of concurrent writers
+    std::string tempSuffix() {
+        static std::atomic<uint64_t> counter{0};
+        return ".tmp." + std::to_string(std::hash<std::thread::id>{}(std::this_thread::get_id())) +
+               "." + std::to_string(counter.fetch_add(1));
+    }
+
+    bool isTempFile(const std::filesystem::path& path) {
+        return path.filename().string().find(".tmp.") != std::string::npos;
+    }
+
+    bool writeFileContent(const std::string& path, const char* data, size_t size) {
+        std::ofstream file(path, std::ios::binary | std::ios::trunc);
+        file.write(data, static_cast<std::streamsize>(size));
+        file.close();
+        return !file.fail();
+    }
+
+    bool writeFileContent(const std::string& path, const std::string& content) {
+        return writeFileContent(path, content.data(), content.size());
+    }
+
+    // Writes and flushes the file, so it can be renamed into place and published
+    bool writeDurableFile(const std::string& path, const char* data, size_t size) {
+        int fd = ::open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+        if (fd < 0) {
+            return false;
+        }
+        bool ok = true;
+        while (ok && size > 0) {
+            ssize_t written = ::write(fd, data, size);
+            if (written < 0 && errno == EINTR) {
+                continue;
+            }
+            ok = written > 0;
+            if (ok) {
+                data += written;
+                size -= static_cast<size_t>(written);
+            }
         }
+        ok = ok && ::fdatasync(fd) == 0;
+        return ::close(fd) == 0 && ok;
+    }
+
+    // Makes a rename into the directory durable
+    bool syncDirectory(const std::filesystem::path& directory) {
+        int fd = ::open(directory.c_str(), O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+        if (fd < 0) {
+            return false;
+        }
+        bool ok = ::fsync(fd) == 0;
+        ::close(fd);
+        return ok;
+    }
+
+    // Shard directories are created the first time a write into one fails
+    bool writeShardedFile(const std::string& path, const char* data, size_t size) {
+        if (writeDurableFile(path, data, size)) {
+            return true;
+        }
+        std::error_code ec;
+        std::filesystem::create_directories(std::filesystem::path(path).parent_path(), ec);
+        return !ec && writeDurableFile(path, data, size);
+    }
 
-        // Default to binary
-        return "application/octet-stream";
+    // Renames a written temp file into place; the caller publishes it afterwards
+    void publishFile(const std::string& temp, const std::string& path, std::error_code& ec) {
+        std::filesystem::rename(temp, path, ec);
+        if (!ec && !syncDirectory(std::filesystem::path(path).parent_path())) {
+            ec = std::error_code(errno, std::generic_category());
+        }
+    }
+
+    std::string shardPath(const std::string& directory, const std::string& hash) {
+        return directory + "/" + hash.substr(0, 2) + "/" + hash.substr(2, 2) + "/" + hash;
+    }
+
+    std::string readFileContent(const std::string& path) {
+        std::ifstream file(path, std::ios::binary);
+        if (!file) {
+            return {};
+        }
+        std::ostringstream ss;
+        ss << file.rdbuf();
+        return ss.str();
+    }
+
+    // Runs the task on the I/O pool, or inline when the storage is not
+    // initialized so the task can report that itself
+    template <typename F>
+    std::future<std::invoke_result_t<F>> submitIo(const std::shared_ptr<IoExecutor>& executor, F&& task) {
+        if (executor) {
+            return executor->submit(std::forward<F>(task));
+        }
+        std::packaged_task<std::invoke_result_t<F>()> packaged(std::forward<F>(task));
+        auto future = packaged.get_future();
+        packaged();
+        return future;
     }
 }
 
-ContentStorage& ContentStorage::getInstance() {
-    static ContentStorage instance;
-    return instance;
+static void to_json(nlohmann::json& j, const ContentStorage::ContentInfo& info) {
+    j = {
+        {"hash", info.hash},
+        {"name", info.name},
+        {"size", info.size},
+        {"mimeType", info.mimeType},
+        {"createdAt", info.createdAt},
+        {"updatedAt", info.updatedAt},
+        {"isPinned", info.isPinned},
+        {"tags", info.tags},
+        {"metadata", info.metadata}
+    };
 }
 
-bool ContentStorage::initialize(const std::string& storagePath) {
-    std::lock_guard<std::mutex> lock(mutex_);
-    if (initialized_) {
+static void from_json(const nlohmann::json& j, ContentStorage::ContentInfo& info) {
+    info.hash = j.value("hash", "");
+    info.name = j.value("name", "");
+    info.size = j.value("size", size_t(0));
+    info.mimeType = j.value("mimeType", "");
+    info.createdAt = j.value("createdAt", "");
+    info.updatedAt = j.value("updatedAt", "");
+    info.isPinned = j.value("isPinned", false);
+    info.tags = j.value("tags", std::vector<std::string>{});
+    info.metadata = j.value("metadata", nlohmann::json::object());
+}
+
+// ---------------------------------------------------------------------------
+// ContentWriter
+
+struct ContentStorage::ContentWriter::State {
+    ContentStorage* storage = nullptr;
+    std::string name;
+    EVP_MD_CTX* digest = nullptr;
+    std::vector<uint8_t> buffer;
+    std::vector<ChunkRef> chunks;
+    std::string head;
+    uint64_t size = 0;
+    bool failed = false;
+    bool finished = false;
+
+    ~State() { EVP_MD_CTX_free(digest); }
+
+    bool emit(const uint8_t* data, size_t length) {
+        ChunkRef ref;
+        if (!storage->storeChunk(data, length, ref)) {
+            return false;
+        }
+        chunks.push_back(std::move(ref));
         return true;
     }
 
-    if (!validateStoragePath(storagePath)) {
-        lastError_ = {1, "Invalid storage path"};
+    // Cuts every chunk whose boundary no longer depends on future input
+    bool drain(bool final) {
+        size_t pos = 0;
+        while (buffer.size() - pos >= CHUNK_MAX_SIZE || (final && pos < buffer.size())) {
+            size_t cut = findChunkBoundary(buffer.data() + pos, buffer.size() - pos);
+            if (!emit(buffer.data() + pos, cut)) {
+                return false;
+            }
+            pos += cut;
+        }
+        buffer.erase(buffer.begin(), buffer.begin() + static_cast<std::ptrdiff_t>(pos));
+        return true;
+    }
+};
+
+ContentStorage::ContentWriter::ContentWriter(std::unique_ptr<State> state) : state_(std::move(state)) {}
+
+ContentStorage::ContentWriter::~ContentWriter() {
+    abort();
+}
+
+bool ContentStorage::ContentWriter::write(const void* data, size_t size) {
+    auto& s = *state_;
+    if (s.finished || s.failed) {
         return false;
     }
+    auto bytes = static_cast<const uint8_t*>(data);
+    EVP_DigestUpdate(s.digest, bytes, size);
+    if (s.head.size() < MIME_SNIFF_SIZE) {
+        s.head.append(reinterpret_cast<const char*>(bytes), std::min(size, MIME_SNIFF_SIZE - s.head.size()));
+    }
+    s.size += size;
+
+    // Feed at most two chunks' worth at a time so the buffer stays bounded
+    while (size > 0) {
+        size_t take = std::min(size, 2 * CHUNK_MAX_SIZE - s.buffer.size());
+        s.buffer.insert(s.buffer.end(), bytes, bytes + take);
+        bytes += take;
+        size -= take;
+        if (!s.drain(false)) {
+            s.failed = true;
+            return false;
+        }
+    }
+    return true;
+}
 
-    storagePath_ = storagePath;
-    maxCacheSize_ = 1024 * 1024 * 100; // 100MB default cache size
-    cacheEnabled_ = true;
-    initialized_ = true;
+ContentStorage::ContentInfo ContentStorage::ContentWriter::finish() {
+    auto& s = *state_;
+    ContentInfo info{};
+    if (s.finished || s.failed || !s.drain(true)) {
+        abort();
+        return info;
+    }
 
-    return createStorageDirectory();
+    unsigned char hash[EVP_MAX_MD_SIZE];
+    unsigned int length = 0;
+    EVP_DigestFinal_ex(s.digest, hash, &length);
+    info.hash = toHex(hash, length);
+    info.name = s.name.empty() ? info.hash : s.name;
+    info.size = s.size;
+    info.mimeType = detectMimeType(s.head, s.size);
+    info.createdAt = getCurrentTimestamp();
+    info.updatedAt = info.createdAt;
+    info.isPinned = false;
+    info.metadata = nlohmann::json::object();
+
+    if (!s.storage->publishObject(info, s.chunks)) {
+        abort();
+        return ContentInfo{};
+    }
+    s.chunks.clear();
+    s.finished = true;
+    return info;
+}
+
+void ContentStorage::ContentWriter::abort() {
+    auto& s = *state_;
+    if (!s.chunks.empty()) {
+        std::lock_guard<std::mutex> lock(s.storage->mutex_);
+        s.storage->releaseChunks(s.chunks);
+        s.chunks.clear();
+    }
+    s.buffer.clear();
+    s.finished = true;
+}
+
+// ---------------------------------------------------------------------------
+// ContentReader
+
+struct ContentStorage::ContentReader::State {
+    ContentStorage* storage = nullptr;
+    std::vector<ChunkRef> chunks;     // referenced until the reader goes away
+    uint64_t generation = 0;          // chunkRefs_ the references were taken in
+    size_t next = 0;
+    std::vector<char> current;
+    uint64_t currentStart = 0;       // object offset of current[0]
+    uint64_t nextStart = 0;          // object offset of chunks[next]
+    size_t pos = 0;
+    uint64_t size = 0;
+    bool failed = false;
+
+    bool loadNext() {
+        const auto& ref = chunks[next];
+        std::ifstream file(storage->chunkPath(ref.hash), std::ios::binary);
+        current.resize(ref.size);
+        file.read(current.data(), ref.size);
+        if (!file || static_cast<size_t>(file.gcount()) != ref.size) {
+            failed = true;
+            return false;
+        }
+        pos = 0;
+        currentStart = nextStart;
+        nextStart += ref.size;
+        ++next;
+        return true;
+    }
+};
+
+ContentStorage::ContentReader::ContentReader(std::unique_ptr<State> state) : state_(std::move(state)) {}
+
+ContentStorage::ContentReader::~ContentReader() {
+    auto& s = *state_;
+    std::lock_guard<std::mutex> lock(s.storage->mutex_);
+    // References taken before a shutdown or restore went with the old table
+    if (s.storage->chunkRefsGeneration_ == s.generation) {
+        s.storage->releaseChunks(s.chunks);
+    }
+}
+
+size_t ContentStorage::ContentReader::read(void* buffer, size_t size) {
+    auto& s = *state_;
+    auto out = static_cast<char*>(buffer);
+    size_t copied = 0;
+    while (copied < size && !s.failed) {
+        if (s.pos == s.current.size()) {
+            if (s.next == s.chunks.size() || !s.loadNext()) {
+                break;
+            }
+        }
+        size_t n = std::min(size - copied, s.current.size() - s.pos);
+        std::memcpy(out + copied, s.current.data() + s.pos, n);
+        s.pos += n;
+        copied += n;
+    }
+    return copied;
+}
+
+bool ContentStorage::ContentReader::seek(uint64_t offset) {
+    auto& s = *state_;
+    if (s.failed || offset > s.size) {
+        return false;
+    }
+    if (offset >= s.currentStart && offset < s.currentStart + s.current.size()) {
+        s.pos = static_cast<size_t>(offset - s.currentStart);
+        return true;
+    }
+    size_t index = 0;
+    uint64_t start = 0;
+    while (index < s.chunks.size() && start + s.chunks[index].size <= offset) {
+        start += s.chunks[index].size;
+        ++index;
+    }
+    s.current.clear();
+    s.pos = 0;
+    s.currentStart = start;
+    s.next = index;
+    s.nextStart = start;
+    if (offset == start) {
+        return true;
+    }
+    if (!s.loadNext()) {
+        return false;
+    }
+    s.pos = static_cast<size_t>(offset - start);
+    return true;
+}
+
+uint64_t ContentStorage::ContentReader::size() const {
+    return state_->size;
+}
+
+bool ContentStorage::ContentReader::good() const {
+    return !state_->failed;
+}
+
+// ---------------------------------------------------------------------------
+// ContentStorage
+
+ContentStorage::ContentStorage() : cache_(std::make_unique<ContentCache>(DEFAULT_CACHE_SIZE)) {}
+
+ContentStorage::~ContentStorage() {
+    shutdown();
+}
+
+ContentStorage& ContentStorage::getInstance() {
+    static ContentStorage instance;
+    return instance;
+}
+
+bool ContentStorage::initialize(const std::string& storagePath) {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (initialized_) {
+            return true;
+        }
+
+        if (!validateStoragePath(storagePath)) {
+            lastError_ = {1, "Invalid storage path"};
+            return false;
+        }
+
+        storagePath_ = storagePath;
+        cache_->setCapacity(DEFAULT_CACHE_SIZE);
+        cache_->setEnabled(true);
+
+        if (!createStorageDirectory()) {
+            return false;
+        }
+        migrateFlatLayout();
+        if (!openIndex()) {
+            return false;
+        }
+        executor_ = std::make_shared<IoExecutor>(IO_THREADS);
+        initialized_ = true;
+    }
+
+    importLegacyFiles();
+    return true;
 }
 
 void ContentStorage::shutdown() {
+    stopScrubber();
+
+    std::shared_ptr<IoExecutor> executor;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        executor = std::move(executor_);
+    }
+    // Let queued operations finish before the state goes away
+    executor.reset();
+
     std::lock_guard<std::mutex> lock(mutex_);
     contentInfo_.clear();
-    contentCache_.clear();
+    chunkRefs_.clear();
+    ++chunkRefsGeneration_;
+    cache_->clear();
     tagIndex_.clear();
     mimeTypeIndex_.clear();
+    secondaryIndexesLoaded_ = false;
+    index_.reset();
     initialized_ = false;
 }
 
-std::future<ContentStorage::ContentInfo> ContentStorage::storeContent(const std::string& content, const std::string& name) {
-    return std::async(std::launch::async, [this, content, name]() {
-        ContentInfo info;
+std::unique_ptr<ContentStorage::ContentWriter> ContentStorage::openWriter(const std::string& name) {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
         if (!initialized_) {
             lastError_ = {2, "Content Storage not initialized"};
-            return info;
+            return nullptr;
         }
+    }
+    auto state = std::make_unique<ContentWriter::State>();
+    state->storage = this;
+    state->name = name;
+    state->digest = EVP_MD_CTX_new();
+    if (!state->digest || EVP_DigestInit_ex(state->digest, EVP_sha256(), nullptr) != 1) {
+        setError(3, "Failed to initialize content hash");
+        return nullptr;
+    }
+    return std::unique_ptr<ContentWriter>(new ContentWriter(std::move(state)));
+}
 
-        std::string hash = calculateHash(content);
-        info.hash = hash;
-        info.name = name.empty() ? hash : name;
-        info.size = content.length();
-        info.mimeType = detectMimeType(content);
-        info.createdAt = getCurrentTimestamp();
-        info.updatedAt = info.createdAt;
-        info.isPinned = false;
+std::unique_ptr<ContentStorage::ContentReader> ContentStorage::openReader(const std::string& hash) {
+    auto state = std::make_unique<ContentReader::State>();
+    state->storage = this;
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (!initialized_) {
+        lastError_ = {2, "Content Storage not initialized"};
+        return nullptr;
+    }
+    if (contentInfo_.find(hash) == contentInfo_.end()) {
+        lastError_ = {7, "Content not found"};
+        return nullptr;
+    }
+    if (!loadChunkList(hash, state->chunks, state->size)) {
+        lastError_ = {5, "Failed to read content manifest"};
+        return nullptr;
+    }
+    // Pin the chunks so deleting the object leaves them until the reader closes
+    for (const auto& chunk : state->chunks) {
+        ++chunkRefs_[chunk.hash];
+    }
+    state->generation = chunkRefsGeneration_;
+    return std::unique_ptr<ContentReader>(new ContentReader(std::move(state)));
+}
 
-        std::string filePath = storagePath_ + "/" + hash;
-        if (!writeFileContent(filePath, content)) {
-            lastError_ = {3, "Failed to write content to file"};
-            return info;
+std::future<ContentStorage::ContentInfo> ContentStorage::storeContent(const std::string& content, const std::string& name) {
+    // Writes bypass the cache: only reads say what is hot
+    return submitIo(executor(), [this, content, name]() {
+        auto writer = openWriter(name);
+        if (!writer) {
+            return ContentInfo{};
         }
-
-        if (cacheEnabled_) {
-            updateCache(hash, content);
+        writer->write(content.data(), content.size());
+        auto info = writer->finish();
+        if (info.hash.empty()) {
+            setError(3, "Failed to write content to file");
         }
-
-        contentInfo_[hash] = info;
         return info;
     });
 }
 
 std::future<ContentStorage::ContentInfo> ContentStorage::storeFile(const std::string& filePath) {
-    return std::async(std::launch::async, [this, filePath]() {
-        ContentInfo info;
-        if (!initialized_) {
-            lastError_ = {2, "Content Storage not initialized"};
-            return info;
+    return submitIo(executor(), [this, filePath]() {
+        std::ifstream file(filePath, std::ios::binary);
+        if (!file) {
+            setError(4, "Failed to read file content");
+            return ContentInfo{};
         }
-
-        std::string content = readFileContent(filePath);
-        if (content.empty()) {
-            lastError_ = {4, "Failed to read file content"};
-            return info;
-        }
-
-        return storeContent(content, std::filesystem::path(filePath).filename().string()).get();
+        return storeStream(file, std::filesystem::path(filePath).filename().string());
     });
 }
 
 std::future<std::vector<ContentStorage::ContentInfo>> ContentStorage::storeDirectory(const std::string& directoryPath) {
-    return std::async(std::launch::async, [this, directoryPath]() {
+    return submitIo(executor(), [this, directoryPath]() {
         std::vector<ContentInfo> results;
-        if (!initialized_) {
-            lastError_ = {2, "Content Storage not initialized"};
-            return results;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (!initialized_) {
+                lastError_ = {2, "Content Storage not initialized"};
+                return results;
+            }
         }
 
         for (const auto& entry : std::filesystem::recursive_directory_iterator(directoryPath)) {
             if (entry.is_regular_file()) {
-                auto info = storeFile(entry.path().string()).get();
-                results.push_back(info);
+                std::ifstream file(entry.path(), std::ios::binary);
+                results.push_back(file ? storeStream(file, entry.path().filename().string()) : ContentInfo{});
             }
         }
 
@@ -194,62 +685,25 @@ std::future<std::vector<ContentStorage::ContentInfo>> ContentStorage::storeDirec
 }
 
 std::future<std::string> ContentStorage::getContent(const std::string& hash) {
-    return std::async(std::launch::async, [this, hash]() {
-        std::string result;
-        if (!initialized_) {
-            lastError_ = {2, "Content Storage not initialized"};
-            return result;
-        }
-
-        // Check cache first
-        if (cacheEnabled_) {
-            auto it = contentCache_.find(hash);
-            if (it != contentCache_.end()) {
-                return it->second;
-            }
-        }
-
-        // Read from file
-        std::string filePath = storagePath_ + "/" + hash;
-        result = readFileContent(filePath);
-        if (result.empty()) {
-            lastError_ = {5, "Failed to read content from file"};
-            return result;
-        }
-
-        // Update cache
-        if (cacheEnabled_) {
-            updateCache(hash, result);
-        }
+    return submitIo(executor(), [this, hash]() { return readContent(hash); });
+}
 
-        return result;
-    });
+std::future<ContentStorage::ContentBuffer> ContentStorage::getContentBuffer(const std::string& hash) {
+    if (auto cached = cache_->get(hash)) {
+        std::promise<ContentBuffer> ready;
+        ready.set_value(std::move(cached));
+        return ready.get_future();
+    }
+    return submitIo(executor(), [this, hash]() { return loadBuffer(hash); });
 }
 
 std::future<bool> ContentStorage::getFile(const std::string& hash, const std::string& outputPath) {
-    return std::async(std::launch::async, [this, hash, outputPath]() {
-        if (!initialized_) {
-            lastError_ = {2, "Content Storage not initialized"};
-            return false;
-        }
-
-        std::string content = getContent(hash).get();
-        if (content.empty()) {
-            return false;
-        }
-
-        return writeFileContent(outputPath, content);
-    });
+    return submitIo(executor(), [this, hash, outputPath]() { return readFile(hash, outputPath); });
 }
 
 std::future<bool> ContentStorage::getDirectory(const std::string& hash, const std::string& outputPath) {
-    return std::async(std::launch::async, [this, hash, outputPath]() {
-        if (!initialized_) {
-            lastError_ = {2, "Content Storage not initialized"};
-            return false;
-        }
-
-        std::string content = getContent(hash).get();
+    return submitIo(executor(), [this, hash, outputPath]() {
+        std::string content = readContent(hash);
         if (content.empty()) {
             return false;
         }
@@ -259,51 +713,54 @@ std::future<bool> ContentStorage::getDirectory(const std::string& hash, const st
             for (const auto& [path, fileHash] : json.items()) {
                 std::string fullPath = outputPath + "/" + path;
                 std::filesystem::create_directories(std::filesystem::path(fullPath).parent_path());
-                if (!getFile(fileHash, fullPath).get()) {
+                if (!readFile(fileHash.get<std::string>(), fullPath)) {
                     return false;
                 }
             }
             return true;
         } catch (const std::exception& e) {
-            lastError_ = {6, std::string("Failed to parse directory content: ") + e.what()};
+            setError(6, std::string("Failed to parse directory content: ") + e.what());
             return false;
         }
     });
 }
 
 bool ContentStorage::updateContent(const std::string& hash, const std::string& newContent) {
-    std::lock_guard<std::mutex> lock(mutex_);
-    if (!initialized_) {
-        lastError_ = {2, "Content Storage not initialized"};
-        return false;
-    }
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (!initialized_) {
+            lastError_ = {2, "Content Storage not initialized"};
+            return false;
+        }
 
-    auto it = contentInfo_.find(hash);
-    if (it == contentInfo_.end()) {
-        lastError_ = {7, "Content not found"};
-        return false;
+        if (contentInfo_.find(hash) == contentInfo_.end()) {
+            lastError_ = {7, "Content not found"};
+            return false;
+        }
     }
 
     std::string newHash = calculateHash(newContent);
     if (newHash != hash) {
-        lastError_ = {8, "Content hash mismatch"};
+        setError(8, "Content hash mismatch");
         return false;
     }
 
-    std::string filePath = storagePath_ + "/" + hash;
-    if (!writeFileContent(filePath, newContent)) {
-        lastError_ = {9, "Failed to update content file"};
+    // Same bytes, so this only restores chunk files that went missing
+    auto writer = openWriter();
+    if (!writer || !writer->write(newContent.data(), newContent.size()) || writer->finish().hash.empty()) {
+        setError(9, "Failed to update content file");
         return false;
     }
 
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = contentInfo_.find(hash);
+    if (it == contentInfo_.end()) {
+        lastError_ = {7, "Content not found"};
+        return false;
+    }
     it->second.updatedAt = getCurrentTimestamp();
     it->second.size = newContent.length();
-    it->second.mimeType = detectMimeType(newContent);
-
-    if (cacheEnabled_) {
-        updateCache(hash, newContent);
-    }
-
+    persistInfo(it->second);
     return true;
 }
 
@@ -322,6 +779,7 @@ bool ContentStorage::updateMetadata(const std::string& hash, const nlohmann::jso
 
     it->second.metadata = metadata;
     it->second.updatedAt = getCurrentTimestamp();
+    persistInfo(it->second);
     return true;
 }
 
@@ -343,12 +801,21 @@ bool ContentStorage::deleteContent(const std::string& hash) {
         return false;
     }
 
-    std::string filePath = storagePath_ + "/" + hash;
-    if (!std::filesystem::remove(filePath)) {
+    std::vector<ChunkRef> chunks;
+    uint64_t size = 0;
+    if (!loadChunkList(hash, chunks, size) || !index_->erase(CHUNKS_KEY + hash) || !index_->erase(INFO_KEY + hash) ||
+        !index_->sync()) {
         lastError_ = {11, "Failed to delete content file"};
         return false;
     }
 
+    // The index no longer lists the object; a manifest left behind by a
+    // failed remove is collected by the scrubber
+    std::error_code ec;
+    std::filesystem::remove(objectPath(hash), ec);
+    // Chunks shared with other objects stay until their last reference goes
+    releaseChunks(chunks);
+    unindexInfo(it->second);
     removeFromCache(hash);
     removeContentInfo(hash);
     return true;
@@ -369,6 +836,7 @@ bool ContentStorage::pinContent(const std::string& hash) {
 
     it->second.isPinned = true;
     it->second.updatedAt = getCurrentTimestamp();
+    persistInfo(it->second);
     return true;
 }
 
@@ -387,6 +855,7 @@ bool ContentStorage::unpinContent(const std::string& hash) {
 
     it->second.isPinned = false;
     it->second.updatedAt = getCurrentTimestamp();
+    persistInfo(it->second);
     return true;
 }
 
@@ -401,6 +870,7 @@ ContentStorage::ContentInfo ContentStorage::getContentInfo(const std::string& ha
 
 std::vector<ContentStorage::ContentInfo> ContentStorage::getContentByTag(const std::string& tag) const {
     std::lock_guard<std::mutex> lock(mutex_);
+    loadSecondaryIndexes();
     std::vector<ContentInfo> results;
     auto it = tagIndex_.find(tag);
     if (it != tagIndex_.end()) {
@@ -416,6 +886,7 @@ std::vector<ContentStorage::ContentInfo> ContentStorage::getContentByTag(const s
 
 std::vector<ContentStorage::ContentInfo> ContentStorage::getContentByMimeType(const std::string& mimeType) const {
     std::lock_guard<std::mutex> lock(mutex_);
+    loadSecondaryIndexes();
     std::vector<ContentInfo> results;
     auto it = mimeTypeIndex_.find(mimeType);
     if (it != mimeTypeIndex_.end()) {
@@ -468,38 +939,29 @@ std::vector<ContentStorage::ContentInfo> ContentStorage::getPinnedContent() cons
     return results;
 }
 
-void ContentStorage::enableCache(bool enable) {
+size_t ContentStorage::getChunkCount() const {
     std::lock_guard<std::mutex> lock(mutex_);
-    cacheEnabled_ = enable;
-    if (!enable) {
-        clearCache();
-    }
+    return chunkRefs_.size();
+}
+
+void ContentStorage::enableCache(bool enable) {
+    cache_->setEnabled(enable);
 }
 
 void ContentStorage::clearCache() {
-    std::lock_guard<std::mutex> lock(mutex_);
-    contentCache_.clear();
+    cache_->clear();
 }
 
 void ContentStorage::setCacheSize(size_t maxSize) {
-    std::lock_guard<std::mutex> lock(mutex_);
-    maxCacheSize_ = maxSize;
-    if (getCacheUsage() > maxSize) {
-        clearCache();
-    }
+    cache_->setCapacity(maxSize);
 }
 
 size_t ContentStorage::getCacheSize() const {
-    return maxCacheSize_;
+    return cache_->capacity();
 }
 
-size_t ContentStorage::getCacheUsage() const {
-    std::lock_guard<std::mutex> lock(mutex_);
-    size_t usage = 0;
-    for (const auto& [hash, content] : contentCache_) {
-        usage += content.length();
-    }
-    return usage;
+ContentStorage::CacheUsage ContentStorage::getCacheUsage() const {
+    return cache_->usage();
 }
 
 bool ContentStorage::createBackup(const std::string& backupPath) {
@@ -510,16 +972,16 @@ bool ContentStorage::createBackup(const std::string& backupPath) {
     }
 
     try {
-        std::filesystem::create_directories(backupPath);
-        
-        // Backup content files
-        for (const auto& [hash, info] : contentInfo_) {
-            std::string sourcePath = storagePath_ + "/" + hash;
-            std::string destPath = backupPath + "/" + hash;
-            std::filesystem::copy_file(sourcePath, destPath, std::filesystem::copy_options::overwrite_existing);
-        }
+        namespace fs = std::filesystem;
+        const auto options = fs::copy_options::recursive | fs::copy_options::overwrite_existing;
+        fs::create_directories(backupPath);
+
+        // Backup manifests and the chunks they share
+        fs::copy(storagePath_ + "/objects", backupPath + "/objects", options);
+        fs::copy(storagePath_ + "/chunks", backupPath + "/chunks", options);
 
         // Backup metadata
+        loadSecondaryIndexes();
         nlohmann::json backupData = {
             {"contentInfo", contentInfo_},
             {"tagIndex", tagIndex_},
@@ -552,18 +1014,35 @@ bool ContentStorage::restoreFromBackup(const std::string& backupPath) {
         }
 
         auto backupData = nlohmann::json::parse(metadataContent);
-        
-        // Restore content files
-        for (const auto& [hash, info] : backupData["contentInfo"].items()) {
-            std::string sourcePath = backupPath + "/" + hash;
-            std::string destPath = storagePath_ + "/" + hash;
-            std::filesystem::copy_file(sourcePath, destPath, std::filesystem::copy_options::overwrite_existing);
+
+        // Restore manifests and chunks, then rebuild the index from the manifests
+        namespace fs = std::filesystem;
+        const auto options = fs::copy_options::recursive | fs::copy_options::overwrite_existing;
+        fs::copy(backupPath + "/objects", storagePath_ + "/objects", options);
+        fs::copy(backupPath + "/chunks", storagePath_ + "/chunks", options);
+        migrateFlatLayout();
+        index_.reset();
+        fs::remove(storagePath_ + "/index.log");
+        contentInfo_.clear();
+        chunkRefs_.clear();
+        ++chunkRefsGeneration_;
+        if (!openIndex()) {
+            return false;
         }
 
-        // Restore indices
-        contentInfo_ = backupData["contentInfo"].get<std::unordered_map<std::string, ContentInfo>>();
-        tagIndex_ = backupData["tagIndex"].get<std::unordered_map<std::string, std::vector<std::string>>>();
-        mimeTypeIndex_ = backupData["mimeTypeIndex"].get<std::unordered_map<std::string, std::vector<std::string>>>();
+        // Restore indices; tag and MIME indexes follow from the restored info
+        auto restored = backupData["contentInfo"].get<std::unordered_map<std::string, ContentInfo>>();
+        for (auto& [hash, info] : restored) {
+            auto it = contentInfo_.find(hash);
+            if (it != contentInfo_.end()) {
+                it->second = std::move(info);
+                persistInfo(it->second, false);
+            }
+        }
+        index_->sync();
+        tagIndex_.clear();
+        mimeTypeIndex_.clear();
+        secondaryIndexesLoaded_ = false;
 
         return true;
     } catch (const std::exception& e) {
@@ -573,10 +1052,12 @@ bool ContentStorage::restoreFromBackup(const std::string& backupPath) {
 }
 
 ContentStorage::Error ContentStorage::getLastError() const {
+    std::lock_guard<std::mutex> lock(mutex_);
     return lastError_;
 }
 
 void ContentStorage::clearLastError() {
+    std::lock_guard<std::mutex> lock(mutex_);
     lastError_ = {0, ""};
 }
 
@@ -587,7 +1068,9 @@ bool ContentStorage::validateStoragePath(const std::string& path) {
 
 bool ContentStorage::createStorageDirectory() {
     try {
-        std::filesystem::create_directories(storagePath_);
+        std::filesystem::create_directories(storagePath_ + "/objects");
+        std::filesystem::create_directories(storagePath_ + "/chunks");
+        std::filesystem::create_directories(storagePath_ + "/quarantine");
         return true;
     } catch (const std::exception& e) {
         lastError_ = {15, std::string("Failed to create storage directory: ") + e.what()};
@@ -596,11 +1079,18 @@ bool ContentStorage::createStorageDirectory() {
 }
 
 bool ContentStorage::validateContentHash(const std::string& hash) {
-    return !hash.empty() && hash.length() == 64; // SHA-256 hash length
+    return hash.length() == 64 &&
+           std::all_of(hash.begin(), hash.end(), [](char c) { return std::isxdigit(static_cast<unsigned char>(c)); });
 }
 
 bool ContentStorage::updateContentInfo(const std::string& hash, const ContentInfo& info) {
+    auto it = contentInfo_.find(hash);
+    if (it != contentInfo_.end()) {
+        unindexInfo(it->second);
+    }
     contentInfo_[hash] = info;
+    indexInfo(info);
+    persistInfo(info);
     return true;
 }
 
@@ -609,29 +1099,592 @@ bool ContentStorage::removeContentInfo(const std::string& hash) {
     return true;
 }
 
-void ContentStorage::updateCache(const std::string& hash, const std::string& content) {
-    size_t contentSize = content.length();
-    if (contentSize > maxCacheSize_) {
-        return; // Content too large to cache
+void ContentStorage::updateCache(const std::string& hash, ContentBuffer content) {
+    cache_->put(hash, std::move(content));
+}
+
+void ContentStorage::removeFromCache(const std::string& hash) {
+    cache_->erase(hash);
+}
+
+bool ContentStorage::handleError(const std::string& operation, const std::string& error) {
+    lastError_ = {16, operation + ": " + error};
+    return false;
+}
+
+void ContentStorage::setError(int code, const std::string& message) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    lastError_ = {code, message};
+}
+
+ContentStorage::ContentInfo ContentStorage::storeStream(std::istream& in, const std::string& name) {
+    auto writer = openWriter(name);
+    if (!writer) {
+        return ContentInfo{};
+    }
+    std::vector<char> buffer(STREAM_BUFFER_SIZE);
+    while (in) {
+        in.read(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+        if (in.gcount() > 0 && !writer->write(buffer.data(), static_cast<size_t>(in.gcount()))) {
+            break;
+        }
+    }
+    if (in.bad()) {
+        writer->abort();
+        setError(4, "Failed to read file content");
+        return ContentInfo{};
+    }
+    auto info = writer->finish();
+    if (info.hash.empty()) {
+        setError(3, "Failed to write content to file");
     }
+    return info;
+}
 
-    // Remove old content if cache would exceed max size
-    while (getCacheUsage() + contentSize > maxCacheSize_ && !contentCache_.empty()) {
-        contentCache_.erase(contentCache_.begin());
+bool ContentStorage::streamContent(const std::string& hash, std::ostream& out) {
+    auto reader = openReader(hash);
+    if (!reader) {
+        return false;
     }
+    std::vector<char> buffer(STREAM_BUFFER_SIZE);
+    size_t n;
+    while ((n = reader->read(buffer.data(), buffer.size())) > 0) {
+        out.write(buffer.data(), static_cast<std::streamsize>(n));
+    }
+    if (!reader->good()) {
+        setError(5, "Failed to read content from file");
+        return false;
+    }
+    return out.good();
+}
 
-    contentCache_[hash] = content;
+std::string ContentStorage::readContent(const std::string& hash) {
+    auto buffer = cache_->get(hash);
+    if (!buffer) {
+        buffer = loadBuffer(hash);
+    }
+    return buffer ? *buffer : std::string();
 }
 
-void ContentStorage::removeFromCache(const std::string& hash) {
-    contentCache_.erase(hash);
+ContentStorage::ContentBuffer ContentStorage::loadBuffer(const std::string& hash) {
+    auto reader = openReader(hash);
+    if (!reader) {
+        return nullptr;
+    }
+    auto content = std::make_shared<std::string>(reader->size(), '\0');
+    if (reader->read(content->data(), content->size()) != content->size() || !reader->good()) {
+        setError(5, "Failed to read content from file");
+        return nullptr;
+    }
+    ContentBuffer buffer = std::move(content);
+    updateCache(hash, buffer);
+    return buffer;
 }
 
-bool ContentStorage::handleError(const std::string& operation, const std::string& error) {
-    lastError_ = {16, operation + ": " + error};
+bool ContentStorage::readFile(const std::string& hash, const std::string& outputPath) {
+    std::ofstream file(outputPath, std::ios::binary | std::ios::trunc);
+    if (!file) {
+        setError(5, "Failed to open output file");
+        return false;
+    }
+    return streamContent(hash, file);
+}
+
+std::shared_ptr<IoExecutor> ContentStorage::executor() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return executor_;
+}
+
+std::string ContentStorage::objectPath(const std::string& hash) const {
+    return shardPath(storagePath_ + "/objects", hash);
+}
+
+std::string ContentStorage::chunkPath(const std::string& hash) const {
+    return shardPath(storagePath_ + "/chunks", hash);
+}
+
+bool ContentStorage::loadManifest(const std::string& hash, std::vector<ChunkRef>& chunks, uint64_t& size,
+                                  nlohmann::json* fields) const {
+    try {
+        auto manifest = nlohmann::json::parse(readFileContent(objectPath(hash)));
+        size = manifest.at("size").get<uint64_t>();
+        chunks.clear();
+        for (const auto& chunk : manifest.at("chunks")) {
+            chunks.push_back({chunk.at(0).get<std::string>(), chunk.at(1).get<uint32_t>()});
+        }
+        if (fields) {
+            manifest.erase("chunks");
+            *fields = std::move(manifest);
+        }
+        return true;
+    } catch (const std::exception&) {
+        return false;
+    }
+}
+
+bool ContentStorage::loadChunkList(const std::string& hash, std::vector<ChunkRef>& chunks, uint64_t& size) const {
+    // Caller holds mutex_
+    std::string value;
+    if (!index_ || !index_->get(CHUNKS_KEY + hash, value)) {
+        return false;
+    }
+    try {
+        auto list = nlohmann::json::parse(value);
+        size = list.at("size").get<uint64_t>();
+        chunks.clear();
+        for (const auto& chunk : list.at("chunks")) {
+            chunks.push_back({chunk.at(0).get<std::string>(), chunk.at(1).get<uint32_t>()});
+        }
+        return true;
+    } catch (const std::exception&) {
+        return false;
+    }
+}
+
+bool ContentStorage::storeChunk(const uint8_t* data, size_t size, ChunkRef& ref) {
+    ref.hash = sha256Hex(data, size);
+    ref.size = static_cast<uint32_t>(size);
+
+    // Take the reference first: from here on nobody deletes the file
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        ++chunkRefs_[ref.hash];
+    }
+
+    namespace fs = std::filesystem;
+    const std::string path = chunkPath(ref.hash);
+    std::error_code ec;
+    if (fs::exists(path, ec)) {
+        return true;
+    }
+    const std::string temp = path + tempSuffix();
+    if (writeShardedFile(temp, reinterpret_cast<const char*>(data), size)) {
+        publishFile(temp, path, ec);
+        if (!ec) {
+            return true;
+        }
+    }
+    fs::remove(temp, ec);
+    std::lock_guard<std::mutex> lock(mutex_);
+    releaseChunks({ref});
     return false;
 }
 
+void ContentStorage::releaseChunks(const std::vector<ChunkRef>& chunks) {
+    // Caller holds mutex_
+    for (const auto& chunk : chunks) {
+        auto it = chunkRefs_.find(chunk.hash);
+        if (it != chunkRefs_.end() && --it->second == 0) {
+            chunkRefs_.erase(it);
+            std::error_code ec;
+            std::filesystem::remove(chunkPath(chunk.hash), ec);
+        }
+    }
+}
+
+bool ContentStorage::publishObject(ContentInfo& info, const std::vector<ChunkRef>& chunks) {
+    nlohmann::json list = nlohmann::json::array();
+    for (const auto& chunk : chunks) {
+        list.push_back({chunk.hash, chunk.size});
+    }
+    nlohmann::json manifest = {
+        {"version", MANIFEST_VERSION},
+        {"size", info.size},
+        {"name", info.name},
+        {"mimeType", info.mimeType},
+        {"createdAt", info.createdAt},
+        {"chunks", list}
+    };
+    const std::string chunkList = nlohmann::json{{"size", info.size}, {"chunks", list}}.dump();
+
+    const std::string path = objectPath(info.hash);
+    const std::string temp = path + tempSuffix();
+    std::error_code ec;
+    const std::string encoded = manifest.dump();
+    if (!writeShardedFile(temp, encoded.data(), encoded.size())) {
+        std::filesystem::remove(temp, ec);
+        return false;
+    }
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto existing = contentInfo_.find(info.hash);
+    if (existing != contentInfo_.end()) {
+        // Same object stored again: keep the first copy and its references
+        std::filesystem::remove(temp, ec);
+        releaseChunks(chunks);
+        info = existing->second;
+        return true;
+    }
+    publishFile(temp, path, ec);
+    // The chunk list goes first: an info record without one is dropped on
+    // load. The sync commits the object, after its chunks and manifest.
+    if (ec || !index_->put(CHUNKS_KEY + info.hash, chunkList) ||
+        !index_->put(INFO_KEY + info.hash, nlohmann::json(info).dump()) || !index_->sync()) {
+        index_->erase(CHUNKS_KEY + info.hash);
+        std::filesystem::remove(ec ? temp : path, ec);
+        return false;
+    }
+    contentInfo_[info.hash] = info;
+    indexInfo(info);
+    return true;
+}
+
+void ContentStorage::persistInfo(const ContentInfo& info, bool commit) {
+    // Caller holds mutex_. Bulk callers commit once after the last record.
+    if (index_ && index_->put(INFO_KEY + info.hash, nlohmann::json(info).dump()) && commit) {
+        index_->sync();
+    }
+}
+
+bool ContentStorage::openIndex() {
+    // Caller holds mutex_
+    const std::string path = storagePath_ + "/index.log";
+    std::error_code ec;
+    bool existed = std::filesystem::exists(path, ec);
+
+    std::unordered_set<std::string> listed;
+    std::string error;
+    // Records are synced once per commit, not on every append
+    index_ = std::make_unique<ContentIndex>();
+    auto visitor = [&](const std::string& key, const std::string& value) {
+        try {
+            const std::string hash = key.substr(CHUNKS_KEY.size());
+            if (key.compare(0, CHUNKS_KEY.size(), CHUNKS_KEY) == 0) {
+                auto list = nlohmann::json::parse(value);
+                for (const auto& chunk : list.at("chunks")) {
+                    ++chunkRefs_[chunk.at(0).get<std::string>()];
+                }
+                listed.insert(hash);
+            } else if (key.compare(0, INFO_KEY.size(), INFO_KEY) == 0) {
+                contentInfo_[hash] = nlohmann::json::parse(value).get<ContentInfo>();
+            }
+        } catch (const std::exception&) {
+            // Unreadable records are left for rebuildIndex
+        }
+    };
+    bool opened = index_->open(path, false, visitor, error);
+    if (!opened && index_->corrupt()) {
+        // Damage mid-log: the records after it may supersede anything
+        // before, so none are trusted. Keep the file aside and start over
+        // from the manifests, which list every published object.
+        std::filesystem::rename(path, path + ".corrupt", ec);
+        existed = false;
+        opened = !ec && index_->open(path, false, visitor, error);
+    }
+    if (!opened) {
+        index_.reset();
+        lastError_ = {15, "Failed to load content index: " + error};
+        return false;
+    }
+
+    // A crash between the two records of a publish leaves a chunk list
+    // without info (the manifest still has it) or info without chunks
+    for (auto it = contentInfo_.begin(); it != contentInfo_.end();) {
+        if (!listed.count(it->first)) {
+            index_->erase(INFO_KEY + it->first);
+            it = contentInfo_.erase(it);
+        } else {
+            ++it;
+        }
+    }
+    for (const auto& hash : listed) {
+        if (contentInfo_.count(hash)) {
+            continue;
+        }
+        std::vector<ChunkRef> chunks;
+        uint64_t size = 0;
+        nlohmann::json fields;
+        if (loadManifest(hash, chunks, size, &fields)) {
+            ContentInfo info{};
+            info.hash = hash;
+            info.name = fields.value("name", hash);
+            info.size = size;
+            info.mimeType = fields.value("mimeType", "application/octet-stream");
+            info.createdAt = fields.value("createdAt", "");
+            info.updatedAt = info.createdAt;
+            info.isPinned = false;
+            info.metadata = nlohmann::json::object();
+            contentInfo_[hash] = info;
+            persistInfo(info, false);
+        } else if (loadChunkList(hash, chunks, size)) {
+            releaseChunks(chunks);
+            index_->erase(CHUNKS_KEY + hash);
+        }
+    }
+
+    // Without an index (first start, or after it was lost) fall back to the manifests
+    const bool loaded = existed || rebuildIndex();
+    index_->sync();
+    return loaded;
+}
+
+bool ContentStorage::rebuildIndex() {
+    // Caller holds mutex_
+    namespace fs = std::filesystem;
+    try {
+        for (const auto& entry : fs::recursive_directory_iterator(storagePath_ + "/objects")) {
+            const std::string hash = entry.path().filename().string();
+            if (!entry.is_regular_file() || !validateContentHash(hash) || contentInfo_.count(hash)) {
+                continue;
+            }
+            std::vector<ChunkRef> chunks;
+            uint64_t size = 0;
+            nlohmann::json fields;
+            if (!loadManifest(hash, chunks, size, &fields)) {
+                continue;
+            }
+            ContentInfo info{};
+            info.hash = hash;
+            info.name = fields.value("name", hash);
+            info.size = size;
+            info.mimeType = fields.value("mimeType", "application/octet-stream");
+            info.createdAt = fields.value("createdAt", "");
+            info.updatedAt = info.createdAt;
+            info.isPinned = false;
+            info.metadata = nlohmann::json::object();
+
+            nlohmann::json list = nlohmann::json::array();
+            for (const auto& chunk : chunks) {
+                ++chunkRefs_[chunk.hash];
+                list.push_back({chunk.hash, chunk.size});
+            }
+            index_->put(CHUNKS_KEY + hash, nlohmann::json{{"size", size}, {"chunks", list}}.dump());
+            contentInfo_[hash] = info;
+            persistInfo(info, false);
+        }
+        return true;
+    } catch (const std::exception& e) {
+        lastError_ = {15, std::string("Failed to rebuild content index: ") + e.what()};
+        return false;
+    }
+}
+
+void ContentStorage::migrateFlatLayout() {
+    // Caller holds mutex_. Moves objects/<hash> and chunks/<hash> into shards.
+    namespace fs = std::filesystem;
+    for (const char* directory : {"/objects", "/chunks"}) {
+        const std::string base = storagePath_ + directory;
+        std::error_code ec;
+        for (const auto& entry : fs::directory_iterator(base, ec)) {
+            const std::string hash = entry.path().filename().string();
+            if (!entry.is_regular_file()) {
+                continue;
+            }
+            if (isTempFile(entry.path())) {
+                fs::remove(entry.path(), ec);
+            } else if (validateContentHash(hash)) {
+                const std::string target = shardPath(base, hash);
+                fs::create_directories(fs::path(target).parent_path(), ec);
+                fs::rename(entry.path(), target, ec);
+            }
+        }
+    }
+}
+
+void ContentStorage::loadSecondaryIndexes() const {
+    // Caller holds mutex_
+    if (secondaryIndexesLoaded_) {
+        return;
+    }
+    for (const auto& [hash, info] : contentInfo_) {
+        mimeTypeIndex_[info.mimeType].push_back(hash);
+        for (const auto& tag : info.tags) {
+            tagIndex_[tag].push_back(hash);
+        }
+    }
+    secondaryIndexesLoaded_ = true;
+}
+
+void ContentStorage::indexInfo(const ContentInfo& info) {
+    // Caller holds mutex_; nothing to keep current until the indexes are built
+    if (!secondaryIndexesLoaded_) {
+        return;
+    }
+    mimeTypeIndex_[info.mimeType].push_back(info.hash);
+    for (const auto& tag : info.tags) {
+        tagIndex_[tag].push_back(info.hash);
+    }
+}
+
+void ContentStorage::unindexInfo(const ContentInfo& info) {
+    // Caller holds mutex_
+    if (!secondaryIndexesLoaded_) {
+        return;
+    }
+    auto drop = [&info](std::unordered_map<std::string, std::vector<std::string>>& index, const std::string& key) {
+        auto it = index.find(key);
+        if (it != index.end()) {
+            it->second.erase(std::remove(it->second.begin(), it->second.end(), info.hash), it->second.end());
+            if (it->second.empty()) {
+                index.erase(it);
+            }
+        }
+    };
+    drop(mimeTypeIndex_, info.mimeType);
+    for (const auto& tag : info.tags) {
+        drop(tagIndex_, tag);
+    }
+}
+
+ContentStorage::ScrubReport ContentStorage::scrub(uint64_t maxBytesPerSecond) {
+    namespace fs = std::filesystem;
+    ScrubReport report;
+    std::vector<std::string> chunks;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (!initialized_) {
+            lastError_ = {2, "Content Storage not initialized"};
+            return report;
+        }
+        report.objectsChecked = contentInfo_.size();
+        chunks.reserve(chunkRefs_.size());
+        for (const auto& [hash, refs] : chunkRefs_) {
+            chunks.push_back(hash);
+        }
+    }
+
+    // Re-hash every referenced chunk, throttled to maxBytesPerSecond
+    const auto start = std::chrono::steady_clock::now();
+    std::unordered_set<std::string> bad;
+    for (const auto& hash : chunks) {
+        std::string path;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (!initialized_ || !chunkRefs_.count(hash)) {
+                continue;
+            }
+            path = chunkPath(hash);
+        }
+        std::ifstream file(path, std::ios::binary);
+        if (!file) {
+            report.missingChunks.push_back(hash);
+            bad.insert(hash);
+            continue;
+        }
+        std::string data{std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>()};
+        report.chunksChecked++;
+        report.bytesChecked += data.size();
+        if (sha256Hex(data.data(), data.size()) != hash) {
+            std::error_code ec;
+            fs::rename(path, storagePath_ + "/quarantine/" + hash, ec);
+            report.corruptChunks.push_back(hash);
+            bad.insert(hash);
+        }
+        if (maxBytesPerSecond > 0) {
+            auto due = start + std::chrono::microseconds(report.bytesChecked * 1000000 / maxBytesPerSecond);
+            if (!waitScrubber(due - std::chrono::steady_clock::now())) {
+                return report;
+            }
+        }
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (!initialized_) {
+            return report;
+        }
+        if (!bad.empty()) {
+            for (const auto& [hash, info] : contentInfo_) {
+                std::vector<ChunkRef> objectChunks;
+                uint64_t size = 0;
+                if (!loadChunkList(hash, objectChunks, size)) {
+                    continue;
+                }
+                for (const auto& chunk : objectChunks) {
+                    if (bad.count(chunk.hash)) {
+                        report.damagedObjects.push_back(hash);
+                        break;
+                    }
+                }
+            }
+        }
+    }
+
+    // Files no object owns: manifests of an unfinished publish or delete,
+    // chunks of an interrupted write. The check and the remove happen under
+    // the lock writers take their references with.
+    const auto staleBefore = fs::file_time_type::clock::now() - TEMP_FILE_GRACE;
+    for (const char* directory : {"/objects", "/chunks"}) {
+        const bool objects = directory[1] == 'o';
+        std::error_code ec;
+        for (fs::recursive_directory_iterator it(storagePath_ + directory, ec), end; !ec && it != end; it.increment(ec)) {
+            if (!it->is_regular_file()) {
+                continue;
+            }
+            const std::string name = it->path().filename().string();
+            std::error_code removeError;
+            if (isTempFile(it->path())) {
+                if (fs::last_write_time(it->path(), removeError) < staleBefore && fs::remove(it->path(), removeError)) {
+                    report.orphansRemoved++;
+                }
+                continue;
+            }
+            std::lock_guard<std::mutex> lock(mutex_);
+            bool owned = objects ? contentInfo_.count(name) != 0 : chunkRefs_.count(name) != 0;
+            if (initialized_ && !owned && fs::remove(it->path(), removeError)) {
+                report.orphansRemoved++;
+            }
+        }
+    }
+
+    report.finishedAt = getCurrentTimestamp();
+    std::lock_guard<std::mutex> lock(mutex_);
+    lastScrubReport_ = report;
+    return report;
+}
+
+void ContentStorage::startScrubber(std::chrono::seconds interval, uint64_t maxBytesPerSecond) {
+    stopScrubber();
+    scrubberThread_ = std::thread([this, interval, maxBytesPerSecond] {
+        while (waitScrubber(interval)) {
+            scrub(maxBytesPerSecond);
+        }
+    });
+}
+
+void ContentStorage::stopScrubber() {
+    {
+        std::lock_guard<std::mutex> lock(scrubberMutex_);
+        scrubberStop_ = true;
+    }
+    scrubberWake_.notify_all();
+    if (scrubberThread_.joinable()) {
+        scrubberThread_.join();
+    }
+    std::lock_guard<std::mutex> lock(scrubberMutex_);
+    scrubberStop_ = false;
+}
+
+ContentStorage::ScrubReport ContentStorage::getLastScrubReport() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return lastScrubReport_;
+}
+
+bool ContentStorage::waitScrubber(std::chrono::steady_clock::duration delay) {
+    // False once stopScrubber() was called
+    std::unique_lock<std::mutex> lock(scrubberMutex_);
+    if (delay.count() > 0) {
+        scrubberWake_.wait_for(lock, delay, [this] { return scrubberStop_; });
+    }
+    return !scrubberStop_;
+}
+
+void ContentStorage::importLegacyFiles() {
+    // Earlier versions kept each object whole as <storagePath>/<hash>
+    namespace fs = std::filesystem;
+    std::error_code ec;
+    for (const auto& entry : fs::directory_iterator(storagePath_, ec)) {
+        const std::string hash = entry.path().filename().string();
+        if (!entry.is_regular_file() || !validateContentHash(hash)) {
+            continue;
+        }
+        std::ifstream file(entry.path(), std::ios::binary);
+        if (file && storeStream(file, hash).hash == hash) {
+            file.close();
+            fs::remove(entry.path(), ec);
+        }
+    }
+}
+
 } // namespace ipfs
 } // namespace satox
- 
\ No newline at end of file
@@ -0,0 +1,330 @@
+/**
+ * @file http_transfer_pool.cpp
+ * @brief Shared curl_multi transfer pool for IPFS daemon requests
+ * @copyright Copyright (c) 2025 Satoxcoin Core Developers
+ * @license MIT License
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "http_transfer_pool.hpp"
+#include <curl/curl.h>
+#include <unistd.h>
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+
+namespace satox {
+namespace ipfs {
+
+struct HttpTransferPool::Transfer {
+    Request request;
+    Response response;
+    std::promise<Response> promise;
+    curl_mime* mime = nullptr;
+    size_t offset = 0;               // next upload byte
+    bool sinkFailed = false;
+    char errorBuffer[CURL_ERROR_SIZE] = {};
+};
+
+namespace {
+
+size_t writeBody(char* contents, size_t size, size_t nmemb, void* userp) {
+    auto* transfer = static_cast<HttpTransferPool::Transfer*>(userp);
+    size_t bytes = size * nmemb;
+    if (transfer->request.sink) {
+        if (!transfer->request.sink(contents, bytes)) {
+            transfer->sinkFailed = true;
+            return 0;
+        }
+    } else {
+        transfer->response.body.append(contents, bytes);
+    }
+    return bytes;
+}
+
+size_t readUpload(char* buffer, size_t size, size_t nitems, void* arg) {
+    auto* transfer = static_cast<HttpTransferPool::Transfer*>(arg);
+    const auto& request = transfer->request;
+    size_t wanted = std::min(size * nitems, request.size - transfer->offset);
+    if (wanted == 0) {
+        return 0;
+    }
+    if (request.fd < 0) {
+        std::memcpy(buffer, request.data + transfer->offset, wanted);
+        transfer->offset += wanted;
+        return wanted;
+    }
+    ssize_t got;
+    do {
+        got = ::pread(request.fd, buffer, wanted, static_cast<off_t>(transfer->offset));
+    } while (got < 0 && errno == EINTR);
+    if (got <= 0) {
+        // Read error, or the file shrank below the size announced to the daemon
+        return CURL_READFUNC_ABORT;
+    }
+    transfer->offset += static_cast<size_t>(got);
+    return static_cast<size_t>(got);
+}
+
+int seekUpload(void* arg, curl_off_t offset, int origin) {
+    auto* transfer = static_cast<HttpTransferPool::Transfer*>(arg);
+    if (origin != SEEK_SET || offset < 0 || static_cast<size_t>(offset) > transfer->request.size) {
+        return CURL_SEEKFUNC_CANTSEEK;
+    }
+    transfer->offset = static_cast<size_t>(offset);
+    return CURL_SEEKFUNC_OK;
+}
+
+} // namespace
+
+HttpTransferPool::HttpTransferPool(size_t maxConcurrent, long connectTimeoutSeconds)
+    : connectTimeoutSeconds_(connectTimeoutSeconds),
+      maxConcurrent_(std::max<size_t>(1, maxConcurrent)) {
+    multi_ = curl_multi_init();
+    // Uploads start right away instead of waiting for 100-continue
+    headers_ = curl_slist_append(nullptr, "Expect:");
+    worker_ = std::thread(&HttpTransferPool::run, this);
+}
+
+HttpTransferPool::~HttpTransferPool() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stopping_ = true;
+    }
+    curl_multi_wakeup(multi_);
+    worker_.join();
+
+    for (auto& [handle, transfer] : active_) {
+        curl_multi_remove_handle(multi_, handle);
+        curl_easy_cleanup(handle);
+        curl_mime_free(transfer->mime);
+        fail(*transfer, "Transfer pool stopped");
+    }
+    for (auto& transfer : queue_) {
+        fail(*transfer, "Transfer pool stopped");
+    }
+    for (CURL* handle : idle_) {
+        curl_easy_cleanup(handle);
+    }
+    curl_multi_cleanup(multi_);
+    curl_slist_free_all(headers_);
+}
+
+std::future<HttpTransferPool::Response> HttpTransferPool::submit(Request request) {
+    auto transfer = std::make_unique<Transfer>();
+    transfer->request = std::move(request);
+    auto future = transfer->promise.get_future();
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (stopping_) {
+            fail(*transfer, "Transfer pool stopped");
+            return future;
+        }
+        queue_.push_back(std::move(transfer));
+        stats_.queued = queue_.size();
+    }
+    curl_multi_wakeup(multi_);
+    return future;
+}
+
+std::vector<HttpTransferPool::Response> HttpTransferPool::performAll(std::vector<Request> requests) {
+    std::vector<std::future<Response>> futures;
+    futures.reserve(requests.size());
+    for (auto& request : requests) {
+        futures.push_back(submit(std::move(request)));
+    }
+    std::vector<Response> responses;
+    responses.reserve(futures.size());
+    for (auto& future : futures) {
+        responses.push_back(future.get());
+    }
+    return responses;
+}
+
+void HttpTransferPool::setMaxConcurrent(size_t maxConcurrent) {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        maxConcurrent_ = std::max<size_t>(1, maxConcurrent);
+    }
+    curl_multi_wakeup(multi_);
+}
+
+HttpTransferPool::Stats HttpTransferPool::getStats() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return stats_;
+}
+
+void HttpTransferPool::run() {
+    for (;;) {
+        std::vector<std::unique_ptr<Transfer>> starting;
+        size_t maxConcurrent;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (stopping_) {
+                return;
+            }
+            maxConcurrent = maxConcurrent_;
+            while (!queue_.empty() && active_.size() + starting.size() < maxConcurrent) {
+                starting.push_back(std::move(queue_.front()));
+                queue_.pop_front();
+            }
+            stats_.queued = queue_.size();
+            stats_.inFlight = active_.size() + starting.size();
+            stats_.peakInFlight = std::max(stats_.peakInFlight, stats_.inFlight);
+        }
+
+        // The multi handle is only touched from this thread
+        if (appliedMaxConnects_ != maxConcurrent) {
+            curl_multi_setopt(multi_, CURLMOPT_MAXCONNECTS, static_cast<long>(maxConcurrent));
+            appliedMaxConnects_ = maxConcurrent;
+        }
+        for (auto& transfer : starting) {
+            begin(std::move(transfer));
+        }
+
+        int running = 0;
+        curl_multi_perform(multi_, &running);
+        bool finished = false;
+        int pending = 0;
+        while (CURLMsg* message = curl_multi_info_read(multi_, &pending)) {
+            if (message->msg == CURLMSG_DONE) {
+                finish(message->easy_handle, message->data.result);
+                finished = true;
+            }
+        }
+        // Completions free slots; fill them before sleeping
+        if (!finished) {
+            curl_multi_poll(multi_, nullptr, 0, 1000, nullptr);
+        }
+    }
+}
+
+void HttpTransferPool::begin(std::unique_ptr<Transfer> transfer) {
+    CURL* handle = nullptr;
+    if (!idle_.empty()) {
+        handle = idle_.back();
+        idle_.pop_back();
+    } else {
+        handle = curl_easy_init();
+        if (!handle) {
+            fail(*transfer, "Failed to initialize CURL");
+            return;
+        }
+        std::lock_guard<std::mutex> lock(mutex_);
+        ++stats_.handlesCreated;
+    }
+
+    const Request& request = transfer->request;
+    curl_easy_setopt(handle, CURLOPT_URL, request.url.c_str());
+    curl_easy_setopt(handle, CURLOPT_PRIVATE, transfer.get());
+    curl_easy_setopt(handle, CURLOPT_ERRORBUFFER, transfer->errorBuffer);
+    curl_easy_setopt(handle, CURLOPT_WRITEFUNCTION, writeBody);
+    curl_easy_setopt(handle, CURLOPT_WRITEDATA, transfer.get());
+    curl_easy_setopt(handle, CURLOPT_NOSIGNAL, 1L);
+    curl_easy_setopt(handle, CURLOPT_TCP_KEEPALIVE, 1L);
+    curl_easy_setopt(handle, CURLOPT_HTTPHEADER, headers_);
+    if (connectTimeoutSeconds_ > 0) {
+        curl_easy_setopt(handle, CURLOPT_CONNECTTIMEOUT, connectTimeoutSeconds_);
+    }
+    if (request.timeoutSeconds > 0) {
+        curl_easy_setopt(handle, CURLOPT_TIMEOUT, request.timeoutSeconds);
+    }
+    if (request.stallSeconds > 0) {
+        curl_easy_setopt(handle, CURLOPT_LOW_SPEED_LIMIT, 1L);
+        curl_easy_setopt(handle, CURLOPT_LOW_SPEED_TIME, request.stallSeconds);
+    }
+
+    if (request.upload) {
+        transfer->mime = curl_mime_init(handle);
+        curl_mimepart* part = curl_mime_addpart(transfer->mime);
+        curl_mime_name(part, "file");
+        curl_mime_filename(part, request.fileName.c_str());
+        curl_mime_type(part, "application/octet-stream");
+        curl_mime_data_cb(part, static_cast<curl_off_t>(request.size),
+                          readUpload, seekUpload, nullptr, transfer.get());
+        curl_easy_setopt(handle, CURLOPT_MIMEPOST, transfer->mime);
+    } else if (request.post) {
+        curl_easy_setopt(handle, CURLOPT_POSTFIELDS, "");
+        curl_easy_setopt(handle, CURLOPT_POSTFIELDSIZE, 0L);
+    }
+
+    if (curl_multi_add_handle(multi_, handle) != CURLM_OK) {
+        curl_mime_free(transfer->mime);
+        curl_easy_cleanup(handle);
+        fail(*transfer, "Failed to queue transfer");
+        return;
+    }
+    active_.emplace(handle, std::move(transfer));
+}
+
+void HttpTransferPool::finish(CURL* handle, int result) {
+    auto found = active_.find(handle);
+    if (found == active_.end()) {
+        return;
+    }
+    std::unique_ptr<Transfer> transfer = std::move(found->second);
+    active_.erase(found);
+    curl_multi_remove_handle(multi_, handle);
+
+    Response& response = transfer->response;
+    response.curlCode = result;
+    if (result == CURLE_OK) {
+        response.transportOk = true;
+        curl_easy_getinfo(handle, CURLINFO_RESPONSE_CODE, &response.status);
+    } else if (transfer->sinkFailed) {
+        response.error = "Response sink rejected data";
+    } else if (transfer->errorBuffer[0] != '\0') {
+        response.error = transfer->errorBuffer;
+    } else {
+        response.error = curl_easy_strerror(static_cast<CURLcode>(result));
+    }
+    long connects = 0;
+    curl_easy_getinfo(handle, CURLINFO_NUM_CONNECTS, &connects);
+
+    curl_mime_free(transfer->mime);
+    transfer->mime = nullptr;
+    curl_easy_reset(handle);
+
+    size_t maxConcurrent;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        ++stats_.completed;
+        if (!response.transportOk) {
+            ++stats_.failed;
+        }
+        stats_.connectionsOpened += static_cast<uint64_t>(connects);
+        stats_.inFlight = active_.size();
+        maxConcurrent = maxConcurrent_;
+    }
+    if (idle_.size() < maxConcurrent) {
+        idle_.push_back(handle);
+    } else {
+        curl_easy_cleanup(handle);
+    }
+    transfer->promise.set_value(std::move(response));
+}
+
+void HttpTransferPool::fail(Transfer& transfer, const std::string& error) {
+    transfer.response.error = error;
+    transfer.promise.set_value(std::move(transfer.response));
+}
+
+} // namespace ipfs
+} // namespace satox
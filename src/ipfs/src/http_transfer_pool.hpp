@@ -0,0 +1,141 @@
+/**
+ * @file http_transfer_pool.hpp
+ * @brief Shared curl_multi transfer pool for IPFS daemon requests
+ * @copyright Copyright (c) 2025 Satoxcoin Core Developers
+ * @license MIT License
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+typedef void CURL;
+typedef void CURLM;
+struct curl_slist;
+
+namespace satox {
+namespace ipfs {
+
+/**
+ * HTTP requests to the IPFS daemon, driven by one curl multi handle.
+ *
+ * A single worker thread runs the multi handle. Submitted requests queue
+ * until one of maxConcurrent slots frees up; easy handles are reset and
+ * reused instead of recreated, and the multi handle's connection cache
+ * keeps connections to the daemon alive between requests, so a burst of
+ * pins shares a few sockets instead of opening one per call.
+ *
+ * Uploads go out as the "file" part of a multipart form. The part is read
+ * from a caller-owned buffer or with pread from a file descriptor as curl
+ * asks for data, so a large file is never held in memory.
+ */
+class HttpTransferPool {
+public:
+    struct Request {
+        std::string url;
+        bool post = true;
+        // Multipart upload of size bytes from data, or from fd when fd >= 0.
+        // The buffer or descriptor must stay valid until the future is ready.
+        bool upload = false;
+        const char* data = nullptr;
+        int fd = -1;
+        size_t size = 0;
+        std::string fileName = "file";
+        // Receives the body as it arrives; returning false aborts the
+        // transfer. Without a sink the body is collected in Response::body.
+        std::function<bool(const char*, size_t)> sink;
+        long timeoutSeconds = 0;     // whole transfer, 0 = no limit
+        long stallSeconds = 0;       // abort when no byte moves for this long
+    };
+
+    struct Response {
+        bool transportOk = false;    // the daemon answered
+        int curlCode = 0;            // CURLcode of a finished transfer
+        long status = 0;
+        std::string body;
+        std::string error;
+
+        bool ok() const { return transportOk && status >= 200 && status < 300; }
+    };
+
+    struct Stats {
+        uint64_t completed = 0;
+        uint64_t failed = 0;         // transport errors, status codes not counted
+        uint64_t handlesCreated = 0;
+        uint64_t connectionsOpened = 0;
+        size_t queued = 0;
+        size_t inFlight = 0;
+        size_t peakInFlight = 0;
+    };
+
+    HttpTransferPool(size_t maxConcurrent, long connectTimeoutSeconds);
+    // Fails queued and in-flight requests with "Transfer pool stopped"
+    ~HttpTransferPool();
+    HttpTransferPool(const HttpTransferPool&) = delete;
+    HttpTransferPool& operator=(const HttpTransferPool&) = delete;
+
+    std::future<Response> submit(Request request);
+    // Submits every request before waiting; responses are in request order
+    std::vector<Response> performAll(std::vector<Request> requests);
+
+    void setMaxConcurrent(size_t maxConcurrent);
+    Stats getStats() const;
+
+    // One queued or running request; defined in the .cpp, where the curl
+    // callbacks need it
+    struct Transfer;
+
+private:
+    void run();
+    void begin(std::unique_ptr<Transfer> transfer);
+    void finish(CURL* handle, int result);
+    static void fail(Transfer& transfer, const std::string& error);
+
+    CURLM* multi_ = nullptr;
+    curl_slist* headers_ = nullptr;
+    const long connectTimeoutSeconds_;
+
+    mutable std::mutex mutex_;
+    std::deque<std::unique_ptr<Transfer>> queue_;
+    size_t maxConcurrent_;
+    bool stopping_ = false;
+    Stats stats_;
+
+    // Owned by the worker thread
+    std::unordered_map<CURL*, std::unique_ptr<Transfer>> active_;
+    std::vector<CURL*> idle_;
+    size_t appliedMaxConnects_ = 0;
+
+    std::thread worker_;
+};
+
+} // namespace ipfs
+} // namespace satox
@@ -22,11 +22,17 @@
  * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
  * SOFTWARE.
  */
-
 #include "satox/ipfs/ipfs_manager.hpp"
+#include "http_transfer_pool.hpp"
 #include <curl/curl.h>
 #include <nlohmann/json.hpp>
 #include <spdlog/spdlog.h>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <algorithm>
+#include <cerrno>
+#include <filesystem>
 #include <fstream>
 #include <sstream>
 #include <chrono>
@@ -35,6 +41,125 @@
 namespace satox {
 namespace ipfs {
 
+namespace {
+
+constexpr long DEFAULT_TIMEOUT_SECONDS = 5;
+constexpr long HEALTH_CHECK_TIMEOUT_SECONDS = 3;
+// addFiles keeps at most this many files open at once
+constexpr size_t MAX_OPEN_UPLOADS = 256;
+
+struct Upload {
+    const char* data = nullptr;
+    int fd = -1;
+    size_t size = 0;
+    std::string name = "file";
+};
+
+// No daemon listening; the operations below fall back to mock results for testing
+bool daemonUnreachable(const HttpTransferPool::Response& response) {
+    return !response.transportOk &&
+           (response.curlCode == CURLE_COULDNT_CONNECT ||
+            response.curlCode == CURLE_COULDNT_RESOLVE_HOST);
+}
+
+std::string transferError(const HttpTransferPool::Response& response) {
+    if (!response.transportOk) {
+        return response.error;
+    }
+    return "IPFS daemon returned HTTP " + std::to_string(response.status) + ": " + response.body;
+}
+
+std::string mockHash(const std::string& content) {
+    std::hash<std::string> hasher;
+    std::stringstream ss;
+    ss << "Qm" << std::hex << hasher(content);
+    return ss.str();
+}
+
+bool readUpload(const Upload& upload, std::string& content) {
+    if (upload.fd < 0) {
+        content.assign(upload.data, upload.size);
+        return true;
+    }
+    content.resize(upload.size);
+    size_t done = 0;
+    while (done < upload.size) {
+        ssize_t got = ::pread(upload.fd, &content[done], upload.size - done, static_cast<off_t>(done));
+        if (got < 0 && errno == EINTR) {
+            continue;
+        }
+        if (got <= 0) {
+            return false;
+        }
+        done += static_cast<size_t>(got);
+    }
+    return true;
+}
+
+// /api/v0/add answers with one JSON object per line; the last one names the upload
+bool parseAddResponse(const std::string& body, std::string& hash, std::string& error) {
+    std::istringstream lines(body);
+    std::string line;
+    std::string last;
+    while (std::getline(lines, line)) {
+        if (!line.empty()) {
+            last = line;
+        }
+    }
+    try {
+        auto json = nlohmann::json::parse(last);
+        hash = json.at("Hash").get<std::string>();
+        return true;
+    } catch (const std::exception& e) {
+        error = e.what();
+        return false;
+    }
+}
+
+// Runs the uploads concurrently. hashes lines up with uploads and holds an
+// empty string for every upload that failed; error keeps the last failure.
+bool uploadAll(HttpTransferPool& pool, const std::string& endpoint, long stallSeconds,
+               const std::vector<Upload>& uploads, std::vector<std::string>& hashes,
+               std::string& error) {
+    std::vector<HttpTransferPool::Request> requests;
+    requests.reserve(uploads.size());
+    for (const auto& upload : uploads) {
+        HttpTransferPool::Request request;
+        request.url = endpoint + "/api/v0/add";
+        request.upload = true;
+        request.data = upload.data;
+        request.fd = upload.fd;
+        request.size = upload.size;
+        request.fileName = upload.name;
+        request.stallSeconds = stallSeconds;
+        requests.push_back(std::move(request));
+    }
+    auto responses = pool.performAll(std::move(requests));
+
+    hashes.assign(uploads.size(), std::string());
+    bool allAdded = true;
+    for (size_t i = 0; i < uploads.size(); ++i) {
+        const auto& response = responses[i];
+        if (daemonUnreachable(response)) {
+            std::string content;
+            if (readUpload(uploads[i], content)) {
+                hashes[i] = mockHash(content);
+            } else {
+                error = "Failed to read file";
+                allAdded = false;
+            }
+        } else if (!response.ok()) {
+            error = transferError(response);
+            allAdded = false;
+        } else if (!parseAddResponse(response.body, hashes[i], error)) {
+            allAdded = false;
+        }
+    }
+    return allAdded;
+}
+
+} // namespace
+
 // Static instance
 static IPFSManager* instance = nullptr;
 
@@ -51,285 +176,348 @@ IPFSManager::Impl::Impl() : initialized_(false) {
 }
 
 IPFSManager::Impl::~Impl() {
+    pool_.reset();
     curl_global_cleanup();
 }
 
 bool IPFSManager::Impl::initialize(const Config& config) {
     try {
+        long timeout = config.timeout_seconds > 0 ? config.timeout_seconds : DEFAULT_TIMEOUT_SECONDS;
+        auto pool = std::make_shared<HttpTransferPool>(config.max_concurrent_requests, timeout);
+        // Requests already running keep the previous pool alive until they finish
+        std::shared_ptr<HttpTransferPool> previous;
+        std::lock_guard<std::mutex> lock(mutex_);
+        previous = std::move(pool_);
         config_ = config;
+        pool_ = std::move(pool);
         initialized_ = true;
         return true;
     } catch (const std::exception& e) {
-        lastError_ = e.what();
+        setError(e.what());
         return false;
     }
 }
 
-bool IPFSManager::Impl::addFile(const std::string& filePath, std::string& hash) {
-    if (!initialized_) {
+void IPFSManager::Impl::shutdown() {
+    std::shared_ptr<HttpTransferPool> pool;
+    std::lock_guard<std::mutex> lock(mutex_);
+    pool = std::move(pool_);
+    initialized_ = false;
+}
+
+bool IPFSManager::Impl::session(std::shared_ptr<HttpTransferPool>& pool, std::string& endpoint) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (!initialized_ || !pool_) {
         lastError_ = "Not initialized";
         return false;
     }
+    pool = pool_;
+    endpoint = config_.api_endpoint;
+    return true;
+}
 
-    try {
-        // For testing purposes, if we can't connect to IPFS daemon, generate a mock hash
-        CURL* curl = curl_easy_init();
-        if (!curl) {
-            lastError_ = "Failed to initialize CURL";
-            return false;
-        }
+long IPFSManager::Impl::timeoutSeconds() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return config_.timeout_seconds > 0 ? config_.timeout_seconds : DEFAULT_TIMEOUT_SECONDS;
+}
 
-        std::string url = config_.api_endpoint + "/api/v0/add";
-        curl_easy_setopt(curl, CURLOPT_URL, url.c_str());
-        curl_easy_setopt(curl, CURLOPT_TIMEOUT, 5L); // 5 second timeout for testing
-
-        struct curl_httppost* formpost = nullptr;
-        struct curl_httppost* lastptr = nullptr;
-
-        curl_formadd(&formpost, &lastptr,
-            CURLFORM_COPYNAME, "file",
-            CURLFORM_FILE, filePath.c_str(),
-            CURLFORM_END);
-
-        curl_easy_setopt(curl, CURLOPT_HTTPPOST, formpost);
-
-        std::string response;
-        curl_easy_setopt(curl, CURLOPT_WRITEFUNCTION, writeCallback);
-        curl_easy_setopt(curl, CURLOPT_WRITEDATA, &response);
-
-        CURLcode res = curl_easy_perform(curl);
-        curl_formfree(formpost);
-        curl_easy_cleanup(curl);
-
-        if (res != CURLE_OK) {
-            // If connection fails, generate a mock hash for testing
-            std::ifstream file(filePath, std::ios::binary);
-            if (file.is_open()) {
-                std::string content((std::istreambuf_iterator<char>(file)),
-                                   std::istreambuf_iterator<char>());
-                file.close();
-                
-                // Generate a simple hash based on content
-                std::hash<std::string> hasher;
-                size_t hashValue = hasher(content);
-                std::stringstream ss;
-                ss << "Qm" << std::hex << hashValue;
-                hash = ss.str();
-                return true;
-            } else {
-                lastError_ = "Failed to read file";
-                return false;
-            }
-        }
+void IPFSManager::Impl::setError(const std::string& error) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    lastError_ = error;
+}
 
-        try {
-            auto json = nlohmann::json::parse(response);
-            hash = json["Hash"].get<std::string>();
-            return true;
-        } catch (const std::exception& e) {
-            lastError_ = e.what();
-            return false;
-        }
-    } catch (const std::exception& e) {
-        lastError_ = e.what();
+bool IPFSManager::Impl::addFile(const std::string& filePath, std::string& hash) {
+    std::vector<std::string> hashes;
+    bool added = addFiles({filePath}, hashes);
+    hash = hashes.empty() ? std::string() : hashes.front();
+    return added;
+}
+
+bool IPFSManager::Impl::addFileDescriptor(int fd, std::string& hash) {
+    std::shared_ptr<HttpTransferPool> pool;
+    std::string endpoint;
+    if (!session(pool, endpoint)) {
+        return false;
+    }
+
+    struct stat info;
+    if (::fstat(fd, &info) != 0 || !S_ISREG(info.st_mode)) {
+        setError("Failed to read file");
+        return false;
+    }
+    Upload upload;
+    upload.fd = fd;
+    upload.size = static_cast<size_t>(info.st_size);
+
+    std::vector<std::string> hashes;
+    std::string error;
+    if (!uploadAll(*pool, endpoint, timeoutSeconds(), {upload}, hashes, error)) {
+        setError(error);
         return false;
     }
+    hash = hashes.front();
+    return true;
 }
 
-bool IPFSManager::Impl::getFile(const std::string& hash, const std::string& outputPath) {
-    if (!initialized_) {
-        lastError_ = "Not initialized";
+bool IPFSManager::Impl::addFiles(const std::vector<std::string>& filePaths,
+                                 std::vector<std::string>& hashes) {
+    std::shared_ptr<HttpTransferPool> pool;
+    std::string endpoint;
+    if (!session(pool, endpoint)) {
         return false;
     }
 
-    try {
-        // For testing purposes, if we can't connect to IPFS daemon, use mock data
-        CURL* curl = curl_easy_init();
-        if (!curl) {
-            lastError_ = "Failed to initialize CURL";
-            return false;
+    hashes.assign(filePaths.size(), std::string());
+    bool allAdded = true;
+    std::string error;
+    for (size_t begin = 0; begin < filePaths.size(); begin += MAX_OPEN_UPLOADS) {
+        size_t end = std::min(filePaths.size(), begin + MAX_OPEN_UPLOADS);
+        std::vector<Upload> uploads;
+        std::vector<size_t> slots;
+        for (size_t i = begin; i < end; ++i) {
+            int fd = ::open(filePaths[i].c_str(), O_RDONLY | O_CLOEXEC);
+            struct stat info;
+            if (fd < 0 || ::fstat(fd, &info) != 0 || !S_ISREG(info.st_mode)) {
+                if (fd >= 0) {
+                    ::close(fd);
+                }
+                error = "Failed to read file: " + filePaths[i];
+                allAdded = false;
+                continue;
+            }
+            Upload upload;
+            upload.fd = fd;
+            upload.size = static_cast<size_t>(info.st_size);
+            upload.name = std::filesystem::path(filePaths[i]).filename().string();
+            uploads.push_back(std::move(upload));
+            slots.push_back(i);
         }
 
-        std::string url = config_.api_endpoint + "/api/v0/cat?arg=" + hash;
-        curl_easy_setopt(curl, CURLOPT_URL, url.c_str());
-        curl_easy_setopt(curl, CURLOPT_TIMEOUT, 5L); // 5 second timeout for testing
-
-        std::ofstream outFile(outputPath, std::ios::binary);
-        if (!outFile) {
-            lastError_ = "Failed to open output file";
-            return false;
+        std::vector<std::string> added;
+        if (!uploadAll(*pool, endpoint, timeoutSeconds(), uploads, added, error)) {
+            allAdded = false;
         }
-
-        curl_easy_setopt(curl, CURLOPT_WRITEFUNCTION, writeFileCallback);
-        curl_easy_setopt(curl, CURLOPT_WRITEDATA, &outFile);
-
-        CURLcode res = curl_easy_perform(curl);
-        curl_easy_cleanup(curl);
-        outFile.close();
-
-        if (res != CURLE_OK) {
-            // If connection fails, create a mock file for testing
-            std::ofstream mockFile(outputPath);
-            if (mockFile.is_open()) {
-                mockFile << "This is a test file for IPFS";
-                mockFile.close();
-                return true;
-            } else {
-                lastError_ = "Failed to create mock file";
-                return false;
-            }
+        for (size_t j = 0; j < uploads.size(); ++j) {
+            hashes[slots[j]] = std::move(added[j]);
+            ::close(uploads[j].fd);
         }
+    }
 
-        return true;
-    } catch (const std::exception& e) {
-        lastError_ = e.what();
-        return false;
+    if (!allAdded) {
+        setError(error);
     }
+    return allAdded;
 }
 
-bool IPFSManager::Impl::pinFile(const std::string& hash) {
-    if (!initialized_) {
-        lastError_ = "Not initialized";
+bool IPFSManager::Impl::addBuffers(const std::vector<std::pair<const char*, size_t>>& buffers,
+                                   std::vector<std::string>& hashes) {
+    std::shared_ptr<HttpTransferPool> pool;
+    std::string endpoint;
+    if (!session(pool, endpoint)) {
         return false;
     }
 
-    try {
-        // For testing purposes, if we can't connect to IPFS daemon, simulate success
-        CURL* curl = curl_easy_init();
-        if (!curl) {
-            lastError_ = "Failed to initialize CURL";
-            return false;
-        }
-
-        std::string url = config_.api_endpoint + "/api/v0/pin/add?arg=" + hash;
-        curl_easy_setopt(curl, CURLOPT_URL, url.c_str());
-        curl_easy_setopt(curl, CURLOPT_TIMEOUT, 5L); // 5 second timeout for testing
+    std::vector<Upload> uploads(buffers.size());
+    for (size_t i = 0; i < buffers.size(); ++i) {
+        uploads[i].data = buffers[i].first;
+        uploads[i].size = buffers[i].second;
+    }
+    std::string error;
+    if (!uploadAll(*pool, endpoint, timeoutSeconds(), uploads, hashes, error)) {
+        setError(error);
+        return false;
+    }
+    return true;
+}
 
-        std::string response;
-        curl_easy_setopt(curl, CURLOPT_WRITEFUNCTION, writeCallback);
-        curl_easy_setopt(curl, CURLOPT_WRITEDATA, &response);
+bool IPFSManager::Impl::getFile(const std::string& hash, const std::string& outputPath) {
+    std::shared_ptr<HttpTransferPool> pool;
+    std::string endpoint;
+    if (!session(pool, endpoint)) {
+        return false;
+    }
 
-        CURLcode res = curl_easy_perform(curl);
-        curl_easy_cleanup(curl);
+    std::ofstream outFile(outputPath, std::ios::binary);
+    if (!outFile) {
+        setError("Failed to open output file");
+        return false;
+    }
 
-        if (res != CURLE_OK) {
-            // If connection fails, simulate successful pinning for testing
+    HttpTransferPool::Request request;
+    request.url = endpoint + "/api/v0/cat?arg=" + hash;
+    request.stallSeconds = timeoutSeconds();
+    request.sink = [&outFile](const char* data, size_t size) {
+        outFile.write(data, static_cast<std::streamsize>(size));
+        return static_cast<bool>(outFile);
+    };
+    auto response = pool->submit(std::move(request)).get();
+    bool written = outFile.good();
+    outFile.close();
+
+    if (daemonUnreachable(response)) {
+        // If connection fails, create a mock file for testing
+        std::ofstream mockFile(outputPath);
+        if (mockFile.is_open()) {
+            mockFile << "This is a test file for IPFS";
+            mockFile.close();
             return true;
+        } else {
+            setError("Failed to create mock file");
+            return false;
         }
-
-        return true;
-    } catch (const std::exception& e) {
-        lastError_ = e.what();
+    }
+    if (!written || !response.ok()) {
+        setError(written ? transferError(response) : "Failed to write output file");
+        std::remove(outputPath.c_str());
         return false;
     }
+    return true;
 }
 
-bool IPFSManager::Impl::unpinFile(const std::string& hash) {
-    if (!initialized_) {
-        lastError_ = "Not initialized";
+bool IPFSManager::Impl::getData(const std::string& hash, std::string& data) {
+    std::shared_ptr<HttpTransferPool> pool;
+    std::string endpoint;
+    if (!session(pool, endpoint)) {
         return false;
     }
 
-    try {
-        // For testing purposes, if we can't connect to IPFS daemon, simulate success
-        CURL* curl = curl_easy_init();
-        if (!curl) {
-            lastError_ = "Failed to initialize CURL";
-            return false;
-        }
-
-        std::string url = config_.api_endpoint + "/api/v0/pin/rm?arg=" + hash;
-        curl_easy_setopt(curl, CURLOPT_URL, url.c_str());
-        curl_easy_setopt(curl, CURLOPT_TIMEOUT, 5L); // 5 second timeout for testing
-
-        std::string response;
-        curl_easy_setopt(curl, CURLOPT_WRITEFUNCTION, writeCallback);
-        curl_easy_setopt(curl, CURLOPT_WRITEDATA, &response);
-
-        CURLcode res = curl_easy_perform(curl);
-        curl_easy_cleanup(curl);
-
-        if (res != CURLE_OK) {
-            // If connection fails, simulate successful unpinning for testing
-            return true;
-        }
+    HttpTransferPool::Request request;
+    request.url = endpoint + "/api/v0/cat?arg=" + hash;
+    request.stallSeconds = timeoutSeconds();
+    auto response = pool->submit(std::move(request)).get();
 
+    if (daemonUnreachable(response)) {
+        // If connection fails, return mock data for testing
+        data = "This is a test file for IPFS";
         return true;
-    } catch (const std::exception& e) {
-        lastError_ = e.what();
+    }
+    if (!response.ok()) {
+        setError(transferError(response));
         return false;
     }
+    data = std::move(response.body);
+    return true;
 }
 
-std::string IPFSManager::Impl::getLastError() const {
-    return lastError_;
-}
+bool IPFSManager::Impl::pinFiles(const std::string& command, const std::vector<std::string>& hashes,
+                                 std::vector<std::string>& failed) {
+    failed.clear();
+    std::shared_ptr<HttpTransferPool> pool;
+    std::string endpoint;
+    if (!session(pool, endpoint)) {
+        failed = hashes;
+        return false;
+    }
 
-size_t IPFSManager::Impl::writeCallback(void* contents, size_t size, size_t nmemb, std::string* userp) {
-    userp->append((char*)contents, size * nmemb);
-    return size * nmemb;
+    long timeout = timeoutSeconds();
+    std::vector<HttpTransferPool::Request> requests;
+    requests.reserve(hashes.size());
+    for (const auto& hash : hashes) {
+        HttpTransferPool::Request request;
+        request.url = endpoint + "/api/v0/" + command + "?arg=" + hash;
+        request.timeoutSeconds = timeout;
+        requests.push_back(std::move(request));
+    }
+    auto responses = pool->performAll(std::move(requests));
+
+    std::string error;
+    for (size_t i = 0; i < hashes.size(); ++i) {
+        // If connection fails, simulate success for testing
+        if (!responses[i].ok() && !daemonUnreachable(responses[i])) {
+            failed.push_back(hashes[i]);
+            error = transferError(responses[i]);
+        }
+    }
+    if (!failed.empty()) {
+        setError(error);
+    }
+    return failed.empty();
 }
 
-size_t IPFSManager::Impl::writeFileCallback(void* contents, size_t size, size_t nmemb, std::ofstream* file) {
-    file->write((char*)contents, size * nmemb);
-    return size * nmemb;
+std::string IPFSManager::Impl::getLastError() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return lastError_;
 }
 
 bool IPFSManager::Impl::isInitialized() const {
+    std::lock_guard<std::mutex> lock(mutex_);
     return initialized_;
 }
 
-std::string IPFSManager::Impl::getApiEndpoint() const {
-    return config_.api_endpoint;
+bool IPFSManager::Impl::isHealthy() {
+    std::shared_ptr<HttpTransferPool> pool;
+    std::string endpoint;
+    if (!session(pool, endpoint)) {
+        return false;
+    }
+
+    HttpTransferPool::Request request;
+    request.url = endpoint + "/api/v0/version";
+    request.timeoutSeconds = HEALTH_CHECK_TIMEOUT_SECONDS;
+    auto response = pool->submit(std::move(request)).get();
+
+    // Consider healthy if we can connect (even if it fails, we're healthy if initialized)
+    return response.transportOk || response.curlCode == CURLE_COULDNT_CONNECT; // CURLE_COULDNT_CONNECT means daemon not running, but manager is healthy
 }
 
 bool IPFSManager::Impl::getPinnedFiles(std::vector<std::string>& pinnedFiles) {
-    if (!initialized_) {
+    std::shared_ptr<HttpTransferPool> pool;
+    std::string endpoint;
+    if (!session(pool, endpoint)) {
         return false;
     }
 
-    try {
-        // For testing purposes, if we can't connect to IPFS daemon, return mock data
-        CURL* curl = curl_easy_init();
-        if (!curl) {
-            return false;
-        }
-
-        std::string url = config_.api_endpoint + "/api/v0/pin/ls";
-        curl_easy_setopt(curl, CURLOPT_URL, url.c_str());
-        curl_easy_setopt(curl, CURLOPT_TIMEOUT, 5L); // 5 second timeout for testing
+    HttpTransferPool::Request request;
+    request.url = endpoint + "/api/v0/pin/ls";
+    request.timeoutSeconds = timeoutSeconds();
+    auto response = pool->submit(std::move(request)).get();
 
-        std::string response;
-        curl_easy_setopt(curl, CURLOPT_WRITEFUNCTION, writeCallback);
-        curl_easy_setopt(curl, CURLOPT_WRITEDATA, &response);
-
-        CURLcode res = curl_easy_perform(curl);
-        curl_easy_cleanup(curl);
+    if (daemonUnreachable(response)) {
+        // If connection fails, return mock pinned files for testing
+        pinnedFiles.clear();
+        pinnedFiles.push_back("QmTestHash123");
+        return true;
+    }
+    if (!response.ok()) {
+        setError(transferError(response));
+        return false;
+    }
 
-        if (res != CURLE_OK) {
-            // If connection fails, return mock pinned files for testing
+    try {
+        auto json = nlohmann::json::parse(response.body);
+        if (json.contains("Keys")) {
             pinnedFiles.clear();
-            pinnedFiles.push_back("QmTestHash123");
-            return true;
-        }
-
-        try {
-            auto json = nlohmann::json::parse(response);
-            if (json.contains("Keys")) {
-                pinnedFiles.clear();
-                for (const auto& [hash, info] : json["Keys"].items()) {
-                    pinnedFiles.push_back(hash);
-                }
+            for (const auto& [hash, info] : json["Keys"].items()) {
+                pinnedFiles.push_back(hash);
             }
-            return true;
-        } catch (const std::exception& e) {
-            return false;
         }
+        return true;
     } catch (const std::exception& e) {
+        setError(e.what());
         return false;
     }
 }
 
+TransferStats IPFSManager::Impl::getTransferStats() const {
+    std::shared_ptr<HttpTransferPool> pool;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        pool = pool_;
+    }
+    TransferStats stats;
+    if (!pool) {
+        return stats;
+    }
+    auto poolStats = pool->getStats();
+    stats.completed = poolStats.completed;
+    stats.failed = poolStats.failed;
+    stats.connectionsOpened = poolStats.connectionsOpened;
+    stats.queued = poolStats.queued;
+    stats.inFlight = poolStats.inFlight;
+    stats.peakInFlight = poolStats.peakInFlight;
+    return stats;
+}
+
 // IPFSManager constructor and destructor
 IPFSManager::IPFSManager() : pimpl_(std::make_unique<Impl>()) {}
 IPFSManager::~IPFSManager() = default;
@@ -339,7 +527,7 @@ bool IPFSManager::initialize(const Config& config) {
 }
 
 void IPFSManager::shutdown() {
-    // Implementation for shutdown
+    pimpl_->shutdown();
 }
 
 bool IPFSManager::isRunning() const {
@@ -351,29 +539,7 @@ bool IPFSManager::isInitialized() const {
 }
 
 bool IPFSManager::isHealthy() const {
-    if (!pimpl_->isInitialized()) {
-        return false;
-    }
-    
-    // Basic health check - try to connect to IPFS daemon
-    try {
-        CURL* curl = curl_easy_init();
-        if (!curl) {
-            return false;
-        }
-        
-        std::string url = pimpl_->getApiEndpoint() + "/api/v0/version";
-        curl_easy_setopt(curl, CURLOPT_URL, url.c_str());
-        curl_easy_setopt(curl, CURLOPT_TIMEOUT, 3L); // 3 second timeout for health check
-        
-        CURLcode res = curl_easy_perform(curl);
-        curl_easy_cleanup(curl);
-        
-        // Consider healthy if we can connect (even if it fails, we're healthy if initialized)
-        return res == CURLE_OK || res == CURLE_COULDNT_CONNECT; // CURLE_COULDNT_CONNECT means daemon not running, but manager is healthy
-    } catch (const std::exception&) {
-        return false;
-    }
+    return pimpl_->isHealthy();
 }
 
 bool IPFSManager::addFile(const std::string& filePath, std::string& hash) {
@@ -381,21 +547,12 @@ bool IPFSManager::addFile(const std::string& filePath, std::string& hash) {
 }
 
 bool IPFSManager::addFileData(const std::string& data, std::string& hash) {
-    // Create a temporary file with the data and add it
-    std::string tempFile = "/tmp/ipfs_temp_" + std::to_string(std::time(nullptr));
-    std::ofstream file(tempFile);
-    if (!file.is_open()) {
+    std::vector<std::string> hashes;
+    if (!pimpl_->addBuffers({{data.data(), data.size()}}, hashes)) {
         return false;
     }
-    file << data;
-    file.close();
-    
-    bool result = pimpl_->addFile(tempFile, hash);
-    
-    // Clean up temporary file
-    std::remove(tempFile.c_str());
-    
-    return result;
+    hash = hashes.front();
+    return true;
 }
 
 bool IPFSManager::getFile(const std::string& hash, const std::string& outputPath) {
@@ -403,33 +560,17 @@ bool IPFSManager::getFile(const std::string& hash, const std::string& outputPath
 }
 
 bool IPFSManager::getFile(const std::string& hash, std::string& data) {
-    // Create a temporary file to store the data
-    std::string tempFile = "/tmp/ipfs_get_temp_" + std::to_string(std::time(nullptr));
-    bool result = pimpl_->getFile(hash, tempFile);
-    
-    if (result) {
-        std::ifstream file(tempFile);
-        if (file.is_open()) {
-            data = std::string((std::istreambuf_iterator<char>(file)),
-                              std::istreambuf_iterator<char>());
-            file.close();
-        } else {
-            result = false;
-        }
-    }
-    
-    // Clean up temporary file
-    std::remove(tempFile.c_str());
-    
-    return result;
+    return pimpl_->getData(hash, data);
 }
 
 bool IPFSManager::pinFile(const std::string& hash) {
-    return pimpl_->pinFile(hash);
+    std::vector<std::string> failed;
+    return pimpl_->pinFiles("pin/add", {hash}, failed);
 }
 
 bool IPFSManager::unpinFile(const std::string& hash) {
-    return pimpl_->unpinFile(hash);
+    std::vector<std::string> failed;
+    return pimpl_->pinFiles("pin/rm", {hash}, failed);
 }
 
 bool IPFSManager::getPinnedFiles(std::vector<std::string>& pinnedFiles) {
@@ -440,12 +581,41 @@ std::string IPFSManager::getLastError() const {
     return pimpl_->getLastError();
 }
 
-// Placeholder implementations for additional operations
+bool IPFSManager::addFileDescriptor(int fd, std::string& hash) {
+    return pimpl_->addFileDescriptor(fd, hash);
+}
+
+bool IPFSManager::addFiles(const std::vector<std::string>& filePaths, std::vector<std::string>& hashes) {
+    return pimpl_->addFiles(filePaths, hashes);
+}
+
+bool IPFSManager::addDataBatch(const std::vector<std::vector<uint8_t>>& items,
+                               std::vector<std::string>& hashes) {
+    std::vector<std::pair<const char*, size_t>> buffers;
+    buffers.reserve(items.size());
+    for (const auto& item : items) {
+        buffers.emplace_back(reinterpret_cast<const char*>(item.data()), item.size());
+    }
+    return pimpl_->addBuffers(buffers, hashes);
+}
+
+bool IPFSManager::pinFiles(const std::vector<std::string>& hashes, std::vector<std::string>& failed) {
+    return pimpl_->pinFiles("pin/add", hashes, failed);
+}
+
+TransferStats IPFSManager::getTransferStats() const {
+    return pimpl_->getTransferStats();
+}
+
 std::string IPFSManager::addData(const std::vector<uint8_t>& data) {
-    // TODO: Implement
-    return "";
+    std::vector<std::string> hashes;
+    if (!pimpl_->addBuffers({{reinterpret_cast<const char*>(data.data()), data.size()}}, hashes)) {
+        return "";
+    }
+    return hashes.front();
 }
 
+// Placeholder implementations for additional operations
 std::vector<uint8_t> IPFSManager::getData(const std::string& ipfs_hash) {
     // TODO: Implement
     return {};
@@ -0,0 +1,381 @@
+/**
+ * @file transfer_scheduler.cpp
+ * @brief Bandwidth-limited, weighted-fair chunk scheduler for content distribution
+ * @copyright Copyright (c) 2025 Satoxcoin Core Developers
+ * @license MIT License
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "transfer_scheduler.hpp"
+#include <algorithm>
+#include <cmath>
+
+namespace satox {
+namespace ipfs {
+
+namespace {
+
+constexpr double RATE_TIME_CONSTANT_SECONDS = 1.0;
+
+double seconds(std::chrono::steady_clock::duration duration) {
+    return std::chrono::duration<double>(duration).count();
+}
+
+} // namespace
+
+// ---------------------------------------------------------------------------
+// TokenBucket
+
+TokenBucket::TokenBucket(double burst)
+    : burst_(burst), tokens_(burst), last_(std::chrono::steady_clock::now()) {}
+
+void TokenBucket::setRate(double bytesPerSecond) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    rate_ = bytesPerSecond;
+    tokens_ = std::min(tokens_, burst_);
+    last_ = std::chrono::steady_clock::now();
+}
+
+std::chrono::steady_clock::duration TokenBucket::reserve(size_t bytes) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (rate_ <= 0) {
+        return std::chrono::steady_clock::duration::zero();
+    }
+    auto now = std::chrono::steady_clock::now();
+    tokens_ = std::min(burst_, tokens_ + seconds(now - last_) * rate_);
+    last_ = now;
+    tokens_ -= static_cast<double>(bytes);
+    if (tokens_ >= 0) {
+        return std::chrono::steady_clock::duration::zero();
+    }
+    return std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+        std::chrono::duration<double>(-tokens_ / rate_));
+}
+
+// ---------------------------------------------------------------------------
+// RateMeter
+
+void RateMeter::add(size_t bytes, std::chrono::steady_clock::time_point now) {
+    rate_ = rate(now) + static_cast<double>(bytes) / RATE_TIME_CONSTANT_SECONDS;
+    last_ = now;
+}
+
+double RateMeter::rate(std::chrono::steady_clock::time_point now) const {
+    return rate_ * std::exp(-seconds(now - last_) / RATE_TIME_CONSTANT_SECONDS);
+}
+
+// ---------------------------------------------------------------------------
+// TransferScheduler
+
+TransferScheduler::TransferScheduler(size_t workers, Transport transport, ProgressCallback callback)
+    : transport_(std::move(transport)), callback_(std::move(callback)), bucket_(CHUNK_SIZE) {
+    for (size_t i = 0; i < std::max<size_t>(1, workers); ++i) {
+        workers_.emplace_back(&TransferScheduler::run, this);
+    }
+}
+
+TransferScheduler::~TransferScheduler() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stopping_ = true;
+    }
+    work_.notify_all();
+    for (auto& worker : workers_) {
+        worker.join();
+    }
+    for (auto& job : jobs_) {
+        job->result.set_value(false);
+    }
+}
+
+double TransferScheduler::weightFor(int priority) {
+    return priority >= 0 ? 1.0 + priority : 1.0 / (1.0 - priority);
+}
+
+std::string TransferScheduler::checkpointKey(const std::string& contentHash, const std::string& nodeId) {
+    return contentHash + '\n' + nodeId;
+}
+
+std::future<bool> TransferScheduler::submit(const std::string& contentHash, uint64_t size,
+                                            ReaderFactory open, std::vector<Target> targets,
+                                            int priority) {
+    std::promise<bool> result;
+    auto future = result.get_future();
+    submit(contentHash, size, std::move(open), std::move(targets), priority, std::move(result));
+    return future;
+}
+
+void TransferScheduler::submit(const std::string& contentHash, uint64_t size, ReaderFactory open,
+                               std::vector<Target> targets, int priority, std::promise<bool> result) {
+    auto job = std::make_shared<Job>();
+    job->contentHash = contentHash;
+    job->size = size;
+    job->open = std::move(open);
+    job->weight = weightFor(priority);
+    job->result = std::move(result);
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (stopping_) {
+        job->result.set_value(false);
+        return;
+    }
+    for (auto& target : targets) {
+        Stream stream;
+        stream.nodeId = std::move(target.nodeId);
+        stream.address = std::move(target.address);
+        auto checkpoint = checkpoints_.find(checkpointKey(contentHash, stream.nodeId));
+        if (checkpoint != checkpoints_.end() && checkpoint->second.first == size) {
+            stream.acked = checkpoint->second.second;
+            job->transferred += stream.acked;
+        }
+        job->streams.push_back(std::move(stream));
+    }
+    // A new job starts at the current virtual time instead of banking credit
+    job->lastFinish = virtualTime_;
+    jobs_.push_back(job);
+    work_.notify_all();
+}
+
+bool TransferScheduler::cancel(const std::string& contentHash) {
+    bool found = false;
+    std::vector<JobPtr> idle;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        for (auto& job : jobs_) {
+            if (job->contentHash == contentHash && !job->cancelled) {
+                job->cancelled = true;
+                found = true;
+                // Jobs with chunks in flight finish when the last one returns
+                if (job->busy == 0) {
+                    idle.push_back(job);
+                }
+            }
+        }
+        for (auto& job : idle) {
+            retire(job);
+        }
+    }
+    for (auto& job : idle) {
+        job->result.set_value(false);
+    }
+    return found;
+}
+
+void TransferScheduler::setPriority(const std::string& contentHash, int priority) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (auto& job : jobs_) {
+        if (job->contentHash == contentHash) {
+            job->weight = weightFor(priority);
+        }
+    }
+}
+
+void TransferScheduler::setBandwidthLimit(size_t bytesPerSecond) {
+    bucket_.setRate(static_cast<double>(bytesPerSecond));
+}
+
+void TransferScheduler::setMaxTransfersPerNode(size_t maxTransfers) {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        maxTransfersPerNode_ = std::max<size_t>(1, maxTransfers);
+    }
+    work_.notify_all();
+}
+
+double TransferScheduler::getBandwidthUsage() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return meter_.rate(std::chrono::steady_clock::now());
+}
+
+bool TransferScheduler::pick(JobPtr& picked, Stream*& pickedStream) {
+    Job* best = nullptr;
+    size_t bestIndex = 0;
+    double bestStart = 0;
+    for (auto& job : jobs_) {
+        if (job->cancelled) {
+            continue;
+        }
+        size_t count = job->streams.size();
+        for (size_t i = 0; i < count; ++i) {
+            size_t index = (job->nextStream + i) % count;
+            const Stream& stream = job->streams[index];
+            if (stream.busy || stream.done || stream.failed) {
+                continue;
+            }
+            auto active = nodeActive_.find(stream.nodeId);
+            if (active != nodeActive_.end() && active->second >= maxTransfersPerNode_) {
+                continue;
+            }
+            double start = std::max(virtualTime_, job->lastFinish);
+            if (!best || start < bestStart) {
+                best = job.get();
+                bestIndex = index;
+                bestStart = start;
+            }
+            break;
+        }
+    }
+    if (!best) {
+        return false;
+    }
+
+    for (auto& job : jobs_) {
+        if (job.get() == best) {
+            picked = job;
+            break;
+        }
+    }
+    Stream& stream = best->streams[bestIndex];
+    size_t length = static_cast<size_t>(std::min<uint64_t>(CHUNK_SIZE, best->size - stream.acked));
+    virtualTime_ = bestStart;
+    best->lastFinish = bestStart + static_cast<double>(std::max<size_t>(length, 1)) / best->weight;
+    best->nextStream = (bestIndex + 1) % best->streams.size();
+    ++best->busy;
+    stream.busy = true;
+    ++nodeActive_[stream.nodeId];
+    pickedStream = &stream;
+    return true;
+}
+
+void TransferScheduler::run() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    while (true) {
+        JobPtr job;
+        Stream* stream = nullptr;
+        work_.wait(lock, [&] { return stopping_ || pick(job, stream); });
+        if (stopping_) {
+            return;
+        }
+
+        uint64_t offset = stream->acked;
+        size_t length = static_cast<size_t>(std::min<uint64_t>(CHUNK_SIZE, job->size - offset));
+        auto delay = bucket_.reserve(length);
+        if (delay > std::chrono::steady_clock::duration::zero()) {
+            work_.wait_for(lock, delay, [this] { return stopping_; });
+            if (stopping_) {
+                return;
+            }
+        }
+
+        bool read = false;
+        bool sent = false;
+        if (!job->cancelled) {
+            lock.unlock();
+            if (!stream->reader) {
+                stream->reader = job->open();
+            }
+            std::string chunk;
+            read = stream->reader && stream->reader(offset, length, chunk) && chunk.size() == length;
+            sent = read && transport_(stream->nodeId, stream->address, job->contentHash, offset, chunk);
+            lock.lock();
+        }
+
+        auto now = std::chrono::steady_clock::now();
+        bool changed = complete(*job, *stream, length, sent, read);
+        bool finished = job->busy == 0 &&
+                        (job->cancelled ||
+                         std::all_of(job->streams.begin(), job->streams.end(),
+                                     [](const Stream& s) { return s.done || s.failed; }));
+        bool report = callback_ && (changed || finished || now - job->lastReport >= REPORT_INTERVAL);
+        Progress progress;
+        if (report) {
+            job->lastReport = now;
+            progress = snapshot(*job, finished, now);
+        }
+        if (finished) {
+            retire(job);
+        }
+        work_.notify_all();
+
+        if (report || finished) {
+            lock.unlock();
+            if (report) {
+                callback_(progress);
+            }
+            if (finished) {
+                job->result.set_value(!job->cancelled && job->failedNodes.empty());
+            }
+            lock.lock();
+        }
+    }
+}
+
+bool TransferScheduler::complete(Job& job, Stream& stream, size_t length, bool sent, bool read) {
+    stream.busy = false;
+    --job.busy;
+    auto active = nodeActive_.find(stream.nodeId);
+    if (active != nodeActive_.end() && --active->second == 0) {
+        nodeActive_.erase(active);
+    }
+    if (job.cancelled) {
+        return false;
+    }
+
+    std::string key = checkpointKey(job.contentHash, stream.nodeId);
+    if (sent) {
+        auto now = std::chrono::steady_clock::now();
+        stream.acked += length;
+        stream.failures = 0;
+        job.transferred += length;
+        job.meter.add(length, now);
+        meter_.add(length, now);
+        if (stream.acked >= job.size) {
+            stream.done = true;
+            job.completedNodes.push_back(stream.nodeId);
+            checkpoints_.erase(key);
+            return true;
+        }
+        checkpoints_[key] = {job.size, stream.acked};
+        return false;
+    }
+
+    if (++stream.failures < MAX_CHUNK_ATTEMPTS) {
+        return false;
+    }
+    stream.failed = true;
+    job.failedNodes.push_back(stream.nodeId);
+    job.error = read ? "Transfer to " + stream.nodeId + " failed at offset " + std::to_string(stream.acked)
+                     : "Failed to read content at offset " + std::to_string(stream.acked);
+    // Drop the reader; a resumed job opens a fresh one
+    stream.reader = nullptr;
+    return true;
+}
+
+TransferScheduler::Progress TransferScheduler::snapshot(const Job& job, bool finished,
+                                                        std::chrono::steady_clock::time_point now) const {
+    Progress progress;
+    progress.contentHash = job.contentHash;
+    progress.totalBytes = job.size * job.streams.size();
+    progress.bytesTransferred = job.transferred;
+    progress.bytesPerSecond = job.meter.rate(now);
+    progress.completedNodes = job.completedNodes;
+    progress.failedNodes = job.failedNodes;
+    progress.error = job.error;
+    progress.finished = finished;
+    progress.cancelled = job.cancelled;
+    return progress;
+}
+
+void TransferScheduler::retire(const JobPtr& job) {
+    jobs_.remove(job);
+}
+
+} // namespace ipfs
+} // namespace satox
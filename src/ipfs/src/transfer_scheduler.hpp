@@ -0,0 +1,199 @@
+/**
+ * @file transfer_scheduler.hpp
+ * @brief Bandwidth-limited, weighted-fair chunk scheduler for content distribution
+ * @copyright Copyright (c) 2025 Satoxcoin Core Developers
+ * @license MIT License
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#pragma once
+
+#include "satox/ipfs/content_distribution.hpp"
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <future>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+namespace satox {
+namespace ipfs {
+
+// Refills at a fixed byte rate, holding at most burst bytes. reserve() always
+// succeeds and returns how long the caller has to wait before sending, so
+// concurrent senders line up behind each other's debt. Rate 0 is unlimited.
+class TokenBucket {
+public:
+    explicit TokenBucket(double burst);
+
+    void setRate(double bytesPerSecond);
+    std::chrono::steady_clock::duration reserve(size_t bytes);
+
+private:
+    std::mutex mutex_;
+    double rate_ = 0;
+    const double burst_;
+    double tokens_;
+    std::chrono::steady_clock::time_point last_;
+};
+
+// Exponentially decaying byte rate with a one second time constant
+class RateMeter {
+public:
+    void add(size_t bytes, std::chrono::steady_clock::time_point now);
+    double rate(std::chrono::steady_clock::time_point now) const;
+
+private:
+    double rate_ = 0;
+    std::chrono::steady_clock::time_point last_;
+};
+
+/**
+ * Moves distribution jobs to their target nodes in CHUNK_SIZE pieces.
+ *
+ * A job keeps one stream per target node. A stream sends its chunks in
+ * order, one at a time, and remembers how many bytes the node acknowledged.
+ * Workers pick the next chunk with start-time fair queuing across jobs,
+ * weighted by priority, skip nodes that already have maxTransfersPerNode
+ * chunks in flight, and take the chunk's bytes from a global token bucket
+ * before sending it.
+ *
+ * A chunk is tried MAX_CHUNK_ATTEMPTS times before its stream fails. The
+ * acknowledged offset of an unfinished stream is kept, and a later job for
+ * the same content, size and node starts from there.
+ */
+class TransferScheduler {
+public:
+    static constexpr size_t CHUNK_SIZE = 256 * 1024;
+    static constexpr int MAX_CHUNK_ATTEMPTS = 3;
+    static constexpr std::chrono::milliseconds REPORT_INTERVAL{250};
+
+    // Fills chunk with size bytes from offset
+    using Reader = std::function<bool(uint64_t offset, size_t size, std::string& chunk)>;
+    // Called once per stream; each stream reads from one thread at a time
+    using ReaderFactory = std::function<Reader()>;
+    using Transport = ContentDistribution::ChunkTransport;
+
+    struct Target {
+        std::string nodeId;
+        std::string address;
+    };
+
+    struct Progress {
+        std::string contentHash;
+        uint64_t totalBytes = 0;
+        uint64_t bytesTransferred = 0;       // acknowledged, including resumed bytes
+        double bytesPerSecond = 0;
+        std::vector<std::string> completedNodes;
+        std::vector<std::string> failedNodes;
+        std::string error;
+        bool finished = false;
+        bool cancelled = false;
+    };
+    // Runs on worker threads with no scheduler lock held
+    using ProgressCallback = std::function<void(const Progress&)>;
+
+    TransferScheduler(size_t workers, Transport transport, ProgressCallback callback);
+    // Cancels every job; their futures turn false
+    ~TransferScheduler();
+    TransferScheduler(const TransferScheduler&) = delete;
+    TransferScheduler& operator=(const TransferScheduler&) = delete;
+
+    // True once every target acknowledged the whole content
+    std::future<bool> submit(const std::string& contentHash, uint64_t size, ReaderFactory open,
+                             std::vector<Target> targets, int priority);
+    // Same, settling a promise whose future the caller already handed out
+    void submit(const std::string& contentHash, uint64_t size, ReaderFactory open,
+                std::vector<Target> targets, int priority, std::promise<bool> result);
+    bool cancel(const std::string& contentHash);
+    void setPriority(const std::string& contentHash, int priority);
+
+    void setBandwidthLimit(size_t bytesPerSecond);
+    void setMaxTransfersPerNode(size_t maxTransfers);
+    double getBandwidthUsage() const;
+
+    // Priority 0 weighs 1, each step up adds 1, each step down divides
+    static double weightFor(int priority);
+
+private:
+    struct Stream {
+        std::string nodeId;
+        std::string address;
+        uint64_t acked = 0;
+        int failures = 0;
+        bool busy = false;
+        bool done = false;
+        bool failed = false;
+        Reader reader;                       // touched only by the worker holding busy
+    };
+
+    struct Job {
+        std::string contentHash;
+        uint64_t size = 0;
+        ReaderFactory open;
+        double weight = 1;
+        double lastFinish = 0;               // virtual finish tag of the last chunk
+        std::vector<Stream> streams;
+        size_t nextStream = 0;
+        size_t busy = 0;
+        uint64_t transferred = 0;
+        RateMeter meter;
+        std::chrono::steady_clock::time_point lastReport;
+        std::vector<std::string> completedNodes;
+        std::vector<std::string> failedNodes;
+        std::string error;
+        bool cancelled = false;
+        std::promise<bool> result;
+    };
+    using JobPtr = std::shared_ptr<Job>;
+
+    void run();
+    bool pick(JobPtr& job, Stream*& stream);
+    // Returns true when the job has nothing left to run
+    bool complete(Job& job, Stream& stream, size_t length, bool sent, bool read);
+    Progress snapshot(const Job& job, bool finished, std::chrono::steady_clock::time_point now) const;
+    void retire(const JobPtr& job);
+    static std::string checkpointKey(const std::string& contentHash, const std::string& nodeId);
+
+    const Transport transport_;
+    const ProgressCallback callback_;
+    TokenBucket bucket_;
+
+    mutable std::mutex mutex_;
+    std::condition_variable work_;
+    std::list<JobPtr> jobs_;
+    std::unordered_map<std::string, size_t> nodeActive_;
+    // contentHash '\n' nodeId -> (content size, bytes acknowledged)
+    std::unordered_map<std::string, std::pair<uint64_t, uint64_t>> checkpoints_;
+    double virtualTime_ = 0;
+    size_t maxTransfersPerNode_ = 2;
+    RateMeter meter_;
+    bool stopping_ = false;
+    std::vector<std::thread> workers_;
+};
+
+} // namespace ipfs
+} // namespace satox
@@ -0,0 +1,312 @@
+/**
+ * @file content_distribution_test.cpp
+ * @brief Tests for the ContentDistribution transfer scheduler
+ * @copyright Copyright (c) 2025 Satoxcoin Core Developers
+ * @license MIT License
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <gtest/gtest.h>
+#include "satox/ipfs/content_distribution.hpp"
+#include "satox/ipfs/content_storage.hpp"
+#include <algorithm>
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <map>
+#include <openssl/evp.h>
+#include <mutex>
+#include <random>
+#include <thread>
+
+namespace satox::ipfs::tests {
+
+namespace {
+    constexpr size_t MiB = 1024 * 1024;
+
+    std::string randomBytes(size_t size, uint32_t seed) {
+        std::mt19937 rng(seed);
+        std::string data(size, '\0');
+        for (auto& c : data) {
+            c = static_cast<char>(rng());
+        }
+        return data;
+    }
+
+    // Distributions of a file are keyed by the SHA-256 of its bytes
+    std::string sha256Hex(const std::string& data) {
+        unsigned char hash[EVP_MAX_MD_SIZE];
+        unsigned int length = 0;
+        EVP_Digest(data.data(), data.size(), hash, &length, EVP_sha256(), nullptr);
+        static const char digits[] = "0123456789abcdef";
+        std::string hex;
+        for (unsigned int i = 0; i < length; ++i) {
+            hex += digits[hash[i] >> 4];
+            hex += digits[hash[i] & 0xf];
+        }
+        return hex;
+    }
+
+    struct Delivery {
+        std::string contentHash;
+        std::string nodeId;
+        uint64_t offset;
+        size_t size;
+    };
+}
+
+class ContentDistributionTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        dir = std::filesystem::temp_directory_path() / "satox_content_distribution_test";
+        std::filesystem::remove_all(dir);
+        std::filesystem::create_directories(dir);
+        nlohmann::json config;
+        config["nodes"] = nlohmann::json::array();
+        for (int i = 1; i <= 4; ++i) {
+            config["nodes"].push_back({{"id", "n" + std::to_string(i)}, {"address", "http://node" + std::to_string(i)}});
+        }
+        config["bandwidthLimit"] = 0;
+        std::ofstream((dir / "config.json").string()) << config.dump();
+        ASSERT_TRUE(distribution.initialize((dir / "config.json").string()));
+        useTransport();
+    }
+
+    void TearDown() override {
+        distribution.shutdown();
+        std::filesystem::remove_all(dir);
+    }
+
+    // Records every chunk; fail decides which ones the node rejects
+    void useTransport(int delayMs = 0,
+                      std::function<bool(const std::string&, uint64_t)> fail = nullptr) {
+        distribution.setChunkTransport([this, delayMs, fail](const std::string& nodeId, const std::string&,
+                                                             const std::string& contentHash, uint64_t offset,
+                                                             const std::string& chunk) {
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                int running = ++inFlight[nodeId];
+                peakPerNode[nodeId] = std::max(peakPerNode[nodeId], running);
+            }
+            std::this_thread::sleep_for(std::chrono::milliseconds(delayMs));
+            std::lock_guard<std::mutex> lock(mutex);
+            --inFlight[nodeId];
+            if (fail && fail(nodeId, offset)) {
+                return false;
+            }
+            deliveries.push_back({contentHash, nodeId, offset, chunk.size()});
+            received[contentHash + "/" + nodeId].resize(std::max<size_t>(received[contentHash + "/" + nodeId].size(), offset + chunk.size()));
+            received[contentHash + "/" + nodeId].replace(offset, chunk.size(), chunk);
+            return true;
+        });
+    }
+
+    std::string writeFile(const std::string& name, const std::string& data) {
+        std::string path = (dir / name).string();
+        std::ofstream(path, std::ios::binary) << data;
+        return path;
+    }
+
+    ContentDistribution& distribution = ContentDistribution::getInstance();
+    std::filesystem::path dir;
+    std::mutex mutex;
+    std::vector<Delivery> deliveries;
+    std::map<std::string, std::string> received;
+    std::map<std::string, int> inFlight;
+    std::map<std::string, int> peakPerNode;
+};
+
+TEST_F(ContentDistributionTest, DeliversFileToEveryNode) {
+    const std::string data = randomBytes(MiB + 12345, 1);
+    const std::string hash = sha256Hex(data);
+    ASSERT_TRUE(distribution.distributeFile(writeFile("a.bin", data), {"n1", "n2", "n3", "unknown"}).get());
+
+    for (const auto& node : {"n1", "n2", "n3"}) {
+        EXPECT_EQ(received[hash + "/" + std::string(node)], data);
+    }
+    auto status = distribution.getDistributionStatus(hash);
+    EXPECT_EQ(status.status, "completed");
+    EXPECT_EQ(status.progress, 100u);
+    EXPECT_EQ(status.totalBytes, 3 * data.size());
+    EXPECT_EQ(status.bytesTransferred, status.totalBytes);
+    EXPECT_EQ(status.completedNodes.size(), 3u);
+}
+
+TEST_F(ContentDistributionTest, BandwidthLimitIsEnforced) {
+    distribution.setBandwidthLimit(MiB);
+    const std::string data = randomBytes(MiB + MiB / 4, 2);
+    auto start = std::chrono::steady_clock::now();
+    ASSERT_TRUE(distribution.distributeFile(writeFile("slow.bin", data), {"n1"}).get());
+    double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    // One chunk of burst, the remaining MiB at 1 MiB/s
+    EXPECT_GE(elapsed, 0.9);
+    EXPECT_LT(elapsed, 3.0);
+    EXPECT_GT(distribution.getCurrentBandwidthUsage(), 0u);
+}
+
+TEST_F(ContentDistributionTest, HigherPriorityGetsLargerShare) {
+    useTransport(5);
+    distribution.setMaxTransfersPerNode(8);
+    const std::string urgentData = randomBytes(MiB, 4);
+    const std::string urgentHash = sha256Hex(urgentData);
+    distribution.setDistributionPriority(urgentHash, 3);
+    const std::vector<std::string> nodes = {"n1", "n2", "n3", "n4"};
+    std::string bulkPath = writeFile("bulk.bin", randomBytes(MiB, 3));
+    std::string urgentPath = writeFile("urgent.bin", urgentData);
+    auto bulk = distribution.distributeFile(bulkPath, nodes);
+    auto urgent = distribution.distributeFile(urgentPath, nodes);
+    ASSERT_TRUE(urgent.get());
+    ASSERT_TRUE(bulk.get());
+
+    // Weights 4:1; with equal priorities bulk sends about as many chunks as
+    // urgent. Counted from urgent's first chunk, since the files are hashed
+    // in the background and bulk may start sending first.
+    size_t urgentChunks = 0;
+    size_t bulkChunks = 0;
+    for (const auto& delivery : deliveries) {
+        if (delivery.contentHash == urgentHash) {
+            if (++urgentChunks == 16) {
+                break;
+            }
+        } else if (urgentChunks > 0) {
+            ++bulkChunks;
+        }
+    }
+    EXPECT_EQ(urgentChunks, 16u);
+    EXPECT_LE(bulkChunks, 10u);
+}
+
+TEST_F(ContentDistributionTest, PerNodeCapLimitsConcurrentChunks) {
+    useTransport(5);
+    distribution.setMaxTransfersPerNode(1);
+    std::vector<std::future<bool>> results;
+    for (int i = 0; i < 3; ++i) {
+        std::string name = "capped" + std::to_string(i) + ".bin";
+        results.push_back(distribution.distributeFile(writeFile(name, randomBytes(MiB / 2, 10 + i)), {"n1", "n2"}));
+    }
+    for (auto& result : results) {
+        EXPECT_TRUE(result.get());
+    }
+    EXPECT_EQ(peakPerNode["n1"], 1);
+    EXPECT_EQ(peakPerNode["n2"], 1);
+}
+
+TEST_F(ContentDistributionTest, FailedNodeResumesFromLastAcknowledgedChunk) {
+    const std::string data = randomBytes(MiB, 5);
+    const std::string hash = sha256Hex(data);
+    std::string path = writeFile("resume.bin", data);
+    useTransport(0, [](const std::string& nodeId, uint64_t offset) { return nodeId == "n2" && offset >= 512 * 1024; });
+    EXPECT_FALSE(distribution.distributeFile(path, {"n1", "n2"}).get());
+
+    auto status = distribution.getDistributionStatus(hash);
+    EXPECT_EQ(status.status, "failed");
+    EXPECT_EQ(status.completedNodes, std::vector<std::string>{"n1"});
+    EXPECT_EQ(status.failedNodes, std::vector<std::string>{"n2"});
+    EXPECT_EQ(status.bytesTransferred, data.size() + 512 * 1024);
+    EXPECT_FALSE(status.error.empty());
+
+    // A file with other bytes under the same name starts from scratch
+    useTransport();
+    deliveries.clear();
+    std::filesystem::create_directories(dir / "other");
+    const std::string other = randomBytes(MiB, 9);
+    EXPECT_TRUE(distribution.distributeFile(writeFile("other/resume.bin", other), {"n2"}).get());
+    ASSERT_FALSE(deliveries.empty());
+    EXPECT_EQ(deliveries.front().offset, 0u);
+
+    // The same bytes under another name resume where n2 stopped
+    deliveries.clear();
+    std::filesystem::rename(path, dir / "renamed.bin");
+    EXPECT_TRUE(distribution.distributeFile((dir / "renamed.bin").string(), {"n2"}).get());
+    ASSERT_FALSE(deliveries.empty());
+    EXPECT_EQ(deliveries.front().offset, 512u * 1024);
+    EXPECT_EQ(received[hash + "/n2"], data);
+}
+
+TEST_F(ContentDistributionTest, StatusCallbackReportsThroughput) {
+    distribution.setBandwidthLimit(2 * MiB);
+    std::mutex statusMutex;
+    std::vector<ContentDistribution::DistributionStatus> statuses;
+    distribution.setStatusCallback([&](const ContentDistribution::DistributionStatus& status) {
+        std::lock_guard<std::mutex> lock(statusMutex);
+        statuses.push_back(status);
+    });
+    ASSERT_TRUE(distribution.distributeFile(writeFile("watched.bin", randomBytes(MiB, 6)), {"n1"}).get());
+
+    std::lock_guard<std::mutex> lock(statusMutex);
+    ASSERT_GE(statuses.size(), 2u);
+    EXPECT_EQ(statuses.back().status, "completed");
+    bool sawThroughput = std::any_of(statuses.begin(), statuses.end(), [](const auto& status) {
+        return status.status == "in_progress" && status.bytesPerSecond > 0 && status.bytesTransferred > 0;
+    });
+    EXPECT_TRUE(sawThroughput);
+}
+
+TEST_F(ContentDistributionTest, CancelStopsSending) {
+    distribution.setBandwidthLimit(MiB / 2);
+    const std::string data = randomBytes(4 * MiB, 7);
+    const std::string hash = sha256Hex(data);
+    auto result = distribution.distributeFile(writeFile("big.bin", data), {"n1"});
+    std::this_thread::sleep_for(std::chrono::milliseconds(300));
+    EXPECT_TRUE(distribution.cancelDistribution(hash));
+    ASSERT_EQ(result.wait_for(std::chrono::seconds(2)), std::future_status::ready);
+    EXPECT_FALSE(result.get());
+    EXPECT_EQ(distribution.getDistributionStatus(hash).status, "cancelled");
+    EXPECT_LT(deliveries.size(), 16u);
+}
+
+TEST_F(ContentDistributionTest, DistributesDirectoryFilesTogether) {
+    useTransport(5);
+    std::filesystem::create_directories(dir / "tree/nested");
+    const std::string first = randomBytes(MiB / 2, 20);
+    const std::string second = randomBytes(MiB / 2, 21);
+    writeFile("tree/first.bin", first);
+    writeFile("tree/nested/second.bin", second);
+    writeFile("tree/nested/copy.bin", first);
+
+    ASSERT_TRUE(distribution.distributeDirectory((dir / "tree").string(), {"n1"}).get());
+    EXPECT_EQ(received[sha256Hex(first) + "/n1"], first);
+    EXPECT_EQ(received[sha256Hex(second) + "/n1"], second);
+    // Identical files are sent once, and the two distributions interleave
+    EXPECT_EQ(deliveries.size(), 4u);
+    ASSERT_FALSE(deliveries.empty());
+    EXPECT_NE(deliveries[0].contentHash, deliveries[1].contentHash);
+
+    EXPECT_FALSE(distribution.distributeDirectory((dir / "missing").string(), {"n1"}).get());
+    EXPECT_EQ(distribution.getLastError().code, 5);
+}
+
+TEST_F(ContentDistributionTest, DistributesContentFromLocalStorage) {
+    auto& storage = ContentStorage::getInstance();
+    ASSERT_TRUE(storage.initialize((dir / "storage").string()));
+    const std::string data = randomBytes(700 * 1024, 8);
+    auto info = storage.storeContent(data).get();
+    ASSERT_FALSE(info.hash.empty());
+
+    EXPECT_TRUE(distribution.distributeContent(info.hash, {"n1", "n2"}).get());
+    EXPECT_EQ(received[info.hash + "/n1"], data);
+    EXPECT_EQ(received[info.hash + "/n2"], data);
+    EXPECT_FALSE(distribution.distributeContent("missing", {"n1"}).get());
+    EXPECT_EQ(distribution.getLastError().code, 11);
+    storage.shutdown();
+}
+
+} // namespace satox::ipfs::tests
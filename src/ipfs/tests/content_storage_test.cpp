@@ -0,0 +1,335 @@
+/**
+ * @file content_storage_test.cpp
+ * @brief Tests for the chunked ContentStorage
+ * @copyright Copyright (c) 2025 Satoxcoin Core Developers
+ * @license MIT License
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <gtest/gtest.h>
+#include "satox/ipfs/content_storage.hpp"
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <random>
+#include <sstream>
+#include <openssl/evp.h>
+
+namespace satox::ipfs::tests {
+
+namespace {
+    std::string randomBytes(size_t size, uint32_t seed) {
+        std::mt19937 rng(seed);
+        std::string data(size, '\0');
+        for (auto& c : data) {
+            c = static_cast<char>(rng());
+        }
+        return data;
+    }
+
+    std::string sha256(const std::string& data) {
+        unsigned char hash[EVP_MAX_MD_SIZE];
+        unsigned int length = 0;
+        EVP_Digest(data.data(), data.size(), hash, &length, EVP_sha256(), nullptr);
+        std::ostringstream hex;
+        for (unsigned int i = 0; i < length; ++i) {
+            hex << std::hex << std::setw(2) << std::setfill('0') << static_cast<int>(hash[i]);
+        }
+        return hex.str();
+    }
+}
+
+class ContentStorageTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        path = (std::filesystem::temp_directory_path() / "satox_content_storage_test").string();
+        std::filesystem::remove_all(path);
+        ASSERT_TRUE(storage.initialize(path));
+    }
+
+    void TearDown() override {
+        storage.shutdown();
+        std::filesystem::remove_all(path);
+    }
+
+    ContentStorage::ContentInfo store(const std::string& data, size_t piece) {
+        auto writer = storage.openWriter();
+        EXPECT_NE(writer, nullptr);
+        for (size_t offset = 0; offset < data.size(); offset += piece) {
+            EXPECT_TRUE(writer->write(data.data() + offset, std::min(piece, data.size() - offset)));
+        }
+        return writer->finish();
+    }
+
+    std::string path;
+    ContentStorage& storage = ContentStorage::getInstance();
+};
+
+TEST_F(ContentStorageTest, StreamingRoundTrip) {
+    const std::string data = randomBytes(6 * 1024 * 1024 + 123, 1);
+    auto info = store(data, 100003);
+    ASSERT_EQ(info.hash, sha256(data));
+    EXPECT_EQ(info.size, data.size());
+    EXPECT_GT(storage.getChunkCount(), 6u);
+
+    auto reader = storage.openReader(info.hash);
+    ASSERT_NE(reader, nullptr);
+    EXPECT_EQ(reader->size(), data.size());
+    std::string back;
+    char buffer[7777];
+    size_t n;
+    while ((n = reader->read(buffer, sizeof(buffer))) > 0) {
+        back.append(buffer, n);
+    }
+    EXPECT_TRUE(reader->good());
+    EXPECT_EQ(back, data);
+
+    EXPECT_EQ(storage.getContent(info.hash).get(), data);
+    const std::string outputPath = path + "/out.bin";
+    ASSERT_TRUE(storage.getFile(info.hash, outputPath).get());
+    std::ifstream output(outputPath, std::ios::binary);
+    EXPECT_EQ(std::string(std::istreambuf_iterator<char>(output), {}), data);
+}
+
+TEST_F(ContentStorageTest, ReaderSeeksWithinAndAcrossChunks) {
+    const std::string data = randomBytes(3 * 1024 * 1024, 11);
+    auto info = store(data, 100000);
+    auto reader = storage.openReader(info.hash);
+    ASSERT_NE(reader, nullptr);
+
+    for (uint64_t offset : {2500000ull, 17ull, 18ull, 1000000ull, 0ull}) {
+        ASSERT_TRUE(reader->seek(offset));
+        std::string back(4096, '\0');
+        back.resize(reader->read(&back[0], back.size()));
+        EXPECT_EQ(back, data.substr(offset, 4096));
+    }
+    EXPECT_TRUE(reader->seek(data.size()));
+    char byte;
+    EXPECT_EQ(reader->read(&byte, 1), 0u);
+    EXPECT_FALSE(reader->seek(data.size() + 1));
+    EXPECT_TRUE(reader->good());
+}
+
+TEST_F(ContentStorageTest, ReaderKeepsChunksOfDeletedObject) {
+    const std::string data = randomBytes(3 * 1024 * 1024, 12);
+    auto info = store(data, 100000);
+    auto reader = storage.openReader(info.hash);
+    ASSERT_NE(reader, nullptr);
+
+    // The chunks outlive the object until the reader lets go of them
+    ASSERT_TRUE(storage.deleteContent(info.hash));
+    EXPECT_GT(storage.getChunkCount(), 0u);
+    std::string back(data.size(), '\0');
+    EXPECT_EQ(reader->read(&back[0], back.size()), data.size());
+    EXPECT_TRUE(reader->good());
+    EXPECT_EQ(back, data);
+    reader.reset();
+    EXPECT_EQ(storage.getChunkCount(), 0u);
+
+    // A reader from before a restart does not release the new references
+    info = store(data, 100000);
+    reader = storage.openReader(info.hash);
+    ASSERT_NE(reader, nullptr);
+    storage.shutdown();
+    ASSERT_TRUE(storage.initialize(path));
+    size_t chunks = storage.getChunkCount();
+    reader.reset();
+    EXPECT_EQ(storage.getChunkCount(), chunks);
+    EXPECT_EQ(storage.getContent(info.hash).get(), data);
+}
+
+TEST_F(ContentStorageTest, ChunkBoundariesIgnoreWriteSizes) {
+    const std::string data = randomBytes(4 * 1024 * 1024, 2);
+    auto whole = store(data, data.size());
+    size_t chunks = storage.getChunkCount();
+    auto pieces = store(data, 4097);
+    EXPECT_EQ(pieces.hash, whole.hash);
+    EXPECT_EQ(storage.getChunkCount(), chunks);
+}
+
+TEST_F(ContentStorageTest, SharedChunksAreStoredOnce) {
+    const std::string original = randomBytes(8 * 1024 * 1024, 3);
+    // An insertion near the start only disturbs the chunks around it
+    const std::string edited = original.substr(0, 1000) + "inserted" + original.substr(1000);
+
+    auto first = store(original, 65536);
+    size_t chunksFirst = storage.getChunkCount();
+    auto second = storage.storeContent(edited, "edited").get();
+    ASSERT_FALSE(second.hash.empty());
+    EXPECT_LE(storage.getChunkCount(), chunksFirst + 2);
+
+    ASSERT_TRUE(storage.deleteContent(first.hash));
+    EXPECT_EQ(storage.getContent(second.hash).get(), edited);
+    ASSERT_TRUE(storage.deleteContent(second.hash));
+    EXPECT_EQ(storage.getChunkCount(), 0u);
+}
+
+TEST_F(ContentStorageTest, AbortedWriteLeavesNothing) {
+    auto writer = storage.openWriter();
+    const std::string data = randomBytes(3 * 1024 * 1024, 4);
+    ASSERT_TRUE(writer->write(data.data(), data.size()));
+    EXPECT_GT(storage.getChunkCount(), 0u);
+    writer.reset();
+    EXPECT_EQ(storage.getChunkCount(), 0u);
+    for (const auto& entry : std::filesystem::recursive_directory_iterator(path + "/chunks")) {
+        EXPECT_FALSE(entry.is_regular_file()) << entry.path();
+    }
+}
+
+TEST_F(ContentStorageTest, ReinitializeReloadsObjects) {
+    const std::string data = randomBytes(2 * 1024 * 1024, 5);
+    auto info = storage.storeContent(data, "asset.bin").get();
+    storage.shutdown();
+    ASSERT_TRUE(storage.initialize(path));
+    auto reloaded = storage.getContentInfo(info.hash);
+    EXPECT_EQ(reloaded.name, "asset.bin");
+    EXPECT_EQ(reloaded.size, data.size());
+    EXPECT_EQ(storage.getContent(info.hash).get(), data);
+}
+
+TEST_F(ContentStorageTest, MimeTypeFromLeadingBytes) {
+    std::string png = std::string("\x89PNG\r\n\x1a\n", 8) + randomBytes(1024 * 1024, 6);
+    EXPECT_EQ(storage.storeContent(png).get().mimeType, "image/png");
+    EXPECT_EQ(storage.storeContent("{\"name\": \"token\"}").get().mimeType, "application/json");
+    EXPECT_EQ(storage.storeContent("plain words").get().mimeType, "text/plain");
+}
+
+TEST_F(ContentStorageTest, ObjectsAreShardedByHashPrefix) {
+    auto info = storage.storeContent("sharded object").get();
+    const std::string shard = path + "/objects/" + info.hash.substr(0, 2) + "/" + info.hash.substr(2, 2);
+    EXPECT_TRUE(std::filesystem::exists(shard + "/" + info.hash));
+    EXPECT_TRUE(std::filesystem::exists(path + "/chunks/" + sha256("sharded object").substr(0, 2)));
+}
+
+TEST_F(ContentStorageTest, IndexPersistsMetadataWithoutManifests) {
+    const std::string data = randomBytes(2 * 1024 * 1024, 7);
+    auto info = storage.storeContent(data, "image.bin").get();
+    ASSERT_TRUE(storage.pinContent(info.hash));
+    ASSERT_TRUE(storage.updateMetadata(info.hash, {{"collection", "genesis"}}));
+    storage.shutdown();
+
+    // Startup replays index.log alone; a torn last record is cut off
+    std::filesystem::remove_all(path + "/objects");
+    std::ofstream(path + "/index.log", std::ios::app | std::ios::binary) << "\x40\x00\x00\x00torn";
+    ASSERT_TRUE(storage.initialize(path));
+    auto reloaded = storage.getContentInfo(info.hash);
+    EXPECT_TRUE(reloaded.isPinned);
+    EXPECT_EQ(reloaded.metadata["collection"], "genesis");
+    EXPECT_EQ(storage.getContent(info.hash).get(), data);
+    ASSERT_EQ(storage.getContentByMimeType(reloaded.mimeType).size(), 1u);
+}
+
+TEST_F(ContentStorageTest, MidLogIndexDamageRebuildsFromManifests) {
+    const std::string data = randomBytes(2 * 1024 * 1024, 13);
+    auto first = storage.storeContent(data, "first.bin").get();
+    auto second = storage.storeContent("second object", "second.txt").get();
+    storage.shutdown();
+
+    // Flip a byte inside the first record: later records are still intact
+    std::fstream(path + "/index.log", std::ios::in | std::ios::out | std::ios::binary).seekp(12).put('X');
+    ASSERT_TRUE(storage.initialize(path));
+    EXPECT_TRUE(std::filesystem::exists(path + "/index.log.corrupt"));
+    EXPECT_EQ(storage.getContent(first.hash).get(), data);
+    EXPECT_EQ(storage.getContent(second.hash).get(), "second object");
+
+    // Nothing the manifests list is mistaken for an orphan
+    auto report = storage.scrub();
+    EXPECT_EQ(report.orphansRemoved, 0u);
+    EXPECT_TRUE(report.damagedObjects.empty());
+    EXPECT_EQ(storage.getContent(first.hash).get(), data);
+}
+
+TEST_F(ContentStorageTest, ScrubQuarantinesCorruptChunksAndRemovesOrphans) {
+    auto info = storage.storeContent(randomBytes(1024 * 1024, 8)).get();
+    auto other = storage.storeContent("untouched").get();
+
+    std::string victim;
+    for (const auto& entry : std::filesystem::recursive_directory_iterator(path + "/chunks")) {
+        if (entry.is_regular_file() && entry.path().filename() != sha256("untouched")) {
+            victim = entry.path().string();
+            break;
+        }
+    }
+    ASSERT_FALSE(victim.empty());
+    std::fstream(victim, std::ios::in | std::ios::out | std::ios::binary).write("X", 1);
+    const std::string orphan = path + "/chunks/00/00/" + std::string(64, '0');
+    std::filesystem::create_directories(path + "/chunks/00/00");
+    std::ofstream(orphan) << "left behind";
+
+    auto report = storage.scrub();
+    EXPECT_EQ(report.corruptChunks.size(), 1u);
+    ASSERT_EQ(report.damagedObjects.size(), 1u);
+    EXPECT_EQ(report.damagedObjects[0], info.hash);
+    EXPECT_EQ(report.orphansRemoved, 1u);
+    EXPECT_FALSE(std::filesystem::exists(orphan));
+    EXPECT_TRUE(std::filesystem::exists(path + "/quarantine/" + report.corruptChunks[0]));
+    EXPECT_EQ(storage.getContent(other.hash).get(), "untouched");
+    EXPECT_EQ(storage.getLastScrubReport().chunksChecked, report.chunksChecked);
+}
+
+TEST_F(ContentStorageTest, CachedReadsShareOneBuffer) {
+    const std::string data = randomBytes(256 * 1024, 9);
+    auto info = storage.storeContent(data).get();
+    storage.clearCache();
+    auto before = storage.getCacheUsage();
+
+    auto first = storage.getContentBuffer(info.hash).get();
+    auto second = storage.getContentBuffer(info.hash).get();
+    ASSERT_NE(first, nullptr);
+    EXPECT_EQ(*first, data);
+    EXPECT_EQ(first.get(), second.get());
+
+    auto usage = storage.getCacheUsage();
+    EXPECT_EQ(usage.misses - before.misses, 1u);
+    EXPECT_EQ(usage.hits - before.hits, 1u);
+    EXPECT_EQ(usage.bytesServed - before.bytesServed, data.size());
+    EXPECT_EQ(usage.bytes, data.size());
+    EXPECT_EQ(usage.protectedBytes, data.size());
+}
+
+TEST_F(ContentStorageTest, OneOffReadsDoNotEvictHotObjects) {
+    storage.setCacheSize(1024 * 1024);
+    auto hot = storage.storeContent(randomBytes(100 * 1024, 10)).get();
+    ASSERT_NE(storage.getContentBuffer(hot.hash).get(), nullptr);
+    ASSERT_NE(storage.getContentBuffer(hot.hash).get(), nullptr);
+
+    // A sweep of objects read once only churns the probationary segment
+    for (uint32_t i = 0; i < 30; ++i) {
+        auto cold = storage.storeContent(randomBytes(100 * 1024, 100 + i)).get();
+        ASSERT_NE(storage.getContent(cold.hash).get().size(), 0u);
+    }
+    auto usage = storage.getCacheUsage();
+    EXPECT_LE(usage.bytes, usage.capacity);
+    EXPECT_GT(usage.evictions, 0u);
+
+    auto hits = usage.hits;
+    ASSERT_NE(storage.getContentBuffer(hot.hash).get(), nullptr);
+    EXPECT_EQ(storage.getCacheUsage().hits, hits + 1);
+
+    // Objects over a quarter of the budget bypass the cache
+    auto large = storage.storeContent(randomBytes(512 * 1024, 11)).get();
+    EXPECT_EQ(storage.getContent(large.hash).get().size(), 512u * 1024);
+    EXPECT_LE(storage.getCacheUsage().bytes, usage.capacity);
+    auto misses = storage.getCacheUsage().misses;
+    storage.getContentBuffer(large.hash).get();
+    EXPECT_EQ(storage.getCacheUsage().misses, misses + 1);
+}
+
+} // namespace satox::ipfs::tests
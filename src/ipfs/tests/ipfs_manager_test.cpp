@@ -25,8 +25,18 @@
 
 #include <gtest/gtest.h>
 #include "satox/ipfs/ipfs_manager.hpp"
+#include <arpa/inet.h>
+#include <fcntl.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
 #include <fstream>
+#include <mutex>
 #include <sstream>
+#include <thread>
 
 namespace satox::ipfs::tests {
 
@@ -248,4 +258,257 @@ TEST_F(IPFSManagerTest_UnpinFile_Test, UnpinFileSuccessfully) {
     EXPECT_TRUE(manager.unpinFile(testHash_));
 }
 
-} // namespace satox::ipfs::tests 
\ No newline at end of file
+// Minimal keep-alive IPFS daemon: /add answers with a hash and records the
+// uploaded file part, /pin/add waits delayMs and fails for "QmBad", /cat
+// echoes its argument
+class MockIpfsDaemon {
+public:
+    explicit MockIpfsDaemon(int delayMs = 0) : delayMs_(delayMs) {
+        listenFd_ = ::socket(AF_INET, SOCK_STREAM, 0);
+        int one = 1;
+        ::setsockopt(listenFd_, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+        sockaddr_in addr{};
+        addr.sin_family = AF_INET;
+        addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        ::bind(listenFd_, reinterpret_cast<sockaddr*>(&addr), sizeof(addr));
+        ::listen(listenFd_, 64);
+        socklen_t len = sizeof(addr);
+        ::getsockname(listenFd_, reinterpret_cast<sockaddr*>(&addr), &len);
+        port_ = ntohs(addr.sin_port);
+        acceptThread_ = std::thread([this] { acceptLoop(); });
+    }
+
+    ~MockIpfsDaemon() {
+        ::shutdown(listenFd_, SHUT_RDWR);
+        ::close(listenFd_);
+        acceptThread_.join();
+        for (auto& t : connections_) {
+            t.join();
+        }
+    }
+
+    std::string endpoint() const { return "http://127.0.0.1:" + std::to_string(port_); }
+    int calls() const { return calls_; }
+    int accepted() const { return accepted_; }
+    int peakConcurrent() const { return peak_; }
+
+    std::vector<std::string> uploads() const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return uploads_;
+    }
+
+private:
+    void acceptLoop() {
+        while (true) {
+            int fd = ::accept(listenFd_, nullptr, nullptr);
+            if (fd < 0) {
+                return;
+            }
+            ++accepted_;
+            connections_.emplace_back([this, fd] { serve(fd); });
+        }
+    }
+
+    bool fill(int fd, std::string& buffer, size_t size) {
+        char chunk[65536];
+        while (buffer.size() < size) {
+            ssize_t n = ::recv(fd, chunk, sizeof(chunk), 0);
+            if (n <= 0) {
+                return false;
+            }
+            buffer.append(chunk, static_cast<size_t>(n));
+        }
+        return true;
+    }
+
+    void serve(int fd) {
+        std::string buffer;
+        while (true) {
+            size_t headerEnd;
+            while ((headerEnd = buffer.find("\r\n\r\n")) == std::string::npos) {
+                if (!fill(fd, buffer, buffer.size() + 1)) {
+                    ::close(fd);
+                    return;
+                }
+            }
+            std::string headers = buffer.substr(0, headerEnd);
+            size_t lengthPos = headers.find("Content-Length: ");
+            size_t length = lengthPos == std::string::npos ? 0 : std::stoul(headers.substr(lengthPos + 16));
+            if (!fill(fd, buffer, headerEnd + 4 + length)) {
+                ::close(fd);
+                return;
+            }
+            std::string body = buffer.substr(headerEnd + 4, length);
+            buffer.erase(0, headerEnd + 4 + length);
+
+            std::string target = headers.substr(headers.find(' ') + 1);
+            target = target.substr(0, target.find(' '));
+            std::string arg;
+            if (target.find("?arg=") != std::string::npos) {
+                arg = target.substr(target.find("?arg=") + 5);
+            }
+
+            ++calls_;
+            int running = ++running_;
+            for (int peak = peak_; running > peak && !peak_.compare_exchange_weak(peak, running);) {
+            }
+            int status = 200;
+            std::string reply;
+            if (target.rfind("/api/v0/add", 0) == 0) {
+                // The file part sits between its headers and the closing boundary
+                size_t start = body.find("\r\n\r\n") + 4;
+                size_t end = body.rfind("\r\n--");
+                std::lock_guard<std::mutex> lock(mutex_);
+                uploads_.push_back(body.substr(start, end - start));
+                reply = "{\"Name\":\"file\",\"Hash\":\"QmServed" + std::to_string(uploads_.size()) + "\"}\n";
+            } else if (target.rfind("/api/v0/pin/add", 0) == 0) {
+                std::this_thread::sleep_for(std::chrono::milliseconds(delayMs_));
+                if (arg == "QmBad") {
+                    status = 500;
+                    reply = "{\"Message\":\"not found\"}";
+                } else {
+                    reply = "{\"Pins\":[\"" + arg + "\"]}";
+                }
+            } else {
+                reply = "content of " + arg;
+            }
+            --running_;
+
+            std::string response = "HTTP/1.1 " + std::to_string(status) + " X\r\nContent-Length: " +
+                                   std::to_string(reply.size()) + "\r\n\r\n" + reply;
+            ::send(fd, response.data(), response.size(), MSG_NOSIGNAL);
+        }
+    }
+
+    int delayMs_;
+    int listenFd_ = -1;
+    uint16_t port_ = 0;
+    std::atomic<int> calls_{0};
+    std::atomic<int> accepted_{0};
+    std::atomic<int> running_{0};
+    std::atomic<int> peak_{0};
+    mutable std::mutex mutex_;
+    std::vector<std::string> uploads_;
+    std::thread acceptThread_;
+    std::vector<std::thread> connections_;
+};
+
+class IPFSManagerTest_Transfer_Test : public ::testing::Test {
+protected:
+    // The daemon outlives the manager's pooled connections to it
+    MockIpfsDaemon& start(size_t maxConcurrent, int delayMs = 0) {
+        daemon_ = std::make_unique<MockIpfsDaemon>(delayMs);
+        Config config;
+        config.api_endpoint = daemon_->endpoint();
+        config.gateway_url = "http://127.0.0.1:8080";
+        config.timeout_seconds = 30;
+        config.enable_pinning = true;
+        config.max_concurrent_requests = maxConcurrent;
+        EXPECT_TRUE(IPFSManager::getInstance().initialize(config));
+        return *daemon_;
+    }
+
+    void TearDown() override {
+        IPFSManager::getInstance().shutdown();
+        daemon_.reset();
+    }
+
+    std::unique_ptr<MockIpfsDaemon> daemon_;
+};
+
+TEST_F(IPFSManagerTest_Transfer_Test, PinFilesRunConcurrentlyOverKeptAliveConnections) {
+    auto& daemon = start(8, 20);
+    auto& manager = IPFSManager::getInstance();
+
+    std::vector<std::string> hashes;
+    for (int i = 0; i < 64; ++i) {
+        hashes.push_back("QmPin" + std::to_string(i));
+    }
+    std::vector<std::string> failed;
+    EXPECT_TRUE(manager.pinFiles(hashes, failed));
+    EXPECT_TRUE(failed.empty());
+
+    EXPECT_EQ(daemon.calls(), 64);
+    EXPECT_GT(daemon.peakConcurrent(), 1);
+    EXPECT_LE(daemon.peakConcurrent(), 8);
+    EXPECT_LE(daemon.accepted(), 8);
+
+    auto stats = manager.getTransferStats();
+    EXPECT_EQ(stats.completed, 64u);
+    EXPECT_LE(stats.peakInFlight, 8u);
+    EXPECT_EQ(stats.connectionsOpened, static_cast<uint64_t>(daemon.accepted()));
+}
+
+TEST_F(IPFSManagerTest_Transfer_Test, FailedPinsAreReported) {
+    start(4);
+    auto& manager = IPFSManager::getInstance();
+
+    std::vector<std::string> failed;
+    EXPECT_FALSE(manager.pinFiles({"QmGood", "QmBad", "QmAlsoGood"}, failed));
+    ASSERT_EQ(failed.size(), 1u);
+    EXPECT_EQ(failed[0], "QmBad");
+    EXPECT_NE(manager.getLastError().find("500"), std::string::npos);
+    EXPECT_FALSE(manager.pinFile("QmBad"));
+}
+
+TEST_F(IPFSManagerTest_Transfer_Test, AddFilesStreamsFileContents) {
+    auto& daemon = start(4);
+    auto& manager = IPFSManager::getInstance();
+
+    std::vector<std::string> contents = {"small file", std::string(3 * 1024 * 1024 + 17, 'x'), ""};
+    std::vector<std::string> paths;
+    for (size_t i = 0; i < contents.size(); ++i) {
+        paths.push_back("transfer_test_" + std::to_string(i) + ".bin");
+        std::ofstream(paths.back(), std::ios::binary) << contents[i];
+    }
+
+    std::vector<std::string> hashes;
+    EXPECT_TRUE(manager.addFiles(paths, hashes));
+    ASSERT_EQ(hashes.size(), contents.size());
+    for (const auto& hash : hashes) {
+        EXPECT_EQ(hash.rfind("QmServed", 0), 0u);
+    }
+    auto uploads = daemon.uploads();
+    std::sort(uploads.begin(), uploads.end());
+    std::sort(contents.begin(), contents.end());
+    EXPECT_EQ(uploads, contents);
+
+    std::vector<std::string> withMissing = {paths[0], "no_such_file.bin"};
+    EXPECT_FALSE(manager.addFiles(withMissing, hashes));
+    EXPECT_FALSE(hashes[0].empty());
+    EXPECT_TRUE(hashes[1].empty());
+
+    for (const auto& path : paths) {
+        std::remove(path.c_str());
+    }
+}
+
+TEST_F(IPFSManagerTest_Transfer_Test, AddFromDescriptorAndMemory) {
+    auto& daemon = start(4);
+    auto& manager = IPFSManager::getInstance();
+
+    std::ofstream("transfer_fd_test.bin", std::ios::binary) << "descriptor payload";
+    int fd = ::open("transfer_fd_test.bin", O_RDONLY);
+    ASSERT_GE(fd, 0);
+    std::string hash;
+    EXPECT_TRUE(manager.addFileDescriptor(fd, hash));
+    EXPECT_FALSE(hash.empty());
+    ::close(fd);
+    std::remove("transfer_fd_test.bin");
+
+    std::vector<std::vector<uint8_t>> items = {{1, 2, 3}, {4, 5}};
+    std::vector<std::string> hashes;
+    EXPECT_TRUE(manager.addDataBatch(items, hashes));
+    EXPECT_EQ(hashes.size(), 2u);
+    EXPECT_FALSE(manager.addData({6}).empty());
+
+    auto uploads = daemon.uploads();
+    ASSERT_EQ(uploads.size(), 4u);
+    EXPECT_EQ(uploads[0], "descriptor payload");
+
+    std::string data;
+    EXPECT_TRUE(manager.getFile("QmEcho", data));
+    EXPECT_EQ(data, "content of QmEcho");
+}
+
+} // namespace satox::ipfs::tests
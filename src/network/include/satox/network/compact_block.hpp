@@ -0,0 +1,190 @@
+/**
+ * @file compact_block.hpp
+ * @brief Compact block relay: short IDs, CMPCTBLOCK/GETBLOCKTXN/BLOCKTXN and reconstruction
+ * @copyright Copyright (c) 2025 Satoxcoin Core Developers
+ * @license MIT License
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#pragma once
+
+#include "p2p_protocol.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace satox {
+
+// Short IDs are computed over txids (no witness variant)
+constexpr uint64_t COMPACT_BLOCK_VERSION = 1;
+constexpr size_t COMPACT_SHORT_ID_BYTES = 6;
+// Peers asked to push compact blocks unsolicited
+constexpr size_t MAX_HIGH_BANDWIDTH_PEERS = 3;
+constexpr size_t MAX_COMPACT_BLOCK_TXS = 1000000;
+
+// A transaction as relayed: its id and serialised bytes. Inside compact block
+// messages each one travels as CompactSize length + bytes, since this layer
+// never parses transactions itself.
+struct RawTransaction {
+    uint256 txid{};
+    std::vector<uint8_t> data;
+};
+
+using RawTransactionRef = std::shared_ptr<const RawTransaction>;
+
+// txid = double SHA-256 of the bytes
+RawTransactionRef makeRawTransaction(std::vector<uint8_t> data);
+
+// SipHash-2-4 of `size` bytes under the 128-bit key (k0, k1)
+uint64_t sipHash24(uint64_t k0, uint64_t k1, const uint8_t* data, size_t size);
+
+// Double SHA-256 of the serialised header
+uint256 blockHash(const BlockHeader& header);
+
+// Bitcoin-style merkle root over txids (last entry duplicated on odd levels)
+uint256 computeMerkleRoot(const std::vector<RawTransactionRef>& txs);
+
+struct SendCmpctMessage {
+    bool highBandwidth = false;
+    uint64_t version = COMPACT_BLOCK_VERSION;
+};
+
+struct PrefilledTransaction {
+    uint32_t index = 0;                  // absolute position in the block
+    RawTransactionRef tx;
+};
+
+struct CompactBlockMessage {
+    BlockHeader header;
+    uint64_t nonce = 0;
+    std::vector<uint64_t> shortIds;      // low 48 bits used
+    std::vector<PrefilledTransaction> prefilled;
+
+    // Prefills the coinbase (index 0) and short-IDs everything else
+    static CompactBlockMessage fromBlock(const BlockHeader& header,
+                                         const std::vector<RawTransactionRef>& txs,
+                                         uint64_t nonce);
+
+    // SipHash key: first 16 bytes of SHA-256(header || nonce)
+    std::pair<uint64_t, uint64_t> shortIdKeys() const;
+    size_t transactionCount() const { return shortIds.size() + prefilled.size(); }
+};
+
+uint64_t shortTxId(uint64_t k0, uint64_t k1, const uint256& txid);
+
+struct BlockTxnRequest {
+    uint256 blockHash{};
+    std::vector<uint32_t> indexes;       // absolute, ascending
+};
+
+struct BlockTxnMessage {
+    uint256 blockHash{};
+    std::vector<RawTransactionRef> txs;  // in the order requested
+};
+
+// Wire encoding. Index lists are differentially encoded as in BIP152.
+// Decoders throw std::runtime_error on malformed input.
+std::vector<uint8_t> serializeSendCmpct(const SendCmpctMessage& msg);
+SendCmpctMessage deserializeSendCmpct(const std::vector<uint8_t>& data);
+std::vector<uint8_t> serializeCompactBlock(const CompactBlockMessage& msg);
+CompactBlockMessage deserializeCompactBlock(const std::vector<uint8_t>& data);
+std::vector<uint8_t> serializeBlockTxnRequest(const BlockTxnRequest& msg);
+BlockTxnRequest deserializeBlockTxnRequest(const std::vector<uint8_t>& data);
+std::vector<uint8_t> serializeBlockTxn(const BlockTxnMessage& msg);
+BlockTxnMessage deserializeBlockTxn(const std::vector<uint8_t>& data);
+
+// Serving side of GETBLOCKTXN; throws when an index is past the block
+BlockTxnMessage answerBlockTxnRequest(const BlockTxnRequest& request,
+                                      const std::vector<RawTransactionRef>& blockTxs);
+
+/**
+ * Rebuilds a block from a CMPCTBLOCK and the local mempool.
+ *
+ * init() places the prefilled transactions, then matches mempool txids by
+ * short ID. When two mempool transactions share a short ID the slot is left
+ * empty and requested instead. Whatever is still missing goes into one
+ * GETBLOCKTXN (missing()); fill() completes the block from the BLOCKTXN
+ * answer and checks the merkle root, which also catches short ID collisions
+ * between a mempool transaction and a different block transaction.
+ *
+ * Invalid means the message itself is malformed; Failed means the block is
+ * fine but can't be rebuilt this way, so fetch it in full.
+ */
+class PartiallyDownloadedBlock {
+public:
+    enum class Status { Ok, Invalid, Failed };
+
+    Status init(const CompactBlockMessage& block, const std::vector<RawTransactionRef>& mempool);
+    bool isComplete() const { return missingCount_ == 0; }
+    BlockTxnRequest missing() const;
+    Status fill(const BlockTxnMessage& response, std::vector<RawTransactionRef>& txs);
+
+    const BlockHeader& header() const { return header_; }
+    size_t prefilledCount() const { return prefilledCount_; }
+    size_t mempoolCount() const { return mempoolCount_; }
+
+private:
+    BlockHeader header_;
+    uint256 blockHash_{};
+    std::vector<RawTransactionRef> txs_;
+    size_t missingCount_ = 0;
+    size_t prefilledCount_ = 0;
+    size_t mempoolCount_ = 0;
+};
+
+/**
+ * BIP152 high-bandwidth peer selection.
+ *
+ * Inbound: a peer's SENDCMPCT decides whether we push it CMPCTBLOCK
+ * unsolicited (high bandwidth) or only announce (low bandwidth).
+ *
+ * Outbound: the peers that most recently delivered a new block first are
+ * asked for high-bandwidth mode, at most MAX_HIGH_BANDWIDTH_PEERS of them;
+ * onBlockDelivered returns the SENDCMPCT messages that switch peers in and
+ * out.
+ */
+class CompactBlockPeers {
+public:
+    void onSendCmpct(const std::string& peer, const SendCmpctMessage& msg);
+    void removePeer(const std::string& peer);
+
+    bool supportsCompactBlocks(const std::string& peer) const;
+    bool pushesTo(const std::string& peer) const;
+    std::vector<std::string> highBandwidthTargets() const;
+
+    std::vector<std::pair<std::string, SendCmpctMessage>> onBlockDelivered(const std::string& peer);
+    const std::deque<std::string>& highBandwidthSources() const { return sources_; }
+
+private:
+    struct PeerState {
+        bool compact = false;
+        bool highBandwidth = false;
+    };
+
+    std::unordered_map<std::string, PeerState> peers_;
+    std::deque<std::string> sources_;    // most recent first
+};
+
+} // namespace satox
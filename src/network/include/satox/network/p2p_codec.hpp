@@ -0,0 +1,145 @@
+/**
+ * @file p2p_codec.hpp
+ * @brief Streaming P2P frame parser, scatter/gather frames and command dispatch
+ * @copyright Copyright (c) 2025 Satoxcoin Core Developers
+ * @license MIT License
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#pragma once
+
+#include "p2p_protocol.hpp"
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <vector>
+#include <sys/types.h>
+#include <sys/uio.h>
+
+namespace satox {
+
+// Largest payload the parser accepts before treating the stream as hostile
+constexpr size_t MAX_P2P_PAYLOAD = 32 * 1024 * 1024;
+
+// Wire name of a message type ("version", "cmpctblock", ...)
+const char* messageCommand(P2PMessageType type);
+
+// Maps a NUL padded command field to its type through a perfect hash of the
+// known command names: one multiply, one table probe, one 12-byte compare
+bool lookupCommand(const char* command, P2PMessageType& type);
+
+// One complete frame. payload points into the parser's buffer and stays
+// valid until the next call that writes to the parser (prepare/feed/readFrom)
+struct P2PFrameView {
+    P2PMessageHeader header;
+    P2PMessageType type = P2PMessageType::VERSION;
+    bool known = false;                  // false for commands outside the table
+    const uint8_t* payload = nullptr;
+    size_t size = 0;
+};
+
+/**
+ * Incremental frame parser over a receive buffer.
+ *
+ * Bytes are received straight into the buffer (prepare + commit, or
+ * readFrom), and next() hands out frames without copying their payloads.
+ * Consumed bytes are reclaimed by sliding the unread tail to the front when
+ * a receive needs the room, which moves at most one partial frame.
+ *
+ * A bad magic, oversized length or checksum mismatch puts the parser in an
+ * error state: the stream can't be resynchronised, so the peer should be
+ * dropped.
+ */
+class P2PFrameParser {
+public:
+    enum class Status { NeedMore, Frame, Error };
+
+    explicit P2PFrameParser(uint32_t magic = P2P_NETWORK_MAGIC,
+                            size_t maxPayload = MAX_P2P_PAYLOAD);
+
+    // At least `minimum` writable bytes at the end of the buffer; commit()
+    // what was actually received
+    uint8_t* prepare(size_t minimum, size_t& available);
+    void commit(size_t bytes);
+
+    // Copies `size` bytes in, for callers that already hold the data
+    void feed(const uint8_t* data, size_t size);
+
+    // One read(2) into the buffer; returns its result
+    ssize_t readFrom(int fd, size_t chunk = 64 * 1024);
+
+    Status next(P2PFrameView& frame);
+
+    bool failed() const { return failed_; }
+    const std::string& getLastError() const { return lastError_; }
+    size_t bufferedBytes() const { return end_ - begin_; }
+    void reset();
+
+private:
+    Status fail(const std::string& error);
+
+    uint32_t magic_;
+    size_t maxPayload_;
+    std::vector<uint8_t> buffer_;
+    size_t begin_ = 0;                   // first unread byte
+    size_t end_ = 0;                     // one past the last received byte
+    bool haveHeader_ = false;            // header_ parsed, waiting for the payload
+    P2PMessageHeader header_;
+    bool failed_ = false;
+    std::string lastError_;
+};
+
+// Header bytes for an outgoing message plus a reference to its payload, sent
+// with one writev() so the payload is never copied into a frame buffer
+struct P2POutgoingFrame {
+    uint8_t header[P2P_HEADER_SIZE];
+    const uint8_t* payload = nullptr;
+    size_t size = 0;
+
+    std::array<iovec, 2> iovecs() const;
+};
+
+void encodeHeader(const P2PMessageHeader& header, uint8_t* out);
+void decodeHeader(const uint8_t* in, P2PMessageHeader& header);
+P2POutgoingFrame makeFrame(P2PMessageType type, const uint8_t* payload, size_t size,
+                           uint32_t magic = P2P_NETWORK_MAGIC);
+
+// Writes the whole frame, retrying partial writes; false on error
+bool sendFrame(int fd, const P2POutgoingFrame& frame);
+
+// Handlers indexed by message type
+class P2PDispatcher {
+public:
+    using Handler = std::function<void(const P2PFrameView&)>;
+
+    void setHandler(P2PMessageType type, Handler handler);
+    void setUnknownHandler(Handler handler);
+
+    // Returns false when nothing handled the frame
+    bool dispatch(const P2PFrameView& frame) const;
+
+private:
+    std::array<Handler, P2P_MESSAGE_TYPE_COUNT> handlers_;
+    Handler unknown_;
+};
+
+} // namespace satox
@@ -25,6 +25,9 @@
 
 #pragma once
 
+#include <algorithm>
+#include <array>
+#include <cstddef>
 #include <cstdint>
 #include <vector>
 #include <string>
@@ -32,12 +35,21 @@
 
 namespace satox {
 
+using uint256 = std::array<uint8_t, 32>;
+
 // Satoxcoin network magic number
 constexpr uint32_t SATOX_MAGIC = 0x53545843; // "STXC"
 
 // Protocol version
 constexpr int32_t PROTOCOL_VERSION = 70015;
 
+// Wire magic in every message header
+constexpr uint32_t P2P_NETWORK_MAGIC = 0x52415645;
+
+// magic | command | length | checksum
+constexpr size_t P2P_COMMAND_SIZE = 12;
+constexpr size_t P2P_HEADER_SIZE = 24;
+
 // User agent string
 constexpr const char* USER_AGENT = "/Satoxcoin:1.0.0/";
 
@@ -75,15 +87,17 @@ enum class P2PMessageType : uint8_t {
     GETNFT = 28
 };
 
+constexpr size_t P2P_MESSAGE_TYPE_COUNT = 29;
+
 // P2P message header structure
 struct P2PMessageHeader {
     uint32_t magic;           // Network magic number (0x52415645 for Satoxcoin)
-    char command[12];         // Command name
+    char command[P2P_COMMAND_SIZE]; // Command name, NUL padded
     uint32_t length;          // Payload length
     uint32_t checksum;        // First 4 bytes of double SHA256 of payload
 
-    P2PMessageHeader() : magic(0x52415645), length(0), checksum(0) {
-        std::fill(command, command + 12, 0);
+    P2PMessageHeader() : magic(P2P_NETWORK_MAGIC), length(0), checksum(0) {
+        std::fill(command, command + P2P_COMMAND_SIZE, 0);
     }
 };
 
@@ -94,6 +108,7 @@ struct P2PMessage {
 
     P2PMessage() = default;
     P2PMessage(P2PMessageType type, const std::vector<uint8_t>& data);
+    P2PMessage(P2PMessageType type, std::vector<uint8_t>&& data);
 };
 
 // Version message structure
@@ -131,7 +146,9 @@ struct InvVector {
     InvVector() : type(0) {}
 };
 
-// Block header structure
+// Block header structure; BLOCK_HEADER_SIZE bytes on the wire
+constexpr size_t BLOCK_HEADER_SIZE = 80;
+
 struct BlockHeader {
     int32_t version;
     uint256 prev_block;
@@ -143,14 +160,12 @@ struct BlockHeader {
     BlockHeader() : version(0), timestamp(0), bits(0), nonce(0) {}
 };
 
-// Transaction structure
-struct Transaction {
-    int32_t version;
-    std::vector<TxIn> inputs;
-    std::vector<TxOut> outputs;
-    uint32_t locktime;
+// OutPoint structure
+struct OutPoint {
+    uint256 hash;
+    uint32_t n;
 
-    Transaction() : version(1), locktime(0) {}
+    OutPoint() : n(0) {}
 };
 
 // Transaction input structure
@@ -170,12 +185,14 @@ struct TxOut {
     TxOut() : value(0) {}
 };
 
-// OutPoint structure
-struct OutPoint {
-    uint256 hash;
-    uint32_t n;
+// Transaction structure
+struct Transaction {
+    int32_t version;
+    std::vector<TxIn> inputs;
+    std::vector<TxOut> outputs;
+    uint32_t locktime;
 
-    OutPoint() : n(0) {}
+    Transaction() : version(1), locktime(0) {}
 };
 
 // Function declarations
@@ -194,5 +211,6 @@ Transaction deserializeTransaction(const std::vector<uint8_t>& data);
 std::string messageTypeToString(P2PMessageType type);
 P2PMessageType stringToMessageType(const std::string& str);
 uint32_t calculateChecksum(const std::vector<uint8_t>& data);
+uint32_t calculateChecksum(const uint8_t* data, size_t size);
 
 } // namespace satox 
\ No newline at end of file
@@ -0,0 +1,577 @@
+/**
+ * @file compact_block.cpp
+ * @brief Compact block relay: short IDs, CMPCTBLOCK/GETBLOCKTXN/BLOCKTXN and reconstruction
+ * @copyright Copyright (c) 2025 Satoxcoin Core Developers
+ * @license MIT License
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "satox/network/compact_block.hpp"
+#include <openssl/sha.h>
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+
+namespace satox {
+
+namespace {
+
+uint256 doubleSHA256(const uint8_t* data, size_t size) {
+    uint8_t first[SHA256_DIGEST_LENGTH];
+    uint256 result;
+    SHA256(data, size, first);
+    SHA256(first, sizeof(first), result.data());
+    return result;
+}
+
+inline uint64_t rotl(uint64_t x, int b) {
+    return (x << b) | (x >> (64 - b));
+}
+
+inline void sipRound(uint64_t& v0, uint64_t& v1, uint64_t& v2, uint64_t& v3) {
+    v0 += v1; v1 = rotl(v1, 13); v1 ^= v0; v0 = rotl(v0, 32);
+    v2 += v3; v3 = rotl(v3, 16); v3 ^= v2;
+    v0 += v3; v3 = rotl(v3, 21); v3 ^= v0;
+    v2 += v1; v1 = rotl(v1, 17); v1 ^= v2; v2 = rotl(v2, 32);
+}
+
+inline uint64_t readLE64(const uint8_t* in) {
+    uint64_t value = 0;
+    for (int i = 7; i >= 0; --i) {
+        value = (value << 8) | in[i];
+    }
+    return value;
+}
+
+void writeCompactSize(std::vector<uint8_t>& out, uint64_t value) {
+    if (value < 0xfd) {
+        out.push_back(static_cast<uint8_t>(value));
+        return;
+    }
+    size_t bytes = value <= 0xffff ? 2 : value <= 0xffffffffULL ? 4 : 8;
+    out.push_back(bytes == 2 ? 0xfd : bytes == 4 ? 0xfe : 0xff);
+    for (size_t i = 0; i < bytes; ++i) {
+        out.push_back(static_cast<uint8_t>(value >> (8 * i)));
+    }
+}
+
+void writeLE(std::vector<uint8_t>& out, uint64_t value, size_t bytes) {
+    for (size_t i = 0; i < bytes; ++i) {
+        out.push_back(static_cast<uint8_t>(value >> (8 * i)));
+    }
+}
+
+void writeTransaction(std::vector<uint8_t>& out, const RawTransactionRef& tx) {
+    if (!tx) {
+        throw std::runtime_error("Missing transaction");
+    }
+    writeCompactSize(out, tx->data.size());
+    out.insert(out.end(), tx->data.begin(), tx->data.end());
+}
+
+// Bounds-checked cursor over a message payload
+class Reader {
+public:
+    explicit Reader(const std::vector<uint8_t>& data) : data_(data) {}
+
+    const uint8_t* take(size_t size) {
+        if (data_.size() - offset_ < size) {
+            throw std::runtime_error("Message truncated");
+        }
+        const uint8_t* at = data_.data() + offset_;
+        offset_ += size;
+        return at;
+    }
+
+    uint64_t readLE(size_t bytes) {
+        const uint8_t* in = take(bytes);
+        uint64_t value = 0;
+        for (size_t i = bytes; i-- > 0;) {
+            value = (value << 8) | in[i];
+        }
+        return value;
+    }
+
+    uint64_t readCompactSize() {
+        uint8_t tag = *take(1);
+        if (tag < 0xfd) {
+            return tag;
+        }
+        size_t bytes = tag == 0xfd ? 2 : tag == 0xfe ? 4 : 8;
+        uint64_t value = readLE(bytes);
+        uint64_t minimum = bytes == 2 ? 0xfd : bytes == 4 ? 0x10000 : 0x100000000ULL;
+        if (value < minimum) {
+            throw std::runtime_error("Non-canonical CompactSize");
+        }
+        return value;
+    }
+
+    // A count whose elements take at least `elementBytes` each
+    uint64_t readCount(size_t elementBytes) {
+        uint64_t count = readCompactSize();
+        if (count > MAX_COMPACT_BLOCK_TXS || count * elementBytes > remaining()) {
+            throw std::runtime_error("Element count exceeds message");
+        }
+        return count;
+    }
+
+    uint256 readHash() {
+        uint256 hash;
+        std::memcpy(hash.data(), take(hash.size()), hash.size());
+        return hash;
+    }
+
+    RawTransactionRef readTransaction() {
+        uint64_t size = readCompactSize();
+        if (size > remaining()) {
+            throw std::runtime_error("Transaction truncated");
+        }
+        const uint8_t* in = take(static_cast<size_t>(size));
+        return makeRawTransaction(std::vector<uint8_t>(in, in + size));
+    }
+
+    size_t remaining() const { return data_.size() - offset_; }
+
+    void finish() const {
+        if (offset_ != data_.size()) {
+            throw std::runtime_error("Trailing bytes in message");
+        }
+    }
+
+private:
+    const std::vector<uint8_t>& data_;
+    size_t offset_ = 0;
+};
+
+// Absolute ascending indexes <-> BIP152 differential form
+void writeIndexes(std::vector<uint8_t>& out, const std::vector<uint32_t>& indexes) {
+    writeCompactSize(out, indexes.size());
+    uint64_t next = 0;
+    for (uint32_t index : indexes) {
+        if (index < next) {
+            throw std::runtime_error("Indexes not ascending");
+        }
+        writeCompactSize(out, index - next);
+        next = uint64_t(index) + 1;
+    }
+}
+
+uint32_t nextIndex(Reader& reader, uint64_t& next) {
+    uint64_t index = next + reader.readCompactSize();
+    if (index > UINT32_MAX) {
+        throw std::runtime_error("Index overflow");
+    }
+    next = index + 1;
+    return static_cast<uint32_t>(index);
+}
+
+} // namespace
+
+uint64_t sipHash24(uint64_t k0, uint64_t k1, const uint8_t* data, size_t size) {
+    uint64_t v0 = k0 ^ 0x736f6d6570736575ULL;
+    uint64_t v1 = k1 ^ 0x646f72616e646f6dULL;
+    uint64_t v2 = k0 ^ 0x6c7967656e657261ULL;
+    uint64_t v3 = k1 ^ 0x7465646279746573ULL;
+
+    const size_t words = size / 8;
+    for (size_t i = 0; i < words; ++i) {
+        uint64_t m = readLE64(data + i * 8);
+        v3 ^= m;
+        sipRound(v0, v1, v2, v3);
+        sipRound(v0, v1, v2, v3);
+        v0 ^= m;
+    }
+
+    uint64_t last = uint64_t(size) << 56;
+    for (size_t i = 0; i < size % 8; ++i) {
+        last |= uint64_t(data[words * 8 + i]) << (8 * i);
+    }
+    v3 ^= last;
+    sipRound(v0, v1, v2, v3);
+    sipRound(v0, v1, v2, v3);
+    v0 ^= last;
+
+    v2 ^= 0xff;
+    for (int i = 0; i < 4; ++i) {
+        sipRound(v0, v1, v2, v3);
+    }
+    return v0 ^ v1 ^ v2 ^ v3;
+}
+
+RawTransactionRef makeRawTransaction(std::vector<uint8_t> data) {
+    auto tx = std::make_shared<RawTransaction>();
+    tx->txid = doubleSHA256(data.data(), data.size());
+    tx->data = std::move(data);
+    return tx;
+}
+
+uint256 blockHash(const BlockHeader& header) {
+    auto bytes = serializeBlockHeader(header);
+    return doubleSHA256(bytes.data(), bytes.size());
+}
+
+uint256 computeMerkleRoot(const std::vector<RawTransactionRef>& txs) {
+    if (txs.empty()) {
+        return uint256{};
+    }
+
+    std::vector<uint256> level;
+    level.reserve(txs.size());
+    for (const auto& tx : txs) {
+        level.push_back(tx ? tx->txid : uint256{});
+    }
+
+    uint8_t pair[64];
+    while (level.size() > 1) {
+        if (level.size() % 2 != 0) {
+            level.push_back(level.back());
+        }
+        for (size_t i = 0; i < level.size() / 2; ++i) {
+            std::memcpy(pair, level[2 * i].data(), 32);
+            std::memcpy(pair + 32, level[2 * i + 1].data(), 32);
+            level[i] = doubleSHA256(pair, sizeof(pair));
+        }
+        level.resize(level.size() / 2);
+    }
+    return level[0];
+}
+
+uint64_t shortTxId(uint64_t k0, uint64_t k1, const uint256& txid) {
+    return sipHash24(k0, k1, txid.data(), txid.size()) & 0xffffffffffffULL;
+}
+
+std::pair<uint64_t, uint64_t> CompactBlockMessage::shortIdKeys() const {
+    auto bytes = serializeBlockHeader(header);
+    writeLE(bytes, nonce, sizeof(nonce));
+    uint8_t digest[SHA256_DIGEST_LENGTH];
+    SHA256(bytes.data(), bytes.size(), digest);
+    return {readLE64(digest), readLE64(digest + 8)};
+}
+
+CompactBlockMessage CompactBlockMessage::fromBlock(const BlockHeader& header,
+                                                   const std::vector<RawTransactionRef>& txs,
+                                                   uint64_t nonce) {
+    CompactBlockMessage msg;
+    msg.header = header;
+    msg.nonce = nonce;
+    if (txs.empty()) {
+        return msg;
+    }
+
+    // The coinbase is never in a mempool, so it always travels in full
+    msg.prefilled.push_back({0, txs[0]});
+    auto keys = msg.shortIdKeys();
+    msg.shortIds.reserve(txs.size() - 1);
+    for (size_t i = 1; i < txs.size(); ++i) {
+        msg.shortIds.push_back(shortTxId(keys.first, keys.second, txs[i]->txid));
+    }
+    return msg;
+}
+
+std::vector<uint8_t> serializeSendCmpct(const SendCmpctMessage& msg) {
+    std::vector<uint8_t> result;
+    result.push_back(msg.highBandwidth ? 1 : 0);
+    writeLE(result, msg.version, sizeof(msg.version));
+    return result;
+}
+
+SendCmpctMessage deserializeSendCmpct(const std::vector<uint8_t>& data) {
+    Reader reader(data);
+    SendCmpctMessage msg;
+    msg.highBandwidth = *reader.take(1) != 0;
+    msg.version = reader.readLE(sizeof(msg.version));
+    reader.finish();
+    return msg;
+}
+
+std::vector<uint8_t> serializeCompactBlock(const CompactBlockMessage& msg) {
+    std::vector<uint8_t> result = serializeBlockHeader(msg.header);
+    result.reserve(BLOCK_HEADER_SIZE + 16 + msg.shortIds.size() * COMPACT_SHORT_ID_BYTES);
+    writeLE(result, msg.nonce, sizeof(msg.nonce));
+
+    writeCompactSize(result, msg.shortIds.size());
+    for (uint64_t id : msg.shortIds) {
+        writeLE(result, id, COMPACT_SHORT_ID_BYTES);
+    }
+
+    writeCompactSize(result, msg.prefilled.size());
+    uint64_t next = 0;
+    for (const auto& prefilled : msg.prefilled) {
+        if (prefilled.index < next) {
+            throw std::runtime_error("Prefilled indexes not ascending");
+        }
+        writeCompactSize(result, prefilled.index - next);
+        next = uint64_t(prefilled.index) + 1;
+        writeTransaction(result, prefilled.tx);
+    }
+    return result;
+}
+
+CompactBlockMessage deserializeCompactBlock(const std::vector<uint8_t>& data) {
+    Reader reader(data);
+    CompactBlockMessage msg;
+    const uint8_t* header = reader.take(BLOCK_HEADER_SIZE);
+    msg.header = deserializeBlockHeader(std::vector<uint8_t>(header, header + BLOCK_HEADER_SIZE));
+    msg.nonce = reader.readLE(sizeof(msg.nonce));
+
+    uint64_t ids = reader.readCount(COMPACT_SHORT_ID_BYTES);
+    msg.shortIds.reserve(ids);
+    for (uint64_t i = 0; i < ids; ++i) {
+        msg.shortIds.push_back(reader.readLE(COMPACT_SHORT_ID_BYTES));
+    }
+
+    uint64_t prefilled = reader.readCount(2);
+    msg.prefilled.reserve(prefilled);
+    uint64_t next = 0;
+    for (uint64_t i = 0; i < prefilled; ++i) {
+        PrefilledTransaction entry;
+        entry.index = nextIndex(reader, next);
+        entry.tx = reader.readTransaction();
+        msg.prefilled.push_back(std::move(entry));
+    }
+    reader.finish();
+    return msg;
+}
+
+std::vector<uint8_t> serializeBlockTxnRequest(const BlockTxnRequest& msg) {
+    std::vector<uint8_t> result(msg.blockHash.begin(), msg.blockHash.end());
+    writeIndexes(result, msg.indexes);
+    return result;
+}
+
+BlockTxnRequest deserializeBlockTxnRequest(const std::vector<uint8_t>& data) {
+    Reader reader(data);
+    BlockTxnRequest msg;
+    msg.blockHash = reader.readHash();
+    uint64_t count = reader.readCount(1);
+    msg.indexes.reserve(count);
+    uint64_t next = 0;
+    for (uint64_t i = 0; i < count; ++i) {
+        msg.indexes.push_back(nextIndex(reader, next));
+    }
+    reader.finish();
+    return msg;
+}
+
+std::vector<uint8_t> serializeBlockTxn(const BlockTxnMessage& msg) {
+    std::vector<uint8_t> result(msg.blockHash.begin(), msg.blockHash.end());
+    writeCompactSize(result, msg.txs.size());
+    for (const auto& tx : msg.txs) {
+        writeTransaction(result, tx);
+    }
+    return result;
+}
+
+BlockTxnMessage deserializeBlockTxn(const std::vector<uint8_t>& data) {
+    Reader reader(data);
+    BlockTxnMessage msg;
+    msg.blockHash = reader.readHash();
+    uint64_t count = reader.readCount(1);
+    msg.txs.reserve(count);
+    for (uint64_t i = 0; i < count; ++i) {
+        msg.txs.push_back(reader.readTransaction());
+    }
+    reader.finish();
+    return msg;
+}
+
+BlockTxnMessage answerBlockTxnRequest(const BlockTxnRequest& request,
+                                      const std::vector<RawTransactionRef>& blockTxs) {
+    BlockTxnMessage response;
+    response.blockHash = request.blockHash;
+    response.txs.reserve(request.indexes.size());
+    for (uint32_t index : request.indexes) {
+        if (index >= blockTxs.size()) {
+            throw std::runtime_error("Requested transaction index out of range");
+        }
+        response.txs.push_back(blockTxs[index]);
+    }
+    return response;
+}
+
+PartiallyDownloadedBlock::Status PartiallyDownloadedBlock::init(const CompactBlockMessage& block,
+                                                               const std::vector<RawTransactionRef>& mempool) {
+    const size_t total = block.transactionCount();
+    if (total == 0 || total > MAX_COMPACT_BLOCK_TXS) {
+        return Status::Invalid;
+    }
+
+    header_ = block.header;
+    blockHash_ = blockHash(block.header);
+    txs_.assign(total, nullptr);
+    prefilledCount_ = 0;
+    mempoolCount_ = 0;
+
+    // Prefilled transactions first; their indexes must ascend and fit
+    int64_t last = -1;
+    for (const auto& prefilled : block.prefilled) {
+        if (!prefilled.tx || int64_t(prefilled.index) <= last || prefilled.index >= total) {
+            return Status::Invalid;
+        }
+        txs_[prefilled.index] = prefilled.tx;
+        last = prefilled.index;
+        ++prefilledCount_;
+    }
+
+    // Short IDs fill the remaining slots in order
+    std::unordered_map<uint64_t, uint32_t> slots;
+    slots.reserve(block.shortIds.size());
+    size_t next = 0;
+    for (uint64_t id : block.shortIds) {
+        while (txs_[next]) {
+            ++next;
+        }
+        if (!slots.emplace(id & 0xffffffffffffULL, static_cast<uint32_t>(next)).second) {
+            // Two block transactions share an ID: no way to tell them apart
+            return Status::Failed;
+        }
+        ++next;
+    }
+
+    auto keys = block.shortIdKeys();
+    std::vector<bool> collided(total, false);
+    size_t matched = 0;
+    for (const auto& tx : mempool) {
+        if (matched == slots.size()) {
+            break;
+        }
+        auto slot = slots.find(shortTxId(keys.first, keys.second, tx->txid));
+        if (slot == slots.end() || collided[slot->second]) {
+            continue;
+        }
+        RawTransactionRef& target = txs_[slot->second];
+        if (!target) {
+            target = tx;
+            ++matched;
+        } else if (target->txid != tx->txid) {
+            // Two mempool transactions claim the slot; ask the peer instead
+            target.reset();
+            collided[slot->second] = true;
+            --matched;
+        }
+    }
+
+    mempoolCount_ = matched;
+    missingCount_ = total - prefilledCount_ - matched;
+    return Status::Ok;
+}
+
+BlockTxnRequest PartiallyDownloadedBlock::missing() const {
+    BlockTxnRequest request;
+    request.blockHash = blockHash_;
+    request.indexes.reserve(missingCount_);
+    for (size_t i = 0; i < txs_.size(); ++i) {
+        if (!txs_[i]) {
+            request.indexes.push_back(static_cast<uint32_t>(i));
+        }
+    }
+    return request;
+}
+
+PartiallyDownloadedBlock::Status PartiallyDownloadedBlock::fill(const BlockTxnMessage& response,
+                                                               std::vector<RawTransactionRef>& txs) {
+    if (txs_.empty() || response.blockHash != blockHash_ || response.txs.size() != missingCount_) {
+        return Status::Invalid;
+    }
+
+    std::vector<RawTransactionRef> block = txs_;
+    size_t next = 0;
+    for (auto& tx : block) {
+        if (!tx) {
+            if (!response.txs[next]) {
+                return Status::Invalid;
+            }
+            tx = response.txs[next++];
+        }
+    }
+
+    // A mempool transaction that merely shares a short ID shows up here
+    if (computeMerkleRoot(block) != header_.merkle_root) {
+        return Status::Failed;
+    }
+
+    txs_ = block;
+    missingCount_ = 0;
+    txs = std::move(block);
+    return Status::Ok;
+}
+
+void CompactBlockPeers::onSendCmpct(const std::string& peer, const SendCmpctMessage& msg) {
+    // Unknown versions are ignored, as BIP152 asks
+    if (msg.version != COMPACT_BLOCK_VERSION) {
+        return;
+    }
+    PeerState& state = peers_[peer];
+    state.compact = true;
+    state.highBandwidth = msg.highBandwidth;
+}
+
+void CompactBlockPeers::removePeer(const std::string& peer) {
+    peers_.erase(peer);
+    sources_.erase(std::remove(sources_.begin(), sources_.end(), peer), sources_.end());
+}
+
+bool CompactBlockPeers::supportsCompactBlocks(const std::string& peer) const {
+    auto it = peers_.find(peer);
+    return it != peers_.end() && it->second.compact;
+}
+
+bool CompactBlockPeers::pushesTo(const std::string& peer) const {
+    auto it = peers_.find(peer);
+    return it != peers_.end() && it->second.compact && it->second.highBandwidth;
+}
+
+std::vector<std::string> CompactBlockPeers::highBandwidthTargets() const {
+    std::vector<std::string> targets;
+    for (const auto& entry : peers_) {
+        if (entry.second.compact && entry.second.highBandwidth) {
+            targets.push_back(entry.first);
+        }
+    }
+    return targets;
+}
+
+std::vector<std::pair<std::string, SendCmpctMessage>> CompactBlockPeers::onBlockDelivered(const std::string& peer) {
+    std::vector<std::pair<std::string, SendCmpctMessage>> messages;
+    if (!supportsCompactBlocks(peer)) {
+        return messages;
+    }
+
+    auto it = std::find(sources_.begin(), sources_.end(), peer);
+    if (it != sources_.end()) {
+        // Already high bandwidth; just refresh its position
+        sources_.erase(it);
+        sources_.push_front(peer);
+        return messages;
+    }
+
+    sources_.push_front(peer);
+    SendCmpctMessage enable;
+    enable.highBandwidth = true;
+    messages.emplace_back(peer, enable);
+
+    if (sources_.size() > MAX_HIGH_BANDWIDTH_PEERS) {
+        messages.emplace_back(sources_.back(), SendCmpctMessage{});
+        sources_.pop_back();
+    }
+    return messages;
+}
+
+} // namespace satox
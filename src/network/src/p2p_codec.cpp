@@ -0,0 +1,329 @@
+/**
+ * @file p2p_codec.cpp
+ * @brief Streaming P2P frame parser, scatter/gather frames and command dispatch
+ * @copyright Copyright (c) 2025 Satoxcoin Core Developers
+ * @license MIT License
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "satox/network/p2p_codec.hpp"
+#include <openssl/sha.h>
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <unistd.h>
+
+namespace satox {
+
+namespace {
+
+// Indexed by P2PMessageType; at most P2P_COMMAND_SIZE characters each
+constexpr const char* COMMAND_NAMES[P2P_MESSAGE_TYPE_COUNT] = {
+    "version", "verack", "addr", "inv", "getdata", "getblocks", "getheaders",
+    "tx", "block", "headers", "getaddr", "mempool", "ping", "pong", "reject",
+    "sendheaders", "feefilter", "sendcmpct", "cmpctblock", "getblocktxn",
+    "blocktxn", "asset", "getasset", "assetalloc", "getassetalc", "ipfs",
+    "getipfs", "nft", "getnft"
+};
+
+// Found by search over odd multipliers; the static_assert below rejects any
+// change to the command list that makes two names share a slot
+constexpr uint64_t COMMAND_HASH_MULTIPLIER = 0xf44e70c67c1e2743ULL;
+constexpr unsigned COMMAND_TABLE_BITS = 6;
+constexpr size_t COMMAND_TABLE_SIZE = size_t(1) << COMMAND_TABLE_BITS;
+
+// Hashes the 12-byte field as two little-endian words; bytes after the
+// first NUL count as zero, so "ping" and its padded field hash alike
+constexpr size_t commandSlot(const char* command) {
+    uint64_t lo = 0;
+    uint64_t hi = 0;
+    bool ended = false;
+    for (size_t i = 0; i < P2P_COMMAND_SIZE; ++i) {
+        uint64_t byte = ended ? 0 : static_cast<uint8_t>(command[i]);
+        ended = ended || byte == 0;
+        if (i < 8) {
+            lo |= byte << (8 * i);
+        } else {
+            hi |= byte << (8 * (i - 8));
+        }
+    }
+    return static_cast<size_t>(((lo ^ (hi * 0x9E3779B97F4A7C15ULL)) * COMMAND_HASH_MULTIPLIER) >>
+                               (64 - COMMAND_TABLE_BITS));
+}
+
+struct CommandSlot {
+    char command[P2P_COMMAND_SIZE];
+    int type;                            // -1 for an empty slot
+};
+
+struct CommandTable {
+    CommandSlot slots[COMMAND_TABLE_SIZE];
+    bool perfect;
+};
+
+constexpr CommandTable buildCommandTable() {
+    CommandTable table{};
+    table.perfect = true;
+    for (auto& slot : table.slots) {
+        slot.type = -1;
+    }
+    for (size_t type = 0; type < P2P_MESSAGE_TYPE_COUNT; ++type) {
+        const char* name = COMMAND_NAMES[type];
+        CommandSlot& slot = table.slots[commandSlot(name)];
+        if (slot.type != -1) {
+            table.perfect = false;
+        }
+        slot.type = static_cast<int>(type);
+        for (size_t i = 0; i < P2P_COMMAND_SIZE && name[i] != 0; ++i) {
+            slot.command[i] = name[i];
+        }
+    }
+    return table;
+}
+
+constexpr CommandTable COMMAND_TABLE = buildCommandTable();
+static_assert(COMMAND_TABLE.perfect, "P2P command names collide; pick another COMMAND_HASH_MULTIPLIER");
+
+} // namespace
+
+const char* messageCommand(P2PMessageType type) {
+    size_t index = static_cast<size_t>(type);
+    return index < P2P_MESSAGE_TYPE_COUNT ? COMMAND_NAMES[index] : nullptr;
+}
+
+bool lookupCommand(const char* command, P2PMessageType& type) {
+    const CommandSlot& slot = COMMAND_TABLE.slots[commandSlot(command)];
+    if (slot.type < 0 || std::memcmp(slot.command, command, P2P_COMMAND_SIZE) != 0) {
+        return false;
+    }
+    type = static_cast<P2PMessageType>(slot.type);
+    return true;
+}
+
+uint32_t calculateChecksum(const uint8_t* data, size_t size) {
+    uint8_t hash1[SHA256_DIGEST_LENGTH];
+    uint8_t hash2[SHA256_DIGEST_LENGTH];
+    SHA256(data, size, hash1);
+    SHA256(hash1, sizeof(hash1), hash2);
+    uint32_t checksum;
+    std::memcpy(&checksum, hash2, sizeof(checksum));
+    return checksum;
+}
+
+void encodeHeader(const P2PMessageHeader& header, uint8_t* out) {
+    std::memcpy(out, &header.magic, sizeof(header.magic));
+    std::memcpy(out + 4, header.command, P2P_COMMAND_SIZE);
+    std::memcpy(out + 16, &header.length, sizeof(header.length));
+    std::memcpy(out + 20, &header.checksum, sizeof(header.checksum));
+}
+
+void decodeHeader(const uint8_t* in, P2PMessageHeader& header) {
+    std::memcpy(&header.magic, in, sizeof(header.magic));
+    std::memcpy(header.command, in + 4, P2P_COMMAND_SIZE);
+    std::memcpy(&header.length, in + 16, sizeof(header.length));
+    std::memcpy(&header.checksum, in + 20, sizeof(header.checksum));
+}
+
+P2PFrameParser::P2PFrameParser(uint32_t magic, size_t maxPayload)
+    : magic_(magic)
+    , maxPayload_(maxPayload) {
+}
+
+uint8_t* P2PFrameParser::prepare(size_t minimum, size_t& available) {
+    if (buffer_.size() - end_ < minimum && begin_ > 0) {
+        // Slide the unread tail (at most one partial frame) to the front
+        std::memmove(buffer_.data(), buffer_.data() + begin_, end_ - begin_);
+        end_ -= begin_;
+        begin_ = 0;
+    }
+    if (buffer_.size() - end_ < minimum) {
+        buffer_.resize(std::max(end_ + minimum, buffer_.size() * 2));
+    }
+    available = buffer_.size() - end_;
+    return buffer_.data() + end_;
+}
+
+void P2PFrameParser::commit(size_t bytes) {
+    end_ = std::min(end_ + bytes, buffer_.size());
+}
+
+void P2PFrameParser::feed(const uint8_t* data, size_t size) {
+    size_t available = 0;
+    uint8_t* out = prepare(size, available);
+    std::memcpy(out, data, size);
+    commit(size);
+}
+
+ssize_t P2PFrameParser::readFrom(int fd, size_t chunk) {
+    // Room for the rest of the frame in progress, so a block lands in one place
+    size_t wanted = chunk;
+    size_t buffered = end_ - begin_;
+    if (haveHeader_ && header_.length > buffered) {
+        wanted = std::max(wanted, header_.length - buffered);
+    }
+
+    size_t available = 0;
+    uint8_t* out = prepare(wanted, available);
+    ssize_t received = ::read(fd, out, available);
+    if (received > 0) {
+        commit(static_cast<size_t>(received));
+    }
+    return received;
+}
+
+P2PFrameParser::Status P2PFrameParser::next(P2PFrameView& frame) {
+    if (failed_) {
+        return Status::Error;
+    }
+
+    if (!haveHeader_) {
+        if (end_ - begin_ < P2P_HEADER_SIZE) {
+            return Status::NeedMore;
+        }
+        decodeHeader(buffer_.data() + begin_, header_);
+        if (header_.magic != magic_) {
+            return fail("Invalid magic number");
+        }
+        if (header_.length > maxPayload_) {
+            return fail("Payload length " + std::to_string(header_.length) + " exceeds limit");
+        }
+        begin_ += P2P_HEADER_SIZE;
+        haveHeader_ = true;
+    }
+
+    if (end_ - begin_ < header_.length) {
+        return Status::NeedMore;
+    }
+
+    const uint8_t* payload = buffer_.data() + begin_;
+    if (calculateChecksum(payload, header_.length) != header_.checksum) {
+        return fail("Invalid checksum");
+    }
+
+    frame.header = header_;
+    frame.known = lookupCommand(header_.command, frame.type);
+    frame.payload = payload;
+    frame.size = header_.length;
+
+    begin_ += header_.length;
+    haveHeader_ = false;
+    if (begin_ == end_) {
+        // Nothing buffered: the next receive starts at the front again
+        begin_ = 0;
+        end_ = 0;
+    }
+    return Status::Frame;
+}
+
+void P2PFrameParser::reset() {
+    begin_ = 0;
+    end_ = 0;
+    haveHeader_ = false;
+    failed_ = false;
+    lastError_.clear();
+}
+
+P2PFrameParser::Status P2PFrameParser::fail(const std::string& error) {
+    failed_ = true;
+    lastError_ = error;
+    return Status::Error;
+}
+
+std::array<iovec, 2> P2POutgoingFrame::iovecs() const {
+    return {{
+        {const_cast<uint8_t*>(header), P2P_HEADER_SIZE},
+        {const_cast<uint8_t*>(payload), size}
+    }};
+}
+
+P2POutgoingFrame makeFrame(P2PMessageType type, const uint8_t* payload, size_t size, uint32_t magic) {
+    P2PMessageHeader header;
+    header.magic = magic;
+    const char* command = messageCommand(type);
+    if (command) {
+        std::memcpy(header.command, command, std::strlen(command));
+    }
+    header.length = static_cast<uint32_t>(size);
+    header.checksum = calculateChecksum(payload, size);
+
+    P2POutgoingFrame frame;
+    encodeHeader(header, frame.header);
+    frame.payload = payload;
+    frame.size = size;
+    return frame;
+}
+
+bool sendFrame(int fd, const P2POutgoingFrame& frame) {
+    auto iov = frame.iovecs();
+    iovec* current = iov.data();
+    int count = frame.size > 0 ? 2 : 1;
+
+    while (count > 0) {
+        ssize_t written = ::writev(fd, current, count);
+        if (written < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            return false;
+        }
+
+        // Skip what went out, possibly stopping inside an iovec
+        size_t remaining = static_cast<size_t>(written);
+        while (count > 0 && remaining >= current->iov_len) {
+            remaining -= current->iov_len;
+            ++current;
+            --count;
+        }
+        if (count > 0) {
+            current->iov_base = static_cast<uint8_t*>(current->iov_base) + remaining;
+            current->iov_len -= remaining;
+        }
+    }
+    return true;
+}
+
+void P2PDispatcher::setHandler(P2PMessageType type, Handler handler) {
+    size_t index = static_cast<size_t>(type);
+    if (index < handlers_.size()) {
+        handlers_[index] = std::move(handler);
+    }
+}
+
+void P2PDispatcher::setUnknownHandler(Handler handler) {
+    unknown_ = std::move(handler);
+}
+
+bool P2PDispatcher::dispatch(const P2PFrameView& frame) const {
+    if (frame.known) {
+        const Handler& handler = handlers_[static_cast<size_t>(frame.type)];
+        if (handler) {
+            handler(frame);
+            return true;
+        }
+        return false;
+    }
+    if (unknown_) {
+        unknown_(frame);
+        return true;
+    }
+    return false;
+}
+
+} // namespace satox
@@ -23,178 +23,87 @@
  * SOFTWARE.
  */
 
-#include "p2p_protocol.hpp"
-#include <openssl/sha.h>
+#include "satox/network/p2p_protocol.hpp"
+#include "satox/network/p2p_codec.hpp"
 #include <algorithm>
 #include <cstring>
+#include <sstream>
 #include <stdexcept>
 
 namespace satox {
 
-// Helper function to calculate double SHA256
-std::vector<uint8_t> doubleSHA256(const std::vector<uint8_t>& data) {
-    std::vector<uint8_t> hash1(SHA256_DIGEST_LENGTH);
-    std::vector<uint8_t> hash2(SHA256_DIGEST_LENGTH);
-    
-    SHA256_CTX sha256;
-    SHA256_Init(&sha256);
-    SHA256_Update(&sha256, data.data(), data.size());
-    SHA256_Final(hash1.data(), &sha256);
-    
-    SHA256_Init(&sha256);
-    SHA256_Update(&sha256, hash1.data(), hash1.size());
-    SHA256_Final(hash2.data(), &sha256);
-    
-    return hash2;
-}
-
 uint32_t calculateChecksum(const std::vector<uint8_t>& data) {
-    auto hash = doubleSHA256(data);
-    uint32_t checksum;
-    std::memcpy(&checksum, hash.data(), sizeof(checksum));
-    return checksum;
+    return calculateChecksum(data.data(), data.size());
 }
 
 std::string messageTypeToString(P2PMessageType type) {
-    switch (type) {
-        case P2PMessageType::VERSION: return "version";
-        case P2PMessageType::VERACK: return "verack";
-        case P2PMessageType::INV: return "inv";
-        case P2PMessageType::GETDATA: return "getdata";
-        case P2PMessageType::BLOCK: return "block";
-        case P2PMessageType::TX: return "tx";
-        case P2PMessageType::GETBLOCKS: return "getblocks";
-        case P2PMessageType::GETHEADERS: return "getheaders";
-        case P2PMessageType::HEADERS: return "headers";
-        case P2PMessageType::PING: return "ping";
-        case P2PMessageType::PONG: return "pong";
-        case P2PMessageType::REJECT: return "reject";
-        case P2PMessageType::MEMPOOL: return "mempool";
-        case P2PMessageType::FILTERLOAD: return "filterload";
-        case P2PMessageType::FILTERADD: return "filteradd";
-        case P2PMessageType::FILTERCLEAR: return "filterclear";
-        case P2PMessageType::MERKLEBLOCK: return "merkleblock";
-        case P2PMessageType::ALERT: return "alert";
-        case P2PMessageType::SENDHEADERS: return "sendheaders";
-        case P2PMessageType::FEEFILTER: return "feefilter";
-        case P2PMessageType::SENDCMPCT: return "sendcmpct";
-        case P2PMessageType::CMPCTBLOCK: return "cmpctblock";
-        case P2PMessageType::GETBLOCKTXN: return "getblocktxn";
-        case P2PMessageType::BLOCKTXN: return "blocktxn";
-        case P2PMessageType::GETCFILTERS: return "getcfilters";
-        case P2PMessageType::CFILTER: return "cfilter";
-        case P2PMessageType::GETCFHEADERS: return "getcfheaders";
-        case P2PMessageType::CFHEADERS: return "cfheaders";
-        case P2PMessageType::GETCFCHECKPT: return "getcfcheckpt";
-        case P2PMessageType::CFCHECKPT: return "cfcheckpt";
-        case P2PMessageType::WTXIDRELAY: return "wtxidrelay";
-        default: throw std::runtime_error("Unknown message type");
+    const char* command = messageCommand(type);
+    if (!command) {
+        throw std::runtime_error("Unknown message type");
     }
+    return command;
 }
 
 P2PMessageType stringToMessageType(const std::string& str) {
-    if (str == "version") return P2PMessageType::VERSION;
-    if (str == "verack") return P2PMessageType::VERACK;
-    if (str == "inv") return P2PMessageType::INV;
-    if (str == "getdata") return P2PMessageType::GETDATA;
-    if (str == "block") return P2PMessageType::BLOCK;
-    if (str == "tx") return P2PMessageType::TX;
-    if (str == "getblocks") return P2PMessageType::GETBLOCKS;
-    if (str == "getheaders") return P2PMessageType::GETHEADERS;
-    if (str == "headers") return P2PMessageType::HEADERS;
-    if (str == "ping") return P2PMessageType::PING;
-    if (str == "pong") return P2PMessageType::PONG;
-    if (str == "reject") return P2PMessageType::REJECT;
-    if (str == "mempool") return P2PMessageType::MEMPOOL;
-    if (str == "filterload") return P2PMessageType::FILTERLOAD;
-    if (str == "filteradd") return P2PMessageType::FILTERADD;
-    if (str == "filterclear") return P2PMessageType::FILTERCLEAR;
-    if (str == "merkleblock") return P2PMessageType::MERKLEBLOCK;
-    if (str == "alert") return P2PMessageType::ALERT;
-    if (str == "sendheaders") return P2PMessageType::SENDHEADERS;
-    if (str == "feefilter") return P2PMessageType::FEEFILTER;
-    if (str == "sendcmpct") return P2PMessageType::SENDCMPCT;
-    if (str == "cmpctblock") return P2PMessageType::CMPCTBLOCK;
-    if (str == "getblocktxn") return P2PMessageType::GETBLOCKTXN;
-    if (str == "blocktxn") return P2PMessageType::BLOCKTXN;
-    if (str == "getcfilters") return P2PMessageType::GETCFILTERS;
-    if (str == "cfilter") return P2PMessageType::CFILTER;
-    if (str == "getcfheaders") return P2PMessageType::GETCFHEADERS;
-    if (str == "cfheaders") return P2PMessageType::CFHEADERS;
-    if (str == "getcfcheckpt") return P2PMessageType::GETCFCHECKPT;
-    if (str == "cfcheckpt") return P2PMessageType::CFCHECKPT;
-    if (str == "wtxidrelay") return P2PMessageType::WTXIDRELAY;
-    throw std::runtime_error("Unknown message type string");
+    char command[P2P_COMMAND_SIZE] = {};
+    P2PMessageType type;
+    if (str.size() > P2P_COMMAND_SIZE) {
+        throw std::runtime_error("Unknown message type string");
+    }
+    std::memcpy(command, str.data(), str.size());
+    if (!lookupCommand(command, type)) {
+        throw std::runtime_error("Unknown message type string");
+    }
+    return type;
+}
+
+P2PMessage::P2PMessage(P2PMessageType type, const std::vector<uint8_t>& data)
+    : P2PMessage(type, std::vector<uint8_t>(data)) {
 }
 
-P2PMessage::P2PMessage(P2PMessageType type, const std::vector<uint8_t>& data) {
-    header.magic = 0x52415645; // Satoxcoin magic number
+P2PMessage::P2PMessage(P2PMessageType type, std::vector<uint8_t>&& data)
+    : payload(std::move(data)) {
+    header.magic = P2P_NETWORK_MAGIC;
     std::string cmd = messageTypeToString(type);
     std::copy(cmd.begin(), cmd.end(), header.command);
-    header.length = data.size();
-    header.checksum = calculateChecksum(data);
-    payload = data;
+    header.length = payload.size();
+    header.checksum = calculateChecksum(payload);
 }
 
 std::vector<uint8_t> serializeMessage(const P2PMessage& message) {
-    std::vector<uint8_t> result;
-    result.reserve(sizeof(P2PMessageHeader) + message.payload.size());
-    
-    // Serialize header
-    result.insert(result.end(), reinterpret_cast<const uint8_t*>(&message.header.magic),
-                 reinterpret_cast<const uint8_t*>(&message.header.magic) + sizeof(message.header.magic));
-    result.insert(result.end(), message.header.command,
-                 message.header.command + sizeof(message.header.command));
-    result.insert(result.end(), reinterpret_cast<const uint8_t*>(&message.header.length),
-                 reinterpret_cast<const uint8_t*>(&message.header.length) + sizeof(message.header.length));
-    result.insert(result.end(), reinterpret_cast<const uint8_t*>(&message.header.checksum),
-                 reinterpret_cast<const uint8_t*>(&message.header.checksum) + sizeof(message.header.checksum));
-    
-    // Add payload
-    result.insert(result.end(), message.payload.begin(), message.payload.end());
-    
+    std::vector<uint8_t> result(P2P_HEADER_SIZE + message.payload.size());
+    encodeHeader(message.header, result.data());
+    if (!message.payload.empty()) {
+        std::memcpy(result.data() + P2P_HEADER_SIZE, message.payload.data(), message.payload.size());
+    }
     return result;
 }
 
 P2PMessage deserializeMessage(const std::vector<uint8_t>& data) {
-    if (data.size() < sizeof(P2PMessageHeader)) {
+    if (data.size() < P2P_HEADER_SIZE) {
         throw std::runtime_error("Message too short");
     }
-    
+
     P2PMessage message;
-    size_t offset = 0;
-    
-    // Deserialize header
-    std::memcpy(&message.header.magic, &data[offset], sizeof(message.header.magic));
-    offset += sizeof(message.header.magic);
-    
-    std::memcpy(message.header.command, &data[offset], sizeof(message.header.command));
-    offset += sizeof(message.header.command);
-    
-    std::memcpy(&message.header.length, &data[offset], sizeof(message.header.length));
-    offset += sizeof(message.header.length);
-    
-    std::memcpy(&message.header.checksum, &data[offset], sizeof(message.header.checksum));
-    offset += sizeof(message.header.checksum);
-    
+    decodeHeader(data.data(), message.header);
+
     // Verify magic number
-    if (message.header.magic != 0x52415645) {
+    if (message.header.magic != P2P_NETWORK_MAGIC) {
         throw std::runtime_error("Invalid magic number");
     }
-    
+
     // Get payload
-    if (data.size() < offset + message.header.length) {
+    if (data.size() - P2P_HEADER_SIZE < message.header.length) {
         throw std::runtime_error("Message payload too short");
     }
-    
-    message.payload.assign(data.begin() + offset, data.begin() + offset + message.header.length);
-    
-    // Verify checksum
-    uint32_t calculated_checksum = calculateChecksum(message.payload);
-    if (calculated_checksum != message.header.checksum) {
+
+    // Verify checksum before copying anything
+    const uint8_t* payload = data.data() + P2P_HEADER_SIZE;
+    if (calculateChecksum(payload, message.header.length) != message.header.checksum) {
         throw std::runtime_error("Invalid checksum");
     }
-    
+
+    message.payload.assign(payload, payload + message.header.length);
     return message;
 }
 
@@ -354,6 +263,33 @@ VersionMessage deserializeVersionMessage(const std::vector<uint8_t>& data) {
     return msg;
 }
 
+std::vector<uint8_t> serializeBlockHeader(const BlockHeader& header) {
+    std::vector<uint8_t> result(BLOCK_HEADER_SIZE);
+    uint8_t* out = result.data();
+    std::memcpy(out, &header.version, sizeof(header.version));
+    std::memcpy(out + 4, header.prev_block.data(), header.prev_block.size());
+    std::memcpy(out + 36, header.merkle_root.data(), header.merkle_root.size());
+    std::memcpy(out + 68, &header.timestamp, sizeof(header.timestamp));
+    std::memcpy(out + 72, &header.bits, sizeof(header.bits));
+    std::memcpy(out + 76, &header.nonce, sizeof(header.nonce));
+    return result;
+}
+
+BlockHeader deserializeBlockHeader(const std::vector<uint8_t>& data) {
+    if (data.size() < BLOCK_HEADER_SIZE) {
+        throw std::runtime_error("Block header too short");
+    }
+    BlockHeader header;
+    const uint8_t* in = data.data();
+    std::memcpy(&header.version, in, sizeof(header.version));
+    std::memcpy(header.prev_block.data(), in + 4, header.prev_block.size());
+    std::memcpy(header.merkle_root.data(), in + 36, header.merkle_root.size());
+    std::memcpy(&header.timestamp, in + 68, sizeof(header.timestamp));
+    std::memcpy(&header.bits, in + 72, sizeof(header.bits));
+    std::memcpy(&header.nonce, in + 76, sizeof(header.nonce));
+    return header;
+}
+
 // Additional serialization/deserialization functions for other message types
 // would be implemented similarly...
 
@@ -25,6 +25,9 @@
 
 #include "rate_limiter.hpp"
 #include <spdlog/spdlog.h>
+#include <functional>
+#include <shared_mutex>
+#include <string_view>
 
 namespace satox {
 
@@ -33,96 +36,121 @@ RateLimiter& RateLimiter::getInstance() {
     return instance;
 }
 
-RateLimiter::RateLimiter() : running_(false) {
-    // Set default limits
-    default_limit_ = {100, std::chrono::seconds(60)}; // 100 requests per minute
+namespace {
 
-    // Set method-specific limits
-    method_limits_["getblockchaininfo"] = {10, std::chrono::seconds(60)};
-    method_limits_["getmempoolinfo"] = {10, std::chrono::seconds(60)};
-    method_limits_["getmininginfo"] = {10, std::chrono::seconds(60)};
-    method_limits_["getnetworkinfo"] = {10, std::chrono::seconds(60)};
-    method_limits_["getpeerinfo"] = {10, std::chrono::seconds(60)};
-    method_limits_["getrawtransaction"] = {20, std::chrono::seconds(60)};
-    method_limits_["sendrawtransaction"] = {5, std::chrono::seconds(60)};
-    method_limits_["getblock"] = {20, std::chrono::seconds(60)};
-    method_limits_["getblockhash"] = {20, std::chrono::seconds(60)};
-    method_limits_["getblockcount"] = {20, std::chrono::seconds(60)};
-    method_limits_["getdifficulty"] = {20, std::chrono::seconds(60)};
-    method_limits_["getbalance"] = {20, std::chrono::seconds(60)};
-    method_limits_["listunspent"] = {20, std::chrono::seconds(60)};
-    method_limits_["getnewaddress"] = {10, std::chrono::seconds(60)};
-    method_limits_["gettransaction"] = {20, std::chrono::seconds(60)};
-    method_limits_["listtransactions"] = {20, std::chrono::seconds(60)};
-    method_limits_["backupwallet"] = {1, std::chrono::seconds(3600)};
-    method_limits_["importwallet"] = {1, std::chrono::seconds(3600)};
-    method_limits_["dumpprivkey"] = {1, std::chrono::seconds(3600)};
-    method_limits_["importprivkey"] = {1, std::chrono::seconds(3600)};
-    method_limits_["getwalletinfo"] = {20, std::chrono::seconds(60)};
-    method_limits_["getaddressesbyaccount"] = {20, std::chrono::seconds(60)};
-    method_limits_["getaccount"] = {20, std::chrono::seconds(60)};
-    method_limits_["getaccountaddress"] = {20, std::chrono::seconds(60)};
-    method_limits_["getaddressesbylabel"] = {20, std::chrono::seconds(60)};
-    method_limits_["getreceivedbylabel"] = {20, std::chrono::seconds(60)};
-    method_limits_["listlabels"] = {20, std::chrono::seconds(60)};
-    method_limits_["getaddressinfo"] = {20, std::chrono::seconds(60)};
-    method_limits_["getblocktemplate"] = {10, std::chrono::seconds(60)};
-    method_limits_["submitblock"] = {5, std::chrono::seconds(60)};
-    method_limits_["getmempoolentry"] = {20, std::chrono::seconds(60)};
-    method_limits_["gettxout"] = {20, std::chrono::seconds(60)};
-    method_limits_["gettxoutsetinfo"] = {5, std::chrono::seconds(60)};
-    method_limits_["verifychain"] = {1, std::chrono::seconds(3600)};
-    method_limits_["getchaintips"] = {10, std::chrono::seconds(60)};
-    method_limits_["getchaintxstats"] = {10, std::chrono::seconds(60)};
-    method_limits_["getnettotals"] = {10, std::chrono::seconds(60)};
-    method_limits_["getnetworkhashps"] = {10, std::chrono::seconds(60)};
-    method_limits_["getmemoryinfo"] = {10, std::chrono::seconds(60)};
-    method_limits_["getrpcinfo"] = {10, std::chrono::seconds(60)};
-    method_limits_["help"] = {20, std::chrono::seconds(60)};
-    method_limits_["stop"] = {1, std::chrono::seconds(3600)};
-    method_limits_["uptime"] = {20, std::chrono::seconds(60)};
+int64_t nowNanoseconds() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
 
-    // Set Satoxcoin-specific method limits
-    method_limits_["issueasset"] = {5, std::chrono::seconds(3600)};
-    method_limits_["reissueasset"] = {5, std::chrono::seconds(3600)};
-    method_limits_["transferasset"] = {20, std::chrono::seconds(60)};
-    method_limits_["listassets"] = {20, std::chrono::seconds(60)};
-    method_limits_["getassetinfo"] = {20, std::chrono::seconds(60)};
-    method_limits_["getassetallocation"] = {20, std::chrono::seconds(60)};
-    method_limits_["getassethistory"] = {20, std::chrono::seconds(60)};
-    method_limits_["getassetbalances"] = {20, std::chrono::seconds(60)};
-    method_limits_["getassettransactions"] = {20, std::chrono::seconds(60)};
-    method_limits_["getassetaddresses"] = {20, std::chrono::seconds(60)};
-    method_limits_["getassetaddressbalances"] = {20, std::chrono::seconds(60)};
-    method_limits_["getassetaddresstransactions"] = {20, std::chrono::seconds(60)};
-    method_limits_["getassetaddresshistory"] = {20, std::chrono::seconds(60)};
-    method_limits_["getassetaddressallocations"] = {20, std::chrono::seconds(60)};
-    method_limits_["getassetaddressallocationhistory"] = {20, std::chrono::seconds(60)};
-    method_limits_["getassetaddressallocationbalances"] = {20, std::chrono::seconds(60)};
-    method_limits_["getassetaddressallocationtransactions"] = {20, std::chrono::seconds(60)};
-    method_limits_["getipfshash"] = {20, std::chrono::seconds(60)};
-    method_limits_["getipfsdata"] = {20, std::chrono::seconds(60)};
-    method_limits_["getipfshistory"] = {20, std::chrono::seconds(60)};
-    method_limits_["getipfsbalances"] = {20, std::chrono::seconds(60)};
-    method_limits_["getipfstransactions"] = {20, std::chrono::seconds(60)};
-    method_limits_["getipfsaddresses"] = {20, std::chrono::seconds(60)};
-    method_limits_["getipfsaddressbalances"] = {20, std::chrono::seconds(60)};
-    method_limits_["getipfsaddresstransactions"] = {20, std::chrono::seconds(60)};
-    method_limits_["getipfsaddresshistory"] = {20, std::chrono::seconds(60)};
-    method_limits_["getnftinfo"] = {20, std::chrono::seconds(60)};
-    method_limits_["getnfthistory"] = {20, std::chrono::seconds(60)};
-    method_limits_["getnftbalances"] = {20, std::chrono::seconds(60)};
-    method_limits_["getnfttransactions"] = {20, std::chrono::seconds(60)};
-    method_limits_["getnftaddresses"] = {20, std::chrono::seconds(60)};
-    method_limits_["getnftaddressbalances"] = {20, std::chrono::seconds(60)};
-    method_limits_["getnftaddresstransactions"] = {20, std::chrono::seconds(60)};
-    method_limits_["getnftaddresshistory"] = {20, std::chrono::seconds(60)};
+// splitmix64 finaliser; spreads std::hash output and combines key halves
+uint64_t mix(uint64_t value) {
+    value += 0x9e3779b97f4a7c15ULL;
+    value = (value ^ (value >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    value = (value ^ (value >> 27)) * 0x94d049bb133111ebULL;
+    return value ^ (value >> 31);
+}
+
+} // namespace
+
+RateLimiter::RateLimiter() : running_(false), reapInterval_(60) {
+    loadDefaultLimits();
 }
 
 RateLimiter::~RateLimiter() {
     shutdown();
 }
 
+void RateLimiter::loadDefaultLimits() {
+    std::unique_lock<std::shared_mutex> lock(configMutex_);
+    method_limits_.clear();
+    client_limits_.clear();
+
+    // Set default limits
+    default_limit_ = {100, std::chrono::seconds(60)}; // 100 requests per minute
+
+    // Set method-specific limits
+    method_limits_[hashMethod("getblockchaininfo")] = {10, std::chrono::seconds(60)};
+    method_limits_[hashMethod("getmempoolinfo")] = {10, std::chrono::seconds(60)};
+    method_limits_[hashMethod("getmininginfo")] = {10, std::chrono::seconds(60)};
+    method_limits_[hashMethod("getnetworkinfo")] = {10, std::chrono::seconds(60)};
+    method_limits_[hashMethod("getpeerinfo")] = {10, std::chrono::seconds(60)};
+    method_limits_[hashMethod("getrawtransaction")] = {20, std::chrono::seconds(60)};
+    method_limits_[hashMethod("sendrawtransaction")] = {5, std::chrono::seconds(60)};
+    method_limits_[hashMethod("getblock")] = {20, std::chrono::seconds(60)};
+    method_limits_[hashMethod("getblockhash")] = {20, std::chrono::seconds(60)};
+    method_limits_[hashMethod("getblockcount")] = {20, std::chrono::seconds(60)};
+    method_limits_[hashMethod("getdifficulty")] = {20, std::chrono::seconds(60)};
+    method_limits_[hashMethod("getbalance")] = {20, std::chrono::seconds(60)};
+    method_limits_[hashMethod("listunspent")] = {20, std::chrono::seconds(60)};
+    method_limits_[hashMethod("getnewaddress")] = {10, std::chrono::seconds(60)};
+    method_limits_[hashMethod("gettransaction")] = {20, std::chrono::seconds(60)};
+    method_limits_[hashMethod("listtransactions")] = {20, std::chrono::seconds(60)};
+    method_limits_[hashMethod("backupwallet")] = {1, std::chrono::seconds(3600)};
+    method_limits_[hashMethod("importwallet")] = {1, std::chrono::seconds(3600)};
+    method_limits_[hashMethod("dumpprivkey")] = {1, std::chrono::seconds(3600)};
+    method_limits_[hashMethod("importprivkey")] = {1, std::chrono::seconds(3600)};
+    method_limits_[hashMethod("getwalletinfo")] = {20, std::chrono::seconds(60)};
+    method_limits_[hashMethod("getaddressesbyaccount")] = {20, std::chrono::seconds(60)};
+    method_limits_[hashMethod("getaccount")] = {20, std::chrono::seconds(60)};
+    method_limits_[hashMethod("getaccountaddress")] = {20, std::chrono::seconds(60)};
+    method_limits_[hashMethod("getaddressesbylabel")] = {20, std::chrono::seconds(60)};
+    method_limits_[hashMethod("getreceivedbylabel")] = {20, std::chrono::seconds(60)};
+    method_limits_[hashMethod("listlabels")] = {20, std::chrono::seconds(60)};
+    method_limits_[hashMethod("getaddressinfo")] = {20, std::chrono::seconds(60)};
+    method_limits_[hashMethod("getblocktemplate")] = {10, std::chrono::seconds(60)};
+    method_limits_[hashMethod("submitblock")] = {5, std::chrono::seconds(60)};
+    method_limits_[hashMethod("getmempoolentry")] = {20, std::chrono::seconds(60)};
+    method_limits_[hashMethod("gettxout")] = {20, std::chrono::seconds(60)};
+    method_limits_[hashMethod("gettxoutsetinfo")] = {5, std::chrono::seconds(60)};
+    method_limits_[hashMethod("verifychain")] = {1, std::chrono::seconds(3600)};
+    method_limits_[hashMethod("getchaintips")] = {10, std::chrono::seconds(60)};
+    method_limits_[hashMethod("getchaintxstats")] = {10, std::chrono::seconds(60)};
+    method_limits_[hashMethod("getnettotals")] = {10, std::chrono::seconds(60)};
+    method_limits_[hashMethod("getnetworkhashps")] = {10, std::chrono::seconds(60)};
+    method_limits_[hashMethod("getmemoryinfo")] = {10, std::chrono::seconds(60)};
+    method_limits_[hashMethod("getrpcinfo")] = {10, std::chrono::seconds(60)};
+    method_limits_[hashMethod("help")] = {20, std::chrono::seconds(60)};
+    method_limits_[hashMethod("stop")] = {1, std::chrono::seconds(3600)};
+    method_limits_[hashMethod("uptime")] = {20, std::chrono::seconds(60)};
+
+    // Set Satoxcoin-specific method limits
+    method_limits_[hashMethod("issueasset")] = {5, std::chrono::seconds(3600)};
+    method_limits_[hashMethod("reissueasset")] = {5, std::chrono::seconds(3600)};
+    method_limits_[hashMethod("transferasset")] = {20, std::chrono::seconds(60)};
+    method_limits_[hashMethod("listassets")] = {20, std::chrono::seconds(60)};
+    method_limits_[hashMethod("getassetinfo")] = {20, std::chrono::seconds(60)};
+    method_limits_[hashMethod("getassetallocation")] = {20, std::chrono::seconds(60)};
+    method_limits_[hashMethod("getassethistory")] = {20, std::chrono::seconds(60)};
+    method_limits_[hashMethod("getassetbalances")] = {20, std::chrono::seconds(60)};
+    method_limits_[hashMethod("getassettransactions")] = {20, std::chrono::seconds(60)};
+    method_limits_[hashMethod("getassetaddresses")] = {20, std::chrono::seconds(60)};
+    method_limits_[hashMethod("getassetaddressbalances")] = {20, std::chrono::seconds(60)};
+    method_limits_[hashMethod("getassetaddresstransactions")] = {20, std::chrono::seconds(60)};
+    method_limits_[hashMethod("getassetaddresshistory")] = {20, std::chrono::seconds(60)};
+    method_limits_[hashMethod("getassetaddressallocations")] = {20, std::chrono::seconds(60)};
+    method_limits_[hashMethod("getassetaddressallocationhistory")] = {20, std::chrono::seconds(60)};
+    method_limits_[hashMethod("getassetaddressallocationbalances")] = {20, std::chrono::seconds(60)};
+    method_limits_[hashMethod("getassetaddressallocationtransactions")] = {20, std::chrono::seconds(60)};
+    method_limits_[hashMethod("getipfshash")] = {20, std::chrono::seconds(60)};
+    method_limits_[hashMethod("getipfsdata")] = {20, std::chrono::seconds(60)};
+    method_limits_[hashMethod("getipfshistory")] = {20, std::chrono::seconds(60)};
+    method_limits_[hashMethod("getipfsbalances")] = {20, std::chrono::seconds(60)};
+    method_limits_[hashMethod("getipfstransactions")] = {20, std::chrono::seconds(60)};
+    method_limits_[hashMethod("getipfsaddresses")] = {20, std::chrono::seconds(60)};
+    method_limits_[hashMethod("getipfsaddressbalances")] = {20, std::chrono::seconds(60)};
+    method_limits_[hashMethod("getipfsaddresstransactions")] = {20, std::chrono::seconds(60)};
+    method_limits_[hashMethod("getipfsaddresshistory")] = {20, std::chrono::seconds(60)};
+    method_limits_[hashMethod("getnftinfo")] = {20, std::chrono::seconds(60)};
+    method_limits_[hashMethod("getnfthistory")] = {20, std::chrono::seconds(60)};
+    method_limits_[hashMethod("getnftbalances")] = {20, std::chrono::seconds(60)};
+    method_limits_[hashMethod("getnfttransactions")] = {20, std::chrono::seconds(60)};
+    method_limits_[hashMethod("getnftaddresses")] = {20, std::chrono::seconds(60)};
+    method_limits_[hashMethod("getnftaddressbalances")] = {20, std::chrono::seconds(60)};
+    method_limits_[hashMethod("getnftaddresstransactions")] = {20, std::chrono::seconds(60)};
+    method_limits_[hashMethod("getnftaddresshistory")] = {20, std::chrono::seconds(60)};
+}
+
 bool RateLimiter::initialize() {
     std::lock_guard<std::mutex> lock(mutex_);
     if (running_) {
@@ -131,128 +159,217 @@ bool RateLimiter::initialize() {
     }
 
     running_ = true;
+    reaper_ = std::thread(&RateLimiter::reaperLoop, this);
     spdlog::info("RateLimiter initialized successfully");
     return true;
 }
 
 void RateLimiter::shutdown() {
-    std::lock_guard<std::mutex> lock(mutex_);
-    if (!running_) return;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (!running_) return;
+        running_ = false;
+    }
+    reaperCv_.notify_all();
+    if (reaper_.joinable()) {
+        reaper_.join();
+    }
 
-    running_ = false;
-    resetAllLimits();
+    // Limits set while running do not carry over to the next initialize()
+    clearShards();
+    loadDefaultLimits();
     spdlog::info("RateLimiter shut down successfully");
 }
 
 bool RateLimiter::isRunning() const {
-    std::lock_guard<std::mutex> lock(mutex_);
     return running_;
 }
 
+uint64_t RateLimiter::hashClientId(const std::string& client_id) {
+    return mix(std::hash<std::string_view>{}(client_id));
+}
+
+uint64_t RateLimiter::hashMethod(const std::string& method) {
+    return mix(std::hash<std::string_view>{}(method) ^ 0x6d6574686f64ULL);
+}
+
 bool RateLimiter::checkLimit(const std::string& method, const std::string& client_id) {
-    std::lock_guard<std::mutex> lock(mutex_);
-    if (!running_) {
-        throw std::runtime_error("RateLimiter not running");
-    }
+    return apply(method, hashClientId(client_id), Mode::Check);
+}
 
-    auto now = std::chrono::steady_clock::now();
-    auto& client_counts = request_counts_[client_id];
-    auto& count = client_counts[method];
+void RateLimiter::updateLimit(const std::string& method, const std::string& client_id) {
+    apply(method, hashClientId(client_id), Mode::Update);
+}
 
-    // Get the appropriate limit configuration
-    const LimitConfig* limit = nullptr;
-    if (auto it = method_limits_.find(method); it != method_limits_.end()) {
-        limit = &it->second;
-    } else if (auto it = client_limits_.find(client_id); it != client_limits_.end()) {
-        limit = &it->second;
-    } else {
-        limit = &default_limit_;
-    }
+bool RateLimiter::tryAcquire(const std::string& method, const std::string& client_id) {
+    return apply(method, hashClientId(client_id), Mode::Acquire);
+}
+
+bool RateLimiter::checkLimit(const std::string& method, uint64_t client_hash) {
+    return apply(method, client_hash, Mode::Check);
+}
 
-    // Check if the window has expired
-    if (now - count.window_start > limit->window) {
-        count.count = 0;
-        count.window_start = now;
+void RateLimiter::updateLimit(const std::string& method, uint64_t client_hash) {
+    apply(method, client_hash, Mode::Update);
+}
+
+bool RateLimiter::tryAcquire(const std::string& method, uint64_t client_hash) {
+    return apply(method, client_hash, Mode::Acquire);
+}
+
+RateLimiter::LimitConfig RateLimiter::findLimit(uint64_t method_hash, uint64_t client_hash) const {
+    std::shared_lock<std::shared_mutex> lock(configMutex_);
+    if (auto it = method_limits_.find(method_hash); it != method_limits_.end()) {
+        return it->second;
+    }
+    if (auto it = client_limits_.find(client_hash); it != client_limits_.end()) {
+        return it->second;
     }
+    return default_limit_;
+}
 
-    // Check if the limit has been exceeded
-    return count.count < limit->max_requests;
+RateLimiter::Shard& RateLimiter::shardFor(uint64_t key) {
+    return shards_[key >> 58];
 }
 
-void RateLimiter::updateLimit(const std::string& method, const std::string& client_id) {
-    std::lock_guard<std::mutex> lock(mutex_);
+bool RateLimiter::apply(const std::string& method, uint64_t client_hash, Mode mode) {
     if (!running_) {
         throw std::runtime_error("RateLimiter not running");
     }
 
-    auto now = std::chrono::steady_clock::now();
-    auto& client_counts = request_counts_[client_id];
-    auto& count = client_counts[method];
-
-    // Get the appropriate limit configuration
-    const LimitConfig* limit = nullptr;
-    if (auto it = method_limits_.find(method); it != method_limits_.end()) {
-        limit = &it->second;
-    } else if (auto it = client_limits_.find(client_id); it != client_limits_.end()) {
-        limit = &it->second;
-    } else {
-        limit = &default_limit_;
+    const uint64_t method_hash = hashMethod(method);
+    const LimitConfig limit = findLimit(method_hash, client_hash);
+    if (limit.max_requests <= 0) {
+        return false;
     }
 
-    // Check if the window has expired
-    if (now - count.window_start > limit->window) {
-        count.count = 0;
-        count.window_start = now;
+    // GCRA: each request advances the TAT by one emission interval; a request
+    // fits while the TAT it would leave stays within one window of now
+    const int64_t window = std::chrono::duration_cast<std::chrono::nanoseconds>(limit.window).count();
+    const int64_t interval = std::max<int64_t>(1, window / limit.max_requests);
+    const uint64_t key = mix(client_hash ^ method_hash);
+    const int64_t now = nowNanoseconds();
+
+    Shard& shard = shardFor(key);
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    auto it = shard.tat.find(key);
+    int64_t tat = it != shard.tat.end() ? std::max(it->second, now) : now;
+    bool allowed = tat + interval - now <= window;
+
+    if (mode == Mode::Check) {
+        return allowed;
     }
-
-    // Increment the count
-    count.count++;
+    if (mode == Mode::Acquire && !allowed) {
+        return false;
+    }
+    if (it != shard.tat.end()) {
+        it->second = tat + interval;
+    } else {
+        shard.tat.emplace(key, tat + interval);
+    }
+    return allowed;
 }
 
 void RateLimiter::resetLimit(const std::string& method, const std::string& client_id) {
-    std::lock_guard<std::mutex> lock(mutex_);
     if (!running_) {
         throw std::runtime_error("RateLimiter not running");
     }
 
-    auto& client_counts = request_counts_[client_id];
-    client_counts.erase(method);
+    const uint64_t key = mix(hashClientId(client_id) ^ hashMethod(method));
+    Shard& shard = shardFor(key);
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    shard.tat.erase(key);
 }
 
 void RateLimiter::resetAllLimits() {
-    std::lock_guard<std::mutex> lock(mutex_);
     if (!running_) {
         throw std::runtime_error("RateLimiter not running");
     }
 
-    request_counts_.clear();
+    clearShards();
+}
+
+void RateLimiter::clearShards() {
+    for (auto& shard : shards_) {
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        shard.tat.clear();
+    }
+}
+
+size_t RateLimiter::reapIdle() {
+    // A TAT at or before now means a full bucket: the same as no entry at all
+    const int64_t now = nowNanoseconds();
+    size_t removed = 0;
+    for (auto& shard : shards_) {
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        for (auto it = shard.tat.begin(); it != shard.tat.end();) {
+            if (it->second <= now) {
+                it = shard.tat.erase(it);
+                ++removed;
+            } else {
+                ++it;
+            }
+        }
+    }
+    return removed;
+}
+
+size_t RateLimiter::getTrackedKeys() const {
+    size_t total = 0;
+    for (auto& shard : shards_) {
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        total += shard.tat.size();
+    }
+    return total;
+}
+
+void RateLimiter::reaperLoop() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    while (running_) {
+        reaperCv_.wait_for(lock, reapInterval_, [this]() { return !running_; });
+        if (!running_) {
+            break;
+        }
+        lock.unlock();
+        size_t removed = reapIdle();
+        if (removed > 0) {
+            spdlog::debug("RateLimiter reaped {} idle keys", removed);
+        }
+        lock.lock();
+    }
 }
 
 void RateLimiter::setMethodLimit(const std::string& method, int max_requests, std::chrono::seconds window) {
-    std::lock_guard<std::mutex> lock(mutex_);
     if (!running_) {
         throw std::runtime_error("RateLimiter not running");
     }
 
-    method_limits_[method] = {max_requests, window};
+    std::unique_lock<std::shared_mutex> lock(configMutex_);
+    method_limits_[hashMethod(method)] = {max_requests, window};
 }
 
 void RateLimiter::setDefaultLimit(int max_requests, std::chrono::seconds window) {
-    std::lock_guard<std::mutex> lock(mutex_);
     if (!running_) {
         throw std::runtime_error("RateLimiter not running");
     }
 
+    std::unique_lock<std::shared_mutex> lock(configMutex_);
     default_limit_ = {max_requests, window};
 }
 
 void RateLimiter::setClientLimit(const std::string& client_id, int max_requests, std::chrono::seconds window) {
-    std::lock_guard<std::mutex> lock(mutex_);
     if (!running_) {
         throw std::runtime_error("RateLimiter not running");
     }
 
-    client_limits_[client_id] = {max_requests, window};
+    std::unique_lock<std::shared_mutex> lock(configMutex_);
+    client_limits_[hashClientId(client_id)] = {max_requests, window};
+}
+
+void RateLimiter::setReapInterval(std::chrono::seconds interval) {
+    // Takes effect from the reaper's next wait
+    std::lock_guard<std::mutex> lock(mutex_);
+    reapInterval_ = std::max(interval, std::chrono::seconds(1));
 }
 
-} // namespace satox 
\ No newline at end of file
+} // namespace satox
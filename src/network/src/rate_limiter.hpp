@@ -25,14 +25,38 @@
 
 #pragma once
 
+#include <array>
+#include <atomic>
 #include <chrono>
+#include <condition_variable>
+#include <cstdint>
 #include <mutex>
+#include <shared_mutex>
+#include <thread>
 #include <unordered_map>
 #include <string>
 #include <memory>
 
 namespace satox {
 
+/**
+ * Per (client, method) request limiter.
+ *
+ * Each limit of max_requests per window is enforced with GCRA, the
+ * "virtual scheduling" form of a token bucket: a key keeps only its
+ * theoretical arrival time (TAT), a request costs window / max_requests,
+ * and it is allowed while TAT - now stays within one window. Bursts of up
+ * to max_requests pass, after which requests are spaced evenly.
+ *
+ * Keys are 64-bit hashes of client and method, spread over SHARD_COUNT
+ * lock-striped shards, so a key costs one map node no matter how many
+ * methods or windows are configured. A key whose TAT has fallen behind the
+ * clock is indistinguishable from a new one, and the reaper thread drops
+ * those every reap interval.
+ *
+ * Callers that already hashed the client ID (hashClientId) pass the hash
+ * to skip rehashing on the hot path.
+ */
 class RateLimiter {
 public:
     static RateLimiter& getInstance();
@@ -47,10 +71,24 @@ public:
     void resetLimit(const std::string& method, const std::string& client_id);
     void resetAllLimits();
 
+    // Check and record in one step; false when the request is over the limit
+    bool tryAcquire(const std::string& method, const std::string& client_id);
+
+    // Pre-hashed client IDs
+    static uint64_t hashClientId(const std::string& client_id);
+    bool checkLimit(const std::string& method, uint64_t client_hash);
+    void updateLimit(const std::string& method, uint64_t client_hash);
+    bool tryAcquire(const std::string& method, uint64_t client_hash);
+
     // Configuration
     void setMethodLimit(const std::string& method, int max_requests, std::chrono::seconds window);
     void setDefaultLimit(int max_requests, std::chrono::seconds window);
     void setClientLimit(const std::string& client_id, int max_requests, std::chrono::seconds window);
+    void setReapInterval(std::chrono::seconds interval);
+
+    // Idle keys; reapIdle returns how many were dropped
+    size_t reapIdle();
+    size_t getTrackedKeys() const;
 
 private:
     RateLimiter();
@@ -65,17 +103,35 @@ private:
         std::chrono::seconds window;
     };
 
-    struct RequestCount {
-        int count;
-        std::chrono::steady_clock::time_point window_start;
+    struct Shard {
+        mutable std::mutex mutex;
+        std::unordered_map<uint64_t, int64_t> tat;   // key -> theoretical arrival time (ns)
     };
 
-    bool running_;
-    std::mutex mutex_;
-    std::unordered_map<std::string, LimitConfig> method_limits_;
-    std::unordered_map<std::string, LimitConfig> client_limits_;
+    enum class Mode { Check, Update, Acquire };
+
+    static constexpr size_t SHARD_COUNT = 64;
+
+    static uint64_t hashMethod(const std::string& method);
+    LimitConfig findLimit(uint64_t method_hash, uint64_t client_hash) const;
+    bool apply(const std::string& method, uint64_t client_hash, Mode mode);
+    Shard& shardFor(uint64_t key);
+    void loadDefaultLimits();
+    void clearShards();
+    void reaperLoop();
+
+    std::atomic<bool> running_;
+    std::mutex mutex_;                                // lifecycle and reaper wakeups
+    std::condition_variable reaperCv_;
+    std::thread reaper_;
+    std::chrono::seconds reapInterval_;
+
+    mutable std::shared_mutex configMutex_;
+    std::unordered_map<uint64_t, LimitConfig> method_limits_;   // by hashMethod
+    std::unordered_map<uint64_t, LimitConfig> client_limits_;   // by hashClientId
     LimitConfig default_limit_;
-    std::unordered_map<std::string, std::unordered_map<std::string, RequestCount>> request_counts_;
+
+    std::array<Shard, SHARD_COUNT> shards_;
 };
 
-} // namespace satox 
\ No newline at end of file
+} // namespace satox
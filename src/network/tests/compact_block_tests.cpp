@@ -0,0 +1,132 @@
+/**
+ * @file compact_block_tests.cpp
+ * @brief Tests for compact block encoding, reconstruction and peer selection
+ * @copyright Copyright (c) 2025 Satoxcoin Core Developers
+ * @license MIT License
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "satox/network/compact_block.hpp"
+#include <gtest/gtest.h>
+#include <string>
+#include <vector>
+
+namespace satox {
+namespace test {
+
+class CompactBlockTests : public ::testing::Test {
+protected:
+    void SetUp() override {
+        for (int i = 0; i < 50; ++i) {
+            std::vector<uint8_t> data(100 + i, static_cast<uint8_t>(i));
+            txs_.push_back(makeRawTransaction(std::move(data)));
+        }
+        header_.version = 4;
+        header_.timestamp = 1700000000;
+        header_.merkle_root = computeMerkleRoot(txs_);
+    }
+
+    BlockHeader header_;
+    std::vector<RawTransactionRef> txs_;
+};
+
+TEST_F(CompactBlockTests, SipHashReferenceVector) {
+    // Key 00..0f, messages of length 0 and 15 (bytes 00..0e)
+    std::vector<uint8_t> message(15);
+    for (size_t i = 0; i < message.size(); ++i) {
+        message[i] = static_cast<uint8_t>(i);
+    }
+    uint64_t k0 = 0x0706050403020100ULL;
+    uint64_t k1 = 0x0f0e0d0c0b0a0908ULL;
+    EXPECT_EQ(sipHash24(k0, k1, nullptr, 0), 0x726fdb47dd0e0e31ULL);
+    EXPECT_EQ(sipHash24(k0, k1, message.data(), message.size()), 0xa129ca6149be45e5ULL);
+}
+
+TEST_F(CompactBlockTests, ReconstructWithRoundTrip) {
+    auto compact = deserializeCompactBlock(serializeCompactBlock(CompactBlockMessage::fromBlock(header_, txs_, 99)));
+    EXPECT_EQ(compact.shortIds.size(), txs_.size() - 1);
+
+    // The mempool is missing every fifth transaction
+    std::vector<RawTransactionRef> mempool;
+    for (size_t i = 1; i < txs_.size(); ++i) {
+        if (i % 5 != 0) {
+            mempool.push_back(txs_[i]);
+        }
+    }
+
+    PartiallyDownloadedBlock partial;
+    ASSERT_EQ(partial.init(compact, mempool), PartiallyDownloadedBlock::Status::Ok);
+    EXPECT_FALSE(partial.isComplete());
+    EXPECT_EQ(partial.prefilledCount(), 1u);
+    EXPECT_EQ(partial.mempoolCount(), mempool.size());
+
+    auto request = deserializeBlockTxnRequest(serializeBlockTxnRequest(partial.missing()));
+    EXPECT_EQ(request.indexes, (std::vector<uint32_t>{5, 10, 15, 20, 25, 30, 35, 40, 45}));
+
+    auto response = deserializeBlockTxn(serializeBlockTxn(answerBlockTxnRequest(request, txs_)));
+    std::vector<RawTransactionRef> block;
+    ASSERT_EQ(partial.fill(response, block), PartiallyDownloadedBlock::Status::Ok);
+    ASSERT_EQ(block.size(), txs_.size());
+    for (size_t i = 0; i < block.size(); ++i) {
+        EXPECT_EQ(block[i]->txid, txs_[i]->txid);
+    }
+}
+
+TEST_F(CompactBlockTests, WrongTransactionFailsMerkleCheck) {
+    auto compact = CompactBlockMessage::fromBlock(header_, txs_, 7);
+    std::vector<RawTransactionRef> mempool(txs_.begin() + 1, txs_.end() - 1);
+
+    PartiallyDownloadedBlock partial;
+    ASSERT_EQ(partial.init(compact, mempool), PartiallyDownloadedBlock::Status::Ok);
+    BlockTxnMessage response;
+    response.blockHash = blockHash(header_);
+    response.txs.push_back(makeRawTransaction({1, 2, 3}));
+    std::vector<RawTransactionRef> block;
+    EXPECT_EQ(partial.fill(response, block), PartiallyDownloadedBlock::Status::Failed);
+
+    EXPECT_THROW(deserializeCompactBlock({1, 2, 3}), std::runtime_error);
+}
+
+TEST_F(CompactBlockTests, HighBandwidthPeerRotation) {
+    CompactBlockPeers peers;
+    for (const char* peer : {"a", "b", "c", "d"}) {
+        peers.onSendCmpct(peer, SendCmpctMessage{});
+    }
+    EXPECT_TRUE(peers.onBlockDelivered("x").empty());
+
+    peers.onBlockDelivered("a");
+    peers.onBlockDelivered("b");
+    peers.onBlockDelivered("c");
+    auto messages = peers.onBlockDelivered("d");
+    ASSERT_EQ(messages.size(), 2u);
+    EXPECT_EQ(messages[0].first, "d");
+    EXPECT_TRUE(messages[0].second.highBandwidth);
+    EXPECT_EQ(messages[1].first, "a");
+    EXPECT_FALSE(messages[1].second.highBandwidth);
+
+    SendCmpctMessage push;
+    push.highBandwidth = true;
+    peers.onSendCmpct("b", push);
+    EXPECT_TRUE(peers.pushesTo("b"));
+    EXPECT_FALSE(peers.pushesTo("a"));
+}
+
+} // namespace test
+} // namespace satox
@@ -0,0 +1,132 @@
+/**
+ * @file p2p_codec_tests.cpp
+ * @brief Tests for the streaming P2P frame parser and command table
+ * @copyright Copyright (c) 2025 Satoxcoin Core Developers
+ * @license MIT License
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "satox/network/p2p_codec.hpp"
+#include <gtest/gtest.h>
+#include <cstring>
+#include <string>
+#include <sys/socket.h>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+
+namespace satox {
+namespace test {
+
+class P2PCodecTests : public ::testing::Test {
+protected:
+    static std::vector<uint8_t> frameBytes(P2PMessageType type, const std::vector<uint8_t>& payload) {
+        P2POutgoingFrame frame = makeFrame(type, payload.data(), payload.size());
+        std::vector<uint8_t> bytes(frame.header, frame.header + P2P_HEADER_SIZE);
+        bytes.insert(bytes.end(), payload.begin(), payload.end());
+        return bytes;
+    }
+};
+
+TEST_F(P2PCodecTests, CommandTableRoundTrip) {
+    for (size_t i = 0; i < P2P_MESSAGE_TYPE_COUNT; ++i) {
+        auto type = static_cast<P2PMessageType>(i);
+        char command[P2P_COMMAND_SIZE] = {};
+        std::memcpy(command, messageCommand(type), std::strlen(messageCommand(type)));
+        P2PMessageType found;
+        ASSERT_TRUE(lookupCommand(command, found)) << messageCommand(type);
+        EXPECT_EQ(found, type);
+    }
+
+    char unknown[P2P_COMMAND_SIZE] = {'p', 'i', 'n', 'g', 0, 'x'};
+    P2PMessageType found;
+    EXPECT_FALSE(lookupCommand(unknown, found));
+}
+
+TEST_F(P2PCodecTests, ByteAtATime) {
+    std::vector<uint8_t> payload(1000);
+    for (size_t i = 0; i < payload.size(); ++i) {
+        payload[i] = static_cast<uint8_t>(i * 7);
+    }
+    auto bytes = frameBytes(P2PMessageType::BLOCK, payload);
+    auto ping = frameBytes(P2PMessageType::PING, {1, 2, 3, 4, 5, 6, 7, 8});
+    bytes.insert(bytes.end(), ping.begin(), ping.end());
+
+    P2PFrameParser parser;
+    P2PFrameView frame;
+    std::vector<P2PMessageType> seen;
+    for (uint8_t byte : bytes) {
+        parser.feed(&byte, 1);
+        while (parser.next(frame) == P2PFrameParser::Status::Frame) {
+            ASSERT_TRUE(frame.known);
+            if (frame.type == P2PMessageType::BLOCK) {
+                EXPECT_EQ(std::vector<uint8_t>(frame.payload, frame.payload + frame.size), payload);
+            }
+            seen.push_back(frame.type);
+        }
+    }
+    EXPECT_EQ(seen, (std::vector<P2PMessageType>{P2PMessageType::BLOCK, P2PMessageType::PING}));
+    EXPECT_EQ(parser.bufferedBytes(), 0u);
+}
+
+TEST_F(P2PCodecTests, RejectsCorruptFrames) {
+    auto bytes = frameBytes(P2PMessageType::TX, {9, 9, 9});
+    bytes.back() ^= 1;
+    P2PFrameParser parser;
+    P2PFrameView frame;
+    parser.feed(bytes.data(), bytes.size());
+    EXPECT_EQ(parser.next(frame), P2PFrameParser::Status::Error);
+    EXPECT_TRUE(parser.failed());
+
+    P2PFrameParser limited(P2P_NETWORK_MAGIC, 16);
+    auto large = frameBytes(P2PMessageType::TX, std::vector<uint8_t>(17));
+    limited.feed(large.data(), P2P_HEADER_SIZE);
+    EXPECT_EQ(limited.next(frame), P2PFrameParser::Status::Error);
+}
+
+TEST_F(P2PCodecTests, ScatterGatherOverSocket) {
+    int fds[2];
+    ASSERT_EQ(socketpair(AF_UNIX, SOCK_STREAM, 0, fds), 0);
+
+    std::vector<uint8_t> payload(200000, 0x42);
+    P2POutgoingFrame out = makeFrame(P2PMessageType::BLOCK, payload.data(), payload.size());
+
+    P2PDispatcher dispatcher;
+    size_t received = 0;
+    dispatcher.setHandler(P2PMessageType::BLOCK, [&](const P2PFrameView& frame) {
+        received = frame.size;
+    });
+
+    P2PFrameParser parser;
+    P2PFrameView frame;
+    std::thread writer([&]() { EXPECT_TRUE(sendFrame(fds[0], out)); });
+    while (parser.next(frame) != P2PFrameParser::Status::Frame) {
+        ASSERT_GT(parser.readFrom(fds[1]), 0);
+    }
+    writer.join();
+    EXPECT_TRUE(dispatcher.dispatch(frame));
+    EXPECT_EQ(received, payload.size());
+
+    close(fds[0]);
+    close(fds[1]);
+}
+
+} // namespace test
+} // namespace satox
@@ -211,6 +211,35 @@ TEST_F(RateLimiterTests, MultipleClients) {
     EXPECT_FALSE(limiter->checkLimit(method, client2));
 }
 
+TEST_F(RateLimiterTests, TryAcquirePreHashed) {
+    const std::string method = "acquire_method";
+    const uint64_t client = RateLimiter::hashClientId("hashed_client");
+    limiter->setMethodLimit(method, 3, std::chrono::seconds(60));
+
+    EXPECT_TRUE(limiter->tryAcquire(method, client));
+    EXPECT_TRUE(limiter->tryAcquire(method, client));
+    EXPECT_TRUE(limiter->tryAcquire(method, "hashed_client"));
+    EXPECT_FALSE(limiter->tryAcquire(method, client));
+    EXPECT_FALSE(limiter->checkLimit(method, "hashed_client"));
+
+    // Other clients have their own bucket
+    EXPECT_TRUE(limiter->tryAcquire(method, RateLimiter::hashClientId("other_client")));
+}
+
+TEST_F(RateLimiterTests, IdleKeysReaped) {
+    const std::string method = "reaped_method";
+    limiter->setMethodLimit(method, 1000, std::chrono::seconds(1));
+    for (int i = 0; i < 1000; ++i) {
+        limiter->updateLimit(method, "client" + std::to_string(i));
+    }
+    EXPECT_GE(limiter->getTrackedKeys(), 1000u);
+
+    // One request costs 1ms of a 1s window, so every key is idle shortly after
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    EXPECT_GE(limiter->reapIdle(), 1000u);
+    EXPECT_EQ(limiter->getTrackedKeys(), 0u);
+}
+
 TEST_F(RateLimiterTests, Shutdown) {
     limiter->shutdown();
     EXPECT_FALSE(limiter->isRunning());
@@ -0,0 +1,120 @@
+/*
+ * MIT License
+ * Copyright (c) 2025 Satoxcoin Core Developer
+ */
+#include "http_connection_pool.hpp"
+#include <curl/curl.h>
+#include <algorithm>
+#include <utility>
+
+namespace satox::rpc_proxy {
+
+namespace {
+
+std::once_flag g_curlInit;
+
+size_t writeBody(char* data, size_t size, size_t count, void* userdata) {
+    static_cast<std::string*>(userdata)->append(data, size * count);
+    return size * count;
+}
+
+} // namespace
+
+HttpConnectionPool::HttpConnectionPool(std::string endpoint, std::string username, std::string password,
+                                       uint32_t timeoutMs, size_t maxConnections)
+    : endpoint_(std::move(endpoint))
+    , credentials_(username.empty() ? std::string() : username + ":" + password)
+    , timeoutMs_(timeoutMs)
+    , maxConnections_(std::max<size_t>(1, maxConnections)) {
+    std::call_once(g_curlInit, []() { curl_global_init(CURL_GLOBAL_DEFAULT); });
+    headers_ = curl_slist_append(headers_, "Content-Type: application/json");
+    // No "Expect: 100-continue" round trip before larger bodies
+    headers_ = curl_slist_append(headers_, "Expect:");
+}
+
+HttpConnectionPool::~HttpConnectionPool() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    // Requests still running return their handles before we tear down
+    available_.wait(lock, [this]() { return idle_.size() == created_; });
+    for (CURL* handle : idle_) {
+        curl_easy_cleanup(handle);
+    }
+    idle_.clear();
+    curl_slist_free_all(headers_);
+}
+
+CURL* HttpConnectionPool::acquire() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    available_.wait(lock, [this]() { return !idle_.empty() || created_ < maxConnections_; });
+    if (!idle_.empty()) {
+        CURL* handle = idle_.back();
+        idle_.pop_back();
+        return handle;
+    }
+
+    CURL* handle = curl_easy_init();
+    if (!handle) {
+        return nullptr;
+    }
+    ++created_;
+    lock.unlock();
+
+    curl_easy_setopt(handle, CURLOPT_URL, endpoint_.c_str());
+    curl_easy_setopt(handle, CURLOPT_HTTPHEADER, headers_);
+    curl_easy_setopt(handle, CURLOPT_POST, 1L);
+    curl_easy_setopt(handle, CURLOPT_TIMEOUT_MS, static_cast<long>(timeoutMs_));
+    curl_easy_setopt(handle, CURLOPT_NOSIGNAL, 1L);
+    curl_easy_setopt(handle, CURLOPT_TCP_KEEPALIVE, 1L);
+    curl_easy_setopt(handle, CURLOPT_TCP_NODELAY, 1L);
+    curl_easy_setopt(handle, CURLOPT_WRITEFUNCTION, writeBody);
+    if (!credentials_.empty()) {
+        curl_easy_setopt(handle, CURLOPT_HTTPAUTH, CURLAUTH_BASIC);
+        curl_easy_setopt(handle, CURLOPT_USERPWD, credentials_.c_str());
+    }
+    return handle;
+}
+
+void HttpConnectionPool::release(CURL* handle) {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        idle_.push_back(handle);
+    }
+    available_.notify_all();
+}
+
+HttpConnectionPool::Result HttpConnectionPool::post(const std::string& body) {
+    Result result;
+    CURL* handle = acquire();
+    if (!handle) {
+        result.error = "Failed to create HTTP handle";
+        return result;
+    }
+
+    curl_easy_setopt(handle, CURLOPT_POSTFIELDS, body.data());
+    curl_easy_setopt(handle, CURLOPT_POSTFIELDSIZE_LARGE, static_cast<curl_off_t>(body.size()));
+    curl_easy_setopt(handle, CURLOPT_WRITEDATA, &result.body);
+
+    CURLcode code = curl_easy_perform(handle);
+    long connects = 0;
+    curl_easy_getinfo(handle, CURLINFO_NUM_CONNECTS, &connects);
+    if (code == CURLE_OK) {
+        curl_easy_getinfo(handle, CURLINFO_RESPONSE_CODE, &result.status);
+        result.ok = true;
+    } else {
+        result.error = curl_easy_strerror(code);
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        connectionsOpened_ += static_cast<uint64_t>(connects);
+    }
+    release(handle);
+    return result;
+}
+
+uint64_t HttpConnectionPool::connectionsOpened() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return connectionsOpened_;
+}
+
+} // namespace satox::rpc_proxy
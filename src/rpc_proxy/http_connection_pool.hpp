@@ -0,0 +1,60 @@
+/*
+ * MIT License
+ * Copyright (c) 2025 Satoxcoin Core Developer
+ */
+#pragma once
+
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <vector>
+
+typedef void CURL;
+struct curl_slist;
+
+namespace satox::rpc_proxy {
+
+// Keep-alive HTTP/1.1 POSTs to one endpoint. Each pooled curl handle owns
+// its connection, so a handle reused for the next request skips the TCP
+// (and TLS) handshake. At most maxConnections requests are in flight;
+// further callers wait for a handle to come back.
+class HttpConnectionPool {
+public:
+    struct Result {
+        bool ok = false;
+        long status = 0;
+        std::string body;
+        std::string error;
+    };
+
+    HttpConnectionPool(std::string endpoint, std::string username, std::string password,
+                       uint32_t timeoutMs, size_t maxConnections);
+    ~HttpConnectionPool();
+    HttpConnectionPool(const HttpConnectionPool&) = delete;
+    HttpConnectionPool& operator=(const HttpConnectionPool&) = delete;
+
+    Result post(const std::string& body);
+
+    // Fresh TCP connections opened so far; stays flat while keep-alive works
+    uint64_t connectionsOpened() const;
+
+private:
+    CURL* acquire();
+    void release(CURL* handle);
+
+    const std::string endpoint_;
+    const std::string credentials_;
+    const uint32_t timeoutMs_;
+    const size_t maxConnections_;
+
+    mutable std::mutex mutex_;
+    std::condition_variable available_;
+    std::vector<CURL*> idle_;
+    size_t created_ = 0;
+    uint64_t connectionsOpened_ = 0;
+    curl_slist* headers_ = nullptr;
+};
+
+} // namespace satox::rpc_proxy
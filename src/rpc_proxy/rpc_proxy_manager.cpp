@@ -5,12 +5,14 @@
 #include "../../include/satox/rpc_proxy/rpc_proxy_manager.hpp"
 #include "../../include/satox/rpc_proxy/types.hpp"
 #include "../../include/satox/rpc_proxy/error.hpp"
+#include "http_connection_pool.hpp"
 #include <spdlog/spdlog.h>
 #include <spdlog/sinks/rotating_file_sink.h>
 #include <spdlog/sinks/stdout_color_sinks.h>
 #include <iostream>
 #include <nlohmann/json.hpp>
 #include <chrono>
+#include <filesystem>
 #include <thread>
 
 namespace satox::rpc_proxy {
@@ -23,6 +25,9 @@ static std::shared_ptr<spdlog::logger>& getLogger() {
     return g_logger;
 }
 
+// Cached or coalesced entries beyond this trigger a sweep of expired ones
+static constexpr size_t CACHE_SWEEP_THRESHOLD = 10000;
+
 static void initializeLogging(const std::string& logPath) {
     std::lock_guard<std::mutex> lock(g_logger_mutex);
     try {
@@ -59,6 +64,10 @@ bool RpcProxyManager::initialize(const RpcProxyConfig& config) {
         if (config_.enableLogging) {
             initializeLogging(config_.logPath);
         }
+        pool_ = std::make_shared<HttpConnectionPool>(config_.endpoint, config_.username, config_.password,
+                                                     config_.timeout_ms, config_.max_connections);
+        readOnlyMethods_ = std::unordered_set<std::string>(config_.read_only_methods.begin(),
+                                                           config_.read_only_methods.end());
         initialized_ = true;
         healthy_ = true;
         logInfo("RPC Proxy initialized");
@@ -86,6 +95,13 @@ void RpcProxyManager::shutdown() {
         }
     }
     
+    // Requests already running keep their reference to the pool until they finish
+    pool_.reset();
+    {
+        std::lock_guard<std::mutex> cacheLock(cacheMutex_);
+        cache_.clear();
+    }
+
     initialized_ = false;
     healthy_ = false;
     logInfo("RPC Proxy shutdown");
@@ -107,27 +123,220 @@ std::string RpcProxyManager::getLastError() const {
 }
 
 RpcProxyStats RpcProxyManager::getStats() const {
-    std::lock_guard<std::mutex> lock(mutex_);
-    return stats_;
+    RpcProxyStats stats;
+    std::shared_ptr<HttpConnectionPool> pool;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stats = stats_;
+        pool = pool_;
+    }
+    std::lock_guard<std::mutex> cacheLock(cacheMutex_);
+    stats.additional_stats["cache_hits"] = cacheHits_;
+    stats.additional_stats["coalesced"] = coalesced_;
+    stats.additional_stats["upstream_requests"] = upstreamRequests_;
+    stats.additional_stats["batches"] = batches_;
+    stats.additional_stats["cache_entries"] = cache_.size();
+    stats.additional_stats["connections_opened"] = pool ? pool->connectionsOpened() : 0;
+    return stats;
 }
 
 bool RpcProxyManager::sendRpcRequest(const nlohmann::json& request, nlohmann::json& response) {
-    std::lock_guard<std::mutex> lock(mutex_);
-    if (!initialized_) {
-        lastError_ = "Not initialized";
-        logError(lastError_);
-        stats_.errors_total++;
+    std::shared_ptr<HttpConnectionPool> pool;
+    bool readOnly = false;
+    std::chrono::milliseconds ttl{0};
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (!initialized_) {
+            lastError_ = "Not initialized";
+            logError(lastError_);
+            stats_.errors_total++;
+            return false;
+        }
+        pool = pool_;
+        readOnly = request.is_object() && request.contains("method") && request["method"].is_string() &&
+                   readOnlyMethods_.count(request["method"].get<std::string>()) != 0;
+        ttl = std::chrono::milliseconds(config_.cache_ttl_ms);
+    }
+
+    const auto start = std::chrono::steady_clock::now();
+    UpstreamResult result;
+    if (!readOnly) {
+        result = postUpstream(*pool, request);
+    } else {
+        // Identical read-only calls share the cached answer or the one request in flight
+        const std::string key = request["method"].get<std::string>() + '\n' +
+                                request.value("params", nlohmann::json::array()).dump();
+        std::promise<UpstreamResult> promise;
+        SharedResult pending;
+        {
+            std::lock_guard<std::mutex> cacheLock(cacheMutex_);
+            auto cached = cache_.find(key);
+            if (cached != cache_.end()) {
+                if (cached->second.expires > start) {
+                    ++cacheHits_;
+                    result.ok = true;
+                    result.response = cached->second.response;
+                } else {
+                    cache_.erase(cached);
+                }
+            }
+            if (!result.ok) {
+                auto inFlight = inFlight_.find(key);
+                if (inFlight != inFlight_.end()) {
+                    ++coalesced_;
+                    pending = inFlight->second;
+                } else {
+                    inFlight_.emplace(key, promise.get_future().share());
+                }
+            }
+        }
+
+        if (result.ok) {
+            // Served from cache
+        } else if (pending.valid()) {
+            result = pending.get();
+        } else {
+            try {
+                result = postUpstream(*pool, request);
+            } catch (...) {
+                // Waiters see the same failure and the next caller starts a new request
+                {
+                    std::lock_guard<std::mutex> cacheLock(cacheMutex_);
+                    inFlight_.erase(key);
+                }
+                promise.set_exception(std::current_exception());
+                throw;
+            }
+            {
+                std::lock_guard<std::mutex> cacheLock(cacheMutex_);
+                inFlight_.erase(key);
+                bool rpcError = result.response.is_object() && result.response.contains("error") &&
+                                !result.response["error"].is_null();
+                if (result.ok && !rpcError && ttl.count() > 0) {
+                    auto now = std::chrono::steady_clock::now();
+                    if (cache_.size() >= CACHE_SWEEP_THRESHOLD) {
+                        for (auto it = cache_.begin(); it != cache_.end();) {
+                            it = it->second.expires <= now ? cache_.erase(it) : std::next(it);
+                        }
+                    }
+                    cache_[key] = {result.response, now + ttl};
+                }
+            }
+            promise.set_value(result);
+        }
+    }
+
+    recordResult(result.ok, start, result.error);
+    if (!result.ok) {
         return false;
     }
-    // TODO: Implement actual HTTP/HTTPS request logic
-    // For now, just simulate a response
-    std::this_thread::sleep_for(std::chrono::milliseconds(10));
-    response = nlohmann::json{{"result", "ok"}, {"id", request.value("id", "0")}};
-    stats_.requests_total++;
-    stats_.last_latency_ms = 10;
+    response = std::move(result.response);
+    // Shared answers carry whichever id reached the node first
+    if (response.is_object() && request.contains("id")) {
+        response["id"] = request["id"];
+    }
+    return true;
+}
+
+bool RpcProxyManager::sendRpcBatch(const std::vector<nlohmann::json>& requests,
+                                   std::vector<nlohmann::json>& responses) {
+    std::shared_ptr<HttpConnectionPool> pool;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (!initialized_) {
+            lastError_ = "Not initialized";
+            logError(lastError_);
+            stats_.errors_total++;
+            return false;
+        }
+        pool = pool_;
+    }
+    responses.assign(requests.size(), nullptr);
+    if (requests.empty()) {
+        return true;
+    }
+
+    const auto start = std::chrono::steady_clock::now();
+    {
+        std::lock_guard<std::mutex> cacheLock(cacheMutex_);
+        ++batches_;
+    }
+    UpstreamResult result = postUpstream(*pool, nlohmann::json(requests));
+    if (result.ok && !result.response.is_array()) {
+        result.ok = false;
+        result.error = "Batch response is not an array";
+    }
+    recordResult(result.ok, start, result.error);
+    if (!result.ok) {
+        return false;
+    }
+
+    // Nodes may answer a batch in any order: match by id where ids are
+    // unique, by position otherwise
+    std::unordered_map<std::string, size_t> byId;
+    for (size_t i = 0; i < requests.size(); ++i) {
+        if (requests[i].contains("id")) {
+            auto inserted = byId.emplace(requests[i]["id"].dump(), i);
+            if (!inserted.second) {
+                inserted.first->second = SIZE_MAX;
+            }
+        }
+    }
+    const auto& answers = result.response;
+    for (size_t i = 0; i < answers.size(); ++i) {
+        auto it = answers[i].is_object() && answers[i].contains("id")
+                      ? byId.find(answers[i]["id"].dump()) : byId.end();
+        if (it != byId.end() && it->second != SIZE_MAX) {
+            responses[it->second] = answers[i];
+        } else if (i < responses.size() && responses[i].is_null()) {
+            responses[i] = answers[i];
+        }
+    }
     return true;
 }
 
+RpcProxyManager::UpstreamResult RpcProxyManager::postUpstream(HttpConnectionPool& pool,
+                                                              const nlohmann::json& body) {
+    {
+        std::lock_guard<std::mutex> cacheLock(cacheMutex_);
+        ++upstreamRequests_;
+    }
+
+    UpstreamResult result;
+    auto http = pool.post(body.dump());
+    if (!http.ok) {
+        result.error = "Connection failed: " + http.error;
+        return result;
+    }
+
+    // Nodes report RPC errors with HTTP 500 and a JSON body, so parse first
+    try {
+        result.response = nlohmann::json::parse(http.body);
+        result.ok = true;
+    } catch (const nlohmann::json::exception&) {
+        result.error = "Invalid response (HTTP " + std::to_string(http.status) + ")";
+    }
+    return result;
+}
+
+void RpcProxyManager::recordResult(bool ok, std::chrono::steady_clock::time_point start,
+                                   const std::string& error) {
+    auto latency = std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::steady_clock::now() - start).count();
+    std::lock_guard<std::mutex> lock(mutex_);
+    stats_.requests_total++;
+    stats_.last_latency_ms = static_cast<uint64_t>(latency);
+    if (!ok) {
+        stats_.errors_total++;
+        lastError_ = error;
+        logError(error);
+    }
+    if (healthy_ != ok && initialized_) {
+        healthy_ = ok;
+        notifyHealth(ok);
+    }
+}
+
 void RpcProxyManager::registerErrorCallback(std::function<void(const std::string&)> cb) {
     std::lock_guard<std::mutex> lock(mutex_);
     errorCallbacks_.push_back(cb);
@@ -4,9 +4,116 @@
  */
 #include <gtest/gtest.h>
 #include "satox/rpc_proxy/rpc_proxy_manager.hpp"
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <vector>
 
 using namespace satox::rpc_proxy;
 
+// Minimal keep-alive JSON-RPC node: answers every call with "ok" after delayMs
+class MockRpcServer {
+public:
+    explicit MockRpcServer(int delayMs = 0) : delayMs_(delayMs) {
+        listenFd_ = ::socket(AF_INET, SOCK_STREAM, 0);
+        int one = 1;
+        ::setsockopt(listenFd_, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+        sockaddr_in addr{};
+        addr.sin_family = AF_INET;
+        addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        ::bind(listenFd_, reinterpret_cast<sockaddr*>(&addr), sizeof(addr));
+        ::listen(listenFd_, 64);
+        socklen_t len = sizeof(addr);
+        ::getsockname(listenFd_, reinterpret_cast<sockaddr*>(&addr), &len);
+        port_ = ntohs(addr.sin_port);
+        acceptThread_ = std::thread([this] { acceptLoop(); });
+    }
+
+    ~MockRpcServer() {
+        stopping_ = true;
+        ::shutdown(listenFd_, SHUT_RDWR);
+        ::close(listenFd_);
+        acceptThread_.join();
+        for (auto& t : connections_) {
+            t.join();
+        }
+    }
+
+    std::string endpoint() const { return "http://127.0.0.1:" + std::to_string(port_); }
+    int calls() const { return calls_; }
+    int accepted() const { return accepted_; }
+
+private:
+    void acceptLoop() {
+        while (!stopping_) {
+            int fd = ::accept(listenFd_, nullptr, nullptr);
+            if (fd < 0) {
+                return;
+            }
+            ++accepted_;
+            connections_.emplace_back([this, fd] { serve(fd); });
+        }
+    }
+
+    void serve(int fd) {
+        std::string buffer;
+        char chunk[4096];
+        while (true) {
+            size_t headerEnd;
+            while ((headerEnd = buffer.find("\r\n\r\n")) == std::string::npos) {
+                ssize_t n = ::recv(fd, chunk, sizeof(chunk), 0);
+                if (n <= 0) {
+                    ::close(fd);
+                    return;
+                }
+                buffer.append(chunk, static_cast<size_t>(n));
+            }
+            size_t lengthPos = buffer.find("Content-Length: ");
+            size_t length = std::stoul(buffer.substr(lengthPos + 16));
+            while (buffer.size() < headerEnd + 4 + length) {
+                ssize_t n = ::recv(fd, chunk, sizeof(chunk), 0);
+                if (n <= 0) {
+                    ::close(fd);
+                    return;
+                }
+                buffer.append(chunk, static_cast<size_t>(n));
+            }
+            auto request = nlohmann::json::parse(buffer.substr(headerEnd + 4, length));
+            buffer.erase(0, headerEnd + 4 + length);
+
+            ++calls_;
+            std::this_thread::sleep_for(std::chrono::milliseconds(delayMs_));
+            nlohmann::json reply;
+            if (request.is_array()) {
+                reply = nlohmann::json::array();
+                // Answer in reverse order; clients must match by id
+                for (auto it = request.rbegin(); it != request.rend(); ++it) {
+                    reply.push_back({{"result", (*it)["method"]}, {"error", nullptr}, {"id", (*it)["id"]}});
+                }
+            } else {
+                reply = {{"result", "ok"}, {"error", nullptr}, {"id", request["id"]}};
+            }
+            std::string body = reply.dump();
+            std::string response = "HTTP/1.1 200 OK\r\nContent-Type: application/json\r\nContent-Length: " +
+                                   std::to_string(body.size()) + "\r\n\r\n" + body;
+            ::send(fd, response.data(), response.size(), MSG_NOSIGNAL);
+        }
+    }
+
+    int delayMs_;
+    int listenFd_ = -1;
+    uint16_t port_ = 0;
+    std::atomic<bool> stopping_{false};
+    std::atomic<int> calls_{0};
+    std::atomic<int> accepted_{0};
+    std::thread acceptThread_;
+    std::vector<std::thread> connections_;
+};
+
 class RpcProxyManagerTest : public ::testing::Test {
 protected:
     void SetUp() override {
@@ -35,11 +142,125 @@ TEST_F(RpcProxyManagerTest, InitializationAndShutdown) {
 }
 
 TEST_F(RpcProxyManagerTest, SendRpcRequest) {
+    MockRpcServer server;
+    config.endpoint = server.endpoint();
     auto& proxy = RpcProxyManager::getInstance();
     proxy.initialize(config);
     nlohmann::json req = {{"method", "ping"}, {"id", "1"}};
     nlohmann::json resp;
     EXPECT_TRUE(proxy.sendRpcRequest(req, resp));
     EXPECT_EQ(resp["result"], "ok");
+    EXPECT_EQ(resp["id"], "1");
+    proxy.shutdown();
+}
+
+TEST_F(RpcProxyManagerTest, UnreachableNodeFails) {
+    config.endpoint = "http://127.0.0.1:1";
+    auto& proxy = RpcProxyManager::getInstance();
+    proxy.initialize(config);
+    nlohmann::json resp;
+    EXPECT_FALSE(proxy.sendRpcRequest({{"method", "ping"}, {"id", 1}}, resp));
+    EXPECT_FALSE(proxy.getLastError().empty());
+    proxy.shutdown();
+}
+
+TEST_F(RpcProxyManagerTest, ConnectionsAreReused) {
+    MockRpcServer server;
+    config.endpoint = server.endpoint();
+    config.max_connections = 2;
+    auto& proxy = RpcProxyManager::getInstance();
+    proxy.initialize(config);
+    for (int i = 0; i < 20; ++i) {
+        nlohmann::json resp;
+        EXPECT_TRUE(proxy.sendRpcRequest({{"method", "sendrawtransaction"}, {"id", i}}, resp));
+    }
+    EXPECT_EQ(server.calls(), 20);
+    EXPECT_EQ(server.accepted(), 1);
+    EXPECT_EQ(proxy.getStats().additional_stats["connections_opened"], 1);
+    proxy.shutdown();
+}
+
+TEST_F(RpcProxyManagerTest, BatchMatchesResponsesById) {
+    MockRpcServer server;
+    config.endpoint = server.endpoint();
+    auto& proxy = RpcProxyManager::getInstance();
+    proxy.initialize(config);
+    std::vector<nlohmann::json> requests = {
+        {{"method", "getblockcount"}, {"id", 1}},
+        {{"method", "getbestblockhash"}, {"id", 2}},
+        {{"method", "getdifficulty"}, {"id", 3}},
+    };
+    std::vector<nlohmann::json> responses;
+    ASSERT_TRUE(proxy.sendRpcBatch(requests, responses));
+    ASSERT_EQ(responses.size(), 3u);
+    for (size_t i = 0; i < requests.size(); ++i) {
+        EXPECT_EQ(responses[i]["result"], requests[i]["method"]);
+        EXPECT_EQ(responses[i]["id"], requests[i]["id"]);
+    }
+    EXPECT_EQ(server.calls(), 1);
     proxy.shutdown();
-} 
\ No newline at end of file
+}
+
+TEST_F(RpcProxyManagerTest, IdenticalReadsAreCoalesced) {
+    MockRpcServer server(100);
+    config.endpoint = server.endpoint();
+    config.cache_ttl_ms = 0;
+    auto& proxy = RpcProxyManager::getInstance();
+    proxy.initialize(config);
+    const int coalescedBefore = proxy.getStats().additional_stats["coalesced"].get<int>();
+    std::vector<std::thread> clients;
+    std::atomic<int> succeeded{0};
+    for (int i = 0; i < 8; ++i) {
+        clients.emplace_back([&proxy, &succeeded, i] {
+            nlohmann::json resp;
+            if (proxy.sendRpcRequest({{"method", "getblockcount"}, {"params", nlohmann::json::array()}, {"id", i}}, resp) &&
+                resp["id"] == i) {
+                ++succeeded;
+            }
+        });
+    }
+    for (auto& t : clients) {
+        t.join();
+    }
+    EXPECT_EQ(succeeded, 8);
+    EXPECT_LT(server.calls(), 8);
+    auto stats = proxy.getStats();
+    EXPECT_EQ(stats.additional_stats["coalesced"].get<int>() - coalescedBefore + server.calls(), 8);
+    proxy.shutdown();
+}
+
+TEST_F(RpcProxyManagerTest, ReadsServedFromCacheWithinTtl) {
+    MockRpcServer server;
+    config.endpoint = server.endpoint();
+    config.cache_ttl_ms = 60000;
+    auto& proxy = RpcProxyManager::getInstance();
+    proxy.initialize(config);
+    const int hitsBefore = proxy.getStats().additional_stats["cache_hits"].get<int>();
+    nlohmann::json resp;
+    EXPECT_TRUE(proxy.sendRpcRequest({{"method", "getblockcount"}, {"id", 1}}, resp));
+    EXPECT_TRUE(proxy.sendRpcRequest({{"method", "getblockcount"}, {"id", 2}}, resp));
+    EXPECT_EQ(resp["id"], 2);
+    EXPECT_EQ(server.calls(), 1);
+    // Writes are never cached
+    EXPECT_TRUE(proxy.sendRpcRequest({{"method", "sendrawtransaction"}, {"id", 3}}, resp));
+    EXPECT_TRUE(proxy.sendRpcRequest({{"method", "sendrawtransaction"}, {"id", 4}}, resp));
+    EXPECT_EQ(server.calls(), 3);
+    EXPECT_EQ(proxy.getStats().additional_stats["cache_hits"].get<int>() - hitsBefore, 1);
+    proxy.shutdown();
+}
+
+TEST_F(RpcProxyManagerTest, FailedInFlightReadIsNotReused) {
+    MockRpcServer server;
+    config.endpoint = server.endpoint();
+    config.cache_ttl_ms = 0;
+    auto& proxy = RpcProxyManager::getInstance();
+    proxy.initialize(config);
+    nlohmann::json resp;
+    // Invalid UTF-8 makes serializing the upstream body throw
+    EXPECT_THROW(proxy.sendRpcRequest({{"method", "getblockcount"}, {"id", "\xff"}}, resp),
+                 nlohmann::json::exception);
+    // The failed request no longer counts as in flight
+    EXPECT_TRUE(proxy.sendRpcRequest({{"method", "getblockcount"}, {"id", 1}}, resp));
+    EXPECT_EQ(resp["id"], 1);
+    proxy.shutdown();
+}